@@ -24,7 +24,7 @@ const std::string EXPERIMENT_CSV_PATH = "experiments_db_CSV"; // To contain CSV
 // Each input element to db is a (key, value) pair of types uint64_t, which has the size of 16 bytes.
 const int KV_BYTE_SIZE = sizeof(uint64_t) * 2;
 const std::string EVICTION_POLICIES_NAMES[2] = {"LRU", "CLOCK"};
-const std::string SEARCH_TYPES_NAMES[2] = {"BinarySearch", "BTreeSearch"};
+const std::string SEARCH_TYPES_NAMES[3] = {"BinarySearch", "BTreeSearch", "LearnedIndex"};
 
 class Experiment {
     Db *db;
@@ -37,6 +37,7 @@ class Experiment {
     EvictionPolicyType evictionPolicy;
     SearchType searchType;
     int bloomFilterBits;
+    size_t pageSize;
 
     /**
      * Write experiment data in CSV format to file at given path.
@@ -60,7 +61,8 @@ class Experiment {
                        << "elapsedTime(sec)" << ","
                        << "throughput(MB/sec)" << ","
                        << "latency(sec)" << ","
-                       << "bloomFilterBits"
+                       << "bloomFilterBits" << ","
+                       << "pageSize"
                        << std::endl;
         }
 
@@ -73,7 +75,8 @@ class Experiment {
                    << elapsedTime << ","
                    << throughput << "," // throughput
                    << elapsedTime / this->numKVPairs << "," // latency
-                   << this->bloomFilterBits
+                   << this->bloomFilterBits << ","
+                   << this->pageSize
                    << std::endl;
 
         outputFile.close();
@@ -131,7 +134,7 @@ class Experiment {
 
 public:
     explicit Experiment(std::string outputDir, uint64_t dataByteSize, int memtableSize, SearchType searchType,
-                        int bloomFilterBits = 0) {
+                        int bloomFilterBits = 0, size_t pageSize = SST::PAGE_SIZE) {
         this->outputDir = Utils::EnsureDirSlash(std::move(outputDir));
         this->numKVPairs = dataByteSize / KV_BYTE_SIZE;
         this->memtableSize = memtableSize;
@@ -139,15 +142,18 @@ public:
         this->bufferMaxSize = 0;
         this->evictionPolicy = EvictionPolicyType::LRU_t;
         this->bloomFilterBits = bloomFilterBits;
+        this->pageSize = pageSize;
 
         // Create new db using given parameter, exit if fails
         int memtableKVPairs = this->memtableSize / KV_BYTE_SIZE;
+        DbOptions options;
+        options.pageSize = pageSize;
         if (this->bloomFilterBits == 0) {
-            this->db = new Db(memtableKVPairs, searchType);
+            this->db = new Db(memtableKVPairs, searchType, nullptr, nullptr, options);
         } else {
             auto bufferPool = new BufferPool(pow(2, 3), pow(2, 8), LRU_t);
             auto lsmTree = new LSMTree(bloomFilterBits, 8, 8);
-            this->db = new Db(memtableKVPairs, searchType, bufferPool, lsmTree);
+            this->db = new Db(memtableKVPairs, searchType, bufferPool, lsmTree, options);
         }
         if (!this->db->Open(EXPERIMENT_DB_PATH)) {
             std::cout << "Failed to open DB at path " << EXPERIMENT_DB_PATH << std::endl;
@@ -1,6 +1,10 @@
 #include "Db.h"
 #include "Data.h"
 #include "Experiment.h"
+#include "MemtableBenchmark.h"
+#include "WriteAheadLogBenchmark.h"
+#include "SearchBenchmark.h"
+#include "SSTWriteBenchmark.h"
 #include <string>
 
 void RunExperimentsStepOne() {
@@ -74,7 +78,7 @@ void BinarySearchBTreeExperiment(const std::string &outputDir) {
     int memtableByteSize = ONE_MEGA_BYTE;
 
     // Run experiment
-    for (auto &searchType: {SearchType::BINARY_SEARCH, SearchType::B_TREE_SEARCH}) {
+    for (auto &searchType: {SearchType::BINARY_SEARCH, SearchType::B_TREE_SEARCH, SearchType::LEARNED_INDEX}) {
         // Clear experiment db directory
         Experiment::ResetDbDirectory();
 
@@ -179,11 +183,105 @@ void RunExperimentStepThree() {
     BloomFilterExperiment(outputDir);
 }
 
+void MemtableAllocationBenchmark(const std::string &outputDir) {
+    // Vary the number of keys in the memtable from 2^14 to 2^20.
+    uint64_t maxNumKeys = 1 << 20;
+    auto benchmark = MemtableBenchmark(outputDir, maxNumKeys);
+    for (uint64_t numKeys = 1 << 14; numKeys <= maxNumKeys; numKeys <<= 2) {
+        benchmark.RunRedBlackTreeAllocationBenchmark(numKeys, 5);
+    }
+}
+
+void MemtableIndexBenchmark(const std::string &outputDir) {
+    // Vary the number of keys in the memtable from 2^14 to 2^20.
+    uint64_t maxNumKeys = 1 << 20;
+    auto benchmark = MemtableBenchmark(outputDir, maxNumKeys);
+    for (uint64_t numKeys = 1 << 14; numKeys <= maxNumKeys; numKeys <<= 2) {
+        benchmark.RunMemtableIndexBenchmark(numKeys, 10000, 100);
+    }
+}
+
+void WriteAheadLogSyncModeBenchmark(const std::string &outputDir) {
+    // Vary the number of concurrent writers, which share the syncs of the write-ahead log.
+    auto benchmark = WriteAheadLogBenchmark(outputDir);
+    for (int numThreads: {1, 4, 16}) {
+        benchmark.RunPutBenchmark(1 << 12, numThreads);
+    }
+}
+
+void NodeSearchBenchmark(const std::string &outputDir) {
+    // Vary the number of keys from a columnar leaf (256) and an internal page (512) to the
+    // fence keys of a large file.
+    auto benchmark = SearchBenchmark(outputDir);
+    for (uint64_t numKeys: {256, 512, 1 << 14, 1 << 20}) {
+        benchmark.RunNodeSearchBenchmark(numKeys, 1 << 22);
+    }
+}
+
+void SSTWriteThroughputBenchmark(const std::string &outputDir) {
+    // Vary the number of key-value pairs from a file of 16 MB to one of 256 MB.
+    auto benchmark = SSTWriteBenchmark(outputDir);
+    for (uint64_t numEntries: {1 << 20, 1 << 22, 1 << 24}) {
+        benchmark.RunSmallWritesBenchmark(numEntries);
+        benchmark.RunSSTWriterBenchmark(numEntries);
+    }
+}
+
+void PageSizeExperiment(const std::string &outputDir) {
+    // Larger pages mean fewer reads per scan and compaction, but more bytes read per lookup.
+    int memtableSize = ONE_MEGA_BYTE;
+    uint64_t inputDataByteSize = 256 * ONE_MEGA_BYTE;
+    int bloomFilterNumBits = 5;
+    for (size_t pageSize: {(size_t) 4096, (size_t) 16384, (size_t) 65536}) {
+        // Clear experiment db directory
+        Experiment::ResetDbDirectory();
+
+        auto experiment = Experiment(outputDir, inputDataByteSize, memtableSize, B_TREE_SEARCH, bloomFilterNumBits,
+                                     pageSize);
+        experiment.RunExperiment(Operation::Put, "put_operation_page_size.csv");
+
+        // Randomize the input data and reset buffer pool before Get queries
+        experiment.RandomizeData();
+        experiment.ResetBufferPool(pow(2, 8), EvictionPolicyType::LRU_t);
+
+        experiment.RunExperiment(Operation::Get, "get_operation_page_size.csv");
+        experiment.RunExperiment(Operation::Scan, "scan_operation_page_size.csv");
+    }
+}
+
+void RunExperimentStepFour() {
+    std::cout << "Running experiment Step 4\n";
+
+    const std::string outputDir = EXPERIMENT_CSV_PATH + "_step4";
+    if (!fs::exists(outputDir)) {
+        fs::create_directories(outputDir);
+    }
+
+    /** Experiment #1: Measure memtable Put throughput with heap allocated vs arena allocated nodes **/
+    MemtableAllocationBenchmark(outputDir);
+
+    /** Experiment #2: Measure memtable Put, Get and Scan throughput of each memtable data structure **/
+    MemtableIndexBenchmark(outputDir);
+
+    /** Experiment #3: Measure Put throughput with each write-ahead log sync mode **/
+    WriteAheadLogSyncModeBenchmark(outputDir);
+
+    /** Experiment #4: Measure the throughput of searching a B-Tree node with each search kernel **/
+    NodeSearchBenchmark(outputDir);
+
+    /** Experiment #5: Measure the write throughput of SST files with and without O_DIRECT **/
+    SSTWriteThroughputBenchmark(outputDir);
+
+    /** Experiment #6: Measure Put, Get and Scan throughput of the LSM-Tree for each page size **/
+    PageSizeExperiment(outputDir);
+}
+
 int main(int argc, char *argv[]) {
     if (argc < 2) {
         RunExperimentsStepOne();
         RunExperimentsStepTwo();
         RunExperimentStepThree();
+        RunExperimentStepFour();
         return 0;
     }
 
@@ -197,6 +295,9 @@ int main(int argc, char *argv[]) {
         case 3:
             RunExperimentStepThree();
             break;
+        case 4:
+            RunExperimentStepFour();
+            break;
         default:
             std::cout << "Unknown step number!\n";
     }
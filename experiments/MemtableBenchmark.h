@@ -0,0 +1,186 @@
+#ifndef MEMTABLE_BENCHMARK_H
+#define MEMTABLE_BENCHMARK_H
+
+#include "RedBlackTree.h"
+#include "Memtable.h"
+#include "Arena.h"
+#include "Data.h"
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+
+/**
+ * Micro-benchmarks of the in-memory structures used by the memtable.
+ */
+class MemtableBenchmark {
+    std::string outputDir;
+    std::vector<uint64_t> keys;
+
+    void WriteDataToFile(const std::string &filename, const std::string &structure, uint64_t numKeys,
+                         double elapsedTime, double throughput, double teardownTime) const {
+        bool fileIsNew = !std::filesystem::exists(this->outputDir + filename);
+        std::ofstream outputFile(this->outputDir + filename, std::ofstream::out | std::ofstream::app);
+        if (fileIsNew) {
+            outputFile << "structure" << ","
+                       << "numKeys" << ","
+                       << "elapsedTime(sec)" << ","
+                       << "throughput(ops/sec)" << ","
+                       << "teardownTime(sec)"
+                       << std::endl;
+        }
+        outputFile << structure << ","
+                   << numKeys << ","
+                   << elapsedTime << ","
+                   << throughput << ","
+                   << teardownTime
+                   << std::endl;
+        outputFile.close();
+    }
+
+    void WriteOperationDataToFile(const std::string &filename, const std::string &structure, uint64_t numKeys,
+                                  const std::string &operation, double elapsedTime, double throughput) const {
+        bool fileIsNew = !std::filesystem::exists(this->outputDir + filename);
+        std::ofstream outputFile(this->outputDir + filename, std::ofstream::out | std::ofstream::app);
+        if (fileIsNew) {
+            outputFile << "structure" << ","
+                       << "numKeys" << ","
+                       << "operation" << ","
+                       << "elapsedTime(sec)" << ","
+                       << "throughput(ops/sec)"
+                       << std::endl;
+        }
+        outputFile << structure << ","
+                   << numKeys << ","
+                   << operation << ","
+                   << elapsedTime << ","
+                   << throughput
+                   << std::endl;
+        outputFile.close();
+    }
+
+public:
+    /**
+     * Constructor for a MemtableBenchmark object.
+     *
+     * @param outputDir the directory to write the CSV files to.
+     * @param maxNumKeys the largest number of keys a benchmark inserts.
+     */
+    MemtableBenchmark(const std::string &outputDir, uint64_t maxNumKeys) {
+        this->outputDir = Utils::EnsureDirSlash(outputDir);
+        this->keys = std::vector<uint64_t>(maxNumKeys);
+        Data::GetUniqueRandomData(maxNumKeys, this->keys);
+    }
+
+    /**
+     * Measures the Put throughput of the red-black tree when its nodes are allocated
+     * one by one on the heap versus when they are allocated from an arena, together
+     * with the time it takes to drop all the nodes once the memtable is flushed.
+     *
+     * @param numKeys the number of keys to insert in each round.
+     * @param numRounds the number of times the memtable is filled and reset.
+     */
+    void RunRedBlackTreeAllocationBenchmark(uint64_t numKeys, int numRounds) {
+        for (bool useArena: {false, true}) {
+            std::string structure = useArena ? "RedBlackTreeArena" : "RedBlackTreeHeap";
+            Arena *arena = useArena ? new Arena() : nullptr;
+            auto *tree = new RedBlackTree(arena);
+
+            std::chrono::duration<double> putTime{};
+            std::chrono::duration<double> teardownTime{};
+            for (int round = 0; round < numRounds; round++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                for (uint64_t i = 0; i < numKeys; i++) {
+                    tree->Insert(this->keys[i], i);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                putTime += end - start;
+
+                // This is what the memtable does when it is reset after a flush.
+                start = std::chrono::high_resolution_clock::now();
+                tree->Clear();
+                if (arena != nullptr) {
+                    arena->Reset();
+                }
+                end = std::chrono::high_resolution_clock::now();
+                teardownTime += end - start;
+            }
+
+            double throughput = (double) (numKeys * numRounds) / putTime.count();
+            std::cout << structure << " | Keys: " << numKeys << " | Put throughput (ops/sec): " << throughput
+                      << " | Teardown (sec): " << teardownTime.count() / numRounds << "\n";
+            this->WriteDataToFile("memtable_put_allocation.csv", structure, numKeys, putTime.count() / numRounds,
+                                  throughput, teardownTime.count() / numRounds);
+            delete tree;
+            delete arena;
+        }
+    }
+
+    /**
+     * Measures the throughput of Put, Get and Scan on a memtable backed by each of the
+     * available data structures.
+     *
+     * @param numKeys the number of keys to insert, and then to look up.
+     * @param numScans the number of range scans to run.
+     * @param scanLength the number of keys each range scan should return.
+     */
+    void RunMemtableIndexBenchmark(uint64_t numKeys, uint64_t numScans, uint64_t scanLength) {
+        std::pair<MemtableType, std::string> memtableTypes[] = {
+                {MemtableType::RED_BLACK_TREE, "RedBlackTree"},
+                {MemtableType::SKIP_LIST,      "SkipList"},
+                {MemtableType::B_PLUS_TREE,    "BPlusTree"}
+        };
+        // The keys are a permutation of [1, keys.size()], so a range this wide holds scanLength keys on average.
+        uint64_t scanRange = scanLength * this->keys.size() / numKeys;
+
+        for (auto &[memtableType, structure]: memtableTypes) {
+            auto *memtable = new Memtable((int) numKeys, memtableType);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint64_t i = 0; i < numKeys; i++) {
+                memtable->Put(this->keys[i], i);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> putTime = end - start;
+
+            // Look the keys up in a different order than they were inserted in.
+            uint64_t checksum = 0;
+            start = std::chrono::high_resolution_clock::now();
+            for (uint64_t i = 0; i < numKeys; i++) {
+                checksum += memtable->Get(this->keys[(i * 7919) % numKeys]);
+            }
+            end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> getTime = end - start;
+
+            uint64_t numScannedKeys = 0;
+            start = std::chrono::high_resolution_clock::now();
+            for (uint64_t i = 0; i < numScans; i++) {
+                uint64_t key1 = this->keys[(i * 7919) % numKeys];
+                numScannedKeys += memtable->Scan(key1, key1 + scanRange).size();
+            }
+            end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> scanTime = end - start;
+
+            std::pair<std::string, std::pair<double, uint64_t>> results[] = {
+                    {"Put",  {putTime.count(),  numKeys}},
+                    {"Get",  {getTime.count(),  numKeys}},
+                    {"Scan", {scanTime.count(), numScans}}
+            };
+            for (auto &[operation, result]: results) {
+                double throughput = (double) result.second / result.first;
+                std::cout << structure << " | Keys: " << numKeys << " | " << operation
+                          << " throughput (ops/sec): " << throughput << "\n";
+                this->WriteOperationDataToFile("memtable_index_operations.csv", structure, numKeys, operation,
+                                               result.first, throughput);
+            }
+            // Keep the lookups from being optimized away.
+            if (checksum == 0 && numScannedKeys == 0) {
+                std::cout << "No keys found\n";
+            }
+            delete memtable;
+        }
+    }
+};
+
+#endif // MEMTABLE_BENCHMARK_H
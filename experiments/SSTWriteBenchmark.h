@@ -0,0 +1,132 @@
+#ifndef SST_WRITE_BENCHMARK_H
+#define SST_WRITE_BENCHMARK_H
+
+#include "SSTWriter.h"
+#include "AlignedFileWriter.h"
+#include "Experiment.h"
+#include "Utils.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+
+/**
+ * Benchmarks of the write throughput of SST files: a file stream against the aligned file
+ * writer, with and without O_DIRECT.
+ */
+class SSTWriteBenchmark {
+    std::string outputDir;
+
+    void WriteDataToFile(const std::string &filename, const std::string &writer, uint64_t numEntries,
+                         uint64_t fileByteSize, double elapsedTime, double throughput) const {
+        bool fileIsNew = !std::filesystem::exists(this->outputDir + filename);
+        std::ofstream outputFile(this->outputDir + filename, std::ofstream::out | std::ofstream::app);
+        if (fileIsNew) {
+            outputFile << "writer" << ","
+                       << "numEntries" << ","
+                       << "fileByteSize" << ","
+                       << "elapsedTime(sec)" << ","
+                       << "throughput(MB/sec)"
+                       << std::endl;
+        }
+        outputFile << writer << ","
+                   << numEntries << ","
+                   << fileByteSize << ","
+                   << elapsedTime << ","
+                   << throughput
+                   << std::endl;
+        outputFile.close();
+    }
+
+    void Report(const std::string &filename, const std::string &writer, uint64_t numEntries,
+                const std::string &filePath, std::chrono::duration<double> elapsedTime) const {
+        uint64_t fileByteSize = std::filesystem::file_size(filePath);
+        double throughput = (double) fileByteSize / (1 << 20) / elapsedTime.count();
+        std::cout << writer << " | Entries: " << numEntries << " | Write throughput (MB/sec): " << throughput << "\n";
+        this->WriteDataToFile(filename, writer, numEntries, fileByteSize, elapsedTime.count(), throughput);
+    }
+
+public:
+    /**
+     * Constructor for a SSTWriteBenchmark object.
+     *
+     * @param outputDir the directory to write the CSV files to.
+     */
+    explicit SSTWriteBenchmark(const std::string &outputDir) {
+        this->outputDir = Utils::EnsureDirSlash(outputDir);
+    }
+
+    /**
+     * Measures the throughput of writing the key-value pairs of a file 8 bytes at a time, as the
+     * leaves used to be padded, through a file stream and through the aligned file writer.
+     *
+     * @param numEntries the number of key-value pairs to write.
+     */
+    void RunSmallWritesBenchmark(uint64_t numEntries) {
+        std::filesystem::create_directories(EXPERIMENT_DB_PATH);
+        const std::string filePath = EXPERIMENT_DB_PATH + "/small_writes.sst";
+
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            std::ofstream file(filePath, std::ios::out | std::ios::binary);
+            for (uint64_t i = 1; i <= numEntries; i++) {
+                file.write(reinterpret_cast<const char *>(&i), sizeof(uint64_t));
+                file.write(reinterpret_cast<const char *>(&i), sizeof(uint64_t));
+            }
+        }
+        std::chrono::duration<double> elapsedTime = std::chrono::high_resolution_clock::now() - start;
+        this->Report("sst_small_writes.csv", "FileStream", numEntries, filePath, elapsedTime);
+
+        for (bool useDirectIO: {false, true}) {
+            start = std::chrono::high_resolution_clock::now();
+            {
+                AlignedFileWriter file(filePath, useDirectIO, numEntries * 2 * sizeof(uint64_t));
+                for (uint64_t i = 1; i <= numEntries; i++) {
+                    file.Write(&i, sizeof(uint64_t));
+                    file.Write(&i, sizeof(uint64_t));
+                }
+            }
+            elapsedTime = std::chrono::high_resolution_clock::now() - start;
+            this->Report("sst_small_writes.csv", useDirectIO ? "AlignedDirect" : "Aligned", numEntries, filePath,
+                         elapsedTime);
+        }
+        std::filesystem::remove(filePath);
+    }
+
+    /**
+     * Measures the throughput of building a B-Tree SST file with the SSTWriter, through the page
+     * cache and with O_DIRECT.
+     *
+     * @param numEntries the number of key-value pairs of the file.
+     */
+    void RunSSTWriterBenchmark(uint64_t numEntries) {
+        std::filesystem::create_directories(EXPERIMENT_DB_PATH);
+        const std::string filePath = EXPERIMENT_DB_PATH + "/sst_writer.sst";
+
+        for (bool useDirectWrites: {false, true}) {
+            auto start = std::chrono::high_resolution_clock::now();
+            SST *sstFile;
+            {
+                SSTWriter writer(filePath, numEntries, 10, SST::DEFAULT_WRITE_BUFFER_NUM_PAGES,
+                                 LeafFormat::RAW_LEAVES, useDirectWrites);
+                for (uint64_t key = 1; key <= numEntries; key++) {
+                    writer.Add(key, key);
+                }
+                sstFile = writer.Finish();
+            }
+            std::chrono::duration<double> elapsedTime = std::chrono::high_resolution_clock::now() - start;
+            if (sstFile == nullptr) {
+                std::cout << "Could not write " << filePath << "\n";
+                continue;
+            }
+            this->Report("sst_writer.csv", useDirectWrites ? "SSTWriterDirect" : "SSTWriter", numEntries, filePath,
+                         elapsedTime);
+            delete sstFile;
+        }
+        std::filesystem::remove(filePath);
+    }
+};
+
+#endif // SST_WRITE_BENCHMARK_H
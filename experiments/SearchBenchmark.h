@@ -0,0 +1,114 @@
+#ifndef SEARCH_BENCHMARK_H
+#define SEARCH_BENCHMARK_H
+
+#include "SearchKernels.h"
+#include "Utils.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+/**
+ * Micro-benchmarks of the searches within a B-Tree node: Utils::BinarySearch against each of
+ * the search kernels the CPU supports.
+ */
+class SearchBenchmark {
+    std::string outputDir;
+
+    void WriteDataToFile(const std::string &filename, const std::string &search, uint64_t numKeys,
+                         double elapsedTime, double throughput) const {
+        bool fileIsNew = !std::filesystem::exists(this->outputDir + filename);
+        std::ofstream outputFile(this->outputDir + filename, std::ofstream::out | std::ofstream::app);
+        if (fileIsNew) {
+            outputFile << "search" << ","
+                       << "numKeys" << ","
+                       << "elapsedTime(sec)" << ","
+                       << "throughput(ops/sec)"
+                       << std::endl;
+        }
+        outputFile << search << ","
+                   << numKeys << ","
+                   << elapsedTime << ","
+                   << throughput
+                   << std::endl;
+        outputFile.close();
+    }
+
+    template<typename Search>
+    void Measure(const std::string &search, uint64_t numKeys, const std::vector<uint64_t> &lookups,
+                 Search searchFn) {
+        uint64_t checksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint64_t key: lookups) {
+            checksum += searchFn(key);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsedTime = end - start;
+
+        double throughput = (double) lookups.size() / elapsedTime.count();
+        std::cout << search << " | Keys: " << numKeys << " | Search throughput (ops/sec): " << throughput << "\n";
+        this->WriteDataToFile("node_search.csv", search, numKeys, elapsedTime.count(), throughput);
+        // Keep the searches from being optimized away.
+        if (checksum == 0) {
+            std::cout << "No keys found\n";
+        }
+    }
+
+public:
+    /**
+     * Constructor for a SearchBenchmark object.
+     *
+     * @param outputDir the directory to write the CSV files to.
+     */
+    explicit SearchBenchmark(const std::string &outputDir) {
+        this->outputDir = Utils::EnsureDirSlash(outputDir);
+    }
+
+    /**
+     * Measures the throughput of searching sorted keys, the way the fence keys of an internal
+     * node or the keys of a columnar leaf are searched, for keys that are both in and between them.
+     *
+     * @param numKeys the number of keys in the node, such as 512 for an internal page.
+     * @param numLookups the number of searches to run.
+     */
+    void RunNodeSearchBenchmark(uint64_t numKeys, uint64_t numLookups) {
+        std::vector<uint64_t> keys;
+        for (uint64_t i = 0; i < numKeys; i++) {
+            keys.push_back(i * 2 + 1);
+        }
+        // Random keys, so that the branches of the binary searches cannot be predicted from a pattern.
+        std::mt19937_64 generator(443);
+        std::uniform_int_distribution<uint64_t> distribution(0, numKeys * 2);
+        std::vector<uint64_t> lookups;
+        for (uint64_t i = 0; i < numLookups; i++) {
+            lookups.push_back(distribution(generator));
+        }
+
+        this->Measure("BinarySearch", numKeys, lookups, [&keys](uint64_t key) {
+            return (uint64_t) Utils::BinarySearch(keys, key);
+        });
+        this->Measure("StdLowerBound", numKeys, lookups, [&keys](uint64_t key) {
+            return (uint64_t) (std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+        });
+        std::pair<SearchKernel, std::string> kernels[] = {
+                {SCALAR_KERNEL, "ScalarKernel"},
+                {SSE42_KERNEL,  "SSE42Kernel"},
+                {AVX2_KERNEL,   "AVX2Kernel"}
+        };
+        for (auto &[kernel, search]: kernels) {
+            if (!SearchKernels::IsKernelSupported(kernel)) {
+                continue;
+            }
+            SearchKernel searchKernel = kernel;
+            this->Measure(search, numKeys, lookups, [&keys, searchKernel](uint64_t key) {
+                return (uint64_t) SearchKernels::LowerBound(keys.data(), keys.size(), key, searchKernel);
+            });
+        }
+    }
+};
+
+#endif // SEARCH_BENCHMARK_H
@@ -0,0 +1,108 @@
+#ifndef WRITE_AHEAD_LOG_BENCHMARK_H
+#define WRITE_AHEAD_LOG_BENCHMARK_H
+
+#include "Db.h"
+#include "Data.h"
+#include "Experiment.h"
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+
+/**
+ * Benchmarks of the Put throughput of the Db with each write-ahead log sync mode.
+ */
+class WriteAheadLogBenchmark {
+    std::string outputDir;
+
+    void WriteDataToFile(const std::string &filename, const std::string &syncMode, int numThreads, uint64_t numKeys,
+                         double elapsedTime, double throughput) const {
+        bool fileIsNew = !std::filesystem::exists(this->outputDir + filename);
+        std::ofstream outputFile(this->outputDir + filename, std::ofstream::out | std::ofstream::app);
+        if (fileIsNew) {
+            outputFile << "syncMode" << ","
+                       << "numThreads" << ","
+                       << "numKeys" << ","
+                       << "elapsedTime(sec)" << ","
+                       << "throughput(ops/sec)"
+                       << std::endl;
+        }
+        outputFile << syncMode << ","
+                   << numThreads << ","
+                   << numKeys << ","
+                   << elapsedTime << ","
+                   << throughput
+                   << std::endl;
+        outputFile.close();
+    }
+
+public:
+    /**
+     * Constructor for a WriteAheadLogBenchmark object.
+     *
+     * @param outputDir the directory to write the CSV files to.
+     */
+    explicit WriteAheadLogBenchmark(const std::string &outputDir) {
+        this->outputDir = Utils::EnsureDirSlash(outputDir);
+    }
+
+    /**
+     * Measures the Put throughput of a Db without a write-ahead log, and with a write-ahead log
+     * in each sync mode. The writers share a skip list memtable, big enough to hold all the keys
+     * so that only the cost of logging is measured.
+     *
+     * @param numKeysPerThread the number of keys each writer inserts.
+     * @param numThreads the number of concurrent writers.
+     */
+    void RunPutBenchmark(uint64_t numKeysPerThread, int numThreads) {
+        std::pair<int, std::string> syncModes[] = {
+                {-1,                          "Disabled"},
+                {WalSyncMode::SYNC_PER_WRITE, "SyncPerWrite"},
+                {WalSyncMode::SYNC_INTERVAL,  "SyncInterval"},
+                {WalSyncMode::SYNC_NONE,      "SyncNone"}
+        };
+        uint64_t numKeys = numKeysPerThread * numThreads;
+
+        for (auto &[syncMode, syncModeName]: syncModes) {
+            Experiment::ResetDbDirectory();
+            DbOptions options;
+            options.memtableType = MemtableType::SKIP_LIST;
+            options.enableWriteAheadLog = syncMode >= 0;
+            if (options.enableWriteAheadLog) {
+                options.walSyncMode = (WalSyncMode) syncMode;
+            }
+            auto *db = new Db((int) numKeys, SearchType::BINARY_SEARCH, new BufferPool(1, 1, LRU_t), nullptr,
+                              options);
+            db->Open(EXPERIMENT_DB_PATH);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (int t = 0; t < numThreads; t++) {
+                threads.emplace_back([db, t, numThreads, numKeysPerThread] {
+                    for (uint64_t i = 0; i < numKeysPerThread; i++) {
+                        uint64_t key = i * numThreads + t + 1;
+                        db->Put(key, key);
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> putTime = end - start;
+
+            double throughput = (double) numKeys / putTime.count();
+            std::cout << syncModeName << " | Threads: " << numThreads << " | Put throughput (ops/sec): "
+                      << throughput << "\n";
+            this->WriteDataToFile("wal_put_sync_modes.csv", syncModeName, numThreads, numKeys, putTime.count(),
+                                  throughput);
+            delete db;
+        }
+        Experiment::ResetDbDirectory();
+    }
+};
+
+#endif // WRITE_AHEAD_LOG_BENCHMARK_H
@@ -0,0 +1,66 @@
+#ifndef CSC443_PROJECT_ALIGNEDBUFFER_H
+#define CSC443_PROJECT_ALIGNEDBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * Class representing a buffer aligned to AlignedBuffer::ALIGNMENT, which files opened with O_DIRECT
+ * can be read into. Reads into such files must also start and end at multiples of ALIGNMENT.
+ */
+class AlignedBuffer {
+private:
+    uint64_t *words;
+    size_t numBytes;
+
+public:
+    static const size_t ALIGNMENT = 4096;
+
+    /**
+     * Constructor for an empty AlignedBuffer object.
+     */
+    AlignedBuffer() : words(nullptr), numBytes(0) {}
+
+    /**
+     * Constructor for an AlignedBuffer object.
+     *
+     * @param numBytes the size of the buffer in bytes, rounded up to a multiple of ALIGNMENT.
+     */
+    explicit AlignedBuffer(size_t numBytes) : AlignedBuffer() {
+        this->Reserve(numBytes);
+    }
+
+    ~AlignedBuffer() {
+        std::free(this->words);
+    }
+
+    AlignedBuffer(const AlignedBuffer &) = delete;
+
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+    /**
+     * Make the buffer hold at least given number of bytes. The content is dropped if the buffer grows.
+     *
+     * @param numBytes the size of the buffer in bytes, rounded up to a multiple of ALIGNMENT.
+     */
+    void Reserve(size_t numBytes) {
+        numBytes = (numBytes + AlignedBuffer::ALIGNMENT - 1) & ~(AlignedBuffer::ALIGNMENT - 1);
+        if (numBytes <= this->numBytes) {
+            return;
+        }
+        std::free(this->words);
+        this->words = static_cast<uint64_t *>(std::aligned_alloc(AlignedBuffer::ALIGNMENT, numBytes));
+        this->numBytes = numBytes;
+    }
+
+    [[nodiscard]] uint64_t *Data() const {
+        return this->words;
+    }
+
+    [[nodiscard]] size_t GetByteSize() const {
+        return this->numBytes;
+    }
+};
+
+#endif // CSC443_PROJECT_ALIGNEDBUFFER_H
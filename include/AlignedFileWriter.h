@@ -0,0 +1,124 @@
+#ifndef CSC443_PROJECT_ALIGNEDFILEWRITER_H
+#define CSC443_PROJECT_ALIGNEDFILEWRITER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Class writing a new file through a buffer of whole pages, aligned in memory and in the file,
+ * which is written out with one pwrite per run of pages. SST files are written from start to
+ * end, but the writes may still jump around the file: the buffer covers a window of the file,
+ * and is only written out when a write falls outside of it or when it is full.
+ *
+ * As only whole pages are written out, the file can be written with O_DIRECT, bypassing the OS
+ * page cache. A page that is only partly written is first filled from the file, or with zeros
+ * past what was written so far. The file is cut back to the end of the last write once closed.
+ */
+class AlignedFileWriter {
+private:
+    std::string fileName;
+    int fd;
+    bool isDirectIO;
+    bool hasFailed;
+    // The buffered window of the file, and which of its pages hold their content.
+    uint8_t *buffer;
+    size_t bufferNumPages;
+    uint64_t windowByteOffset;
+    std::vector<bool> isPageLoaded;
+    size_t numPagesLoaded;
+    uint64_t position;
+    // The end of the last write, which is the size of the file once it is closed.
+    uint64_t fileByteSize;
+    // The end of the pages written out so far. The file only holds zeros after it.
+    uint64_t writtenByteSize;
+    uint64_t numBytesWritten;
+    uint64_t numWriteCalls;
+
+    /**
+     * Fill given page of the window with its content in the file.
+     */
+    void LoadPage(size_t pageIndex);
+
+    /**
+     * Write out each run of loaded pages of the window with one pwrite, and empty the window.
+     */
+    void Flush();
+
+public:
+    // The alignment of the buffer and of the writes, which is the largest logical block size
+    // O_DIRECT can require.
+    static const size_t ALIGNMENT = 4096;
+    static const size_t DEFAULT_BUFFER_NUM_PAGES = 256;
+
+    /**
+     * Constructor for an AlignedFileWriter object. Creates the file, or empties it if it exists.
+     *
+     * @param fileName the path of the file.
+     * @param useDirectIO whether to write the file with O_DIRECT. Ignored if the file system does not support it.
+     * @param preallocateByteSize the number of bytes to allocate on disk up front, if known,
+     * so that the file is laid out in as few extents as possible.
+     * @param bufferNumPages the number of pages of the buffer.
+     */
+    explicit AlignedFileWriter(const std::string &fileName, bool useDirectIO = false, uint64_t preallocateByteSize = 0,
+                               size_t bufferNumPages = AlignedFileWriter::DEFAULT_BUFFER_NUM_PAGES);
+
+    /**
+     * Closes the file if it is still open.
+     */
+    ~AlignedFileWriter();
+
+    AlignedFileWriter(const AlignedFileWriter &) = delete;
+
+    AlignedFileWriter &operator=(const AlignedFileWriter &) = delete;
+
+    /**
+     * Whether the file is open and none of the writes failed so far.
+     */
+    [[nodiscard]] bool IsGood() const;
+
+    /**
+     * Whether the file is written with O_DIRECT.
+     */
+    [[nodiscard]] bool IsDirectIO() const;
+
+    /**
+     * Move where the next write goes.
+     *
+     * @param byteOffset the offset in the file, in bytes.
+     */
+    void Seek(uint64_t byteOffset);
+
+    /**
+     * Get where the next write goes, in bytes.
+     */
+    [[nodiscard]] uint64_t GetPosition() const;
+
+    /**
+     * Write given bytes at the current position, and move past them.
+     *
+     * @param data the bytes.
+     * @param numBytes the number of bytes.
+     */
+    void Write(const void *data, uint64_t numBytes);
+
+    /**
+     * Write the buffered pages out, cut the file back to the end of the last write and close it.
+     *
+     * @return true if all the writes succeeded, false otherwise.
+     */
+    bool Close();
+
+    /**
+     * Get the number of bytes written out to the file, whole pages included.
+     */
+    [[nodiscard]] uint64_t GetNumBytesWritten() const;
+
+    /**
+     * Get the number of pwrite calls made.
+     */
+    [[nodiscard]] uint64_t GetNumWriteCalls() const;
+};
+
+#endif // CSC443_PROJECT_ALIGNEDFILEWRITER_H
@@ -0,0 +1,102 @@
+#ifndef CSC443_PROJECT_ARENA_H
+#define CSC443_PROJECT_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <atomic>
+
+/**
+ * Class representing a bump-pointer arena allocator.
+ *
+ * Memory is carved out of large blocks and is never freed individually. Resetting
+ * the arena rewinds it to its first block in O(1) so the blocks can be reused by the
+ * next round of allocations, and all blocks are freed when the arena is destroyed.
+ *
+ * Allocate is not thread-safe. Structures written by multiple threads at once should
+ * use AllocateConcurrently instead.
+ */
+class Arena {
+private:
+    std::vector<char *> blocks;
+    // Index of the block currently being allocated from.
+    size_t currentBlock;
+    char *allocPtr;
+    size_t allocBytesRemaining;
+    // Blocks larger than BLOCK_SIZE that were handed out as a whole.
+    std::vector<char *> largeBlocks;
+    // Atomic so that the memory held by a memtable can be read while it is written to.
+    std::atomic<size_t> memoryUsage;
+    // Guards the arena when it is shared by concurrent writers.
+    std::atomic_flag spinLock = ATOMIC_FLAG_INIT;
+
+    char *AllocateFallback(size_t bytes);
+
+public:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+    static const size_t ALIGNMENT = alignof(std::max_align_t);
+
+    Arena();
+
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * Allocate given number of bytes from the arena. The returned memory is aligned
+     * to Arena::ALIGNMENT and stays valid until the arena is reset or destroyed.
+     *
+     * @param bytes the number of bytes to allocate.
+     * @return a pointer to the allocated memory.
+     */
+    char *Allocate(size_t bytes) {
+        bytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        if (bytes <= this->allocBytesRemaining) {
+            char *result = this->allocPtr;
+            this->allocPtr += bytes;
+            this->allocBytesRemaining -= bytes;
+            return result;
+        }
+        return this->AllocateFallback(bytes);
+    }
+
+    /**
+     * Allocate given number of bytes from the arena, aligned to given alignment. Useful to
+     * place a structure at the start of a cache line.
+     *
+     * @param bytes the number of bytes to allocate.
+     * @param alignment the alignment of the returned memory, a power of two.
+     * @return a pointer to the allocated memory.
+     */
+    char *AllocateAligned(size_t bytes, size_t alignment);
+
+    /**
+     * Thread-safe version of Allocate. The arena is only held for the few instructions
+     * it takes to bump the pointer, so a spin lock is cheaper than a mutex here.
+     *
+     * @param bytes the number of bytes to allocate.
+     * @return a pointer to the allocated memory.
+     */
+    char *AllocateConcurrently(size_t bytes) {
+        while (this->spinLock.test_and_set(std::memory_order_acquire)) {
+        }
+        char *result = this->Allocate(bytes);
+        this->spinLock.clear(std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * Release every allocation made so far. The regular blocks are kept around and
+     * reused by future allocations, so this does not return memory to the system.
+     */
+    void Reset();
+
+    /**
+     * Get the number of bytes of memory held by the arena.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const;
+};
+
+#endif // CSC443_PROJECT_ARENA_H
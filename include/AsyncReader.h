@@ -0,0 +1,209 @@
+#ifndef CSC443_PROJECT_ASYNCREADER_H
+#define CSC443_PROJECT_ASYNCREADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "AlignedBuffer.h"
+
+/**
+ * How an AsyncReader reads the files.
+ */
+enum AsyncReadBackend {
+    // The reads are queued to an io_uring instance, and completed by the kernel.
+    IO_URING_BACKEND = 0,
+    // The reads are made with pread by a pool of threads, where io_uring is not available.
+    THREAD_POOL_BACKEND = 1
+};
+
+/**
+ * A read of part of a file, submitted to an AsyncReader. It must stay where it is, along with
+ * its buffer, until the AsyncReader is done with it.
+ */
+struct AsyncReadRequest {
+    int fd = -1;
+    uint64_t byteOffset = 0;
+    uint64_t numBytes = 0;
+    void *buffer = nullptr;
+    // Set once the read is done: the number of bytes read, -1 if the read failed.
+    ssize_t bytesRead = -1;
+    bool isDone = false;
+    // The buffer of the read as io_uring takes it.
+    struct iovec iov{};
+};
+
+/**
+ * Class reading parts of files asynchronously, so that one thread can have many reads in flight
+ * at a time, as NVMe drives need to reach their throughput.
+ *
+ * Reads are queued by Submit, and only sent to the kernel when the queue is full or when one
+ * of them is waited for, so that the reads submitted together are sent with one system call.
+ * With io_uring unavailable, such as on older kernels or when it is blocked, the reads are
+ * made by a pool of threads instead. The reader also falls back to the thread pool if io_uring
+ * fails later on.
+ *
+ * Not thread-safe: a Db only uses its AsyncReader while holding its storage lock.
+ */
+class AsyncReader {
+private:
+    AsyncReadBackend backend;
+    unsigned queueDepth;
+    unsigned numInFlight;
+
+    // The io_uring instance and its rings, mapped from the kernel.
+    int ringFd;
+    void *submissionRing;
+    size_t submissionRingByteSize;
+    void *completionRing;
+    size_t completionRingByteSize;
+    struct io_uring_sqe *submissionEntries;
+    size_t submissionEntriesByteSize;
+    unsigned *submissionHead;
+    unsigned *submissionTail;
+    unsigned *submissionMask;
+    unsigned *submissionArray;
+    unsigned *completionHead;
+    unsigned *completionTail;
+    unsigned *completionMask;
+    struct io_uring_cqe *completionEntries;
+    unsigned numToSubmit;
+    // The reads in the rings, whether or not the kernel took them yet.
+    std::vector<AsyncReadRequest *> ringRequests;
+
+    // The thread pool, which takes the reads off of the queue.
+    std::vector<std::thread> threads;
+    std::deque<AsyncReadRequest *> requestQueue;
+    std::mutex queueMutex;
+    std::condition_variable requestCondition;
+    std::condition_variable doneCondition;
+    bool stopThreads;
+
+    bool SetupIoUring();
+
+    void CloseIoUring();
+
+    /**
+     * Send the queued reads to the kernel, and wait for at least minToComplete of the reads in
+     * flight to complete.
+     *
+     * @return false if io_uring failed, in which case the reader fell back to the thread pool.
+     */
+    bool EnterIoUring(unsigned minToComplete);
+
+    /**
+     * Switch to the thread pool once io_uring failed. The reads the kernel did not take yet are
+     * made by the thread pool, and the ones it took are done with -1 bytes read, since they may
+     * never complete.
+     */
+    void FallBackToThreadPool();
+
+    /**
+     * Mark the requests of the completed reads as done.
+     */
+    void ReapCompletions();
+
+    void RunThread();
+
+public:
+    static const unsigned DEFAULT_QUEUE_DEPTH = 32;
+    static const int NUM_THREADS = 4;
+
+    /**
+     * Constructor for an AsyncReader object.
+     *
+     * @param queueDepth the largest number of reads in flight at a time.
+     * @param backend the backend to read with, the thread pool being used if io_uring is not available.
+     */
+    explicit AsyncReader(unsigned queueDepth = AsyncReader::DEFAULT_QUEUE_DEPTH,
+                         AsyncReadBackend backend = AsyncReadBackend::IO_URING_BACKEND);
+
+    /**
+     * Waits for the reads in flight, which write into their buffers until they are done.
+     */
+    ~AsyncReader();
+
+    /**
+     * Get the backend the reads are made with.
+     */
+    [[nodiscard]] AsyncReadBackend GetBackend() const;
+
+    /**
+     * Submit a read, which is done in the background. If there are as many reads in flight as
+     * the queue depth, this first waits for one of them to complete.
+     *
+     * @param request the read, whose fd, byteOffset, numBytes and buffer are set.
+     */
+    void Submit(AsyncReadRequest *request);
+
+    /**
+     * Wait for a submitted read to be done.
+     *
+     * @param request the read.
+     * @return the number of bytes read, -1 if the read failed.
+     */
+    ssize_t Wait(AsyncReadRequest *request);
+
+    /**
+     * Wait for all the submitted reads to be done.
+     */
+    void WaitAll();
+};
+
+/**
+ * Class reading the next pages of a file ahead with an AsyncReader, while the pages before them
+ * are processed, such as the leaves of a SST file during a compaction or a scan.
+ *
+ * The file descriptor is duplicated for the read ahead, as the readers open and close the
+ * file on each call.
+ */
+class PagePrefetcher {
+private:
+    AsyncReader *asyncReader;
+    AsyncReadRequest request;
+    // Aligned, as the files are opened with O_DIRECT, and reused from one read ahead to the next.
+    AlignedBuffer buffer;
+    bool isPending;
+
+public:
+    /**
+     * Constructor for a PagePrefetcher object.
+     *
+     * @param asyncReader the reader to read the pages ahead with, not owned by the prefetcher.
+     */
+    explicit PagePrefetcher(AsyncReader *asyncReader);
+
+    ~PagePrefetcher();
+
+    /**
+     * Start reading given part of a file ahead, dropping the part read ahead before if any.
+     *
+     * @param fd the file descriptor of the file.
+     * @param byteOffset the offset of the part in the file, in bytes, a multiple of AlignedBuffer::ALIGNMENT.
+     * @param numBytes the number of bytes to read, a multiple of AlignedBuffer::ALIGNMENT.
+     */
+    void Prefetch(int fd, uint64_t byteOffset, uint64_t numBytes);
+
+    /**
+     * Take the part of the file read ahead, if it is the given one, waiting for its read to
+     * be done.
+     *
+     * @param byteOffset the offset of the part in the file, in bytes.
+     * @param numBytes the number of bytes of the part.
+     * @param words set to the words of the part, where they were read. They stay valid until the
+     * next call to Prefetch.
+     * @return the number of bytes read, -1 if the part was not read ahead or could not be read.
+     */
+    ssize_t Take(uint64_t byteOffset, uint64_t numBytes, const uint64_t *&words);
+
+    /**
+     * Drop the part of the file read ahead, if any.
+     */
+    void Cancel();
+};
+
+#endif // CSC443_PROJECT_ASYNCREADER_H
@@ -0,0 +1,136 @@
+#ifndef CSC443_PROJECT_BPLUSTREE_H
+#define CSC443_PROJECT_BPLUSTREE_H
+
+#include <cstdint>
+#include <vector>
+#include "Arena.h"
+#include "MemtableIndex.h"
+#include "Utils.h"
+
+/**
+ * Class representing an in-memory B+-tree data structure.
+ *
+ * Every node is NODE_SIZE bytes and aligned to a cache line, and keeps its keys in a
+ * contiguous array, so a lookup touches a handful of cache lines per level instead of
+ * one node per key comparison like a binary tree does. Key-value pairs live in the leaves,
+ * which are linked together for scans. Nodes are never merged or freed individually,
+ * they are released all together through the arena.
+ *
+ * Not thread-safe for writers.
+ */
+class BPlusTree : public MemtableIndex {
+public:
+    static const size_t NODE_SIZE = 256;
+    static const size_t CACHE_LINE_SIZE = 64;
+    // Number of key-value pairs in a leaf: the header and the next pointer take 16 bytes.
+    static const int LEAF_CAPACITY = (NODE_SIZE - 16) / 16;
+    // Number of keys in an inner node, which has one more child pointer than keys.
+    static const int INNER_CAPACITY = (NODE_SIZE - 16) / 16;
+
+private:
+    struct BPlusTreeNode {
+        uint16_t numKeys;
+        bool isLeaf;
+    };
+
+    struct LeafNode : BPlusTreeNode {
+        LeafNode *next;
+        uint64_t keys[LEAF_CAPACITY];
+        uint64_t values[LEAF_CAPACITY];
+    };
+
+    struct InnerNode : BPlusTreeNode {
+        // children[i] holds the keys in [keys[i - 1], keys[i]).
+        uint64_t keys[INNER_CAPACITY];
+        BPlusTreeNode *children[INNER_CAPACITY + 1];
+    };
+
+    // The tree is at most this deep, since every node but the root is at least half full.
+    static const int MAX_DEPTH = 24;
+
+    Arena *arena;
+    BPlusTreeNode *root;
+    // The leaf the previous sorted insertion went into, and the separator key above which
+    // keys go into the following leaves.
+    LeafNode *lastLeaf;
+    uint64_t lastLeafUpperBound;
+    int currentSize;
+
+    LeafNode *NewLeaf();
+
+    InnerNode *NewInner();
+
+    /**
+     * Get the number of keys of the node that are smaller than, or at most equal to if
+     * <inclusive>, the given key.
+     */
+    static int CountKeysBefore(const uint64_t *keys, int numKeys, uint64_t key, bool inclusive);
+
+    /**
+     * Find the leaf that holds the given key, or would hold it if it was inserted.
+     *
+     * @param key
+     * @param upperBound if given, set to the smallest key that belongs to a following leaf,
+     * or UINT64_MAX if it is the last leaf.
+     */
+    LeafNode *FindLeaf(uint64_t key, uint64_t *upperBound = nullptr);
+
+    /**
+     * Insert the key at position <pos> of a leaf that has room for it.
+     */
+    static void InsertIntoLeaf(LeafNode *leaf, int pos, uint64_t key, uint64_t value);
+
+    /**
+     * Split a full leaf and insert the key into the half it belongs to, then insert the
+     * new leaf into the parents on the given path, splitting them as well if needed.
+     */
+    void SplitLeafAndInsert(LeafNode *leaf, int pos, uint64_t key, uint64_t value, InnerNode **path,
+                            int *pathIndexes, int depth);
+
+public:
+    /**
+     * Iterator over the key-value pairs of the tree in ascending key order, following the
+     * links between the leaves. The tree must not be modified while it is iterated.
+     */
+    class Iterator : public EntryIterator {
+    private:
+        LeafNode *leaf;
+        int index;
+
+    public:
+        explicit Iterator(BPlusTree *tree);
+
+        [[nodiscard]] bool Valid() const override;
+
+        [[nodiscard]] DataEntry_t GetEntry() const override;
+
+        void Next() override;
+    };
+
+    /**
+     * Constructor for a BPlusTree object.
+     *
+     * @param arena the arena to allocate the nodes from. The tree does not own the arena.
+     */
+    explicit BPlusTree(Arena *arena);
+
+    bool Insert(uint64_t key, uint64_t value) override;
+
+    /**
+     * Consecutive keys usually go into the same leaf, so each key is inserted straight into
+     * the leaf of the previous one when it falls within it and the leaf has room.
+     */
+    void InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) override;
+
+    uint64_t Search(uint64_t key) override;
+
+    void Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) override;
+
+    EntryIterator *NewIterator() override;
+
+    [[nodiscard]] int GetCurrentSize() const override;
+
+    void Clear() override;
+};
+
+#endif // CSC443_PROJECT_BPLUSTREE_H
@@ -22,7 +22,7 @@ public:
      * @param bitsPerEntry the number of bits in filter array used by each entry.
      * @param numKeys the max number of keys in the bloom filter.
      */
-    explicit BloomFilter(int bitsPerEntry, int numKeys);
+    explicit BloomFilter(int bitsPerEntry, uint64_t numKeys);
 
     static int GetIndexInFilterArray(uint64_t index);
 
@@ -49,7 +49,16 @@ public:
      * @param filterArray the bloom filter array to search through.
      * @return false if the key doesn't exist, true if it probably exist.
      */
-    [[nodiscard]] bool KeyProbablyExists(uint64_t key, std::vector<uint64_t> filterArray) const;
+    [[nodiscard]] bool KeyProbablyExists(uint64_t key, const std::vector<uint64_t> &filterArray) const;
+
+    /**
+     * Check if key exists in the bloom filter array where it is, such as in a mapped SST file.
+     *
+     * @param key the key to search for.
+     * @param filterArray the bloom filter array to search through.
+     * @return false if the key doesn't exist, true if it probably exist.
+     */
+    [[nodiscard]] bool KeyProbablyExists(uint64_t key, const uint64_t *filterArray) const;
 
     static uint64_t GetShiftedLocationInBitArray(uint64_t index);
 
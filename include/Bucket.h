@@ -3,7 +3,7 @@
 #define CSC443_PROJECT_BUCKET_H
 
 #include <cstdint>
-#include <forward_list>
+#include <vector>
 #include "Page.h"
 
 /**
@@ -11,7 +11,8 @@
  */
 class Bucket {
 private:
-    std::forward_list<Page *> pages;
+    // The first page of the chain, which is linked through the pages so that inserting does not allocate.
+    Page *head;
     // Number of bits used by the bucket so far, out of the total globalDepth bits of the hashtable.
     int localDepth;
     // Number of pages mapped to this bucket.
@@ -61,7 +62,7 @@ public:
     /**
      * Get all the Page objects in the bucket.
      */
-    std::forward_list<Page *>GetPages();
+    std::vector<Page *> GetPages();
 
     /**
      * Increment the local depth of the bucket.
@@ -74,7 +75,7 @@ public:
     void DecreaseLocalDepth();
 
     /**
-     * Clear out all the pages stored within the bucket.
+     * Clear out all the pages stored within the bucket, without deleting them.
      */
     void Clear();
 };
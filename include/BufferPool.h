@@ -6,6 +6,8 @@
 #include <string>
 #include "ExtendibleHashtable.h"
 #include "EvictionPolicy.h"
+#include "PageHandle.h"
+#include "FrameArena.h"
 
 /**
  * Class representing a Buffer Pool in the database.
@@ -15,12 +17,34 @@ private:
     // Private data
     ExtendibleHashtable *hashtable;
     EvictionPolicy *policy;
+    FrameArena *arena;
 
     // Private methods
-    void Evict();
+    /**
+     * Evict a page that is not pinned, chosen by the eviction policy.
+     *
+     * @return false if every page is pinned, so none was evicted.
+     */
+    bool Evict();
+
+    PageHandle InsertPage(Page *newPage);
 
 public:
-    BufferPool(int minSize, int maxSize, EvictionPolicyType evictionPolicyType);
+    static const size_t DEFAULT_FRAME_SIZE = 4096;
+
+    /**
+     * Constructor for a BufferPool object. The frames the pages are read into are mapped up
+     * front, one per page the buffer pool holds at its max size.
+     *
+     * @param minSize the min number of directory entries of the hash table of pages.
+     * @param maxSize the max number of directory entries of the hash table of pages.
+     * @param evictionPolicyType the eviction policy.
+     * @param frameSize the size of the frames in bytes. Pages that don't fit in one, such as
+     * decoded compressed leaves and bloom filters, are kept in memory of their own instead.
+     * @param useHugePages whether to back the frames with huge pages.
+     */
+    BufferPool(int minSize, int maxSize, EvictionPolicyType evictionPolicyType,
+               size_t frameSize = BufferPool::DEFAULT_FRAME_SIZE, bool useHugePages = false);
 
     ~BufferPool();
 
@@ -33,6 +57,16 @@ public:
      */
     std::vector<uint64_t> Get(const std::string &pageId);
 
+    /**
+     * Searches for page associated with given pageId in the buffer pool, and pins it so that its
+     * data can be read where it is, without copying it. The page is not evicted until the
+     * returned handle is destroyed.
+     *
+     * @param pageId the ID of the page.
+     * @return a handle to the page, which refers to no page if it is not in the buffer pool.
+     */
+    PageHandle Pin(const std::string &pageId);
+
     /**
      * Resize the max size of the buffer pool. Triggers eviction if new max size is
      * smaller than current size.
@@ -44,12 +78,46 @@ public:
     void Resize(int newMaxSize);
 
     /**
-     * Create a new page with given ID and data and insert it into the buffer pool.
+     * Create a new page with given ID and data and insert it into the buffer pool. Pages that are
+     * pinned are not evicted to make room for it.
      *
      * @param pageId the ID of the page.
-     * @param data the data of the page.
+     * @param data the data of the page, moved into the page.
+     * @return a handle pinning the new page.
+     */
+    PageHandle Insert(const std::string &pageId, std::vector<uint64_t> data);
+
+    /**
+     * Create a new page with given ID over a frame taken with AcquireFrame and insert it into
+     * the buffer pool. The frame is given back when the page is evicted.
+     *
+     * @param pageId the ID of the page.
+     * @param frame the frame holding the data of the page.
+     * @param words where the data starts within the frame.
+     * @param numWords the number of words of data.
+     * @return a handle pinning the new page.
+     */
+    PageHandle Insert(const std::string &pageId, uint64_t *frame, const uint64_t *words, size_t numWords);
+
+    /**
+     * Take a free frame to read a page into, evicting a page to free one if they are all taken.
+     * The frame is aligned, so that it can be read into from files opened with O_DIRECT.
+     *
+     * @return the frame, or nullptr if every page holding a frame is pinned.
+     */
+    uint64_t *AcquireFrame();
+
+    /**
+     * Give back a frame taken with AcquireFrame that is not inserted into the buffer pool.
+     *
+     * @param frame the frame.
+     */
+    void ReleaseFrame(uint64_t *frame);
+
+    /**
+     * Get the size of the frames in bytes.
      */
-    void Insert(const std::string &pageId, std::vector<uint64_t> &data);
+    [[nodiscard]] size_t GetFrameSize() const;
 };
 
 #endif //CSC443_PROJECT_BUFFERPOOL_H
@@ -1,8 +1,7 @@
 #ifndef CSC443_PROJECT_Clock_H
 #define CSC443_PROJECT_Clock_H
 
-#include <vector>
-#include <list>
+#include <cstddef>
 #include "EvictionPolicy.h"
 #include "Page.h"
 
@@ -11,8 +10,10 @@
  */
 class Clock : public EvictionPolicy {
 private:
-    std::list<Page *> pages;
-    int handle;
+    // The page the hand of the clock points to, in the ring linked through the pages, so that
+    // inserting a page does not allocate. nullptr if there are no pages.
+    Page *handle;
+    size_t numPages;
 
 public:
     Clock();
@@ -5,23 +5,222 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include "Memtable.h"
+#include "DbOptions.h"
+#include "WriteBatch.h"
+#include "WriteAheadLog.h"
+#include "WriteBufferManager.h"
+#include "SSTWriter.h"
 #include "BufferPool.h"
 #include "SST.h"
 #include "LSMTree.h"
 
 /**
  * Class representing the key-value database.
+ *
+ * Get and Scan can always be called from multiple threads at the same time. Without the
+ * write-ahead log, Put, Update and Delete can only be called concurrently if the memtable
+ * supports concurrent writes (see DbOptions::memtableType), otherwise writers are serialized.
+ *
+ * If DbOptions::maxImmutableMemtables is set, a full memtable is flushed by a background
+ * thread and stays readable until its content is in storage.
+ *
+ * If DbOptions::enableWriteAheadLog is set, every write is logged before it goes into the
+ * memtable and Open replays the logs left behind by a Db that was not closed. Each memtable
+ * gets a log of its own, which is removed once the memtable is flushed. Concurrent writers
+ * queue up and are committed in groups: the first writer in the queue leads the writers queued
+ * behind it, logs all their writes with a single write and fdatasync, then applies them to the
+ * memtable in the same order, so that a replay ends up with the values the readers saw.
+ *
+ * If DbOptions::writeBufferManager is set, the memory held by the memtables is accounted
+ * in bytes along with the memtables of the other Db objects sharing the manager, which has
+ * the largest memtable flushed once they all go over its budget.
  */
 class Db {
 private:
+    /**
+     * A write waiting in the queue of writers to be logged and applied by the leader of its group.
+     */
+    struct Writer {
+        WalRecordType type;
+        // The pair to put, or the bounds of the range to delete.
+        DataEntry_t entry;
+        // The pairs of a batch sorted by key, nullptr for a single put or range deletion.
+        const std::vector<DataEntry_t> *batch;
+        bool isDone;
+        bool success;
+    };
+
     Memtable *memtable;
+    // Full memtables waiting to be flushed in the background, from the oldest to the newest.
+    std::deque<Memtable *> immutableMemtables;
+    // A flushed memtable kept around so that its memory is reused by the next memtable.
+    Memtable *spareMemtable;
+    // Whether the write buffer manager asked for the memory of the queued memtables back, in which
+    // case the flush thread frees them instead of keeping one as the spare memtable.
+    bool releaseFlushedMemtables;
+    int memtableSize;
     std::string dbPath;
     std::vector<SST *> allSSTs;
     BufferPool *bufferPool;
     SearchType searchType;
     bool isLSMTree;
     LSMTree *lsmTree;
+    DbOptions options;
+    // Reads the leaves of the SST files asynchronously, nullptr unless it is enabled.
+    AsyncReader *asyncReader;
+    // Keeps the SST files open between their reads, nullptr if DbOptions::maxOpenFiles is 0.
+    TableCache *tableCache;
+    // The write-ahead log, nullptr unless it is enabled and the Db is open.
+    WriteAheadLog *wal;
+    // The number of the log that writes go to, or of the log being replayed by Open.
+    uint64_t logNumber;
+    // The memory held by the memtables the last time it was reported to the write buffer manager.
+    std::atomic<size_t> reportedMemoryUsage;
+    // Makes sure the changes of memory usage are reported one at a time.
+    std::mutex memoryUsageMutex;
+
+    // Writers hold it shared while inserting into a memtable that supports concurrent writes,
+    // and exclusively while inserting into any other memtable, switching to a new memtable
+    // or flushing the memtable inline. Also guards the queue of immutable memtables and the
+    // write-ahead log, which is only switched along with the memtable.
+    std::shared_mutex memtableMutex;
+    // Guards the SST files, the LSM-Tree and the buffer pool.
+    std::mutex storageMutex;
+
+    // The writers waiting for their write to be logged, the first one leading the group being written.
+    std::deque<Writer *> writers;
+    std::mutex writersMutex;
+    // Wakes up the writers once their group is written, and the next leader.
+    std::condition_variable writersCondition;
+    // Held by the leader of a group from before it logs the group until it is applied, and by
+    // anything else switching to a new log, so that the log is not switched in between. Taken
+    // before memtableMutex.
+    std::mutex writeMutex;
+
+    std::thread flushThread;
+    bool stopFlushThread;
+    // Run by the flush thread once it has flushed a memtable, before the memtable leaves the queue.
+    std::function<void()> flushedMemtableCallback;
+    // Wakes up the flush thread when a memtable is queued or the Db is destroyed.
+    std::condition_variable_any flushCondition;
+    // Wakes up the writers waiting for an immutable memtable to be flushed.
+    std::condition_variable_any stallCondition;
+
+    /**
+     * Write the content of given memtable to storage. The memtable must not be written
+     * to while it is flushed.
+     *
+     * @param memtableToFlush
+     */
+    void FlushMemtable(Memtable *memtableToFlush);
+
+    /**
+     * Queue the full memtable to be flushed in the background and replace it with an
+     * empty one. The caller must hold memtableMutex exclusively.
+     *
+     * @param startNewLog whether the new memtable gets a new write-ahead log, rather than
+     * sharing the current one with the full memtable.
+     */
+    void SwitchMemtable(bool startNewLog = true);
+
+    /**
+     * Called when the memtable is full. Either flush the memtable inline, or queue it to be
+     * flushed in the background, waiting for the flush thread to catch up if too many memtables
+     * are queued already. The caller must hold memtableMutex exclusively through <memtableLock>.
+     *
+     * @param startNewLog whether the memtable taking the next writes gets a new write-ahead log.
+     * It keeps the current log when that log holds writes that are not applied yet.
+     */
+    void MakeRoomForWrite(std::unique_lock<std::shared_mutex> &memtableLock, bool startNewLog = true);
+
+    /**
+     * Start a new write-ahead log for the memtable that just replaced the full one.
+     * The caller must hold memtableMutex exclusively.
+     */
+    void StartNewLog();
+
+    /**
+     * Remove the write-ahead logs whose key-value pairs have all been flushed.
+     * The caller must hold memtableMutex.
+     */
+    void RemoveObsoleteLogs();
+
+    /**
+     * Apply a write to the memtable, making room for it as needed. The caller must hold
+     * memtableMutex exclusively through <memtableLock>.
+     *
+     * @param writer the write.
+     * @param memtableLock
+     * @param startNewLog whether a memtable replacing a full one gets a new write-ahead log.
+     */
+    void ApplyWrite(const Writer &writer, std::unique_lock<std::shared_mutex> &memtableLock, bool startNewLog = true);
+
+    /**
+     * Log and apply a write. With the write-ahead log, the writer queues up and either leads
+     * the group of writers queued behind it or waits for the leader of its group to write it.
+     * The caller must not hold any lock of this Db.
+     *
+     * @param writer the write.
+     * @return false if the write could not be logged, in which case it is not applied, true otherwise.
+     */
+    bool CommitWrite(Writer &writer);
+
+    /**
+     * Log the writes of a group with a single write to the write-ahead log, then apply them
+     * in the same order. Called by the leader of the group.
+     *
+     * @param group the writers of the group, in the order they queued up.
+     * @return false if the group could not be logged, in which case it is not applied, true otherwise.
+     */
+    bool WriteGroup(const std::vector<Writer *> &group);
+
+    /**
+     * Get the number of bytes held by all the memtables. The caller must hold memtableMutex.
+     */
+    size_t ComputeMemtableMemoryUsage();
+
+    /**
+     * Report the change in memory held by the memtables to the write buffer manager, if any.
+     * The caller must hold memtableMutex.
+     */
+    void UpdateMemoryUsage();
+
+    /**
+     * Flush the largest memtable of the Db objects sharing the write buffer manager if they hold
+     * more memory than its budget. The caller must not hold any lock of this Db, since the memtable
+     * of this Db may be the one flushed.
+     */
+    void LimitWriteBufferMemory();
+
+    /**
+     * Look for given key in the memtables, from the newest one to the oldest one. The caller
+     * must hold memtableMutex.
+     *
+     * @param key
+     * @param value set to the value mapped to the key, INVALID_VALUE if it has been deleted.
+     * @return true if the memtables hold the key or have deleted it, false if it is to be looked
+     * for in storage.
+     */
+    bool GetFromMemtables(uint64_t key, uint64_t &value);
+
+    /**
+     * Rebuild the memtables from the write-ahead logs in the Db directory, then start a new log.
+     */
+    void ReplayWriteAheadLogs();
+
+    /**
+     * Body of the flush thread. Flushes the immutable memtables in the order they were
+     * queued until the Db is destroyed.
+     */
+    void RunFlushThread();
 
 public:
     /**
@@ -31,20 +230,26 @@ public:
      * @param searchType the search type of SST files.
      * @param bufferPool the buffer pool of the DB.
      * @param lsmTree the LSM-Tree data structure for the Db.
+     * @param options the optional settings of the Db.
      */
-    explicit Db(int memtableSize, SearchType searchType, BufferPool *bufferPool = nullptr, LSMTree *lsmTree = nullptr);
+    explicit Db(int memtableSize, SearchType searchType, BufferPool *bufferPool = nullptr, LSMTree *lsmTree = nullptr,
+                const DbOptions &options = DbOptions());
 
     ~Db();
 
     /**
-     * Opens the database at given path and prepares it to run.
+     * Opens the database at given path and prepares it to run. If the write-ahead log is
+     * enabled, the writes that were not flushed before the Db was last destroyed are put
+     * back into the memtable.
      *
      * @param path the path to the database file storage.
+     * @return true if the database was opened, false if the directory could not be created or
+     * holds a SST file that could not be read.
      */
     bool Open(const std::string &path);
 
     /**
-     * Closes the database.
+     * Closes the database. The memtable is flushed, so the write-ahead logs are removed.
      */
     void Close();
 
@@ -53,8 +258,36 @@ public:
      *
      * @param key
      * @param value
+     * @return false if the write could not be logged, in which case it is not applied, true otherwise.
      */
-    void Put(uint64_t key, uint64_t value);
+    bool Put(uint64_t key, uint64_t value);
+
+    /**
+     * Apply all the writes of a batch to the database. The batch is sorted once and
+     * inserted into the memtable in key order, and the memtable is only checked for
+     * room once per run of inserts rather than once per key.
+     *
+     * Updates and deletes in the batch are only applied if database is initialized using
+     * LSMTree data structure, same as Update and Delete.
+     *
+     * @param batch the writes to apply.
+     * @return false if the batch could not be logged, in which case it is not applied, true otherwise.
+     */
+    bool Write(const WriteBatch &batch);
+
+    /**
+     * Link an SST file built by an SSTWriter into the database, without inserting its
+     * key-value pairs one by one. The file is moved into the database directory and its
+     * pairs override the values already in the database, as if they were just put.
+     *
+     * The memtables are flushed first if they hold any key within the range of the file.
+     *
+     * Only available if database is initialized using LSMTree data structure.
+     *
+     * @param sstFile the finished SST file. The database takes ownership of it if it is ingested.
+     * @return true if the file was ingested, false otherwise.
+     */
+    bool IngestFile(SST *sstFile);
 
     /**
      * Retrieves a value associated with a given key in the database.
@@ -64,6 +297,16 @@ public:
      */
     uint64_t Get(uint64_t key);
 
+    /**
+     * Retrieves the values associated with given keys in the database. With async reads enabled,
+     * the leaves holding the keys are read all at once in each B-Tree SST file, rather than one
+     * after another.
+     *
+     * @param keys
+     * @param values set to the value mapped to each key, INVALID_VALUE for the keys not found.
+     */
+    void MultiGet(const std::vector<uint64_t> &keys, std::vector<uint64_t> &values);
+
     /**
      * Updates an existing key to have a new value in the database.
      *
@@ -71,8 +314,9 @@ public:
      *
      * @param key
      * @param newValue
+     * @return false if the database is not an LSMTree or the write could not be logged, true otherwise.
      */
-    void Update(uint64_t key, uint64_t newValue);
+    bool Update(uint64_t key, uint64_t newValue);
 
     /**
      * Deletes an existing key in the database.
@@ -80,8 +324,22 @@ public:
      * Only available if database is initialized using LSMTree data structure.
      *
      * @param key
+     * @return false if the database is not an LSMTree or the write could not be logged, true otherwise.
+     */
+    bool Delete(uint64_t key);
+
+    /**
+     * Deletes all the keys within range of [key1, key2] in the database with a single range
+     * tombstone, rather than one deleted key marker per key. The keys are dropped from the
+     * SST files as they are compacted.
+     *
+     * Only available if database is initialized using LSMTree data structure.
+     *
+     * @param key1 the lower bound of the deleted range.
+     * @param key2 the upper bound of the deleted range.
+     * @return false if the database is not an LSMTree or the deletion could not be logged, true otherwise.
      */
-    void Delete(uint64_t key);
+    bool DeleteRange(uint64_t key1, uint64_t key2);
 
     /**
      * Retrieves all KV-pairs in a key range in key order (key1 < key2)
@@ -92,6 +350,26 @@ public:
      */
     void Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult);
 
+    /**
+     * Get the number of bytes of memory held by the memtables of the database, including
+     * the memory kept by an empty memtable for its next key-value pairs.
+     */
+    size_t GetMemtableMemoryUsage();
+
+    /**
+     * Get the number of bytes of memory held by the memtable taking the writes, leaving out
+     * the memtables waiting to be flushed.
+     */
+    size_t GetActiveMemtableMemoryUsage();
+
+    /**
+     * Replace the memtable taking the writes with a new one, and give the memory of the old one
+     * back once its content is in storage. The old memtable is queued to be flushed by the
+     * flush thread, unless DbOptions::maxImmutableMemtables is 0 in which case it is flushed
+     * inline. Used by the write buffer manager, without holding any lock of this Db.
+     */
+    void ReleaseMemtable();
+
     /**
      * Resets this db's buffer pool by creating a new extendible hashtable with new min size,
      * max size, and eviction policy for it.
@@ -103,6 +381,16 @@ public:
      * @param evictionPolicyType
      */
     void ResetBufferPool(int bufferPoolMinSize, int bufferPoolMaxSize, EvictionPolicyType evictionPolicyType);
+
+    /**
+     * Set a function for the flush thread to run each time it has flushed an immutable memtable,
+     * before the memtable leaves the queue of immutable memtables.
+     *
+     * This method is used in tests.
+     *
+     * @param callback
+     */
+    void SetFlushedMemtableCallback(std::function<void()> callback);
 };
 
 #endif // CSC443_PROJECT_DB_H
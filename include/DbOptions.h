@@ -0,0 +1,62 @@
+#ifndef CSC443_PROJECT_DBOPTIONS_H
+#define CSC443_PROJECT_DBOPTIONS_H
+
+#include "Memtable.h"
+#include "SST.h"
+#include "WriteAheadLog.h"
+#include "WriteBufferManager.h"
+#include "AsyncReader.h"
+#include "TableCache.h"
+
+/**
+ * Struct holding the optional settings of a Db. The defaults match the behaviour of a
+ * Db created without any options.
+ */
+struct DbOptions {
+    // The data structure backing the memtable. Use SKIP_LIST to allow Put to be
+    // called from multiple threads at the same time, or B_PLUS_TREE for faster lookups.
+    MemtableType memtableType = MemtableType::RED_BLACK_TREE;
+    // The number of full memtables that can wait to be flushed by a background thread
+    // while a new memtable takes the writes. Writers stall once that many are queued.
+    // With 0, the writer that fills the memtable flushes it itself before returning.
+    int maxImmutableMemtables = 0;
+    // Log every write to a write-ahead log in the db directory before it goes into the memtable,
+    // so that the memtables can be rebuilt by Db::Open after a crash.
+    bool enableWriteAheadLog = false;
+    // When the write-ahead log is synced to disk, see WalSyncMode.
+    WalSyncMode walSyncMode = WalSyncMode::SYNC_PER_WRITE;
+    // The time between two syncs of the write-ahead log with SYNC_INTERVAL.
+    int walSyncIntervalMs = 100;
+    // Shared by the Db objects whose memtables must fit in one memory budget, in bytes. The
+    // memtables are then flushed when the budget is exceeded, even if they are not full.
+    // Not owned by the Db, and must outlive it.
+    WriteBufferManager *writeBufferManager = nullptr;
+    // How the key-value pairs are laid out in the leaves of the B-Tree SST files written. With
+    // COMPRESSED_LEAVES, dense keys and small values fit several times more entries in a page.
+    LeafFormat leafFormat = LeafFormat::RAW_LEAVES;
+    // How the pages of the SST files are read. With MMAP_READS, each file is mapped into memory
+    // once and searched in place, which suits data that fits in the OS page cache.
+    SSTReadMode readMode = SSTReadMode::PREAD_READS;
+    // Read the leaves of the SST files asynchronously, with io_uring or else a pool of threads:
+    // the leaves holding the keys of a MultiGet are read all at once, and compactions and scans
+    // read the next leaves while they process the ones before them.
+    bool enableAsyncReads = false;
+    // The largest number of asynchronous reads in flight at a time.
+    unsigned asyncReadQueueDepth = AsyncReader::DEFAULT_QUEUE_DEPTH;
+    // The largest number of SST files kept open between their reads, the least recently read
+    // ones being closed first. With 0, each read opens and closes the files it reads.
+    size_t maxOpenFiles = TableCache::DEFAULT_CAPACITY;
+    // Write the SST files with O_DIRECT, bypassing the OS page cache, like they are read. They are
+    // written in large page-aligned chunks either way.
+    bool useDirectWrites = false;
+    // The size of the pages of the SST files written, in bytes, which is recorded in each file so
+    // that files written with other page sizes can still be read. A power of two between
+    // SST::MIN_PAGE_SIZE and SST::MAX_PAGE_SIZE. Larger pages suit scans and compactions, smaller
+    // ones point lookups. The buffer pool still counts pages, whatever their size.
+    size_t pageSize = SST::PAGE_SIZE;
+    // Checksum each page of the SST files written, in its header, so that reads with pread stop at
+    // corrupt pages rather than return their content. Pages read where they are mapped are not checked.
+    bool enablePageChecksums = false;
+};
+
+#endif // CSC443_PROJECT_DBOPTIONS_H
@@ -0,0 +1,55 @@
+#ifndef CSC443_PROJECT_ENTRYITERATOR_H
+#define CSC443_PROJECT_ENTRYITERATOR_H
+
+#include <vector>
+#include "Utils.h"
+
+/**
+ * Interface for iterating over key-value entries in ascending key order, so that
+ * entries can be streamed into a SST file without gathering them in a vector first.
+ */
+class EntryIterator {
+public:
+    virtual ~EntryIterator() = default;
+
+    /**
+     * Whether the iterator points to an entry, i.e. it has not gone past the last entry.
+     */
+    [[nodiscard]] virtual bool Valid() const = 0;
+
+    /**
+     * Get the entry the iterator points to. Only valid if Valid() returns true.
+     */
+    [[nodiscard]] virtual DataEntry_t GetEntry() const = 0;
+
+    /**
+     * Move to the next entry.
+     */
+    virtual void Next() = 0;
+};
+
+/**
+ * Iterator over the entries of a sorted vector. The vector must outlive the iterator.
+ */
+class VectorEntryIterator : public EntryIterator {
+private:
+    const std::vector<DataEntry_t> &data;
+    size_t index;
+
+public:
+    explicit VectorEntryIterator(const std::vector<DataEntry_t> &data) : data(data), index(0) {}
+
+    [[nodiscard]] bool Valid() const override {
+        return this->index < this->data.size();
+    }
+
+    [[nodiscard]] DataEntry_t GetEntry() const override {
+        return this->data[this->index];
+    }
+
+    void Next() override {
+        this->index++;
+    }
+};
+
+#endif // CSC443_PROJECT_ENTRYITERATOR_H
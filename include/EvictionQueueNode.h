@@ -1,8 +1,6 @@
 #ifndef CSC443_PROJECT_EvictionQueueNode_H
 #define CSC443_PROJECT_EvictionQueueNode_H
 
-#include "Page.h"
-
 class Page;
 
 class EvictionQueueNode {
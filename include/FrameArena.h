@@ -0,0 +1,111 @@
+#ifndef CSC443_PROJECT_FRAMEARENA_H
+#define CSC443_PROJECT_FRAMEARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Page;
+
+/**
+ * Class representing the frames of the buffer pool: a fixed number of frames of the same size,
+ * carved out of memory mapped up front, which pages are read into straight from the SST files.
+ *
+ * The frames are aligned to FrameArena::ALIGNMENT, so they can be read into from files opened
+ * with O_DIRECT. The memory can be backed by huge pages, which saves TLB misses when the buffer
+ * pool is large. Handing out and taking back a frame does not allocate.
+ *
+ * Each frame comes with the Page object describing the page read into it, mapped along with the
+ * frames, so the buffer pool does not allocate one for each page it caches either.
+ */
+class FrameArena {
+private:
+    size_t frameSize;
+    bool useHugePages;
+    size_t numFrames;
+    // The regions mapped for the frames, with their size in bytes.
+    std::vector<std::pair<void *, size_t>> regions;
+    // The Page objects of the frames of each region, in the same order as the frames.
+    std::vector<Page *> regionPages;
+    // Reserved for all the frames, so that it never grows when a frame is freed.
+    std::vector<uint64_t *> freeFrames;
+
+    /**
+     * Map given number of bytes, with huge pages if the arena uses them and there are any.
+     *
+     * @return the mapped memory, or nullptr if it could not be mapped.
+     */
+    void *MapRegion(size_t numBytes) const;
+
+public:
+    static const size_t ALIGNMENT = 4096;
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /**
+     * Constructor for a FrameArena object.
+     *
+     * @param numFrames the number of frames to map up front.
+     * @param frameSize the size of each frame in bytes, rounded up to a multiple of ALIGNMENT.
+     * @param useHugePages whether to back the frames with huge pages. Falls back to transparent
+     * huge pages, then to regular pages, when none are reserved.
+     */
+    FrameArena(size_t numFrames, size_t frameSize, bool useHugePages = false);
+
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /**
+     * Map given number of frames more, such as when the buffer pool grows.
+     *
+     * @param numNewFrames the number of frames to add.
+     */
+    void Grow(size_t numNewFrames);
+
+    /**
+     * Take a free frame.
+     *
+     * @return the frame, or nullptr if they are all taken.
+     */
+    uint64_t *Allocate() {
+        if (this->freeFrames.empty()) {
+            return nullptr;
+        }
+        uint64_t *frame = this->freeFrames.back();
+        this->freeFrames.pop_back();
+        return frame;
+    }
+
+    /**
+     * Give back a frame taken with Allocate.
+     *
+     * @param frame the frame.
+     */
+    void Free(uint64_t *frame) {
+        this->freeFrames.push_back(frame);
+    }
+
+    /**
+     * Get the Page object of a frame, which the page read into the frame reuses.
+     *
+     * @param frame the frame.
+     */
+    Page *GetPage(const uint64_t *frame) const;
+
+    [[nodiscard]] size_t GetFrameSize() const {
+        return this->frameSize;
+    }
+
+    [[nodiscard]] size_t GetNumFrames() const {
+        return this->numFrames;
+    }
+
+    [[nodiscard]] size_t GetNumFreeFrames() const {
+        return this->freeFrames.size();
+    }
+};
+
+#endif // CSC443_PROJECT_FRAMEARENA_H
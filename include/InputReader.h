@@ -5,6 +5,7 @@
 #include <queue>
 #include "Utils.h"
 #include "SST.h"
+#include "AsyncReader.h"
 
 /**
  * Class representing an Input Reader Buffer writer for LSM-Tree.
@@ -15,18 +16,34 @@ private:
     uint64_t maxOffsetToRead;
     uint64_t bufferCapacity;
     std::vector<uint64_t> inputBuffer;
+    uint64_t numEntries;
     // Used in LSM tree sort-merge compaction
     std::vector<uint64_t> levelOffsets;
+    LeafFormat leafFormat;
+    size_t pageSize;
+    // Reads the next pages of the file ahead while the ones in the buffer are merged, if set.
+    PagePrefetcher *prefetcher;
 public:
     /**
      * Constructor for a InputReader object.
      *
      * @param maxOffsetToRead the maximum offset in which the buffer can read until in the file.
      * @param capacity the capacity of the buffer (in number of pages).
+     * @param leafFormat how the key-value pairs are laid out in the leaves of the file.
+     * @param pageSize the size of the pages of the file, in bytes.
      */
-    InputReader(uint64_t maxOffsetToRead, int capacity);
+    InputReader(uint64_t maxOffsetToRead, int capacity, LeafFormat leafFormat = LeafFormat::RAW_LEAVES,
+                size_t pageSize = SST::PAGE_SIZE);
 
-    ~InputReader() = default;
+    ~InputReader();
+
+    /**
+     * Read the next pages of the file ahead with given async reader from now on, while the
+     * pages in the buffer are merged.
+     *
+     * @param asyncReader the async reader, not owned by the input reader.
+     */
+    void SetAsyncReader(AsyncReader *asyncReader);
 
     /**
      * Set the file descriptor for the buffer and obtains the offsets of each LSM-Tree level
@@ -52,7 +69,8 @@ public:
     DataEntry_t GetEntry(int index);
 
     /**
-     * Get the current size of the input buffer.
+     * Get the current size of the input buffer, which is twice the number of entries in it,
+     * as if the keys and values were one after another whatever the format of the leaves.
      */
     uint64_t GetInputBufferSize();
 };
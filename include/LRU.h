@@ -16,8 +16,7 @@ public:
     LRU();
 
     /**
-     * We don't do any de-allocation here since each EvictionQueueNode is associated
-     * with a Page object, and we will let the Page object do the de-allocation for us.
+     * We don't do any de-allocation here since each EvictionQueueNode is part of its Page object.
      */
     ~LRU() = default;
 
@@ -18,6 +18,19 @@ private:
     int bitPerEntry;
     int inputBufferCapacity;
     int outputBufferCapacity;
+    LeafFormat leafFormat;
+    SSTReadMode readMode;
+    AsyncReader *asyncReader;
+    TableCache *tableCache;
+    bool useDirectWrites;
+    size_t pageSize;
+    bool usePageChecksums;
+
+    /**
+     * Whether given SST file holds keys or range tombstones within the range of [key1, key2],
+     * which tells from its key range and tombstones in memory, without reading the file.
+     */
+    static bool OverlapsScanRange(SST *sstFile, uint64_t key1, uint64_t key2);
 
 public:
     /**
@@ -31,6 +44,56 @@ public:
 
     ~LSMTree();
 
+    /**
+     * Set how to lay out the key-value pairs in the leaves of the SST files of the levels added from now on.
+     *
+     * @param newLeafFormat the leaf format.
+     */
+    void SetLeafFormat(LeafFormat newLeafFormat);
+
+    /**
+     * Set how the pages of the SST files of the levels added from now on are read.
+     *
+     * @param newReadMode the read mode.
+     */
+    void SetReadMode(SSTReadMode newReadMode);
+
+    /**
+     * Set the reader to read the leaves of the SST files of the levels added from now on ahead
+     * with during compactions and scans, and to batch the reads of MultiGet with.
+     *
+     * @param newAsyncReader the async reader, not owned by the LSM-Tree.
+     */
+    void SetAsyncReader(AsyncReader *newAsyncReader);
+
+    /**
+     * Set the cache keeping the SST files of the levels added from now on open between their reads.
+     *
+     * @param newTableCache the table cache, not owned by the LSM-Tree.
+     */
+    void SetTableCache(TableCache *newTableCache);
+
+    /**
+     * Set whether the SST files of the levels added from now on are written with O_DIRECT.
+     *
+     * @param newUseDirectWrites
+     */
+    void SetDirectWrites(bool newUseDirectWrites);
+
+    /**
+     * Set the size of the pages of the SST files of the levels added from now on.
+     *
+     * @param newPageSize the page size, in bytes.
+     */
+    void SetPageSize(size_t newPageSize);
+
+    /**
+     * Set whether the pages of the SST files of the levels added from now on get a checksum.
+     *
+     * @param newUsePageChecksums
+     */
+    void SetPageChecksums(bool newUsePageChecksums);
+
     /**
      * Compact and push data into the next level if <currLevel> is full, otherwise do nothing.
      *
@@ -49,7 +112,34 @@ public:
     void WriteMemtableData(std::vector<DataEntry_t> &data, SearchType searchType, std::string &dbPath);
 
     /**
-     * Searches for value with given key in the LSM-Tree.
+     * Stream data in memtable into next level.
+     *
+     * @param iterator the iterator over the memtable data in ascending key order.
+     * @param numEntries the number of entries the iterator returns.
+     * @param searchType the search type of the file (Binary search or B-Tree search).
+     * @param dbPath the path to the DB file storage.
+     * @param rangeTombstones the range tombstones of the memtable, if any.
+     */
+    void WriteMemtableData(EntryIterator *iterator, uint64_t numEntries, SearchType searchType,
+                           std::string &dbPath, const RangeTombstones *rangeTombstones = nullptr);
+
+    /**
+     * Link an SST file that is already written, such as one built by an SSTWriter, into the
+     * deepest level it can go in without being rewritten. Its keys are treated as newer than
+     * all the keys already in the LSM-Tree, so it goes in the deepest empty level above the
+     * first level holding any of its keys, or in a new level at the bottom if no level does.
+     * If there is no such level, it is added to the first level and compacted like the data
+     * of a memtable.
+     *
+     * @param sstFile the B-Tree SST file to link. The LSM-Tree takes ownership of it if it is linked.
+     * @param dbPath the path to the DB file storage.
+     * @return true if the file was linked, false if it could not be moved.
+     */
+    bool IngestFile(SST *sstFile, std::string &dbPath);
+
+    /**
+     * Searches for value with given key in the LSM-Tree. A key within a range tombstone of a
+     * file is not looked for in the older files.
      *
      * @param key the key to search for.
      * @param bufferPool the database buffer pool.
@@ -58,7 +148,19 @@ public:
     uint64_t Get(uint64_t key, BufferPool *bufferPool = nullptr);
 
     /**
-     * Scans for all data with keys within range of [key1, key2].
+     * Searches for the values of given keys in the LSM-Tree, level by level, reading the leaves
+     * holding the keys still looked for in a file all at once with the async reader, if set.
+     *
+     * @param keys the keys to search for.
+     * @param keyIndexes the indexes of the keys to search for among the keys.
+     * @param values set to the value associated with each key searched for.
+     * @param bufferPool the database buffer pool.
+     */
+    void MultiGet(const std::vector<uint64_t> &keys, const std::vector<size_t> &keyIndexes,
+                  std::vector<uint64_t> &values, BufferPool *bufferPool = nullptr);
+
+    /**
+     * Scans for all data with keys within range of [key1, key2], leaving out the deleted keys.
      *
      * @param key1 the lower bound of the scanned data.
      * @param key2 the upper bound of the scanned data.
@@ -66,6 +168,12 @@ public:
      */
     void Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult);
 
+    /**
+     * Get the number of bytes of memory taken by the B-Tree indexes pinned for the SST
+     * files of each level, starting from the first level.
+     */
+    [[nodiscard]] std::vector<size_t> GetIndexMemoryUsage() const;
+
     // Methods used for testing purposes only
     std::vector<Level *> GetLevels();
 
@@ -0,0 +1,93 @@
+#ifndef CSC443_PROJECT_LEAFPAGECODEC_H
+#define CSC443_PROJECT_LEAFPAGECODEC_H
+
+#include <cstdint>
+#include <vector>
+#include "Utils.h"
+#include "SearchKernels.h"
+
+/**
+ * Class encoding the key-value pairs of a B-Tree leaf into a compressed page, and decoding them back.
+ *
+ * A compressed page starts with a header of HEADER_NUM_WORDS words:
+ * | number of entries, bits per key delta and bits per value | first key | smallest key delta | smallest value |
+ * followed by the bit-packed differences between each key and the one before it, then the
+ * bit-packed values. The deltas and values are packed relative to their smallest one (frame of
+ * reference), using as many bits as their largest difference to it needs. A page holds as many
+ * entries as fit in it, so dense keys with small values fit several times more entries than a raw page.
+ * Pages are PAGE_NUM_WORDS words long unless the SST file they are in has pages of another size.
+ *
+ * The deltas and values are unpacked several at once with the vector instructions of the CPU it
+ * runs on, picking the kernel the same way as SearchKernels does.
+ */
+class LeafPageCodec {
+private:
+    static uint64_t GetNumBits(uint64_t value);
+
+    static uint64_t GetPackedNumWords(uint64_t numEntries, uint64_t keyBits, uint64_t valueBits);
+
+    static void PackBits(uint64_t *words, uint64_t bitOffset, uint64_t value, uint64_t numBits);
+
+    /**
+     * Unpack numValues values of numBits bits each, starting at bit bitOffset of words, add base to each
+     * of them and write them outputStride words apart.
+     */
+    static void UnpackBits(const uint64_t *words, uint64_t bitOffset, uint64_t numBits, uint64_t numValues,
+                           uint64_t base, uint64_t *output, uint64_t outputStride, SearchKernel kernel);
+
+public:
+    static const size_t PAGE_NUM_WORDS = 4096 / sizeof(uint64_t);
+    static const size_t HEADER_NUM_WORDS = 4;
+    // The fewest entries a page of PAGE_NUM_WORDS words holds, when both the key deltas and the values take 64 bits.
+    static const size_t MIN_ENTRIES_PER_PAGE = ((PAGE_NUM_WORDS - HEADER_NUM_WORDS) * 64 + 64) / 128;
+    // The most entries a page of PAGE_NUM_WORDS words holds, which bounds the memory taken by a decoded page.
+    // Larger pages hold proportionally more.
+    static const size_t MAX_ENTRIES_PER_PAGE = 2048;
+
+    /**
+     * Get the fewest entries a page of given number of words holds.
+     */
+    static size_t GetMinEntriesPerPage(size_t pageNumWords);
+
+    /**
+     * Get the most entries a page of given number of words holds.
+     */
+    static size_t GetMaxEntriesPerPage(size_t pageNumWords);
+
+    /**
+     * Encode as many of given entries as fit into one page, starting from the first one.
+     *
+     * @param entries the entries, in strictly ascending key order.
+     * @param numEntries the number of entries.
+     * @param page the page to encode the entries into, of pageNumWords words.
+     * @param pageNumWords the number of words of the page.
+     * @return the number of entries encoded, which is at least one if numEntries is not 0.
+     */
+    static size_t Encode(const DataEntry_t *entries, size_t numEntries, uint64_t *page,
+                         size_t pageNumWords = LeafPageCodec::PAGE_NUM_WORDS);
+
+    /**
+     * Get the number of entries in an encoded page.
+     *
+     * @param page the encoded page.
+     */
+    static size_t GetNumEntries(const uint64_t *page);
+
+    /**
+     * Decode the entries of a page and append them to given vector, as keys and values one
+     * after another, the same way as they are laid out in a raw leaf.
+     *
+     * @param page the encoded page.
+     * @param data the vector to append the decoded entries to.
+     * @param pageNumWords the number of words of the page.
+     */
+    static void Decode(const uint64_t *page, std::vector<uint64_t> &data,
+                       size_t pageNumWords = LeafPageCodec::PAGE_NUM_WORDS);
+
+    /**
+     * Same as Decode, with given kernel, which the CPU must support.
+     */
+    static void Decode(const uint64_t *page, std::vector<uint64_t> &data, size_t pageNumWords, SearchKernel kernel);
+};
+
+#endif // CSC443_PROJECT_LEAFPAGECODEC_H
@@ -0,0 +1,94 @@
+#ifndef CSC443_PROJECT_LEARNEDINDEX_H
+#define CSC443_PROJECT_LEARNEDINDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+/**
+ * Class representing a piecewise linear model of the position of each key among sorted keys,
+ * such as the fence keys of the leaves of a B-Tree SST file, which predicts the position of a
+ * key within MAX_ERROR of where it is.
+ *
+ * The model is fitted in one pass over the keys as they are written, with a shrinking cone:
+ * a segment goes on as long as one line through its first key predicts the position of all of
+ * its keys within MAX_ERROR, and a new one starts at the first key it cannot. Near-uniform keys
+ * need very few segments, so the model takes a lot less memory than the keys themselves.
+ */
+class LearnedIndex {
+private:
+    // The segments, each being a line through its first key and the position of that key.
+    std::vector<uint64_t> segmentFirstKeys;
+    std::vector<uint64_t> segmentFirstPositions;
+    std::vector<double> segmentSlopes;
+    uint64_t numKeys;
+
+    // The bounds of the slopes of the lines fitting all the keys of the last segment so far.
+    double minSlope;
+    double maxSlope;
+
+    void SetLastSegmentSlope();
+
+public:
+    // The largest distance between the predicted position of a key and its actual position.
+    static const uint64_t MAX_ERROR = 32;
+    // A serialized model starts with the number of keys and of segments, followed by the segments.
+    static const size_t HEADER_NUM_WORDS = 2;
+    static const size_t SEGMENT_NUM_WORDS = 3;
+
+    LearnedIndex();
+
+    /**
+     * Add the next key to the model, at the position following the previous key.
+     *
+     * @param key the key, greater than all the keys added before it.
+     */
+    void AddKey(uint64_t key);
+
+    /**
+     * Get the number of keys the model was fitted over.
+     */
+    [[nodiscard]] uint64_t GetNumKeys() const;
+
+    /**
+     * Get the number of segments of the model.
+     */
+    [[nodiscard]] size_t GetNumSegments() const;
+
+    /**
+     * Get the range of positions [first, second] holding the position of the first key that is
+     * not smaller than given key, which is the number of keys if there is none. The range is at
+     * most about 2 * MAX_ERROR positions wide.
+     *
+     * @param key
+     */
+    [[nodiscard]] std::pair<uint64_t, uint64_t> GetSearchRange(uint64_t key) const;
+
+    /**
+     * Append the model to given words, to be written to storage.
+     *
+     * @param words
+     */
+    void Serialize(std::vector<uint64_t> &words) const;
+
+    /**
+     * Replace the model by the one serialized in given words.
+     *
+     * @param words
+     * @return true if the words hold a whole model, false otherwise.
+     */
+    bool Deserialize(const std::vector<uint64_t> &words);
+
+    /**
+     * Get the number of bytes of memory taken by the model.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+    /**
+     * Remove all the keys from the model.
+     */
+    void Clear();
+};
+
+#endif // CSC443_PROJECT_LEARNEDINDEX_H
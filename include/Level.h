@@ -18,6 +18,13 @@ private:
     std::vector<SST *> sstFiles;
     int inputBufferCapacity;
     int outputBufferCapacity;
+    LeafFormat leafFormat;
+    SSTReadMode readMode;
+    AsyncReader *asyncReader;
+    TableCache *tableCache;
+    bool useDirectWrites;
+    size_t pageSize;
+    bool usePageChecksums;
 
     void AddSSTFile(SST *sstFile);
 
@@ -31,8 +38,20 @@ public:
      * @param bloomFilterBitsPerEntry the number of bits per entry for bloom filter.
      * @param inputBufferCapacity the capacity of input buffer in number of pages.
      * @param outputBufferCapacity the capacity of output buffer in number of pages.
+     * @param leafFormat how to lay out the key-value pairs in the leaves of the SST files written.
+     * @param readMode how the pages of the SST files of the level are read.
+     * @param asyncReader the reader to read the leaves of the SST files of the level ahead with
+     * during compactions and scans, if any. Not owned by the level.
+     * @param tableCache the cache keeping the SST files of the level open between their reads, if
+     * any. Not owned by the level.
+     * @param useDirectWrites whether to write the SST files of the level with O_DIRECT.
+     * @param pageSize the size of the pages of the SST files written, in bytes.
+     * @param usePageChecksums whether the pages of the SST files written get a checksum.
      */
-    Level(int level, int bloomFilterBitsPerEntry, int inputBufferCapacity, int outputBufferCapacity);
+    Level(int level, int bloomFilterBitsPerEntry, int inputBufferCapacity, int outputBufferCapacity,
+          LeafFormat leafFormat = LeafFormat::RAW_LEAVES, SSTReadMode readMode = SSTReadMode::PREAD_READS,
+          AsyncReader *asyncReader = nullptr, TableCache *tableCache = nullptr, bool useDirectWrites = false,
+          size_t pageSize = SST::PAGE_SIZE, bool usePageChecksums = false);
 
     // destructor
     ~Level();
@@ -46,20 +65,60 @@ public:
      * @param searchType the search type used by DB (binary search or B-Tree search)
      * @param dbPath the path to the DB file storage.
      */
-    void WriteDataToLevel(std::vector<DataEntry_t> data, SearchType searchType, std::string &dbPath);
+    void WriteDataToLevel(std::vector<DataEntry_t> &data, SearchType searchType, std::string &dbPath);
 
     /**
-     * Merge sort with the SST file at current level
+     * Stream KV-pair data from given iterator into a new SST file in current LSM-Tree level.
+     *
+     * @param iterator the iterator over the KV-pair data in ascending key order.
+     * @param numEntries the number of entries the iterator returns.
+     * @param searchType the search type used by DB (binary search or B-Tree search)
+     * @param dbPath the path to the DB file storage.
+     * @param rangeTombstones the range tombstones to keep in the new SST file, if any.
+     */
+    void WriteDataToLevel(EntryIterator *iterator, uint64_t numEntries, SearchType searchType, std::string &dbPath,
+                          const RangeTombstones *rangeTombstones = nullptr);
+
+    /**
+     * Link an SST file that is already written, such as one built by an SSTWriter, into
+     * current LSM-Tree level without rewriting it. The file is moved next to the other
+     * files of the level, and is the newest file of the level.
+     *
+     * @param sstFile the B-Tree SST file to link. The level takes ownership of it if it is linked.
+     * @param dbPath the path to the DB file storage.
+     * @return true if the file was linked, false if it could not be moved.
+     */
+    bool IngestSSTFile(SST *sstFile, std::string &dbPath);
+
+    /**
+     * Whether any SST file of current level has keys or range tombstones within the range of [key1, key2].
+     *
+     * @param key1 the lower bound of the range.
+     * @param key2 the upper bound of the range.
+     */
+    [[nodiscard]] bool OverlapsRange(uint64_t key1, uint64_t key2) const;
+
+    /**
+     * Merge sort with the SST file at current level. The keys of the older file that are
+     * within the range tombstones of the newer file are dropped, and the range tombstones
+     * of both files are kept in the merged file unless there is no older data left for them.
      *
      * @param nextLevel the level in which sort-merged data will be written into
      * @param dbPath the path to the DB file storage.
+     * @param isLastLevel whether nextLevel and the levels below it are empty.
      */
-    void SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath);
+    void SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath, bool isLastLevel = false);
 
     /**
      * Get all the SST file objects within current LSM-Tree level.
      */
     std::vector<SST *> GetSSTFiles();
+
+    /**
+     * Get the number of bytes of memory taken by the B-Tree indexes of the SST files
+     * within current LSM-Tree level.
+     */
+    [[nodiscard]] size_t GetIndexMemoryUsage() const;
 };
 
 #endif // LEVEL_H
\ No newline at end of file
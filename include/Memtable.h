@@ -1,30 +1,51 @@
 #ifndef MEMTABLE_H
 #define MEMTABLE_H
 
+#include "MemtableIndex.h"
 #include "RedBlackTree.h"
+#include "SkipList.h"
+#include "BPlusTree.h"
+#include "Arena.h"
+#include "RangeTombstones.h"
 #include "Utils.h"
 #include <vector>
 
+enum MemtableType {
+    RED_BLACK_TREE = 0, // Single writer
+    SKIP_LIST = 1, // Multiple concurrent writers
+    B_PLUS_TREE = 2 // Single writer, cache-friendly lookups
+};
+
 /**
  * Class representing a Memtable in the database.
  */
 class Memtable {
 private:
     /* data */
-    RedBlackTree *redBlackTree;
+    Arena *arena; // Holds the nodes of the index
+    MemtableIndex *index; // The data structure chosen by the memtable type
     int maxSize;
+    uint64_t logNumber; // The oldest write-ahead log holding key-value pairs of this memtable
+    RangeTombstones rangeTombstones; // The ranges deleted while this memtable took the writes
+    bool isFlushed; // Whether the content of this memtable is in storage already
 public:
     /**
      * Constructor for a Memtable object.
      *
      * @param maxSize the maximum key-value entries the memtable can hold.
+     * @param memtableType the data structure backing the memtable.
      */
-    explicit Memtable(int maxSize);
+    explicit Memtable(int maxSize, MemtableType memtableType = MemtableType::RED_BLACK_TREE);
 
     ~Memtable();
 
     /**
-     * Insert a key-value pair into the memtable.
+     * Insert a key-value pair into the memtable. If the key already exists in the memtable,
+     * its value is replaced by the new value.
+     *
+     * Can be called from multiple threads at the same time if the memtable supports
+     * concurrent writes. In that case the memtable may go over its maximum size by at
+     * most one entry per concurrent writer.
      *
      * @param key the key to be inserted.
      * @param value the value associated with the key.
@@ -32,6 +53,34 @@ public:
      */
     bool Put(uint64_t key, uint64_t value);
 
+    /**
+     * Insert the key-value pairs of <entries>, starting from index <start>, until the memtable
+     * is full. The entries must be sorted by key with no duplicate keys, so that each pair is
+     * inserted next to the previous one instead of being searched for from the top of the
+     * memtable. Must not be called alongside other writers.
+     *
+     * @param entries the key-value pairs sorted by key.
+     * @param start the index of the first pair to insert.
+     * @return the index of the first pair that was not inserted, entries.size() if all of them were.
+     */
+    size_t PutSorted(const std::vector<DataEntry_t> &entries, size_t start);
+
+    /**
+     * Delete all the keys within range of [key1, key2]. The keys of the range already in the
+     * memtable are marked as deleted, and a range tombstone hides the keys of the range in the
+     * older memtables and SST files. Keys put afterwards are not affected. Takes no room in the
+     * memtable other than the tombstone. Must not be called alongside other writers.
+     *
+     * @param key1 the lower bound of the deleted range.
+     * @param key2 the upper bound of the deleted range.
+     */
+    void DeleteRange(uint64_t key1, uint64_t key2);
+
+    /**
+     * Get the range tombstones of the memtable, which apply to the older memtables and SST files.
+     */
+    [[nodiscard]] const RangeTombstones &GetRangeTombstones() const;
+
     /**
      * Queries the value associated with given key in the memtable.
      *
@@ -56,6 +105,12 @@ public:
      */
     std::vector<DataEntry_t> GetAllData();
 
+    /**
+     * Create an iterator over all key-value pairs within the memtable in ascending sorted
+     * order. The caller owns the iterator, and must delete it before the memtable is reset.
+     */
+    EntryIterator *NewIterator();
+
     /**
      * Get the maximum size limit for the memtable.
      */
@@ -67,10 +122,56 @@ public:
     int GetCurrentSize();
 
     /**
-     * Reset the memtable by clearing out all key-value pairs it currently contains.
+     * Whether the memtable holds neither key-value pairs nor range tombstones, i.e. there
+     * is nothing to flush.
+     */
+    bool IsEmpty();
+
+    /**
+     * Whether Put can be called from multiple threads at the same time.
+     */
+    [[nodiscard]] bool SupportsConcurrentWrites() const;
+
+    /**
+     * Get the number of bytes of memory held by the memtable. The memory is kept when the
+     * memtable is reset, so it only goes down when the memtable is destroyed.
+     *
+     * Can be called while the memtable is written to.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+    /**
+     * Get the number of the oldest write-ahead log that holds key-value pairs of this memtable.
+     * That log and the newer ones must be kept until the memtable is flushed.
+     */
+    [[nodiscard]] uint64_t GetLogNumber() const;
+
+    /**
+     * Set the number of the oldest write-ahead log that holds key-value pairs of this memtable.
+     *
+     * @param logNumber
+     */
+    void SetLogNumber(uint64_t logNumber);
+
+    /**
+     * Whether the content of the memtable was flushed to storage, while the memtable may still
+     * be in the queue of immutable memtables.
+     */
+    [[nodiscard]] bool IsFlushed() const;
+
+    /**
+     * Mark the content of the memtable as flushed to storage, until the memtable is reset.
+     */
+    void SetFlushed();
+
+    /**
+     * Reset the memtable by clearing out all key-value pairs and range tombstones it currently contains.
+     * The memory of the memtable is kept and reused by the next key-value pairs.
+     *
+     * Must not be called while other threads are accessing the memtable.
      */
     void Reset();
 
 };
 
-#endif  // MEMTABLE_H
\ No newline at end of file
+#endif  // MEMTABLE_H
@@ -0,0 +1,83 @@
+#ifndef CSC443_PROJECT_MEMTABLEINDEX_H
+#define CSC443_PROJECT_MEMTABLEINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "EntryIterator.h"
+#include "Utils.h"
+
+/**
+ * Abstract class for the ordered in-memory data structures that can back a memtable.
+ *
+ * Implementations allocate their nodes from an arena owned by the memtable, so Clear
+ * only has to forget about the nodes.
+ */
+class MemtableIndex {
+public:
+    virtual ~MemtableIndex() = default;
+
+    /**
+     * Insert a key-value pair, or overwrite the value if the key already exists.
+     *
+     * @param key
+     * @param value
+     * @return true if the key was new, false if an existing value was overwritten.
+     */
+    virtual bool Insert(uint64_t key, uint64_t value) = 0;
+
+    /**
+     * Insert the key-value pairs of entries[start, end), which must be sorted by key with
+     * no duplicate keys. Implementations can use the order to avoid searching for each key
+     * from the top of the structure.
+     *
+     * @param entries the key-value pairs sorted by key.
+     * @param start the index of the first pair to insert.
+     * @param end the index after the last pair to insert.
+     */
+    virtual void InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            this->Insert(entries[i].first, entries[i].second);
+        }
+    }
+
+    /**
+     * Searches for value associated with given key.
+     *
+     * @param key
+     * @return the value associated with the key, Utils::INVALID_VALUE if the key does not exist.
+     */
+    virtual uint64_t Search(uint64_t key) = 0;
+
+    /**
+     * Gather all key-value pairs whose key is within the range of [key1, key2] in ascending order.
+     *
+     * @param key1 the lower bound of the scan range.
+     * @param key2 the upper bound of the scan range.
+     * @param nodesList the vector to place resulting key-value pairs in.
+     */
+    virtual void Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) = 0;
+
+    /**
+     * Create an iterator over all key-value pairs in ascending key order. The caller owns the iterator.
+     */
+    virtual EntryIterator *NewIterator() = 0;
+
+    /**
+     * Get the number of keys currently in the structure.
+     */
+    [[nodiscard]] virtual int GetCurrentSize() const = 0;
+
+    /**
+     * Whether Insert can be called from multiple threads at the same time.
+     */
+    [[nodiscard]] virtual bool SupportsConcurrentWrites() const {
+        return false;
+    }
+
+    /**
+     * Remove all the key-value pairs. It is up to the owner of the arena to reset it.
+     */
+    virtual void Clear() = 0;
+};
+
+#endif // CSC443_PROJECT_MEMTABLEINDEX_H
@@ -9,6 +9,9 @@ enum Color {
 
 /**
  * Class representing a node in the Red-Black Tree data structure.
+ *
+ * The color of the node is packed into the least significant bit of the parent
+ * pointer, which is always zero since nodes are at least 8-byte aligned.
  */
 class Node {
 private:
@@ -17,16 +20,13 @@ private:
     uint64_t value;
     Node *left;
     Node *right;
-    Node *parent; // Used in Red-Black tree
-    Color color; // Used in Red-Black tree
+    uintptr_t parentAndColor; // Used in Red-Black tree
+
+    static const uintptr_t COLOR_MASK = 1;
 public:
     Node(uint64_t key, uint64_t value, Node *left, Node *right, Node *parent, Color color) :
-            key(key), value(value), left(left), right(right), parent(parent), color(color) {};
-
-    ~Node() {
-        delete this->left;
-        delete this->right;
-    }
+            key(key), value(value), left(left), right(right),
+            parentAndColor(reinterpret_cast<uintptr_t>(parent) | color) {};
 
     [[nodiscard]] uint64_t GetKey() const {
         return this->key;
@@ -36,6 +36,10 @@ public:
         return this->value;
     }
 
+    void SetValue(uint64_t newValue) {
+        this->value = newValue;
+    }
+
     Node *GetLeftChild() {
         return this->left;
     }
@@ -45,11 +49,11 @@ public:
     }
 
     Node *GetParent() {
-        return this->parent;
+        return reinterpret_cast<Node *>(this->parentAndColor & ~COLOR_MASK);
     }
 
     bool GetColor() {
-        return this->color;
+        return this->parentAndColor & COLOR_MASK;
     }
 
     void SetLeftChild(Node *newLeft) {
@@ -61,12 +65,12 @@ public:
     }
 
     void SetParent(Node *newParent) {
-        this->parent = newParent;
+        this->parentAndColor = reinterpret_cast<uintptr_t>(newParent) | (this->parentAndColor & COLOR_MASK);
     }
 
     void SetColor(Color newColor) {
-        this->color = newColor;
+        this->parentAndColor = (this->parentAndColor & ~COLOR_MASK) | newColor;
     }
 };
 
-#endif // NODE_H
\ No newline at end of file
+#endif // NODE_H
@@ -2,7 +2,6 @@
 #define CSC443_PROJECT_OUTPUTWRITER_H
 
 #include <vector>
-#include <fstream>
 #include "Utils.h"
 #include "SST.h"
 
@@ -15,16 +14,19 @@ private:
     // Number of pages that output buffer hold in memory before writing it to storage
     int bufferCapacity;
     std::vector<DataEntry_t> outputBuffer;
-    std::ofstream file;
-    int numPagesWrittenToFile;
+    AlignedFileWriter *file;
+    uint64_t numEntriesWrittenToFile;
 public:
     /**
      * Constructor for a OutputWrite object.
      *
      * @param sstFile the SST file the buffer is associated with.
      * @param capacity the capacity of the buffer (in number of pages).
+     * @param useDirectWrites whether to write the file with O_DIRECT.
      */
-    OutputWriter(SST *sstFile, int capacity);
+    OutputWriter(SST *sstFile, int capacity, bool useDirectWrites = false);
+
+    ~OutputWriter();
 
     /**
      * Add a new key-value entry into the buffer. Write to file if the buffer is full.
@@ -36,9 +38,9 @@ public:
     /**
      * Write the end of the file current buffer is associated with.
      *
-     * @return the number of pages written to the file.
+     * @return the number of key-value entries written to the file.
      */
-    int WriteEndOfFile();
+    uint64_t WriteEndOfFile();
 };
 
 #endif // CSC443_PROJECT_OUTPUTWRITER_H
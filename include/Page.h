@@ -8,6 +8,7 @@
 #include <vector>
 #include <utility>
 #include "EvictionQueueNode.h"
+#include "FrameArena.h"
 
 class EvictionQueueNode;
 
@@ -17,32 +18,97 @@ class EvictionQueueNode;
 class Page {
 private:
     std::string pageId;
+    // The data is either in a frame of the buffer pool, or in the vector of the page if it does
+    // not fit in a frame.
     std::vector<uint64_t> data;
-    EvictionQueueNode *evictionNode; // Used in LRU
+    FrameArena *arena;
+    uint64_t *frame;
+    const uint64_t *words;
+    size_t numWords;
+    // Part of the page, so that queueing the page does not allocate. Used in LRU.
+    EvictionQueueNode evictionNode;
+    bool isInEvictionQueue;
     bool accessBit; // Used in Clock
+    // The pages around this one in the ring of Clock, so that adding the page to it does not allocate.
+    Page *clockNext;
+    Page *clockPrev;
+    // The next page in the chain of the bucket of the page. Used in Bucket.
+    Page *bucketNext;
+    // Number of PageHandle objects reading the data of the page, which is not evicted while there are any.
+    int pinCount;
 public:
+    /**
+     * Constructor for an empty Page object, such as the ones a FrameArena keeps for its frames.
+     */
+    Page() : Page("", std::vector<uint64_t>()) {}
+
     /**
      * Constructor for a Page object
      *
      * @param pageId the ID of the page.
      * @param data the key-value data stored in the page.
-     * @param evictionNode the eviction queue linked list node. Used for LRU eviction policy.
      */
-    Page(const std::string &pageId, std::vector<uint64_t> data, EvictionQueueNode *evictionNode = nullptr) {
+    Page(const std::string &pageId, std::vector<uint64_t> data) : evictionNode(this, nullptr, nullptr) {
         this->pageId = pageId;
         this->data = std::move(data);
-        this->evictionNode = evictionNode;
+        this->arena = nullptr;
+        this->frame = nullptr;
+        this->words = this->data.data();
+        this->numWords = this->data.size();
+        this->isInEvictionQueue = false;
+        this->accessBit = false;
+        this->clockNext = nullptr;
+        this->clockPrev = nullptr;
+        this->bucketNext = nullptr;
+        this->pinCount = 0;
+    }
+
+    Page(const Page &) = delete;
+
+    Page &operator=(const Page &) = delete;
+
+    /**
+     * Make this page of a FrameArena the page whose data is in its frame. The ID is copied into
+     * the string the page already has, so that reusing the page does not allocate.
+     *
+     * @param newPageId the ID of the page.
+     * @param frameArena the arena the frame was taken from.
+     * @param pageFrame the frame.
+     * @param pageWords where the data starts within the frame.
+     * @param pageNumWords the number of words of data.
+     */
+    void Assign(const std::string &newPageId, FrameArena *frameArena, uint64_t *pageFrame, const uint64_t *pageWords,
+                size_t pageNumWords) {
+        this->pageId.assign(newPageId);
+        this->arena = frameArena;
+        this->frame = pageFrame;
+        this->words = pageWords;
+        this->numWords = pageNumWords;
+        this->isInEvictionQueue = false;
         this->accessBit = false;
+        this->clockNext = nullptr;
+        this->clockPrev = nullptr;
+        this->bucketNext = nullptr;
+        this->pinCount = 0;
     }
 
-    ~Page() {
-        delete this->evictionNode;
+    /**
+     * Delete given page. A page of a FrameArena is kept for its frame instead, which is given back
+     * to the arena.
+     */
+    static void Delete(Page *page) {
+        if (page->frame != nullptr) {
+            page->arena->Free(page->frame);
+            page->frame = nullptr;
+        } else {
+            delete page;
+        }
     }
 
     /**
      * Get the ID of the current page.
      */
-    std::string GetPageId() {
+    [[nodiscard]] const std::string &GetPageId() const {
         return this->pageId;
     }
 
@@ -54,17 +120,29 @@ public:
     }
 
     /**
-     * Get the eviction queue linked list node of the page. Used for LRU eviction policy.
+     * Get the eviction queue linked list node of the page, nullptr if the page is not in the
+     * queue. Used for LRU eviction policy.
      */
     EvictionQueueNode *GetEvictionQueueNode() {
-        return this->evictionNode;
+        return this->isInEvictionQueue ? &this->evictionNode : nullptr;
     }
 
     /**
-     * Set the eviction queue linked list node of the page. Used for LRU eviction policy.
+     * Put the page in the eviction queue, and get its node unlinked from any other. Used for
+     * LRU eviction policy.
      */
-    void SetEvictionQueueNode(EvictionQueueNode *newEvictionNode) {
-        this->evictionNode = newEvictionNode;
+    EvictionQueueNode *AddToEvictionQueue() {
+        this->evictionNode.SetNext(nullptr);
+        this->evictionNode.SetPrev(nullptr);
+        this->isInEvictionQueue = true;
+        return &this->evictionNode;
+    }
+
+    /**
+     * Take the page out of the eviction queue, once its node is unlinked. Used for LRU eviction policy.
+     */
+    void RemoveFromEvictionQueue() {
+        this->isInEvictionQueue = false;
     }
 
     /**
@@ -74,6 +152,48 @@ public:
         this->accessBit = accessStatus;
     }
 
+    /**
+     * Get the page after this one in the ring of pages. Used for CLOCK eviction policy.
+     */
+    [[nodiscard]] Page *GetClockNext() const {
+        return this->clockNext;
+    }
+
+    /**
+     * Get the page before this one in the ring of pages. Used for CLOCK eviction policy.
+     */
+    [[nodiscard]] Page *GetClockPrev() const {
+        return this->clockPrev;
+    }
+
+    /**
+     * Set the page after this one in the ring of pages. Used for CLOCK eviction policy.
+     */
+    void SetClockNext(Page *next) {
+        this->clockNext = next;
+    }
+
+    /**
+     * Set the page before this one in the ring of pages. Used for CLOCK eviction policy.
+     */
+    void SetClockPrev(Page *prev) {
+        this->clockPrev = prev;
+    }
+
+    /**
+     * Get the next page in the chain of the bucket of the page, nullptr if it is the last one.
+     */
+    [[nodiscard]] Page *GetBucketNext() const {
+        return this->bucketNext;
+    }
+
+    /**
+     * Set the next page in the chain of the bucket of the page.
+     */
+    void SetBucketNext(Page *next) {
+        this->bucketNext = next;
+    }
+
     /**
      * Get all the key-value data within the page. The keys are on even indices while
      * values are on odd indices.
@@ -81,7 +201,43 @@ public:
      * @return a vector containing all key-value pairs.
      */
     std::vector<uint64_t> GetData() {
-        return this->data;
+        return {this->words, this->words + this->numWords};
+    }
+
+    /**
+     * Get the data within the page where it is, without copying it. It stays valid as long as the
+     * page is pinned.
+     */
+    [[nodiscard]] const uint64_t *GetWords() const {
+        return this->words;
+    }
+
+    /**
+     * Get the number of words of data within the page.
+     */
+    [[nodiscard]] size_t GetNumWords() const {
+        return this->numWords;
+    }
+
+    /**
+     * Pin the page, so that it is not evicted until it is unpinned as many times.
+     */
+    void Pin() {
+        this->pinCount++;
+    }
+
+    /**
+     * Unpin the page, which can be evicted once it is not pinned anymore.
+     */
+    void Unpin() {
+        this->pinCount--;
+    }
+
+    /**
+     * Whether the page is pinned, and so cannot be evicted.
+     */
+    [[nodiscard]] bool IsPinned() const {
+        return this->pinCount > 0;
     }
 };
 
@@ -0,0 +1,120 @@
+#ifndef CSC443_PROJECT_PAGEHANDLE_H
+#define CSC443_PROJECT_PAGEHANDLE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Page.h"
+
+/**
+ * Class giving read-only access to the data of a page where it is, without copying it. A page
+ * of the buffer pool stays pinned, and so is not evicted, for as long as a handle to it exists.
+ * A page read without a buffer pool is owned by its handle instead.
+ *
+ * Handles are moved rather than copied, and must not outlive the buffer pool their page is in.
+ */
+class PageHandle {
+private:
+    Page *page;
+    bool ownsPage;
+
+    void Release() {
+        if (this->page == nullptr) {
+            return;
+        }
+        if (this->ownsPage) {
+            delete this->page;
+        } else {
+            this->page->Unpin();
+        }
+        this->page = nullptr;
+    }
+
+public:
+    /**
+     * Constructor for an empty PageHandle object, which refers to no page.
+     */
+    PageHandle() : page(nullptr), ownsPage(false) {}
+
+    /**
+     * Constructor for a PageHandle object pinning given page of the buffer pool.
+     *
+     * @param page the page.
+     */
+    explicit PageHandle(Page *page) : page(page), ownsPage(false) {
+        if (this->page != nullptr) {
+            this->page->Pin();
+        }
+    }
+
+    /**
+     * Constructor for a PageHandle object owning given data, read outside of the buffer pool.
+     *
+     * @param data the data of the page.
+     */
+    explicit PageHandle(std::vector<uint64_t> data) : page(new Page("", std::move(data))), ownsPage(true) {}
+
+    ~PageHandle() {
+        this->Release();
+    }
+
+    PageHandle(const PageHandle &) = delete;
+
+    PageHandle &operator=(const PageHandle &) = delete;
+
+    PageHandle(PageHandle &&other) noexcept: page(other.page), ownsPage(other.ownsPage) {
+        other.page = nullptr;
+    }
+
+    PageHandle &operator=(PageHandle &&other) noexcept {
+        if (this != &other) {
+            this->Release();
+            this->page = other.page;
+            this->ownsPage = other.ownsPage;
+            other.page = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * Whether the handle refers to a page.
+     */
+    [[nodiscard]] bool IsValid() const {
+        return this->page != nullptr;
+    }
+
+    /**
+     * Get the data of the page, nullptr if the handle refers to no page.
+     */
+    [[nodiscard]] const uint64_t *Data() const {
+        return this->page != nullptr ? this->page->GetWords() : nullptr;
+    }
+
+    /**
+     * Get the number of words of data of the page, 0 if the handle refers to no page.
+     */
+    [[nodiscard]] size_t Size() const {
+        return this->page != nullptr ? this->page->GetNumWords() : 0;
+    }
+
+    /**
+     * Whether the handle refers to no data.
+     */
+    [[nodiscard]] bool Empty() const {
+        return this->Size() == 0;
+    }
+
+    [[nodiscard]] const uint64_t *begin() const {
+        return this->Data();
+    }
+
+    [[nodiscard]] const uint64_t *end() const {
+        return this->Data() + this->Size();
+    }
+
+    const uint64_t &operator[](size_t index) const {
+        return this->Data()[index];
+    }
+};
+
+#endif // CSC443_PROJECT_PAGEHANDLE_H
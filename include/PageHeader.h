@@ -0,0 +1,94 @@
+#ifndef CSC443_PROJECT_PAGEHEADER_H
+#define CSC443_PROJECT_PAGEHEADER_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * What a page of a SST file holds, which tells how its entries are laid out after its header.
+ */
+enum PageType {
+    // Key-value pairs one after another: raw leaves, and the pages of binary search files.
+    ENTRIES_PAGE = 1,
+    // The keys of the entries followed by their values, each taking half of the page.
+    COLUMNAR_LEAF_PAGE = 2,
+    // The entries encoded by LeafPageCodec.
+    COMPRESSED_LEAF_PAGE = 3,
+    // The fence keys of an internal level of a B-Tree, one key per page or leaf of the level below.
+    FENCE_KEYS_PAGE = 4,
+    // Words describing the file, such as the B-Tree metadata page, which ends with the footer of the file.
+    METADATA_PAGE = 5
+};
+
+/**
+ * Class reading and writing the header the pages of entries, fence keys and metadata of a SST
+ * file start with, so that their extent is known without looking for where they end:
+ * | PAGE_MAGIC, flags, page type and number of entries | checksum |
+ * The number of entries is in the lowest 32 bits of the first word. The checksum, if the page has
+ * one, is the XXH64 of the rest of the page seeded with the first word, and 0 otherwise.
+ * Every page of a file whose footer has SST::FORMAT_VERSION starts with a header; files without
+ * such a footer are not read.
+ */
+class PageHeader {
+private:
+    static const uint64_t MAGIC_SHIFT = 48;
+    static const uint64_t FLAGS_SHIFT = 40;
+    static const uint64_t TYPE_SHIFT = 32;
+    static const uint64_t NUM_ENTRIES_MASK = 0xFFFFFFFF;
+    static const uint64_t HAS_CHECKSUM_FLAG = 1;
+
+    static uint64_t ComputeChecksum(const uint64_t *page, size_t pageNumWords);
+
+public:
+    static const size_t NUM_WORDS = 2;
+    static const uint64_t PAGE_MAGIC = 0x5047; // "PG"
+
+    /**
+     * Get the number of words of a page of given number of words that follow its header.
+     */
+    static size_t GetPayloadNumWords(size_t pageNumWords) {
+        return pageNumWords - PageHeader::NUM_WORDS;
+    }
+
+    /**
+     * Write the header of a page whose entries are already after it.
+     *
+     * @param page the page.
+     * @param pageNumWords the number of words of the page.
+     * @param type what the page holds.
+     * @param numEntries the number of entries of the page: pairs for the pages of leaves, words otherwise.
+     * @param hasChecksum whether to checksum the page, which takes hashing the whole page.
+     */
+    static void Write(uint64_t *page, size_t pageNumWords, PageType type, size_t numEntries, bool hasChecksum);
+
+    /**
+     * Whether the page starts with a header.
+     */
+    static bool IsValid(const uint64_t *page);
+
+    /**
+     * Get what the page holds.
+     */
+    static PageType GetType(const uint64_t *page);
+
+    /**
+     * Get the number of entries of the page, 0 if it does not start with a header.
+     */
+    static size_t GetNumEntries(const uint64_t *page);
+
+    /**
+     * Get the number of words the entries of the page take after its header, 0 if it does not
+     * start with a header.
+     */
+    static size_t GetNumEntryWords(const uint64_t *page);
+
+    /**
+     * Whether the page starts with a header and, if it has a checksum, matches it.
+     *
+     * @param page the page.
+     * @param pageNumWords the number of words of the page.
+     */
+    static bool IsIntact(const uint64_t *page, size_t pageNumWords);
+};
+
+#endif // CSC443_PROJECT_PAGEHEADER_H
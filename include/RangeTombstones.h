@@ -0,0 +1,68 @@
+#ifndef CSC443_PROJECT_RANGETOMBSTONES_H
+#define CSC443_PROJECT_RANGETOMBSTONES_H
+
+#include <cstdint>
+#include <vector>
+#include "Utils.h"
+
+/**
+ * Class representing the key ranges deleted by Db::DeleteRange, held by a memtable or a
+ * SST file. A range tombstone hides the keys within its range in the memtables and SST
+ * files that are older than the one holding it, but not the keys held next to it.
+ *
+ * The ranges are kept sorted, with overlapping and adjacent ranges merged together,
+ * so that a key is checked with a single binary search.
+ */
+class RangeTombstones {
+private:
+    // Sorted, disjoint ranges of [first, second].
+    std::vector<DataEntry_t> ranges;
+
+public:
+    /**
+     * Add the deletion of all the keys within range of [key1, key2].
+     *
+     * @param key1 the lower bound of the deleted range.
+     * @param key2 the upper bound of the deleted range.
+     */
+    void Add(uint64_t key1, uint64_t key2);
+
+    /**
+     * Add all the ranges of <other>.
+     *
+     * @param other
+     */
+    void AddAll(const RangeTombstones &other);
+
+    /**
+     * Whether given key is within one of the deleted ranges.
+     *
+     * @param key
+     */
+    [[nodiscard]] bool Covers(uint64_t key) const;
+
+    /**
+     * Whether any of the deleted ranges overlaps the range of [key1, key2].
+     *
+     * @param key1 the lower bound of the range.
+     * @param key2 the upper bound of the range.
+     */
+    [[nodiscard]] bool OverlapsRange(uint64_t key1, uint64_t key2) const;
+
+    /**
+     * Whether there are no deleted ranges.
+     */
+    [[nodiscard]] bool IsEmpty() const;
+
+    /**
+     * Get the deleted ranges in ascending order, as pairs of lower and upper bounds.
+     */
+    [[nodiscard]] const std::vector<DataEntry_t> &GetRanges() const;
+
+    /**
+     * Remove all the deleted ranges.
+     */
+    void Clear();
+};
+
+#endif // CSC443_PROJECT_RANGETOMBSTONES_H
@@ -2,6 +2,9 @@
 #define REDBLACKTREE_H
 
 #include "Node.h"
+#include "Arena.h"
+#include "EntryIterator.h"
+#include "MemtableIndex.h"
 #include "Utils.h"
 #include <utility>
 #include <vector>
@@ -10,10 +13,11 @@
 /**
  * Class representing a Red-Black Tree data structure.
  */
-class RedBlackTree {
+class RedBlackTree : public MemtableIndex {
 private:
     /* data */
     Node *root;
+    Arena *arena; // Nodes are allocated on the heap if the tree has no arena
     int currentSize;
     uint64_t maxKey;
     uint64_t minKey;
@@ -29,10 +33,53 @@ private:
     void SetRoot(Node *root);
 
     static void Visit(Node *node, std::vector<DataEntry_t> &nodesList);
+
+    Node *NewNode(uint64_t key, uint64_t value, Node *parent);
+
+    /**
+     * Insert a key-value pair by descending from given node, which must be the root or a
+     * node whose subtree covers the key.
+     *
+     * @return the node holding the key.
+     */
+    Node *InsertFrom(Node *start, uint64_t key, uint64_t value);
+
+    void DeleteNodes();
 public:
-    explicit RedBlackTree(Node *root = nullptr);
+    /**
+     * Iterator over the key-value pairs of the tree in ascending key order. It walks the
+     * tree through the parent pointers, so it needs no stack. The tree must not be
+     * modified while it is iterated.
+     */
+    class Iterator : public EntryIterator {
+    private:
+        Node *node;
+
+    public:
+        explicit Iterator(RedBlackTree *tree);
+
+        [[nodiscard]] bool Valid() const override;
 
-    ~RedBlackTree();
+        [[nodiscard]] DataEntry_t GetEntry() const override;
+
+        void Next() override;
+    };
+
+    /**
+     * Constructor for a RedBlackTree object.
+     *
+     * @param arena the arena to allocate the tree nodes from. The tree does not own the arena,
+     * and nodes are allocated one by one on the heap if no arena is given.
+     */
+    explicit RedBlackTree(Arena *arena = nullptr);
+
+    ~RedBlackTree() override;
+
+    /**
+     * Remove all the nodes of the tree. If the tree has an arena, it is up to the
+     * owner of the arena to reset it.
+     */
+    void Clear() override;
 
     /**
      * Get the root of the tree.
@@ -42,7 +89,7 @@ public:
     /**
      * Get the current size of the tree.
      */
-    [[nodiscard]] int GetCurrentSize() const;
+    [[nodiscard]] int GetCurrentSize() const override;
 
     /**
      * Get the key with the largest value currently in the tree.
@@ -60,15 +107,32 @@ public:
      * @param key
      * @return the value associated with the key.
      */
-    uint64_t Search(uint64_t key);
+    uint64_t Search(uint64_t key) override;
 
     /**
-     * Insert a new key-value pair into the tree.
+     * Insert a new key-value pair into the tree. If the key already exists, its value
+     * is replaced by the new value.
      *
      * @param key
      * @param value
+     * @return true if the key was new, false if an existing value was overwritten.
      */
-    void Insert(uint64_t key, uint64_t value);
+    bool Insert(uint64_t key, uint64_t value) override;
+
+    /**
+     * Insert the key-value pairs of entries[start, end), which must be sorted by key with
+     * no duplicate keys. Each insertion starts from the node of the previous key and only
+     * climbs as far as needed, instead of descending from the root.
+     *
+     * @param entries the key-value pairs sorted by key.
+     * @param start the index of the first pair to insert.
+     * @param end the index after the last pair to insert.
+     */
+    void InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) override;
+
+    void Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) override;
+
+    EntryIterator *NewIterator() override;
 
     /**
      * Traverse the tree rooted at given <node> and gather all key-value pairs whose
@@ -1,25 +1,67 @@
 #ifndef CSC443_PROJECT_SST_H
 #define CSC443_PROJECT_SST_H
 
+#include <atomic>
+#include <cinttypes>
 #include <cstdint>
+#include <cstdio>
 #include <vector>
 #include <queue>
 #include <list>
 #include <string>
 #include <fstream>
 #include <map>
+#include <mutex>
 #include "BufferPool.h"
 #include "Utils.h"
 #include "BloomFilter.h"
-#include "BTreeLevel.h"
+#include "EntryIterator.h"
+#include "RangeTombstones.h"
+#include "LearnedIndex.h"
+#include "AlignedFileWriter.h"
+#include "PageHeader.h"
 
 class InputReader;
 
+class AsyncReader;
+
+class PagePrefetcher;
+
 class ScanInputReader;
 
+class TableCache;
+
 enum SearchType {
     BINARY_SEARCH = 0,
-    B_TREE_SEARCH = 1
+    B_TREE_SEARCH = 1,
+    // B-Tree files whose leaves are found with a model of the positions of their fence keys,
+    // stored in the file, rather than with the fence keys themselves.
+    LEARNED_INDEX = 2
+};
+
+/**
+ * How the key-value pairs are laid out in the leaves of a B-Tree SST file.
+ */
+enum LeafFormat {
+    // A page of pairs per leaf, only the last leaf not being full.
+    RAW_LEAVES = 0,
+    // As many pairs per leaf as fit once compressed by LeafPageCodec.
+    COMPRESSED_LEAVES = 1,
+    // Half of the rest of the page after its header holds the keys of the leaf, and the other half
+    // their values. The keys are searched in place, without copying them out.
+    COLUMNAR_LEAVES = 2
+};
+
+/**
+ * How the pages of a SST file are read.
+ */
+enum SSTReadMode {
+    // Each page is read with pread into a buffer of its own, and cached in the buffer pool if any.
+    PREAD_READS = 0,
+    // The whole file is mapped into memory the first time it is read, and the pages are searched
+    // where they are mapped, without any copy or system call. The OS page cache replaces the
+    // buffer pool for the pages of entries and fence keys.
+    MMAP_READS = 1
 };
 
 /**
@@ -28,49 +70,310 @@ enum SearchType {
 class SST {
 private:
     std::string fileName;
+    // Tells apart the pages of files that reuse the name of a deleted file in the buffer pool.
+    uint64_t fileNumber;
+    inline static std::atomic<uint64_t> nextFileNumber = 0;
     uint64_t fileDataByteSize;
-    std::vector<BTreeLevel *> bTreeLevels; // Used when the sst file is a static B-tree
+    // The size of the pages of the file, persisted in the footer of the file, the number of words of
+    // such a page, and the number of keys and of key-value pairs it holds after its header.
+    size_t pageSize;
+    size_t pageNumWords;
+    size_t keysPerPage;
+    size_t kvPairsPerPage;
+    // Whether the pages written get a checksum in their header, which is checked when they are read.
+    bool usePageChecksums;
+    bool isBTreeFile; // Set up by SetupBTreeFile, the file being a binary search file otherwise
     BloomFilter *bloomFilter;
     uint64_t maxOffsetToReadLeaves;
     InputReader *inputReader;
     ScanInputReader *scanInputReader;
+    // The range and number of keys written to the file so far, persisted in the footer of the file.
+    uint64_t minKey;
+    uint64_t maxKey;
+    uint64_t numEntries;
+    // The ranges deleted in the memtables the file was written from. They apply to the older files only.
+    RangeTombstones rangeTombstones;
+
+    // The B-Tree metadata and the fence keys of the leaves, read from the file once by LoadBTreeIndex.
+    // The fence keys of the upper internal levels are a subset of the leaves' ones, so they aren't kept.
+    // While the file is written, the fence keys of the leaves written so far, which the internal
+    // levels are built from once all the leaves are written.
+    bool isBTreeIndexLoaded;
+    std::vector<uint64_t> levelsPageOffsets;
+    std::vector<uint64_t> leafFenceKeys;
+    uint64_t bloomFilterNumPages;
+    uint64_t bloomFilterStartPage;
+    LeafFormat leafFormat;
+    // The model of the leaves' fence keys of a LEARNED_INDEX file, which replaces them in memory.
+    bool hasLearnedIndex;
+    LearnedIndex learnedIndex;
+    uint64_t learnedIndexNumPages;
+    uint64_t learnedIndexStartPage;
+    // The entries of a compressed leaf that is not full yet, while the file is written.
+    std::vector<DataEntry_t> pendingLeafEntries;
+    // The mapping of the whole file with MMAP_READS, set up once by the first read of the file.
+    SSTReadMode readMode;
+    std::once_flag mapFileFlag;
+    const uint64_t *mappedWords;
+    uint64_t mappedNumPages;
+    // Keeps the file open between its reads, nullptr if it is opened and closed by each read.
+    TableCache *tableCache;
 
     /**
-     * Gets the the pageId of a page of a file to use as a key in the buffer pool.
+     * Gets the the pageId of a page of a file to use as a key in the buffer pool. The number of
+     * the file tells it apart from any other file, even one of the same name, and keeps the ID
+     * short enough for std::string to hold it without allocating.
      *
      * @param offsetToRead
      */
-    std::string GetPageIdInBufferPool(uint64_t offsetToRead) {
-        return this->fileName + "-" + std::to_string(offsetToRead);
+    [[nodiscard]] std::string GetPageIdInBufferPool(uint64_t offsetToRead) const {
+        char pageId[2 * sizeof(uint64_t) * 2 + 2];
+        int length = std::snprintf(pageId, sizeof(pageId), "%" PRIx64 "-%" PRIx64, this->fileNumber, offsetToRead);
+        return {pageId, (size_t) length};
     }
 
-    static void WriteExtraToAlign(std::ofstream &file, uint64_t extraSpace);
+    static void WriteExtraToAlign(AlignedFileWriter &file, uint64_t extraSpace);
+
+    /**
+     * Map the whole file into memory, advised for random reads. The file stays unmapped if it
+     * cannot be mapped, and is then read with pread.
+     */
+    void MapFile();
+
+    /**
+     * Get the page at given offset of the file where it is mapped, mapping the file the first
+     * time this is called.
+     *
+     * @param offset the offset of the page in the SST file.
+     * @return the page, nullptr if the file is not read with MMAP_READS or the page is past
+     * the end of the mapping.
+     */
+    const uint64_t *GetMappedPage(uint64_t offset);
+
+    /**
+     * Advise the kernel of how the mapped pages [offset, offset + numPages) are going to be read.
+     *
+     * @param offset the offset of the first page in the SST file.
+     * @param numPages the number of pages.
+     * @param advice the madvise advice, such as MADV_SEQUENTIAL for a scan.
+     */
+    void AdviseMappedPages(uint64_t offset, uint64_t numPages, int advice);
+
+    /**
+     * Get the number of entries in a page of raw or columnar leaves, or of a binary search file,
+     * where the page is mapped, off of its header. Mapped pages are not checked against their checksum.
+     *
+     * @param page the page.
+     */
+    [[nodiscard]] size_t GetMappedPageNumEntries(const uint64_t *page) const;
+
+    /**
+     * Get the number of pages of entries of a binary search file, from its number of entries if
+     * known, or else from its data size.
+     */
+    [[nodiscard]] uint64_t GetNumBinarySearchPages() const;
 
-    void AddNextInternalLevelFenceKeys(std::vector<uint64_t> &data, int nextLevel);
+    /**
+     * Get the last page of entries of a binary search file whose first key is smaller than or
+     * equal to given key, where the file is mapped, which is the first page if there is none.
+     *
+     * @param key
+     * @param numPages the number of pages of entries of the file, all mapped.
+     */
+    uint64_t FindMappedBinarySearchPage(uint64_t key, uint64_t numPages);
 
     /**
-     * Write B-Tree internal nodes into the SST file.
+     * Write given entries as columnar leaves, each page holding the keys of its entries followed
+     * by their values after its header.
      *
      * @param file the file stream of the SST file.
+     * @param data the entries to write.
+     * @return the number of bytes written.
+     */
+    uint64_t WriteColumnarLeaves(AlignedFileWriter &file, std::vector<DataEntry_t> &data);
+
+    /**
+     * Write given words as pages of given type, as many words per page as fit after its header.
+     * The last page is padded with zeros if it is not full.
+     *
+     * @param file the file stream of the SST file.
+     * @param type what the pages hold.
+     * @param words the words to write.
+     * @param numWords the number of words to write.
+     * @param entryNumWords the number of words of each entry counted in the headers of the pages.
+     */
+    void WritePages(AlignedFileWriter &file, PageType type, const uint64_t *words, size_t numWords,
+                    size_t entryNumWords);
+
+    /**
+     * Write the key-value entries one after another as pages of ENTRIES_PAGE type.
+     */
+    void WriteEntries(AlignedFileWriter &file, std::vector<DataEntry_t> &data);
+
+    /**
+     * Whether given page read off of the file starts with a header and matches its checksum, if
+     * it has one. A page that does not match its checksum is reported as corrupt.
+     *
+     * @param page the page.
+     * @param pageNumWords the number of words of the page.
+     */
+    static bool IsPageIntact(const uint64_t *page, size_t pageNumWords);
+
+    /**
+     * Get the type of the pages of leaves of given format.
+     */
+    static PageType GetLeafPageType(LeafFormat leafFormat);
+
+    /**
+     * Whether given page read off of the file is an intact leaf of given format, see IsPageIntact.
+     */
+    static bool IsLeafPageIntact(const uint64_t *page, size_t pageNumWords, LeafFormat leafFormat);
+
+    /**
+     * Widen the key range of the file to include the given entries, which are sorted by key,
+     * and count them in the number of entries of the file.
+     */
+    void UpdateKeyRange(std::vector<DataEntry_t> &data);
+
+    /**
+     * Write the last page of the file, of METADATA_PAGE type, holding given metadata and ending
+     * with the footer of the file, which holds its key range and number of entries.
+     *
+     * @param file the file stream of the SST file, at the start of a page.
+     * @param metaData the words of metadata.
+     */
+    void WriteMetaDataPage(AlignedFileWriter &file, const std::vector<uint64_t> &metaData);
+
+    /**
+     * Write a page ending with the footer of the file after the pages of entries of a binary search SST file.
+     *
+     * @param file the file stream of the SST file.
+     */
+    void WriteBinarySearchFooter(AlignedFileWriter &file);
+
+    /**
+     * Read the footer at the end of a SST file, without knowing its page size beforehand.
+     *
+     * @param fd the file descriptor of the SST file.
+     * @param footer set to the FOOTER_NUM_WORDS words of the footer.
+     * @param fileByteSize set to the size of the file in bytes.
+     * @return true if the file ends with a footer of FORMAT_VERSION and of a valid page size, false otherwise.
+     */
+    static bool ReadFooterOfFile(int fd, uint64_t *footer, uint64_t &fileByteSize);
+
+    /**
+     * Read the key range, number of entries and page size of the file off of the footer at the
+     * end of the file. If the file does not end with a footer, the file is taken to hold keys of
+     * any range, so that it is never skipped, and to have pages of the size it was created with.
+     *
+     * @param fd the file descriptor of the SST file.
+     * @return true if the footer was read, false otherwise.
+     */
+    bool ReadFooter(int fd);
+
+    /**
+     * Pad the page the file stream is in, so that the next write starts a page.
+     *
+     * @param file the file stream of the SST file.
+     */
+    void WriteExtraToAlignPage(AlignedFileWriter &file) const;
+
+    /**
+     * Add the fence key of a leaf to the fence keys the internal levels are built from, and to
+     * the learned index if the file has one.
+     */
+    void AddLeafFenceKey(uint64_t key);
+
+    /**
+     * End the leaves of the B-Tree file: write an empty leaf if there are no entries, and keep
+     * where the leaves end.
+     *
+     * @param file the file stream of the SST file.
+     */
+    void WriteEndOfLeaves(AlignedFileWriter &file);
+
+    /**
+     * Write the internal levels of the B-Tree after the leaves, from the level right above the
+     * leaves up to the root. Each level holds the largest key of each page of the level below.
+     *
+     * @param file the file stream of the SST file.
+     */
+    void WriteBTreeInternalLevels(AlignedFileWriter &file);
+
+    /**
+     * Write the page of B-Tree structure metadata, ending with the footer, as the last page of the SST file.
+     *
+     * @param file the file stream of the SST file.
+     */
+    void WriteBTreeMetaData(AlignedFileWriter &file);
+
+    /**
+     * Read the page of B-Tree structure metadata, the last page of the SST file.
+     *
+     * @param fd the file descriptor of the SST file.
+     * @param metaDataPage set to the offset of the page in the SST file.
+     * @param pageSize set to the size of the pages of the SST file, read off of its footer.
+     * @return the words of metadata of the page, empty if the file could not be read.
+     */
+    static std::vector<uint64_t> ReadBTreeMetaData(int fd, uint64_t &metaDataPage, size_t &pageSize);
+
+    /**
+     * Write the leaves of given data compressed, as many entries per page as fit. The entries
+     * that may share a page with the data written next are held back, unless it is the end of the file.
+     *
+     * @param file the file stream of the SST file.
+     * @param data the leaves data to write.
      * @param endOfFile flag to determine whether it's the end of the file or not.
      */
-    void WriteBTreeInternalLevels(std::ofstream &file, bool endOfFile);
+    void WriteCompressedLeaves(AlignedFileWriter &file, std::vector<DataEntry_t> &data, bool endOfFile);
 
     /**
-     * Write B-Tree structure metadata to the SST file.
+     * Write bloom filter data into the SST file, after the internal levels.
      *
      * @param file the file stream of the SST file.
      */
-    void WriteBTreeMetaData(std::ofstream &file);
+    void WriteBloomFilter(AlignedFileWriter &file);
 
     /**
-     * Write bloom filter data into the SST file.
+     * Write the learned index into the SST file, after the bloom filter.
      *
      * @param file the file stream of the SST file.
      */
-    void WriteBloomFilter(std::ofstream &file);
+    void WriteLearnedIndex(AlignedFileWriter &file);
 
-    std::vector<uint64_t> GetBTreeLevelOffsets(int leavesNumPages);
+    /**
+     * Get the offset of the leaf that holds the smallest key greater than or equal to given key,
+     * by searching the fence keys of the leaves within the range predicted by the learned index.
+     *
+     * @param key
+     * @param fd the file descriptor of the SST file.
+     * @param bufferPool the DB buffer pool to read the pages of fence keys through, if any.
+     */
+    uint64_t FindLeafOffsetWithLearnedIndex(uint64_t key, int fd, BufferPool *bufferPool);
+
+    /**
+     * Whether the pages of the file of given format are read straight into a frame of the
+     * buffer pool when they are not in it. Compressed leaves are decoded before they are cached,
+     * into more words than a page, so they are not.
+     */
+    bool CanReadIntoFrame(BufferPool *bufferPool, LeafFormat leafFormat) const {
+        return bufferPool != nullptr && leafFormat != LeafFormat::COMPRESSED_LEAVES &&
+               this->pageSize <= bufferPool->GetFrameSize();
+    }
+
+    /**
+     * Insert a page read into a frame of the buffer pool as it is in the frame, past its header
+     * unless it is a columnar leaf. The frame is given back if the page is not intact.
+     *
+     * @param pageId the page ID of the page in buffer pool.
+     * @param frame the frame the page was read into.
+     * @param bytesRead the number of bytes read into the frame.
+     * @param bufferPool the buffer pool.
+     * @param leafFormat the format of the page if it is a B-Tree leaf.
+     * @return a handle to the page, which refers to no page if it is not intact.
+     */
+    PageHandle InsertPageReadIntoFrame(const std::string &pageId, uint64_t *frame, ssize_t bytesRead,
+                                       BufferPool *bufferPool, LeafFormat leafFormat);
 
     /**
      * Try to obtain page from buffer pool with given page ID. If page isn't in the buffer
@@ -80,12 +383,14 @@ private:
      * @param fd the file description of SST file containing the page.
      * @param offset the offset of the page in the SST file.
      * @param bufferPool the buffer pool.
-     * @return a vector containing the page data.
+     * @param leafFormat the format of the page if it is a B-Tree leaf, which is decoded before it is cached.
+     * @return a handle to the page data, pinned in the buffer pool if there is one, so that it is not copied.
      */
-    static std::vector<uint64_t> GetPage(const std::string &pageId, int fd, uint64_t offset, BufferPool *bufferPool);
+    PageHandle GetPage(const std::string &pageId, int fd, uint64_t offset, BufferPool *bufferPool,
+                       LeafFormat leafFormat = LeafFormat::RAW_LEAVES);
 
-    static std::vector<uint64_t> GetBloomFilterPages(const std::string &pageId, int fd, uint64_t offset,
-                                                     uint64_t numPages, BufferPool *bufferPool);
+    PageHandle GetBloomFilterPages(const std::string &pageId, int fd, uint64_t offset, uint64_t numPages,
+                                   BufferPool *bufferPool);
 
     /**
      * Read SST file to obtain given number of pages of bloom filters.
@@ -95,26 +400,52 @@ private:
      * @param numPagesToRead number of bloom filter pages to read.
      * @return bloom filter array read from the file.
      */
-    static std::vector<uint64_t> ReadBloomFilter(int fd, uint64_t offset, uint64_t numPagesToRead);
+    std::vector<uint64_t> ReadBloomFilter(int fd, uint64_t offset, uint64_t numPagesToRead);
 
     /**
-     * Searches for key in the B-Tree file given the file offset and descriptor.
+     * Searches for key in the leaf of the B-Tree file that may hold it. The leaf is found with
+     * the fence keys kept in memory, so this reads one page at most.
      *
      * @param fd the file descriptor of the B-Tree SST file.
      * @param key the key to search for.
      * @param bufferPool the DB buffer pool.
-     * @param levelsPageOffsets the file offsets for B-Tree levels.
      * @return the value if key is found, INVALID_VALUE is not.
      */
-    uint64_t FindKeyInBTree(int fd, uint64_t key, BufferPool *bufferPool, std::vector<uint64_t> &levelsPageOffsets);
+    uint64_t FindKeyInBTree(int fd, uint64_t key, BufferPool *bufferPool);
+
+    /**
+     * Scans for the entries whose key is within the range of [key1 and key2] in the leaves of the
+     * B-Tree file where they are mapped.
+     *
+     * @param key1 the lower bound of scan result.
+     * @param key2 the upper bound of scan result.
+     * @param scanResult the vector to put scan results in.
+     */
+    void ScanMappedLeaves(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult);
 
 public:
-    // Size of one page of memory
+    // Default size of one page of a file, and the number of key-value pairs and of keys it holds
+    // after its header. Each file has its own page size, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE.
     static const size_t PAGE_SIZE = 4096;
     static const size_t KV_PAIR_BYTE_SIZE = 16;
     static const size_t KEY_BYTE_SIZE = 8;
-    static const size_t KV_PAIRS_PER_PAGE = PAGE_SIZE / 16;
-    static const size_t KEYS_PER_PAGE = PAGE_SIZE / 8;
+    static const size_t KEYS_PER_PAGE = PAGE_SIZE / KEY_BYTE_SIZE - PageHeader::NUM_WORDS;
+    static const size_t KV_PAIRS_PER_PAGE = KEYS_PER_PAGE / 2;
+    // Pages stay aligned for O_DIRECT, which is what the smallest page size is bound by.
+    static const size_t MIN_PAGE_SIZE = AlignedFileWriter::ALIGNMENT;
+    static const size_t MAX_PAGE_SIZE = 64 * 1024;
+    // The first word of the B-Tree metadata page, the last page of the file, holds the number of levels,
+    // and the leaf format above them.
+    static const uint64_t NUM_LEVELS_MASK = 0xFFFFFFFF;
+    static const uint64_t LEAF_FORMAT_SHIFT = 32;
+    // The footer at the end of the last page of the file, which is the metadata page of B-Tree files:
+    // | smallest key | largest key | number of entries | page size | format version | FOOTER_MAGIC |
+    // Files of another format version, or written before the footer had one, are not read.
+    static const size_t FOOTER_NUM_WORDS = 6;
+    static const uint64_t FOOTER_MAGIC = 0x535354464F4F5456; // "SSTFOOTV"
+    static const uint64_t FORMAT_VERSION = 1;
+    // Number of pages of entries buffered in memory while a file is written from an iterator.
+    static const int DEFAULT_WRITE_BUFFER_NUM_PAGES = 4;
 
     /**
      * Constructor for a SST object.
@@ -122,22 +453,82 @@ public:
      * @param fileName the name of the SST file.
      * @param fileDataByteSize the size of the file in bytes.
      * @param bloomFilter the bloom filter associated with the SST file.
+     * @param pageSize the size of the pages of the file to write, see IsValidPageSize. An existing
+     * file is read with the page size recorded in its footer instead.
      */
-    explicit SST(std::string &fileName, uint64_t fileDataByteSize = 0, BloomFilter *bloomFilter = nullptr);
+    explicit SST(std::string &fileName, uint64_t fileDataByteSize = 0, BloomFilter *bloomFilter = nullptr,
+                 size_t pageSize = SST::PAGE_SIZE);
 
-    ~SST() {
-        delete this->bloomFilter;
-        for (auto bTreeLevel: this->bTreeLevels) {
-            delete bTreeLevel;
-        }
-        this->bTreeLevels.clear();
-    }
+    ~SST();
+
+    /**
+     * Whether given page size can be used for the pages of a file: a power of two between
+     * MIN_PAGE_SIZE and MAX_PAGE_SIZE.
+     *
+     * @param pageSize the page size in bytes.
+     */
+    static bool IsValidPageSize(size_t pageSize);
+
+    /**
+     * Get the size of the pages of the SST file in bytes.
+     */
+    [[nodiscard]] size_t GetPageSize() const;
+
+    /**
+     * Get the number of key-value pairs a page of the SST file holds uncompressed.
+     */
+    [[nodiscard]] size_t GetKVPairsPerPage() const;
+
+    /**
+     * Set whether the pages of the SST file get a checksum in their header, before it is written.
+     * The checksums are checked when the pages are read with pread, but not where they are mapped.
+     *
+     * @param newUsePageChecksums
+     */
+    void SetPageChecksums(bool newUsePageChecksums);
+
+    /**
+     * Set how the pages of the SST file are read, before it is first read.
+     *
+     * @param newReadMode the read mode.
+     */
+    void SetReadMode(SSTReadMode newReadMode);
+
+    /**
+     * Get how the pages of the SST file are read.
+     */
+    [[nodiscard]] SSTReadMode GetReadMode() const;
+
+    /**
+     * Set the table cache keeping the SST file open between its reads. The file is erased from
+     * the cache once the SST object is deleted.
+     *
+     * @param newTableCache the table cache, not owned by the SST object, nullptr to open and
+     * close the file on each read.
+     */
+    void SetTableCache(TableCache *newTableCache);
+
+    /**
+     * Get a file descriptor of the SST file to read it with, from the table cache if any.
+     *
+     * @return the file descriptor, -1 if the file could not be opened.
+     */
+    int AcquireFile();
+
+    /**
+     * Release a file descriptor got from AcquireFile, which closes it unless the table cache
+     * keeps it open.
+     *
+     * @param fd the file descriptor.
+     */
+    void ReleaseFile(int fd);
 
     /**
      * Get the file name of the SST file.
      */
     std::string GetFileName();
 
+
     /**
      * Get the data size of the SST file in bytes.
      */
@@ -150,6 +541,60 @@ public:
      */
     void SetFileDataSize(uint64_t fileDataByteSize);
 
+    /**
+     * Get the smallest key written to the SST file, Utils::INVALID_VALUE if the file is empty.
+     */
+    [[nodiscard]] uint64_t GetMinKey() const;
+
+    /**
+     * Get the largest key written to the SST file.
+     */
+    [[nodiscard]] uint64_t GetMaxKey() const;
+
+    /**
+     * Get the number of key-value entries written to the SST file.
+     */
+    [[nodiscard]] uint64_t GetNumEntries() const;
+
+    /**
+     * Read the key range and number of entries of an existing binary search SST file off of its
+     * footer, and leave the footer page out of the data size of the file. B-Tree SST files read
+     * theirs in LoadBTreeIndex.
+     *
+     * @return true if the footer was read, false if the file has none of FORMAT_VERSION, in which
+     * case its pages can not be told to start with a header and the file is not to be read.
+     */
+    bool LoadBinarySearchFooter();
+
+    /**
+     * Whether the SST file has keys within the range of [key1, key2]. This only uses the key
+     * range kept in memory, so that files can be skipped without any I/O.
+     *
+     * @param key1 the lower bound of the range.
+     * @param key2 the upper bound of the range.
+     */
+    [[nodiscard]] bool OverlapsRange(uint64_t key1, uint64_t key2) const;
+
+    /**
+     * Get the range tombstones of the SST file, which hide keys in the older SST files.
+     */
+    [[nodiscard]] const RangeTombstones &GetRangeTombstones() const;
+
+    /**
+     * Set the range tombstones of the SST file.
+     *
+     * @param newRangeTombstones
+     */
+    void SetRangeTombstones(const RangeTombstones &newRangeTombstones);
+
+    /**
+     * Move the SST file to a new path on disk.
+     *
+     * @param newFileName the new path of the SST file.
+     * @return true if the file was moved, false otherwise.
+     */
+    bool MoveFile(const std::string &newFileName);
+
     /**
      * Get the input buffer reader of the SST file.
      */
@@ -168,6 +613,13 @@ public:
      */
     [[nodiscard]] uint64_t GetMaxOffsetToReadLeaves() const;
 
+    /**
+     * Get the largest number of bytes the SST file can take once written, from its data size
+     * and, if it is a B-Tree file, from the B-Tree levels and the bloom filter such data takes.
+     * The learned index is left out. Used to allocate the file up front.
+     */
+    [[nodiscard]] uint64_t GetMaxFileByteSize() const;
+
     /**
      * Get the scan input buffer reader of the SST file.
      */
@@ -181,27 +633,44 @@ public:
     void SetScanInputReader(ScanInputReader *scanInputReader);
 
     /**
-     * Set up the SST file for B-Tree data structure.
+     * Set up the SST file to be written as a B-Tree file. The file is written in one pass, the
+     * leaves first, so the number of entries does not have to be known up front.
+     *
+     * @param newLeafFormat how to lay out the key-value pairs in the leaves.
+     * @param newHasLearnedIndex whether to fit a learned index over the fence keys of the leaves
+     * and store it in the file, as LEARNED_INDEX files do.
      */
-    void SetupBTreeFile();
+    void SetupBTreeFile(LeafFormat newLeafFormat = LeafFormat::RAW_LEAVES, bool newHasLearnedIndex = false);
 
     /**
-     * Write a B-Tree level into the SST file.
+     * Whether the leaves of the B-Tree SST file are found with a learned index.
+     */
+    [[nodiscard]] bool HasLearnedIndex() const;
+
+    /**
+     * Get how the key-value pairs are laid out in the leaves of the B-Tree SST file.
+     */
+    [[nodiscard]] LeafFormat GetLeafFormat() const;
+
+    /**
+     * Write the leaves of given data at the end of the SST file, and keep their fence keys.
      *
      * @param file the file stream of the SST file.
-     * @param data the level data to write.
-     * @param endOfFile flag to determine whether it's the end of the file or not.
+     * @param data the entries to write, the first one starting a leaf.
+     * @param endOfFile flag to determine whether these are the last entries of the file or not.
      */
-    void WriteBTreeLevels(std::ofstream &file, std::vector<DataEntry_t> &data, bool endOfFile);
+    void WriteBTreeLevels(AlignedFileWriter &file, std::vector<DataEntry_t> &data, bool endOfFile);
 
     /**
-     * Write the end of the B-Tree SST file including B-Tree metadata and bloom filter.
+     * Write the end of the B-Tree SST file after its leaves: the internal levels, the bloom
+     * filter, the learned index and the metadata page.
      *
-     * Clears bloom filter array afterwards to free up unused memory.
+     * Clears bloom filter array afterwards to free up unused memory, and loads the B-Tree index
+     * of the finished file.
      *
      * @param file the file stream of the SST file.
      */
-    void WriteEndOfBTreeFile(std::ofstream &file);
+    void WriteEndOfBTreeFile(AlignedFileWriter &file);
 
     /**
      * Write given key-value data into a SST file with given fileName.
@@ -211,21 +680,225 @@ public:
      * @param searchType the search type of the file (binary search or B-Tree search)
      * @param endOfFile flag to determine whether it's the end of the file or not.
      */
-    void WriteFile(std::ofstream &file, std::vector<DataEntry_t> &data, SearchType searchType, bool endOfFile);
+    void WriteFile(AlignedFileWriter &file, std::vector<DataEntry_t> &data, SearchType searchType, bool endOfFile);
+
+    /**
+     * Write all the key-value entries of given iterator into the SST file in one pass,
+     * holding at most <bufferNumPages> pages of entries in memory at a time. The keys are
+     * also added to the bloom filter of the file if it has one.
+     *
+     * @param file the file stream of the SST file.
+     * @param iterator the iterator over the entries to write, in ascending key order.
+     * @param searchType the search type of the file (binary search or B-Tree search)
+     * @param bufferNumPages the number of pages of entries to buffer before writing them.
+     */
+    void WriteFile(AlignedFileWriter &file, EntryIterator *iterator, SearchType searchType,
+                   int bufferNumPages = SST::DEFAULT_WRITE_BUFFER_NUM_PAGES);
 
     /**
      * Read pages of data off of file with given file descriptor at given offset and
-     * number of pages to read.
+     * number of pages to read, without their headers. Each page holds as many words as its
+     * header tells, and the pages read end at the first one that does not start with a header,
+     * does not match its checksum, or is of another type than the first one.
      *
      * @param fd the file description of SST file containing the page.
      * @param offset the offset of the page in the SST file.
      * @param numPagesToRead number of pages to read from the file.
-     * @return a vector containing the page data read from file.
+     * @param pageSize the size of the pages of the SST file.
+     * @return a vector containing the page data read from file, one page after another.
+     */
+    static std::vector<uint64_t> ReadPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead = 1,
+                                                 size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Read leaves of a B-Tree file with given file descriptor at given offset and number of
+     * pages to read, as keys and values one after another whatever the format of the leaves.
+     *
+     * @param fd the file description of SST file containing the leaves.
+     * @param offset the offset of the first leaf in the SST file.
+     * @param numPagesToRead number of leaves to read from the file.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     * @return a vector containing the key-value pairs of the leaves.
      */
-    static std::vector<uint64_t> ReadPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead = 1);
+    static std::vector<uint64_t> ReadLeafPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead,
+                                                     LeafFormat leafFormat, size_t pageSize = SST::PAGE_SIZE);
 
     /**
-     * Read SST file to obtain B-Tree level offsets metadata.
+     * Read leaves of a B-Tree file as ReadLeafPagesOfFile does, taking them from given prefetcher
+     * if it has read them ahead, and have it read the leaves right after them ahead.
+     *
+     * @param fd the file description of SST file containing the leaves.
+     * @param offset the offset of the first leaf in the SST file.
+     * @param numPagesToRead number of leaves to read from the file.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     * @param prefetcher the prefetcher of the leaves.
+     * @param numPagesToPrefetch number of leaves to read ahead after the ones read, if any.
+     * @return a vector containing the key-value pairs of the leaves.
+     */
+    static std::vector<uint64_t> ReadLeafPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead,
+                                                     LeafFormat leafFormat, size_t pageSize,
+                                                     PagePrefetcher *prefetcher, uint64_t numPagesToPrefetch);
+
+    /**
+     * Decode leaves read off of a B-Tree file into keys and values one after another, as
+     * ReadLeafPagesOfFile returns them. Columnar leaves are kept as they are, headers included.
+     * The leaves decoded end at the first page that is not an intact leaf of given format.
+     *
+     * @param pages the leaves as they are on disk.
+     * @param bytesRead the number of bytes of the leaves that were read.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     * @return a vector containing the key-value pairs of the leaves.
+     */
+    static std::vector<uint64_t> DecodeLeafPages(const uint64_t *pages, ssize_t bytesRead, LeafFormat leafFormat,
+                                                 size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Get the key of the entry at given index of leaves read by ReadLeafPagesOfFile.
+     *
+     * @param leaves the leaves.
+     * @param index the index of the entry in the leaves.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     */
+    static uint64_t GetLeafKey(const std::vector<uint64_t> &leaves, size_t index, LeafFormat leafFormat,
+                               size_t pageSize = SST::PAGE_SIZE) {
+        return SST::GetLeafKey(leaves.data(), index, leafFormat, pageSize);
+    }
+
+    /**
+     * Get the key of the entry at given index of leaves laid out as on disk, such as mapped pages.
+     *
+     * @param leaves the pairs of raw leaves past the header of their page, or columnar leaves headers included.
+     * @param index the index of the entry in the leaves.
+     * @param leafFormat how the key-value pairs are laid out in the leaves, raw or columnar.
+     * @param pageSize the size of the pages of the SST file.
+     */
+    static uint64_t GetLeafKey(const uint64_t *leaves, size_t index, LeafFormat leafFormat,
+                               size_t pageSize = SST::PAGE_SIZE) {
+        if (leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+            size_t pageNumWords = pageSize / SST::KEY_BYTE_SIZE;
+            size_t kvPairsPerPage = PageHeader::GetPayloadNumWords(pageNumWords) / 2;
+            return leaves[(index / kvPairsPerPage) * pageNumWords + PageHeader::NUM_WORDS + index % kvPairsPerPage];
+        }
+        return leaves[index * 2];
+    }
+
+    /**
+     * Get the value of the entry at given index of leaves read by ReadLeafPagesOfFile.
+     *
+     * @param leaves the leaves.
+     * @param index the index of the entry in the leaves.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     */
+    static uint64_t GetLeafValue(const std::vector<uint64_t> &leaves, size_t index, LeafFormat leafFormat,
+                                 size_t pageSize = SST::PAGE_SIZE) {
+        return SST::GetLeafValue(leaves.data(), index, leafFormat, pageSize);
+    }
+
+    /**
+     * Get the value of the entry at given index of leaves laid out as on disk, such as mapped pages.
+     *
+     * @param leaves the pairs of raw leaves past the header of their page, or columnar leaves headers included.
+     * @param index the index of the entry in the leaves.
+     * @param leafFormat how the key-value pairs are laid out in the leaves, raw or columnar.
+     * @param pageSize the size of the pages of the SST file.
+     */
+    static uint64_t GetLeafValue(const uint64_t *leaves, size_t index, LeafFormat leafFormat,
+                                 size_t pageSize = SST::PAGE_SIZE) {
+        if (leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+            size_t pageNumWords = pageSize / SST::KEY_BYTE_SIZE;
+            size_t kvPairsPerPage = PageHeader::GetPayloadNumWords(pageNumWords) / 2;
+            return leaves[(index / kvPairsPerPage) * pageNumWords + PageHeader::NUM_WORDS + kvPairsPerPage +
+                          index % kvPairsPerPage];
+        }
+        return leaves[index * 2 + 1];
+    }
+
+    /**
+     * Get the number of entries in leaves read by ReadLeafPagesOfFile.
+     *
+     * @param leaves the leaves.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     */
+    static size_t GetLeafNumEntries(const std::vector<uint64_t> &leaves, LeafFormat leafFormat,
+                                    size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Get the number of entries in leaves read by ReadLeafPagesOfFile, wherever they are kept.
+     *
+     * @param leaves the leaves.
+     * @param numWords the number of words of the leaves.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param pageSize the size of the pages of the SST file.
+     */
+    static size_t GetLeafNumEntries(const uint64_t *leaves, size_t numWords, LeafFormat leafFormat,
+                                    size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Search for given key in leaves read by ReadLeafPagesOfFile, directly in their layout.
+     *
+     * @param leaves the leaves.
+     * @param numEntries the number of entries in the leaves.
+     * @param key the key to search for.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param startIndex the index of the entry to start searching from.
+     * @param pageSize the size of the pages of the SST file.
+     * @return the index of the entry holding the key if found, or of the first entry with a
+     * greater key, which is numEntries if there is none.
+     */
+    static size_t FindKeyInLeaves(const std::vector<uint64_t> &leaves, size_t numEntries, uint64_t key,
+                                  LeafFormat leafFormat, size_t startIndex = 0, size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Search for given key in leaves laid out as on disk, such as mapped pages, directly in their layout.
+     *
+     * @param leaves the pairs of raw leaves past the header of their page, or columnar leaves headers included.
+     * @param numEntries the number of entries in the leaves.
+     * @param key the key to search for.
+     * @param leafFormat how the key-value pairs are laid out in the leaves.
+     * @param startIndex the index of the entry to start searching from.
+     * @param pageSize the size of the pages of the SST file.
+     * @return the index of the entry holding the key if found, or of the first entry with a
+     * greater key, which is numEntries if there is none.
+     */
+    static size_t FindKeyInLeaves(const uint64_t *leaves, size_t numEntries, uint64_t key,
+                                  LeafFormat leafFormat, size_t startIndex = 0, size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Read the B-Tree metadata and the fence keys of the leaves off of the SST file, and keep
+     * them in memory for the lifetime of the SST object, so that point lookups and scans
+     * don't go through the internal levels of the file. Files with a learned index keep the
+     * learned index in memory instead of the fence keys. Called once the file is written,
+     * or when an existing file is opened.
+     *
+     * @return true if the index was loaded, false if the file could not be read.
+     */
+    bool LoadBTreeIndex();
+
+    /**
+     * Get the number of bytes of memory taken by the B-Tree index kept in memory.
+     */
+    [[nodiscard]] size_t GetIndexMemoryUsage() const;
+
+    /**
+     * Get the offset of the leaf page of the B-Tree file that holds the smallest key greater
+     * than or equal to given key, using the B-Tree index kept in memory. If every key of the
+     * file is smaller, it is the offset right after the last leaf.
+     *
+     * @param key
+     * @param fd the file descriptor of the SST file, which files with a learned index read a
+     * few fence keys from. The file is opened if it is -1.
+     * @param bufferPool the DB buffer pool, if any.
+     */
+    uint64_t FindLeafOffset(uint64_t key, int fd = -1, BufferPool *bufferPool = nullptr);
+
+    /**
+     * Read SST file to obtain B-Tree level offsets metadata, from the root level to the leaves.
      *
      * @param fd the SST file descriptor.
      * @return a vector containing the B-Tree level offsets metadata.
@@ -251,6 +924,19 @@ public:
      */
     uint64_t PerformBTreeSearch(uint64_t key, BufferPool *bufferPool, bool isLSMTree);
 
+    /**
+     * Queries for the values of given keys using B-Tree search. The leaves holding the keys are
+     * found first, and then all read at once with given async reader, one read per leaf.
+     *
+     * @param keys the keys to search for.
+     * @param values set to the value of each key, INVALID_VALUE for the keys not found.
+     * @param bufferPool the DB buffer pool.
+     * @param isLSMTree flag to determine whether DB is using LSM-Tree or not.
+     * @param asyncReader the reader of the leaves, the keys being searched one by one if it is nullptr.
+     */
+    void PerformBTreeMultiSearch(const std::vector<uint64_t> &keys, std::vector<uint64_t> &values,
+                                 BufferPool *bufferPool, bool isLSMTree, AsyncReader *asyncReader);
+
     /**
      * Scans for data whose key is within the range of [key1 and key2] using binary search.
      *
@@ -260,24 +946,17 @@ public:
      */
     void PerformBinaryScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult);
 
-    /**
-     * Read SST file to obtain starting offset in leaves level in B-Tree structure for
-     * scan operation.
-     *
-     * @param fd the file descriptor of the SST file.
-     * @param key1 the starting range of scan operation.
-     * @return the offset in leaves level in B-Tree in which scan operation begins.
-     */
-    static uint64_t ReadBTreeScanLeavesRange(int fd, uint64_t key1);
-
     /**
      * Scans for data whose key is within the range of [key1 and key2] using B-Tree search.
      *
      * @param key1 the lower bound of scan result.
      * @param key2 the upper bound of scan result.
      * @param scanResult the vector to put scan results in.
+     * @param asyncReader the reader to read each leaf ahead with while the one before it is
+     * scanned, if any.
      */
-    void PerformBTreeScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult);
+    void PerformBTreeScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult,
+                          AsyncReader *asyncReader = nullptr);
 };
 
 #endif // CSC443_PROJECT_SST_H
@@ -0,0 +1,77 @@
+#ifndef CSC443_PROJECT_SSTWRITER_H
+#define CSC443_PROJECT_SSTWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SST.h"
+#include "BloomFilter.h"
+#include "Utils.h"
+
+/**
+ * Class building a B-Tree SST file with a bloom filter, laid out exactly like the files
+ * of the LSM-Tree, straight from a stream of key-value pairs sorted by key. Only a few
+ * pages of pairs are held in memory at a time.
+ *
+ * The file is written from start to end. The number of pairs has to be known up front
+ * only to size the bloom filter, and to check that they were all added. The finished file can be linked into a Db with Db::IngestFile.
+ */
+class SSTWriter {
+private:
+    SST *sstFile;
+    BloomFilter *bloomFilter;
+    AlignedFileWriter *file;
+    std::vector<DataEntry_t> buffer;
+    size_t bufferCapacity;
+    uint64_t numEntries;
+    uint64_t numEntriesAdded;
+    uint64_t lastKey;
+    bool hasError;
+
+    /**
+     * Write the buffered pairs to the file.
+     */
+    void WriteBuffer();
+
+public:
+    /**
+     * Constructor for a SSTWriter object. Creates the file at given path.
+     *
+     * @param filePath the path of the SST file to create.
+     * @param numEntries the exact number of key-value pairs that will be added.
+     * @param bloomFilterBitsPerEntry the number of bits in filter array used by each entry.
+     * @param bufferNumPages the number of pages of pairs to buffer before writing them.
+     * @param leafFormat how to lay out the key-value pairs in the leaves.
+     * @param useDirectWrites whether to write the file with O_DIRECT.
+     * @param pageSize the size of the pages of the file, in bytes. A power of two between
+     * SST::MIN_PAGE_SIZE and SST::MAX_PAGE_SIZE.
+     */
+    SSTWriter(const std::string &filePath, uint64_t numEntries, int bloomFilterBitsPerEntry,
+              int bufferNumPages = SST::DEFAULT_WRITE_BUFFER_NUM_PAGES,
+              LeafFormat leafFormat = LeafFormat::RAW_LEAVES, bool useDirectWrites = false,
+              size_t pageSize = SST::PAGE_SIZE);
+
+    /**
+     * Removes the file if it was not finished.
+     */
+    ~SSTWriter();
+
+    /**
+     * Add the next key-value pair to the file. Keys must be added in strictly ascending order.
+     *
+     * @param key
+     * @param value
+     * @return true if the pair was added, false if it is out of order, uses a reserved value,
+     * or is one more than the announced number of pairs.
+     */
+    bool Add(uint64_t key, uint64_t value);
+
+    /**
+     * Write the end of the file, once all the announced pairs are added.
+     *
+     * @return the SST file, owned by the caller, or nullptr if the file could not be written.
+     */
+    SST *Finish();
+};
+
+#endif // CSC443_PROJECT_SSTWRITER_H
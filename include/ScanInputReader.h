@@ -5,6 +5,7 @@
 #include <vector>
 #include <queue>
 #include "SST.h"
+#include "AsyncReader.h"
 #include "Utils.h"
 
 /**
@@ -15,24 +16,37 @@ private:
     std::vector<uint64_t> inputBuffer;
     uint64_t offsetToRead;
     uint64_t bufferCapacity;
-    std::vector<uint64_t> keys;
-    int startIndex;
+    uint64_t numEntries;
+    uint64_t startIndex;
     uint64_t endOffsetToScan;
     bool isScannedCompletely;
+    LeafFormat leafFormat;
+    size_t pageSize;
+    // Reads the next pages of the leaves to scan ahead while the ones in the buffer are scanned, if set.
+    PagePrefetcher *prefetcher;
 
     void ReadDataPagesIntoBuffer(int fd);
 
-    void SetKeys();
-
 public:
     /**
      * Constructor for a ScanInputReader object.
      *
      * @param capacity the capacity of the buffer (in number of pages).
+     * @param leafFormat how the key-value pairs are laid out in the leaves of the file.
+     * @param pageSize the size of the pages of the file, in bytes.
      */
-    explicit ScanInputReader(uint64_t capacity);
+    explicit ScanInputReader(uint64_t capacity, LeafFormat leafFormat = LeafFormat::RAW_LEAVES,
+                             size_t pageSize = SST::PAGE_SIZE);
+
+    ~ScanInputReader();
 
-    ~ScanInputReader() = default;
+    /**
+     * Read the next pages of the leaves to scan ahead with given async reader from now on,
+     * while the pages in the buffer are scanned.
+     *
+     * @param asyncReader the async reader, not owned by the scan input reader.
+     */
+    void SetAsyncReader(AsyncReader *asyncReader);
 
     [[nodiscard]] bool IsLeavesRangeToScanSet() const;
 
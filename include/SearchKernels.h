@@ -0,0 +1,74 @@
+#ifndef CSC443_PROJECT_SEARCHKERNELS_H
+#define CSC443_PROJECT_SEARCHKERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+enum SearchKernel {
+    SCALAR_KERNEL,
+    SSE42_KERNEL,
+    AVX2_KERNEL
+};
+
+/**
+ * Class searching sorted arrays of keys, such as the fence keys of the B-Tree leaves and the
+ * keys of a leaf, with the vector instructions of the CPU it runs on.
+ *
+ * A search halves the range holding the key without branching until it fits in a few cache
+ * lines (LINEAR_SEARCH_NUM_KEYS keys), then counts the keys of that range that are smaller
+ * than the key, comparing four (AVX2) or two (SSE4.2) keys at once. The kernel is picked once,
+ * the first time it is needed, among the ones the CPU supports.
+ */
+class SearchKernels {
+private:
+    static SearchKernel DetectBestKernel();
+
+public:
+    // The number of keys, 4 cache lines worth, left to compare one after another.
+    static const size_t LINEAR_SEARCH_NUM_KEYS = 32;
+
+    /**
+     * Get the fastest kernel the CPU supports.
+     */
+    static SearchKernel GetBestKernel();
+
+    /**
+     * Whether the CPU supports given kernel.
+     *
+     * @param kernel
+     */
+    static bool IsKernelSupported(SearchKernel kernel);
+
+    /**
+     * Get the index of the first key that is not smaller than given key, as std::lower_bound would.
+     *
+     * @param keys the keys, in ascending order.
+     * @param numKeys the number of keys.
+     * @param key the key to look for.
+     * @return the index of the first key not smaller than key, or numKeys if there is none.
+     */
+    static size_t LowerBound(const uint64_t *keys, size_t numKeys, uint64_t key);
+
+    /**
+     * Same as LowerBound, with given kernel, which the CPU must support.
+     */
+    static size_t LowerBound(const uint64_t *keys, size_t numKeys, uint64_t key, SearchKernel kernel);
+
+    /**
+     * Get the index of the first entry whose key is not smaller than given key, in entries laid
+     * out as keys and values one after another, as in a raw leaf.
+     *
+     * @param entries the entries, in ascending key order.
+     * @param numEntries the number of entries, which is half the number of words.
+     * @param key the key to look for.
+     * @return the index of the first entry with a key not smaller than key, or numEntries if there is none.
+     */
+    static size_t LowerBoundInPairs(const uint64_t *entries, size_t numEntries, uint64_t key);
+
+    /**
+     * Same as LowerBoundInPairs, with given kernel, which the CPU must support.
+     */
+    static size_t LowerBoundInPairs(const uint64_t *entries, size_t numEntries, uint64_t key, SearchKernel kernel);
+};
+
+#endif // CSC443_PROJECT_SEARCHKERNELS_H
@@ -0,0 +1,154 @@
+#ifndef CSC443_PROJECT_SKIPLIST_H
+#define CSC443_PROJECT_SKIPLIST_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Arena.h"
+#include "EntryIterator.h"
+#include "MemtableIndex.h"
+#include "Utils.h"
+
+/**
+ * Class representing a lock-free concurrent Skip List data structure.
+ *
+ * Any number of threads can insert and read at the same time. Nodes are linked into
+ * each level with a compare-and-swap, bottom level first, so a node is visible to
+ * readers as soon as it is linked into the bottom level. Nodes are never removed
+ * individually, they are released all together through the arena.
+ */
+class SkipList : public MemtableIndex {
+private:
+    struct SkipListNode {
+        uint64_t key;
+        std::atomic<uint64_t> value;
+        // The node is allocated with enough room for one next pointer per level it is linked in.
+        std::atomic<SkipListNode *> next[1];
+
+        SkipListNode *GetNext(int level) {
+            return this->next[level].load(std::memory_order_acquire);
+        }
+    };
+
+    Arena *arena;
+    char *headMemory;
+    SkipListNode *head;
+    std::atomic<int> maxHeight;
+    std::atomic<int> currentSize;
+
+    static size_t GetNodeSize(int height);
+
+    static SkipListNode *InitNode(char *memory, uint64_t key, uint64_t value, int height);
+
+    SkipListNode *NewNode(uint64_t key, uint64_t value, int height);
+
+    static int RandomHeight();
+
+    /**
+     * Starting from <before> on the given level, find the two adjacent nodes that
+     * <key> falls in between, i.e. prev->key < key <= next->key.
+     */
+    static void FindSpliceForLevel(uint64_t key, SkipListNode *before, int level, SkipListNode **prev,
+                                   SkipListNode **next);
+
+    /**
+     * Insert a key-value pair starting the search of each level from the given predecessors,
+     * which must all have a smaller key than <key>. On return, they are updated to be the
+     * predecessors of the next greater key.
+     */
+    bool InsertWithHint(uint64_t key, uint64_t value, SkipListNode **prev);
+
+    /**
+     * Find the first node whose key is greater than or equal to the given key.
+     */
+    SkipListNode *FindGreaterOrEqual(uint64_t key);
+
+public:
+    static const int MAX_HEIGHT = 12;
+    // A node is linked in the next level up with probability 1 / BRANCHING.
+    static const int BRANCHING = 4;
+
+    /**
+     * Iterator over the key-value pairs of the skip list in ascending key order. It only
+     * walks the bottom level, and sees nodes inserted after it was created if they come
+     * after its current position.
+     */
+    class Iterator : public EntryIterator {
+    private:
+        SkipListNode *node;
+
+    public:
+        explicit Iterator(SkipList *skipList);
+
+        [[nodiscard]] bool Valid() const override;
+
+        [[nodiscard]] DataEntry_t GetEntry() const override;
+
+        void Next() override;
+    };
+
+    /**
+     * Constructor for a SkipList object.
+     *
+     * @param arena the arena to allocate the nodes from. The skip list does not own the arena.
+     */
+    explicit SkipList(Arena *arena);
+
+    ~SkipList() override;
+
+    /**
+     * Insert a key-value pair, or overwrite the value if the key already exists.
+     * Safe to call from multiple threads at the same time.
+     *
+     * @param key
+     * @param value
+     * @return true if the key was new, false if an existing value was overwritten.
+     */
+    bool Insert(uint64_t key, uint64_t value) override;
+
+    /**
+     * Insert the key-value pairs of entries[start, end), which must be sorted by key with
+     * no duplicate keys. Each insertion resumes the search from where the previous key was
+     * linked in every level, instead of from the head. Safe to call alongside other writers,
+     * whose keys may be linked in between.
+     *
+     * @param entries the key-value pairs sorted by key.
+     * @param start the index of the first pair to insert.
+     * @param end the index after the last pair to insert.
+     */
+    void InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) override;
+
+    /**
+     * Searches for value associated with given key.
+     *
+     * @param key
+     * @return the value associated with the key, Utils::INVALID_VALUE if the key does not exist.
+     */
+    uint64_t Search(uint64_t key) override;
+
+    /**
+     * Gather all key-value pairs whose key is within the range of [key1, key2] in ascending order.
+     *
+     * @param key1 the lower bound of the scan range.
+     * @param key2 the upper bound of the scan range.
+     * @param nodesList the vector to place resulting key-value pairs in.
+     */
+    void Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) override;
+
+    EntryIterator *NewIterator() override;
+
+    /**
+     * Get the number of keys currently in the skip list.
+     */
+    [[nodiscard]] int GetCurrentSize() const override;
+
+    [[nodiscard]] bool SupportsConcurrentWrites() const override;
+
+    /**
+     * Remove all the nodes of the skip list. Not thread-safe, and it is up to the owner
+     * of the arena to reset it.
+     */
+    void Clear() override;
+};
+
+#endif // CSC443_PROJECT_SKIPLIST_H
@@ -0,0 +1,102 @@
+#ifndef CSC443_PROJECT_TABLECACHE_H
+#define CSC443_PROJECT_TABLECACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Class keeping the SST files of a Db open between the reads of them, so that a Get or a Scan
+ * does not open and close each file it reads with a system call and a path lookup each time.
+ *
+ * The files are keyed by their SST file number rather than by their name, as the files of a
+ * level are named after their position, which is taken over by the next files once they are
+ * compacted. At most capacity files are kept open, the least recently used one being closed
+ * first. A file is pinned from Acquire to Release, and is only closed once it is released.
+ *
+ * Thread-safe.
+ */
+class TableCache {
+private:
+    struct Entry {
+        uint64_t fileNumber;
+        int fd;
+        // The number of Acquire calls not released yet.
+        int numPins;
+    };
+
+    size_t capacity;
+    // The open files, from the most recently used to the least recently used.
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entryOfFile;
+    uint64_t numHits;
+    uint64_t numMisses;
+    std::mutex mutex;
+
+    /**
+     * Close the least recently used files that are not pinned, until there are at most capacity
+     * files open or they are all pinned.
+     */
+    void EvictFiles();
+
+public:
+    static const size_t DEFAULT_CAPACITY = 1000;
+
+    /**
+     * Constructor for a TableCache object.
+     *
+     * @param capacity the largest number of files kept open, more being open while they are pinned.
+     */
+    explicit TableCache(size_t capacity = TableCache::DEFAULT_CAPACITY);
+
+    /**
+     * Closes all the files. None of them must be pinned anymore.
+     */
+    ~TableCache();
+
+    /**
+     * Get the file descriptor of given file, opening the file if it is not open yet. The file
+     * stays open until it is released.
+     *
+     * @param fileNumber the number of the SST file.
+     * @param fileName the path of the file, only used to open it.
+     * @return the file descriptor, -1 if the file could not be opened.
+     */
+    int Acquire(uint64_t fileNumber, const std::string &fileName);
+
+    /**
+     * Release a file descriptor got from Acquire. It is closed if the file was erased in the meantime.
+     *
+     * @param fileNumber the number of the SST file.
+     * @param fd the file descriptor.
+     */
+    void Release(uint64_t fileNumber, int fd);
+
+    /**
+     * Close given file and forget about it, such as when it is deleted by a compaction. If it is
+     * pinned, it is closed once it is released instead.
+     *
+     * @param fileNumber the number of the SST file.
+     */
+    void Erase(uint64_t fileNumber);
+
+    /**
+     * Get the number of files kept open.
+     */
+    size_t GetNumOpenFiles();
+
+    /**
+     * Get the number of Acquire calls that found their file open.
+     */
+    uint64_t GetNumHits();
+
+    /**
+     * Get the number of Acquire calls that opened their file.
+     */
+    uint64_t GetNumMisses();
+};
+
+#endif // CSC443_PROJECT_TABLECACHE_H
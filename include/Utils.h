@@ -24,7 +24,7 @@ namespace Utils {
      * @param key the key to find
      * @return index of the key if found.
      */
-    int BinarySearch(std::vector<uint64_t> keys, uint64_t key, int startIndex = 0);
+    int BinarySearch(const std::vector<uint64_t> &keys, uint64_t key, int startIndex = 0);
 
     /**
      * Converts an integer to its binary form and taking <numBits> number
@@ -0,0 +1,164 @@
+#ifndef CSC443_PROJECT_WRITEAHEADLOG_H
+#define CSC443_PROJECT_WRITEAHEADLOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Utils.h"
+
+enum WalSyncMode {
+    SYNC_PER_WRITE = 0, // A write returns once it is on disk. Concurrent writes share one fdatasync.
+    SYNC_INTERVAL = 1, // The log is synced every DbOptions::walSyncIntervalMs in the background.
+    SYNC_NONE = 2 // Syncing is left to the OS. Survives a process crash, but not a machine crash.
+};
+
+enum WalRecordType {
+    KEY_VALUE_RECORD = 0, // Key-value pairs to put.
+    RANGE_DELETION_RECORD = 1 // The bounds of deleted key ranges, one range per pair.
+};
+
+/**
+ * A record read back from a write-ahead log.
+ */
+struct WalRecord {
+    WalRecordType type;
+    std::vector<DataEntry_t> entries;
+};
+
+/**
+ * Class representing a write-ahead log file of the database, "wal-<log number>.log" in the
+ * database directory.
+ *
+ * Each write is appended as one record holding a checksum, the type of the record, the number of
+ * key-value pairs and the key-value pairs themselves, so a batch of writes is replayed all or nothing.
+ *
+ * Records are added one by one and written together, so that a group of writes committed at once
+ * (see Db) takes a single write and a single fdatasync.
+ */
+class WriteAheadLog {
+private:
+    std::string dirPath;
+    uint64_t logNumber;
+    int fd;
+    WalSyncMode syncMode;
+    int syncIntervalMs;
+
+    // Records added since the last write.
+    std::string pendingRecords;
+
+    // Guards the file descriptor against the sync thread while the log is rolled.
+    std::mutex fileMutex;
+    // Guards the stop flag of the sync thread.
+    std::mutex mutex;
+    std::atomic<bool> hasUnsyncedWrites;
+    std::thread syncThread;
+    bool stopSyncThread;
+    std::condition_variable syncCondition;
+
+    /**
+     * Open the log file with the current log number for appending, creating it if needed.
+     */
+    void OpenLogFile();
+
+    /**
+     * Body of the sync thread in SYNC_INTERVAL mode.
+     */
+    void RunSyncThread();
+
+    /**
+     * Encode the given key-value pairs as one log record of given type and append it to <record>.
+     */
+    static void EncodeRecord(const DataEntry_t *entries, size_t numEntries, WalRecordType type, std::string &record);
+
+public:
+    static const std::string LOG_FILE_PREFIX;
+    static const std::string LOG_FILE_EXTENSION;
+    // checksum + record type + number of key-value pairs
+    static const int RECORD_HEADER_BYTE_SIZE = 24;
+
+    /**
+     * Constructor for a WriteAheadLog object. Opens, or creates, the log file with the given number.
+     *
+     * @param dirPath the directory of the database.
+     * @param logNumber the number of the log file to append to.
+     * @param syncMode when the appended records are synced to disk.
+     * @param syncIntervalMs the time between two syncs in SYNC_INTERVAL mode.
+     */
+    WriteAheadLog(const std::string &dirPath, uint64_t logNumber, WalSyncMode syncMode, int syncIntervalMs);
+
+    /**
+     * Syncs and closes the log file. The file itself is kept.
+     */
+    ~WriteAheadLog();
+
+    /**
+     * Add the given key-value pairs as one record, written by the next call to WriteRecords.
+     *
+     * @param entries the key-value pairs to log.
+     * @param numEntries the number of key-value pairs.
+     * @param type what the key-value pairs stand for.
+     */
+    void AddRecord(const DataEntry_t *entries, size_t numEntries,
+                   WalRecordType type = WalRecordType::KEY_VALUE_RECORD);
+
+    /**
+     * Write the records added since the last call with a single write, in the order they were
+     * added. Returns once they are written to the file, and synced if the sync mode is
+     * SYNC_PER_WRITE. Must not be called from multiple threads at the same time, nor alongside Roll.
+     *
+     * @return true if the records were written, false otherwise. The records are dropped either way.
+     */
+    bool WriteRecords();
+
+    /**
+     * Sync and close the current log file, and start appending to a new log file.
+     *
+     * @param newLogNumber the number of the new log file.
+     */
+    void Roll(uint64_t newLogNumber);
+
+    /**
+     * Get the number of the log file that is appended to.
+     */
+    [[nodiscard]] uint64_t GetLogNumber() const;
+
+    /**
+     * Get the path of the log file with given number.
+     *
+     * @param dirPath the directory of the database.
+     * @param logNumber
+     */
+    static std::string GetLogFilePath(const std::string &dirPath, uint64_t logNumber);
+
+    /**
+     * Get the numbers of the log files in given directory in ascending order.
+     *
+     * @param dirPath the directory of the database.
+     */
+    static std::vector<uint64_t> GetLogNumbers(const std::string &dirPath);
+
+    /**
+     * Read all the records logged in the given log file, in the order they were appended.
+     * Reading stops at the first incomplete or corrupted record, which is what a crash in
+     * the middle of an append leaves behind.
+     *
+     * @param filePath the path of the log file.
+     * @param records the vector to place the records in.
+     * @return false if the file could not be read, true otherwise.
+     */
+    static bool ReadLogFile(const std::string &filePath, std::vector<WalRecord> &records);
+
+    /**
+     * Remove the log files in given directory whose number is smaller than <minLogNumber>.
+     *
+     * @param dirPath the directory of the database.
+     * @param minLogNumber the number of the oldest log file to keep.
+     */
+    static void RemoveLogFilesBefore(const std::string &dirPath, uint64_t minLogNumber);
+};
+
+#endif // CSC443_PROJECT_WRITEAHEADLOG_H
@@ -0,0 +1,80 @@
+#ifndef CSC443_PROJECT_WRITEBATCH_H
+#define CSC443_PROJECT_WRITEBATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "Utils.h"
+
+/**
+ * Class representing a group of writes that are applied to the database together
+ * through Db::Write.
+ */
+class WriteBatch {
+public:
+    enum WriteType {
+        PUT = 0,
+        UPDATE = 1,
+        DELETE = 2
+    };
+
+    struct Write {
+        WriteType type;
+        uint64_t key;
+        uint64_t value;
+    };
+
+private:
+    std::vector<Write> writes;
+
+public:
+    /**
+     * Add the insertion of a key associated with a value to the batch.
+     *
+     * @param key
+     * @param value
+     */
+    void Put(uint64_t key, uint64_t value);
+
+    /**
+     * Add the update of an existing key to the batch. Same as Db::Update, it is only
+     * applied if the database is initialized using LSMTree data structure.
+     *
+     * @param key
+     * @param newValue
+     */
+    void Update(uint64_t key, uint64_t newValue);
+
+    /**
+     * Add the deletion of an existing key to the batch. Same as Db::Delete, it is only
+     * applied if the database is initialized using LSMTree data structure.
+     *
+     * @param key
+     */
+    void Delete(uint64_t key);
+
+    /**
+     * Remove all the writes from the batch.
+     */
+    void Clear();
+
+    /**
+     * Get the number of writes in the batch.
+     */
+    [[nodiscard]] size_t GetSize() const;
+
+    /**
+     * Get the writes of the batch in the order they were added.
+     */
+    [[nodiscard]] const std::vector<Write> &GetWrites() const;
+
+    /**
+     * Get the key-value pairs written by the batch sorted by key. If a key is written more
+     * than once, only its last write is kept. Deletes are turned into deleted key markers.
+     *
+     * @param includeUpdatesAndDeletes whether to keep the updates and deletes of the batch.
+     * @return a vector containing the key-value pairs in ascending key order.
+     */
+    [[nodiscard]] std::vector<DataEntry_t> GetSortedEntries(bool includeUpdatesAndDeletes) const;
+};
+
+#endif // CSC443_PROJECT_WRITEBATCH_H
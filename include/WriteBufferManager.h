@@ -0,0 +1,100 @@
+#ifndef CSC443_PROJECT_WRITEBUFFERMANAGER_H
+#define CSC443_PROJECT_WRITEBUFFERMANAGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+class Db;
+
+/**
+ * Class bounding the memory held by the memtables of several Db objects, in bytes.
+ *
+ * Each Db sharing the manager (see DbOptions::writeBufferManager) reports the memory held by
+ * its memtables as it changes. Once the total goes over the budget, the next writer has the
+ * largest memtable of all the Db objects flushed, and its Db gives the memory back once the
+ * memtable is in storage. This includes the memory kept by idle Db objects for their next writes.
+ *
+ * The manager must outlive the Db objects using it. All methods can be called from multiple
+ * threads at the same time.
+ */
+class WriteBufferManager {
+private:
+    size_t bufferSize;
+    std::atomic<size_t> memoryUsage;
+    // Guards the registered Db objects and the ones being flushed, but is not held during a flush.
+    std::mutex mutex;
+    std::vector<Db *> dbs;
+    // The Db objects whose memtable a writer is releasing, which are not picked again meanwhile.
+    std::vector<Db *> flushingDbs;
+    // Wakes up the Db objects waiting in UnregisterDb for their flush to finish.
+    std::condition_variable flushCondition;
+
+public:
+    /**
+     * Constructor for a WriteBufferManager object.
+     *
+     * @param bufferSize the number of bytes the memtables of all the Db objects can hold together.
+     */
+    explicit WriteBufferManager(size_t bufferSize);
+
+    WriteBufferManager(const WriteBufferManager &) = delete;
+
+    WriteBufferManager &operator=(const WriteBufferManager &) = delete;
+
+    /**
+     * Start accounting the memory of given Db. Called by the Db when it is created.
+     *
+     * @param db
+     */
+    void RegisterDb(Db *db);
+
+    /**
+     * Stop accounting the memory of given Db. Called by the Db before it is destroyed, so
+     * that it is not picked to be flushed anymore. Waits for the writers flushing it to be done.
+     *
+     * @param db
+     */
+    void UnregisterDb(Db *db);
+
+    /**
+     * Account for memory taken by a memtable.
+     *
+     * @param bytes
+     */
+    void ReserveMemory(size_t bytes);
+
+    /**
+     * Account for memory given back by a memtable.
+     *
+     * @param bytes
+     */
+    void FreeMemory(size_t bytes);
+
+    /**
+     * Whether the memtables hold more memory than the budget.
+     */
+    [[nodiscard]] bool ShouldFlush() const;
+
+    /**
+     * Flush the largest memtable of the Db objects that are not being flushed already, see
+     * Db::ReleaseMemtable. The Db is picked while holding the lock of the manager, which is
+     * released before the flush so that the writers of the other Db objects go on meanwhile.
+     * Called by the writers of the Db objects after a write, without holding any lock of their Db.
+     */
+    void FlushLargestMemtable();
+
+    /**
+     * Get the number of bytes held by the memtables of all the Db objects.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+    /**
+     * Get the number of bytes the memtables of all the Db objects can hold together.
+     */
+    [[nodiscard]] size_t GetBufferSize() const;
+};
+
+#endif // CSC443_PROJECT_WRITEBUFFERMANAGER_H
@@ -0,0 +1,188 @@
+#include "AlignedFileWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+AlignedFileWriter::AlignedFileWriter(const std::string &fileName, bool useDirectIO, uint64_t preallocateByteSize,
+                                     size_t bufferNumPages) {
+    this->fileName = fileName;
+    this->isDirectIO = useDirectIO;
+    this->hasFailed = false;
+    this->bufferNumPages = bufferNumPages > 0 ? bufferNumPages : 1;
+    this->windowByteOffset = 0;
+    this->isPageLoaded.assign(this->bufferNumPages, false);
+    this->numPagesLoaded = 0;
+    this->position = 0;
+    this->fileByteSize = 0;
+    this->writtenByteSize = 0;
+    this->numBytesWritten = 0;
+    this->numWriteCalls = 0;
+    this->buffer = static_cast<uint8_t *>(std::aligned_alloc(AlignedFileWriter::ALIGNMENT,
+                                                             this->bufferNumPages * AlignedFileWriter::ALIGNMENT));
+
+    // The partly written pages are read back, so the file is opened for reading too.
+    int flags = O_RDWR | O_CREAT | O_TRUNC;
+    this->fd = open(fileName.c_str(), flags | (useDirectIO ? O_DIRECT : 0), 0644);
+    if (this->fd == -1 && useDirectIO && errno == EINVAL) {
+        // The file system does not support O_DIRECT, such as tmpfs.
+        this->isDirectIO = false;
+        this->fd = open(fileName.c_str(), flags, 0644);
+    }
+    if (this->fd == -1) {
+        perror("fd");
+        this->hasFailed = true;
+        return;
+    }
+    if (preallocateByteSize > 0) {
+        // Only a hint, so it does not matter if the file system does not support it.
+        fallocate(this->fd, 0, 0, (off_t) preallocateByteSize);
+    }
+}
+
+AlignedFileWriter::~AlignedFileWriter() {
+    this->Close();
+    std::free(this->buffer);
+}
+
+bool AlignedFileWriter::IsGood() const {
+    return this->fd != -1 && !this->hasFailed;
+}
+
+bool AlignedFileWriter::IsDirectIO() const {
+    return this->isDirectIO;
+}
+
+void AlignedFileWriter::Seek(uint64_t byteOffset) {
+    this->position = byteOffset;
+}
+
+uint64_t AlignedFileWriter::GetPosition() const {
+    return this->position;
+}
+
+void AlignedFileWriter::LoadPage(size_t pageIndex) {
+    uint8_t *page = this->buffer + pageIndex * AlignedFileWriter::ALIGNMENT;
+    uint64_t pageByteOffset = this->windowByteOffset + pageIndex * AlignedFileWriter::ALIGNMENT;
+    ssize_t bytesRead = 0;
+    if (pageByteOffset < this->writtenByteSize) {
+        bytesRead = pread(this->fd, page, AlignedFileWriter::ALIGNMENT, (off_t) pageByteOffset);
+        if (bytesRead == -1) {
+            perror("pread");
+            this->hasFailed = true;
+            bytesRead = 0;
+        }
+    }
+    std::memset(page + bytesRead, 0, AlignedFileWriter::ALIGNMENT - bytesRead);
+}
+
+void AlignedFileWriter::Write(const void *data, uint64_t numBytes) {
+    if (this->fd == -1) {
+        return;
+    }
+    auto *bytes = static_cast<const uint8_t *>(data);
+    uint64_t windowByteSize = this->bufferNumPages * AlignedFileWriter::ALIGNMENT;
+    uint64_t windowPosition = this->position - this->windowByteOffset;
+    if (this->position >= this->windowByteOffset && windowPosition % AlignedFileWriter::ALIGNMENT > 0 &&
+        windowPosition % AlignedFileWriter::ALIGNMENT + numBytes < AlignedFileWriter::ALIGNMENT &&
+        windowPosition < windowByteSize && this->isPageLoaded[windowPosition / AlignedFileWriter::ALIGNMENT]) {
+        // Most writes are small ones within the page the previous write ended in.
+        std::memcpy(this->buffer + windowPosition, bytes, numBytes);
+        this->position += numBytes;
+        this->fileByteSize = std::max(this->fileByteSize, this->position);
+        return;
+    }
+    while (numBytes > 0) {
+        if (this->position < this->windowByteOffset || this->position >= this->windowByteOffset + windowByteSize) {
+            // Start a new window at the page of the write.
+            this->Flush();
+            this->windowByteOffset = this->position - this->position % AlignedFileWriter::ALIGNMENT;
+        }
+        uint64_t windowPosition = this->position - this->windowByteOffset;
+        size_t pageIndex = windowPosition / AlignedFileWriter::ALIGNMENT;
+        uint64_t pagePosition = windowPosition % AlignedFileWriter::ALIGNMENT;
+        uint64_t numBytesToCopy = std::min<uint64_t>(numBytes, AlignedFileWriter::ALIGNMENT - pagePosition);
+        if (!this->isPageLoaded[pageIndex]) {
+            // A page that is written whole does not need its old content.
+            if (numBytesToCopy < AlignedFileWriter::ALIGNMENT) {
+                this->LoadPage(pageIndex);
+            }
+            this->isPageLoaded[pageIndex] = true;
+            this->numPagesLoaded++;
+        }
+        std::memcpy(this->buffer + windowPosition, bytes, numBytesToCopy);
+        bytes += numBytesToCopy;
+        numBytes -= numBytesToCopy;
+        this->position += numBytesToCopy;
+        this->fileByteSize = std::max(this->fileByteSize, this->position);
+
+        // The window is written out as soon as it is full, rather than once the next write falls past it.
+        if (this->numPagesLoaded == this->bufferNumPages && this->position == this->windowByteOffset + windowByteSize) {
+            this->Flush();
+        }
+    }
+}
+
+void AlignedFileWriter::Flush() {
+    size_t pageIndex = 0;
+    while (this->numPagesLoaded > 0 && pageIndex < this->bufferNumPages) {
+        if (!this->isPageLoaded[pageIndex]) {
+            pageIndex++;
+            continue;
+        }
+        size_t runEnd = pageIndex;
+        while (runEnd < this->bufferNumPages && this->isPageLoaded[runEnd]) {
+            this->isPageLoaded[runEnd] = false;
+            runEnd++;
+        }
+        this->numPagesLoaded -= runEnd - pageIndex;
+
+        const uint8_t *run = this->buffer + pageIndex * AlignedFileWriter::ALIGNMENT;
+        uint64_t runByteSize = (runEnd - pageIndex) * AlignedFileWriter::ALIGNMENT;
+        uint64_t runByteOffset = this->windowByteOffset + pageIndex * AlignedFileWriter::ALIGNMENT;
+        uint64_t numBytesDone = 0;
+        while (numBytesDone < runByteSize) {
+            ssize_t bytesWritten = pwrite(this->fd, run + numBytesDone, runByteSize - numBytesDone,
+                                          (off_t) (runByteOffset + numBytesDone));
+            this->numWriteCalls++;
+            if (bytesWritten == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("pwrite");
+                this->hasFailed = true;
+                break;
+            }
+            numBytesDone += bytesWritten;
+        }
+        this->numBytesWritten += numBytesDone;
+        this->writtenByteSize = std::max(this->writtenByteSize, runByteOffset + runByteSize);
+        pageIndex = runEnd;
+    }
+}
+
+bool AlignedFileWriter::Close() {
+    if (this->fd == -1) {
+        return !this->hasFailed;
+    }
+    this->Flush();
+    // Drop the end of the last page, and the space allocated up front but not written.
+    if (ftruncate(this->fd, (off_t) this->fileByteSize) == -1) {
+        perror("ftruncate");
+        this->hasFailed = true;
+    }
+    close(this->fd);
+    this->fd = -1;
+    return !this->hasFailed;
+}
+
+uint64_t AlignedFileWriter::GetNumBytesWritten() const {
+    return this->numBytesWritten;
+}
+
+uint64_t AlignedFileWriter::GetNumWriteCalls() const {
+    return this->numWriteCalls;
+}
@@ -0,0 +1,81 @@
+#include "Arena.h"
+
+Arena::Arena() {
+    this->blocks = {};
+    this->currentBlock = 0;
+    this->allocPtr = nullptr;
+    this->allocBytesRemaining = 0;
+    this->largeBlocks = {};
+    this->memoryUsage = 0;
+}
+
+Arena::~Arena() {
+    for (char *block: this->blocks) {
+        delete[] block;
+    }
+    for (char *block: this->largeBlocks) {
+        delete[] block;
+    }
+}
+
+char *Arena::AllocateFallback(size_t bytes) {
+    if (bytes > Arena::BLOCK_SIZE / 4) {
+        // Give big objects their own block so that we do not waste
+        // the remaining bytes of the current block.
+        char *block = new char[bytes];
+        this->largeBlocks.push_back(block);
+        this->memoryUsage += bytes;
+        return block;
+    }
+
+    // Move on to the next block, reusing one kept from before a reset if possible.
+    if (!this->blocks.empty() && this->currentBlock + 1 < this->blocks.size()) {
+        this->currentBlock++;
+    } else {
+        this->blocks.push_back(new char[Arena::BLOCK_SIZE]);
+        this->currentBlock = this->blocks.size() - 1;
+        this->memoryUsage += Arena::BLOCK_SIZE;
+    }
+
+    char *result = this->blocks[this->currentBlock];
+    this->allocPtr = result + bytes;
+    this->allocBytesRemaining = Arena::BLOCK_SIZE - bytes;
+    return result;
+}
+
+char *Arena::AllocateAligned(size_t bytes, size_t alignment) {
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(this->allocPtr) % alignment) % alignment;
+    if (padding + bytes <= this->allocBytesRemaining) {
+        char *result = this->allocPtr + padding;
+        this->allocPtr += padding + bytes;
+        this->allocBytesRemaining -= padding + bytes;
+        return result;
+    }
+
+    // Blocks are not aligned to more than Arena::ALIGNMENT, so ask for enough bytes
+    // to be able to skip to the next aligned address.
+    char *memory = this->AllocateFallback(bytes + alignment - 1);
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(memory) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    return reinterpret_cast<char *>(aligned);
+}
+
+void Arena::Reset() {
+    for (char *block: this->largeBlocks) {
+        delete[] block;
+    }
+    this->largeBlocks.clear();
+    this->memoryUsage = this->blocks.size() * Arena::BLOCK_SIZE;
+
+    this->currentBlock = 0;
+    if (this->blocks.empty()) {
+        this->allocPtr = nullptr;
+        this->allocBytesRemaining = 0;
+    } else {
+        this->allocPtr = this->blocks[0];
+        this->allocBytesRemaining = Arena::BLOCK_SIZE;
+    }
+}
+
+size_t Arena::GetMemoryUsage() const {
+    return this->memoryUsage.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,351 @@
+#include "AsyncReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+AsyncReader::AsyncReader(unsigned queueDepth, AsyncReadBackend backend) {
+    this->backend = backend;
+    this->queueDepth = queueDepth > 0 ? queueDepth : 1;
+    this->numInFlight = 0;
+    this->ringFd = -1;
+    this->submissionRing = nullptr;
+    this->submissionRingByteSize = 0;
+    this->completionRing = nullptr;
+    this->completionRingByteSize = 0;
+    this->submissionEntries = nullptr;
+    this->submissionEntriesByteSize = 0;
+    this->submissionHead = nullptr;
+    this->submissionTail = nullptr;
+    this->submissionMask = nullptr;
+    this->submissionArray = nullptr;
+    this->completionHead = nullptr;
+    this->completionTail = nullptr;
+    this->completionMask = nullptr;
+    this->completionEntries = nullptr;
+    this->numToSubmit = 0;
+    this->stopThreads = false;
+
+    if (this->backend == AsyncReadBackend::IO_URING_BACKEND && !this->SetupIoUring()) {
+        this->backend = AsyncReadBackend::THREAD_POOL_BACKEND;
+    }
+    if (this->backend == AsyncReadBackend::THREAD_POOL_BACKEND) {
+        for (int i = 0; i < AsyncReader::NUM_THREADS; i++) {
+            this->threads.emplace_back(&AsyncReader::RunThread, this);
+        }
+    }
+}
+
+AsyncReader::~AsyncReader() {
+    this->WaitAll();
+    if (this->backend == AsyncReadBackend::IO_URING_BACKEND) {
+        this->CloseIoUring();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> queueLock(this->queueMutex);
+        this->stopThreads = true;
+    }
+    this->requestCondition.notify_all();
+    for (auto &thread: this->threads) {
+        thread.join();
+    }
+}
+
+AsyncReadBackend AsyncReader::GetBackend() const {
+    return this->backend;
+}
+
+bool AsyncReader::SetupIoUring() {
+    struct io_uring_params params{};
+    int fd = (int) syscall(__NR_io_uring_setup, this->queueDepth, &params);
+    if (fd < 0) {
+        return false;
+    }
+    this->ringFd = fd;
+
+    // Map the rings the kernel shares with us: the submission ring holds the indexes of the
+    // submission entries to read, and the completion ring the results of the reads.
+    this->submissionRingByteSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    this->completionRingByteSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool isSingleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (isSingleMap && this->completionRingByteSize > this->submissionRingByteSize) {
+        this->submissionRingByteSize = this->completionRingByteSize;
+    }
+    void *ring = mmap(nullptr, this->submissionRingByteSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED) {
+        this->CloseIoUring();
+        return false;
+    }
+    this->submissionRing = ring;
+    if (isSingleMap) {
+        this->completionRing = ring;
+    } else {
+        ring = mmap(nullptr, this->completionRingByteSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_CQ_RING);
+        if (ring == MAP_FAILED) {
+            this->CloseIoUring();
+            return false;
+        }
+        this->completionRing = ring;
+    }
+    this->submissionEntriesByteSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring = mmap(nullptr, this->submissionEntriesByteSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                fd, IORING_OFF_SQES);
+    if (ring == MAP_FAILED) {
+        this->CloseIoUring();
+        return false;
+    }
+    this->submissionEntries = static_cast<struct io_uring_sqe *>(ring);
+
+    auto *submissionBytes = static_cast<char *>(this->submissionRing);
+    this->submissionHead = reinterpret_cast<unsigned *>(submissionBytes + params.sq_off.head);
+    this->submissionTail = reinterpret_cast<unsigned *>(submissionBytes + params.sq_off.tail);
+    this->submissionMask = reinterpret_cast<unsigned *>(submissionBytes + params.sq_off.ring_mask);
+    this->submissionArray = reinterpret_cast<unsigned *>(submissionBytes + params.sq_off.array);
+    auto *completionBytes = static_cast<char *>(this->completionRing);
+    this->completionHead = reinterpret_cast<unsigned *>(completionBytes + params.cq_off.head);
+    this->completionTail = reinterpret_cast<unsigned *>(completionBytes + params.cq_off.tail);
+    this->completionMask = reinterpret_cast<unsigned *>(completionBytes + params.cq_off.ring_mask);
+    this->completionEntries = reinterpret_cast<struct io_uring_cqe *>(completionBytes + params.cq_off.cqes);
+
+    // The submission ring may be larger than asked for, but never smaller.
+    if (params.sq_entries < this->queueDepth) {
+        this->queueDepth = params.sq_entries;
+    }
+    return true;
+}
+
+void AsyncReader::CloseIoUring() {
+    if (this->submissionEntries != nullptr) {
+        munmap(this->submissionEntries, this->submissionEntriesByteSize);
+        this->submissionEntries = nullptr;
+    }
+    if (this->completionRing != nullptr && this->completionRing != this->submissionRing) {
+        munmap(this->completionRing, this->completionRingByteSize);
+    }
+    this->completionRing = nullptr;
+    if (this->submissionRing != nullptr) {
+        munmap(this->submissionRing, this->submissionRingByteSize);
+        this->submissionRing = nullptr;
+    }
+    if (this->ringFd != -1) {
+        close(this->ringFd);
+        this->ringFd = -1;
+    }
+}
+
+bool AsyncReader::EnterIoUring(unsigned minToComplete) {
+    unsigned flags = minToComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (true) {
+        int numSubmitted = (int) syscall(__NR_io_uring_enter, this->ringFd, this->numToSubmit, minToComplete, flags,
+                                         nullptr, 0);
+        if (numSubmitted >= 0) {
+            this->numToSubmit -= numSubmitted;
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            perror("io_uring_enter");
+            this->FallBackToThreadPool();
+            return false;
+        }
+    }
+}
+
+void AsyncReader::FallBackToThreadPool() {
+    std::vector<AsyncReadRequest *> unsubmittedRequests;
+    unsigned head = __atomic_load_n(this->submissionHead, __ATOMIC_ACQUIRE);
+    for (unsigned i = head; i != *this->submissionTail; i++) {
+        unsigned index = this->submissionArray[i & *this->submissionMask];
+        unsubmittedRequests.push_back(reinterpret_cast<AsyncReadRequest *>(this->submissionEntries[index].user_data));
+    }
+    this->ReapCompletions();
+    for (AsyncReadRequest *request: this->ringRequests) {
+        if (std::find(unsubmittedRequests.begin(), unsubmittedRequests.end(), request) == unsubmittedRequests.end()) {
+            request->bytesRead = -1;
+            request->isDone = true;
+        }
+    }
+    this->ringRequests.clear();
+    this->numInFlight = 0;
+    this->numToSubmit = 0;
+    this->CloseIoUring();
+
+    this->backend = AsyncReadBackend::THREAD_POOL_BACKEND;
+    for (int i = 0; i < AsyncReader::NUM_THREADS; i++) {
+        this->threads.emplace_back(&AsyncReader::RunThread, this);
+    }
+    for (AsyncReadRequest *request: unsubmittedRequests) {
+        this->Submit(request);
+    }
+}
+
+void AsyncReader::ReapCompletions() {
+    unsigned head = *this->completionHead;
+    unsigned tail = __atomic_load_n(this->completionTail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        struct io_uring_cqe *completion = &this->completionEntries[head & *this->completionMask];
+        auto *request = reinterpret_cast<AsyncReadRequest *>(completion->user_data);
+        request->bytesRead = completion->res >= 0 ? completion->res : -1;
+        request->isDone = true;
+        *std::find(this->ringRequests.begin(), this->ringRequests.end(), request) = this->ringRequests.back();
+        this->ringRequests.pop_back();
+        this->numInFlight--;
+        head++;
+    }
+    __atomic_store_n(this->completionHead, head, __ATOMIC_RELEASE);
+}
+
+void AsyncReader::Submit(AsyncReadRequest *request) {
+    request->bytesRead = -1;
+    request->isDone = false;
+    if (this->backend == AsyncReadBackend::THREAD_POOL_BACKEND) {
+        {
+            std::lock_guard<std::mutex> queueLock(this->queueMutex);
+            this->requestQueue.push_back(request);
+            this->numInFlight++;
+        }
+        this->requestCondition.notify_one();
+        return;
+    }
+
+    // Make room for the read in the rings first.
+    this->ReapCompletions();
+    while (this->numInFlight >= this->queueDepth) {
+        if (!this->EnterIoUring(1)) {
+            this->Submit(request);
+            return;
+        }
+        this->ReapCompletions();
+    }
+
+    request->iov.iov_base = request->buffer;
+    request->iov.iov_len = request->numBytes;
+    unsigned tail = *this->submissionTail;
+    unsigned index = tail & *this->submissionMask;
+    struct io_uring_sqe *entry = &this->submissionEntries[index];
+    *entry = {};
+    // Vectored reads are supported by all the kernels with io_uring, unlike plain ones.
+    entry->opcode = IORING_OP_READV;
+    entry->fd = request->fd;
+    entry->off = request->byteOffset;
+    entry->addr = reinterpret_cast<uint64_t>(&request->iov);
+    entry->len = 1;
+    entry->user_data = reinterpret_cast<uint64_t>(request);
+    this->submissionArray[index] = index;
+    __atomic_store_n(this->submissionTail, tail + 1, __ATOMIC_RELEASE);
+    this->numToSubmit++;
+    this->numInFlight++;
+    this->ringRequests.push_back(request);
+}
+
+ssize_t AsyncReader::Wait(AsyncReadRequest *request) {
+    if (this->backend == AsyncReadBackend::THREAD_POOL_BACKEND) {
+        std::unique_lock<std::mutex> queueLock(this->queueMutex);
+        this->doneCondition.wait(queueLock, [request] { return request->isDone; });
+        return request->bytesRead;
+    }
+
+    this->ReapCompletions();
+    while (!request->isDone) {
+        if (!this->EnterIoUring(1)) {
+            return this->Wait(request);
+        }
+        this->ReapCompletions();
+    }
+    return request->bytesRead;
+}
+
+void AsyncReader::WaitAll() {
+    if (this->backend == AsyncReadBackend::THREAD_POOL_BACKEND) {
+        std::unique_lock<std::mutex> queueLock(this->queueMutex);
+        this->doneCondition.wait(queueLock, [this] { return this->numInFlight == 0; });
+        return;
+    }
+
+    this->ReapCompletions();
+    while (this->numInFlight > 0) {
+        if (!this->EnterIoUring(1)) {
+            this->WaitAll();
+            return;
+        }
+        this->ReapCompletions();
+    }
+}
+
+void AsyncReader::RunThread() {
+    while (true) {
+        AsyncReadRequest *request;
+        {
+            std::unique_lock<std::mutex> queueLock(this->queueMutex);
+            this->requestCondition.wait(queueLock, [this] {
+                return this->stopThreads || !this->requestQueue.empty();
+            });
+            if (this->requestQueue.empty()) {
+                return;
+            }
+            request = this->requestQueue.front();
+            this->requestQueue.pop_front();
+        }
+
+        ssize_t bytesRead = pread(request->fd, request->buffer, request->numBytes, (off_t) request->byteOffset);
+        {
+            std::lock_guard<std::mutex> queueLock(this->queueMutex);
+            request->bytesRead = bytesRead;
+            request->isDone = true;
+            this->numInFlight--;
+        }
+        this->doneCondition.notify_all();
+    }
+}
+
+PagePrefetcher::PagePrefetcher(AsyncReader *asyncReader) {
+    this->asyncReader = asyncReader;
+    this->isPending = false;
+}
+
+PagePrefetcher::~PagePrefetcher() {
+    this->Cancel();
+}
+
+void PagePrefetcher::Prefetch(int fd, uint64_t byteOffset, uint64_t numBytes) {
+    this->Cancel();
+    int prefetchFd = dup(fd);
+    if (prefetchFd == -1) {
+        return;
+    }
+    this->buffer.Reserve(numBytes);
+    this->request = {};
+    this->request.fd = prefetchFd;
+    this->request.byteOffset = byteOffset;
+    this->request.numBytes = numBytes;
+    this->request.buffer = this->buffer.Data();
+    this->asyncReader->Submit(&this->request);
+    this->isPending = true;
+}
+
+ssize_t PagePrefetcher::Take(uint64_t byteOffset, uint64_t numBytes, const uint64_t *&words) {
+    if (!this->isPending || this->request.byteOffset != byteOffset || this->request.numBytes != numBytes) {
+        this->Cancel();
+        return -1;
+    }
+    ssize_t bytesRead = this->asyncReader->Wait(&this->request);
+    close(this->request.fd);
+    this->isPending = false;
+    words = this->buffer.Data();
+    return bytesRead;
+}
+
+void PagePrefetcher::Cancel() {
+    if (!this->isPending) {
+        return;
+    }
+    // The read still writes into the buffer until it is done.
+    this->asyncReader->Wait(&this->request);
+    close(this->request.fd);
+    this->isPending = false;
+}
@@ -0,0 +1,286 @@
+#include "BPlusTree.h"
+#include <new>
+
+BPlusTree::BPlusTree(Arena *arena) {
+    static_assert(sizeof(LeafNode) == BPlusTree::NODE_SIZE, "A leaf should fill a whole node");
+    static_assert(sizeof(InnerNode) == BPlusTree::NODE_SIZE, "An inner node should fill a whole node");
+    this->arena = arena;
+    this->root = nullptr;
+    this->lastLeaf = nullptr;
+    this->lastLeafUpperBound = 0;
+    this->currentSize = 0;
+}
+
+BPlusTree::LeafNode *BPlusTree::NewLeaf() {
+    char *memory = this->arena->AllocateAligned(BPlusTree::NODE_SIZE, BPlusTree::CACHE_LINE_SIZE);
+    auto *leaf = new(memory) LeafNode;
+    leaf->numKeys = 0;
+    leaf->isLeaf = true;
+    leaf->next = nullptr;
+    return leaf;
+}
+
+BPlusTree::InnerNode *BPlusTree::NewInner() {
+    char *memory = this->arena->AllocateAligned(BPlusTree::NODE_SIZE, BPlusTree::CACHE_LINE_SIZE);
+    auto *inner = new(memory) InnerNode;
+    inner->numKeys = 0;
+    inner->isLeaf = false;
+    return inner;
+}
+
+int BPlusTree::CountKeysBefore(const uint64_t *keys, int numKeys, uint64_t key, bool inclusive) {
+    // The keys of a node fit in a couple of cache lines, so a branch-free linear scan
+    // is faster than a binary search here.
+    int count = 0;
+    for (int i = 0; i < numKeys; i++) {
+        count += inclusive ? keys[i] <= key : keys[i] < key;
+    }
+    return count;
+}
+
+BPlusTree::LeafNode *BPlusTree::FindLeaf(uint64_t key, uint64_t *upperBound) {
+    uint64_t bound = UINT64_MAX;
+    BPlusTreeNode *node = this->root;
+    while (!node->isLeaf) {
+        auto *inner = static_cast<InnerNode *>(node);
+        int index = CountKeysBefore(inner->keys, inner->numKeys, key, true);
+        if (index < inner->numKeys) {
+            bound = inner->keys[index];
+        }
+        node = inner->children[index];
+    }
+    if (upperBound != nullptr) {
+        *upperBound = bound;
+    }
+    return static_cast<LeafNode *>(node);
+}
+
+void BPlusTree::InsertIntoLeaf(LeafNode *leaf, int pos, uint64_t key, uint64_t value) {
+    for (int i = leaf->numKeys; i > pos; i--) {
+        leaf->keys[i] = leaf->keys[i - 1];
+        leaf->values[i] = leaf->values[i - 1];
+    }
+    leaf->keys[pos] = key;
+    leaf->values[pos] = value;
+    leaf->numKeys++;
+}
+
+bool BPlusTree::Insert(uint64_t key, uint64_t value) {
+    if (this->root == nullptr) {
+        this->root = this->NewLeaf();
+    }
+
+    // Remember the path down to the leaf, in case the nodes on it have to be split.
+    InnerNode *path[BPlusTree::MAX_DEPTH];
+    int pathIndexes[BPlusTree::MAX_DEPTH];
+    int depth = 0;
+    BPlusTreeNode *node = this->root;
+    while (!node->isLeaf) {
+        auto *inner = static_cast<InnerNode *>(node);
+        int index = CountKeysBefore(inner->keys, inner->numKeys, key, true);
+        path[depth] = inner;
+        pathIndexes[depth] = index;
+        depth++;
+        node = inner->children[index];
+    }
+
+    auto *leaf = static_cast<LeafNode *>(node);
+    int pos = CountKeysBefore(leaf->keys, leaf->numKeys, key, false);
+    if (pos < leaf->numKeys && leaf->keys[pos] == key) {
+        // The key already exists, so the newer value replaces the older one.
+        leaf->values[pos] = value;
+        return false;
+    }
+
+    if (leaf->numKeys < BPlusTree::LEAF_CAPACITY) {
+        InsertIntoLeaf(leaf, pos, key, value);
+    } else {
+        this->SplitLeafAndInsert(leaf, pos, key, value, path, pathIndexes, depth);
+    }
+    this->currentSize++;
+    return true;
+}
+
+void BPlusTree::SplitLeafAndInsert(LeafNode *leaf, int pos, uint64_t key, uint64_t value, InnerNode **path,
+                                   int *pathIndexes, int depth) {
+    // Split the leaf in half. When appending past the largest key of the tree, which is what
+    // happens with keys inserted in ascending order, keep the leaf full and start an empty one.
+    int mid = (BPlusTree::LEAF_CAPACITY + 1) / 2;
+    if (pos == BPlusTree::LEAF_CAPACITY && leaf->next == nullptr) {
+        mid = BPlusTree::LEAF_CAPACITY;
+    }
+    LeafNode *newLeaf = this->NewLeaf();
+    for (int i = mid; i < leaf->numKeys; i++) {
+        newLeaf->keys[i - mid] = leaf->keys[i];
+        newLeaf->values[i - mid] = leaf->values[i];
+    }
+    newLeaf->numKeys = leaf->numKeys - mid;
+    leaf->numKeys = mid;
+    newLeaf->next = leaf->next;
+    leaf->next = newLeaf;
+    if (pos < mid) {
+        InsertIntoLeaf(leaf, pos, key, value);
+    } else {
+        InsertIntoLeaf(newLeaf, pos - mid, key, value);
+    }
+
+    // Insert the new node into its parent, splitting full parents on the way up.
+    uint64_t separator = newLeaf->keys[0];
+    BPlusTreeNode *newNode = newLeaf;
+    while (depth > 0) {
+        depth--;
+        InnerNode *parent = path[depth];
+        int index = pathIndexes[depth];
+        if (parent->numKeys < BPlusTree::INNER_CAPACITY) {
+            for (int i = parent->numKeys; i > index; i--) {
+                parent->keys[i] = parent->keys[i - 1];
+                parent->children[i + 1] = parent->children[i];
+            }
+            parent->keys[index] = separator;
+            parent->children[index + 1] = newNode;
+            parent->numKeys++;
+            return;
+        }
+
+        // Gather the keys and children of the full parent together with the new ones,
+        // then give the first half to the parent and the second half to a new node.
+        // The key in the middle moves up to the grandparent.
+        uint64_t keys[BPlusTree::INNER_CAPACITY + 1];
+        BPlusTreeNode *children[BPlusTree::INNER_CAPACITY + 2];
+        for (int i = 0, j = 0; i <= BPlusTree::INNER_CAPACITY; i++) {
+            keys[i] = i == index ? separator : parent->keys[j++];
+        }
+        for (int i = 0, j = 0; i <= BPlusTree::INNER_CAPACITY + 1; i++) {
+            children[i] = i == index + 1 ? newNode : parent->children[j++];
+        }
+
+        int numLeftKeys = (BPlusTree::INNER_CAPACITY + 1) / 2;
+        InnerNode *newInner = this->NewInner();
+        parent->numKeys = numLeftKeys;
+        for (int i = 0; i < numLeftKeys; i++) {
+            parent->keys[i] = keys[i];
+            parent->children[i] = children[i];
+        }
+        parent->children[numLeftKeys] = children[numLeftKeys];
+        newInner->numKeys = BPlusTree::INNER_CAPACITY - numLeftKeys;
+        for (int i = 0; i < newInner->numKeys; i++) {
+            newInner->keys[i] = keys[numLeftKeys + 1 + i];
+            newInner->children[i] = children[numLeftKeys + 1 + i];
+        }
+        newInner->children[newInner->numKeys] = children[BPlusTree::INNER_CAPACITY + 1];
+        separator = keys[numLeftKeys];
+        newNode = newInner;
+    }
+
+    // The root was split, so the tree grows by one level.
+    InnerNode *newRoot = this->NewInner();
+    newRoot->numKeys = 1;
+    newRoot->keys[0] = separator;
+    newRoot->children[0] = this->root;
+    newRoot->children[1] = newNode;
+    this->root = newRoot;
+}
+
+void BPlusTree::InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) {
+    for (size_t i = start; i < end; i++) {
+        uint64_t key = entries[i].first;
+        LeafNode *leaf = this->lastLeaf;
+        // The key belongs to the previous leaf if it is below the separator of the next leaf.
+        // Keys are ascending, so it is never before the keys of the previous leaf.
+        bool fitsInLastLeaf = i > start && leaf != nullptr && leaf->numKeys < BPlusTree::LEAF_CAPACITY &&
+                              key < this->lastLeafUpperBound;
+        if (!fitsInLastLeaf) {
+            this->Insert(key, entries[i].second);
+            this->lastLeaf = this->FindLeaf(key, &this->lastLeafUpperBound);
+            continue;
+        }
+
+        int pos = CountKeysBefore(leaf->keys, leaf->numKeys, key, false);
+        if (pos < leaf->numKeys && leaf->keys[pos] == key) {
+            leaf->values[pos] = entries[i].second;
+        } else {
+            InsertIntoLeaf(leaf, pos, key, entries[i].second);
+            this->currentSize++;
+        }
+    }
+}
+
+uint64_t BPlusTree::Search(uint64_t key) {
+    if (this->root == nullptr) {
+        return Utils::INVALID_VALUE;
+    }
+    LeafNode *leaf = this->FindLeaf(key);
+    int pos = CountKeysBefore(leaf->keys, leaf->numKeys, key, false);
+    if (pos < leaf->numKeys && leaf->keys[pos] == key) {
+        return leaf->values[pos];
+    }
+    // key not found.
+    return Utils::INVALID_VALUE;
+}
+
+void BPlusTree::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) {
+    if (this->root == nullptr) {
+        return;
+    }
+    LeafNode *leaf = this->FindLeaf(key1);
+    int pos = CountKeysBefore(leaf->keys, leaf->numKeys, key1, false);
+    while (leaf != nullptr) {
+        for (; pos < leaf->numKeys; pos++) {
+            if (leaf->keys[pos] > key2) {
+                return;
+            }
+            nodesList.emplace_back(leaf->keys[pos], leaf->values[pos]);
+        }
+        leaf = leaf->next;
+        pos = 0;
+    }
+}
+
+EntryIterator *BPlusTree::NewIterator() {
+    return new Iterator(this);
+}
+
+int BPlusTree::GetCurrentSize() const {
+    return this->currentSize;
+}
+
+void BPlusTree::Clear() {
+    this->root = nullptr;
+    this->lastLeaf = nullptr;
+    this->currentSize = 0;
+}
+
+BPlusTree::Iterator::Iterator(BPlusTree *tree) {
+    this->leaf = nullptr;
+    this->index = 0;
+    if (tree->root == nullptr) {
+        return;
+    }
+
+    // Start at the leftmost leaf, i.e. the smallest key.
+    BPlusTreeNode *node = tree->root;
+    while (!node->isLeaf) {
+        node = static_cast<InnerNode *>(node)->children[0];
+    }
+    this->leaf = static_cast<LeafNode *>(node);
+    if (this->leaf->numKeys == 0) {
+        this->leaf = nullptr;
+    }
+}
+
+bool BPlusTree::Iterator::Valid() const {
+    return this->leaf != nullptr;
+}
+
+DataEntry_t BPlusTree::Iterator::GetEntry() const {
+    return std::make_pair(this->leaf->keys[this->index], this->leaf->values[this->index]);
+}
+
+void BPlusTree::Iterator::Next() {
+    this->index++;
+    if (this->index >= this->leaf->numKeys) {
+        // Leaves are never empty once the tree has a key, since nodes are only ever split.
+        this->leaf = this->leaf->next;
+        this->index = 0;
+    }
+}
@@ -2,8 +2,10 @@
 #include <string>
 #include "BloomFilter.h"
 
-BloomFilter::BloomFilter(int bitsPerEntry, int numKeys) {
-    this->arrayBitSize = (bitsPerEntry * numKeys) + ((bitsPerEntry * numKeys) % Utils::EIGHT_BYTE_SIZE);
+BloomFilter::BloomFilter(int bitsPerEntry, uint64_t numKeys) {
+    // Round the number of bits up to a whole number of array elements.
+    uint64_t numBits = (uint64_t) bitsPerEntry * numKeys;
+    this->arrayBitSize = numBits + (Utils::EIGHT_BYTE_SIZE - numBits % Utils::EIGHT_BYTE_SIZE) % Utils::EIGHT_BYTE_SIZE;
     this->arraySize = this->arrayBitSize / Utils::EIGHT_BYTE_SIZE;
     this->array.resize(this->arraySize);
     std::fill(this->array.begin(), this->array.begin(), 0);
@@ -47,7 +49,11 @@ void BloomFilter::InsertKeys(std::vector<DataEntry_t> &data) {
     }
 }
 
-bool BloomFilter::KeyProbablyExists(uint64_t key, std::vector<uint64_t> filterArray) const {
+bool BloomFilter::KeyProbablyExists(uint64_t key, const std::vector<uint64_t> &filterArray) const {
+    return this->KeyProbablyExists(key, filterArray.data());
+}
+
+bool BloomFilter::KeyProbablyExists(uint64_t key, const uint64_t *filterArray) const {
     for (int seed = 1; seed <= this->numHashFunctions; seed += this->numHashFunctions) {
         uint64_t index = GetIndexInBitArray(key, seed, this->arrayBitSize);
         int i = GetIndexInFilterArray(index);
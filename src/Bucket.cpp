@@ -2,18 +2,22 @@
 #include "Bucket.h"
 
 Bucket::Bucket(int depth) {
+    this->head = nullptr;
     this->localDepth = depth;
     this->size = 0;
 }
 
 Bucket::~Bucket() {
-    for (Page *page : pages) {
-        delete page;
+    Page *page = this->head;
+    while (page != nullptr) {
+        Page *nextPage = page->GetBucketNext();
+        Page::Delete(page);
+        page = nextPage;
     }
 }
 
 Page *Bucket::Get(const std::string &pageId) {
-    for (Page *page : this->pages) {
+    for (Page *page = this->head; page != nullptr; page = page->GetBucketNext()) {
         if (page->GetPageId() == pageId) {
             return page;
         }
@@ -23,12 +27,23 @@ Page *Bucket::Get(const std::string &pageId) {
 
 void Bucket::Insert(Page *newPage) {
     this->size++;
-    this->pages.push_front(newPage);
+    newPage->SetBucketNext(this->head);
+    this->head = newPage;
 }
 
 void Bucket::Remove(Page *pageToRemove) {
-    this->pages.remove(pageToRemove);
-    delete pageToRemove;
+    Page *prevPage = nullptr;
+    Page *page = this->head;
+    while (page != nullptr && page != pageToRemove) {
+        prevPage = page;
+        page = page->GetBucketNext();
+    }
+    if (page != nullptr && prevPage == nullptr) {
+        this->head = page->GetBucketNext();
+    } else if (page != nullptr) {
+        prevPage->SetBucketNext(page->GetBucketNext());
+    }
+    Page::Delete(pageToRemove);
     this->size--;
 }
 
@@ -48,11 +63,15 @@ void Bucket::DecreaseLocalDepth() {
     this->localDepth--;
 }
 
-std::forward_list<Page *>Bucket::GetPages() {
-    return this->pages;
+std::vector<Page *> Bucket::GetPages() {
+    std::vector<Page *> pages;
+    for (Page *page = this->head; page != nullptr; page = page->GetBucketNext()) {
+        pages.push_back(page);
+    }
+    return pages;
 }
 
 void Bucket::Clear() {
-    this->pages.clear();
+    this->head = nullptr;
     this->size = 0;
 }
@@ -5,8 +5,11 @@
 #include "LRU.h"
 #include "Clock.h"
 
-BufferPool::BufferPool(int minSize, int maxSize, EvictionPolicyType evictionPolicyType) {
+BufferPool::BufferPool(int minSize, int maxSize, EvictionPolicyType evictionPolicyType, size_t frameSize,
+                       bool useHugePages) {
     this->hashtable = new ExtendibleHashtable(minSize, maxSize);
+    // There is a frame for each page the buffer pool holds at its max size.
+    this->arena = new FrameArena(maxSize, frameSize, useHugePages);
     if (evictionPolicyType == EvictionPolicyType::LRU_t) {
         this->policy = new LRU();
     } else {
@@ -15,18 +18,23 @@ BufferPool::BufferPool(int minSize, int maxSize, EvictionPolicyType evictionPoli
 }
 
 BufferPool::~BufferPool() {
+    // The pages give their frames back to the arena as they are deleted.
     delete this->hashtable;
     delete this->policy;
+    delete this->arena;
 }
 
 std::vector<uint64_t> BufferPool::Get(const std::string &pageId) {
-    std::vector<uint64_t> pageData;
+    PageHandle page = this->Pin(pageId);
+    return {page.begin(), page.end()};
+}
+
+PageHandle BufferPool::Pin(const std::string &pageId) {
     Page *accessedPage = this->hashtable->Get(pageId);
     if (accessedPage != nullptr) {
         this->policy->UpdatePageAccessStatus(accessedPage);
-        return accessedPage->GetData();
     }
-    return {};
+    return PageHandle(accessedPage);
 }
 
 void BufferPool::Resize(int newMaxSize) {
@@ -40,9 +48,40 @@ void BufferPool::Resize(int newMaxSize) {
         this->hashtable->Shrink();
     }
     this->hashtable->SetMaxSize(newMaxSize);
+    if ((size_t) newMaxSize > this->arena->GetNumFrames()) {
+        this->arena->Grow(newMaxSize - this->arena->GetNumFrames());
+    }
+}
+
+PageHandle BufferPool::Insert(const std::string &pageId, std::vector<uint64_t> data) {
+    return this->InsertPage(new Page(pageId, std::move(data)));
+}
+
+PageHandle BufferPool::Insert(const std::string &pageId, uint64_t *frame, const uint64_t *words, size_t numWords) {
+    // The page of the frame is reused, so caching a page read into a frame does not allocate.
+    Page *page = this->arena->GetPage(frame);
+    page->Assign(pageId, this->arena, frame, words, numWords);
+    return this->InsertPage(page);
 }
 
-void BufferPool::Insert(const std::string &pageId, std::vector<uint64_t> &data) {
+uint64_t *BufferPool::AcquireFrame() {
+    // Evict pages until one gives its frame back, as the pages that don't fit in a frame have none.
+    uint64_t *frame = this->arena->Allocate();
+    while (frame == nullptr && this->Evict()) {
+        frame = this->arena->Allocate();
+    }
+    return frame;
+}
+
+void BufferPool::ReleaseFrame(uint64_t *frame) {
+    this->arena->Free(frame);
+}
+
+size_t BufferPool::GetFrameSize() const {
+    return this->arena->GetFrameSize();
+}
+
+PageHandle BufferPool::InsertPage(Page *newPage) {
     // Expand the directory if the total number of pages mapped to this hash table
     // is greater than a certain directory size threshold.
     if (this->hashtable->GetSize() > this->hashtable->GetNumDirectory() * ExtendibleHashtable::EXPAND_THRESHOLD) {
@@ -52,12 +91,17 @@ void BufferPool::Insert(const std::string &pageId, std::vector<uint64_t> &data)
         }
     }
 
-    Page *newPage = new Page(pageId, data);
     this->hashtable->Insert(newPage);
     this->policy->Insert(newPage);
+    return PageHandle(newPage);
 }
 
-void BufferPool::Evict() {
+bool BufferPool::Evict() {
+    // When every page is pinned, none is evicted and the pool goes over its size until they are unpinned.
     Page *pageToEvict = this->policy->GetPageToEvict();
+    if (pageToEvict == nullptr) {
+        return false;
+    }
     this->hashtable->Remove(pageToEvict);
+    return true;
 }
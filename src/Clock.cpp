@@ -2,12 +2,24 @@
 #include "Clock.h"
 
 Clock::Clock() {
-    this->handle = 0;
+    this->handle = nullptr;
+    this->numPages = 0;
 }
 
 void Clock::Insert(Page *page) {
-    auto it = std::next(this->pages.begin(), this->handle);
-    this->pages.insert(it, page);
+    // The page goes right before the handle, which then points to it.
+    if (this->handle == nullptr) {
+        page->SetClockNext(page);
+        page->SetClockPrev(page);
+    } else {
+        Page *prevPage = this->handle->GetClockPrev();
+        page->SetClockPrev(prevPage);
+        page->SetClockNext(this->handle);
+        prevPage->SetClockNext(page);
+        this->handle->SetClockPrev(page);
+    }
+    this->handle = page;
+    this->numPages++;
     page->SetAccessBit(0);
 }
 
@@ -16,26 +28,34 @@ void Clock::UpdatePageAccessStatus(Page *accessedPage) {
 }
 
 Page *Clock::GetPageToEvict() {
-    auto it = std::next(this->pages.begin(), this->handle);
-    Page *curPage = *it;
-    while (curPage->GetAccessBit()) {
-        curPage->SetAccessBit(0);
-        this->handle++;
-        ++it;
-        if (it == this->pages.end()) {
-            it = this->pages.begin();
-            this->handle = 0;
+    if (this->handle == nullptr) {
+        return nullptr;
+    }
+    Page *curPage = this->handle;
+    // Pinned pages are passed over without clearing their access bit. After two sweeps every page
+    // that is not pinned has had its access bit cleared, so if none was found they are all pinned.
+    size_t numPagesSeen = 0;
+    while (curPage->IsPinned() || curPage->GetAccessBit()) {
+        if (numPagesSeen++ == 2 * this->numPages) {
+            this->handle = curPage;
+            return nullptr;
         }
-        curPage = *it;
+        if (!curPage->IsPinned()) {
+            curPage->SetAccessBit(0);
+        }
+        curPage = curPage->GetClockNext();
     }
 
-    // Delete the evicted page from pages
-    it = std::next(this->pages.begin(), this->handle);
-    this->pages.erase(it);
-
-    // Make sure the handle refers to a valid index after pages has shrunk.
-    if (this->handle >= this->pages.size()) {
-        this->handle = 0;
+    // Unlink the evicted page from the ring, and move the handle to the page after it.
+    if (this->numPages == 1) {
+        this->handle = nullptr;
+    } else {
+        Page *prevPage = curPage->GetClockPrev();
+        Page *nextPage = curPage->GetClockNext();
+        prevPage->SetClockNext(nextPage);
+        nextPage->SetClockPrev(prevPage);
+        this->handle = nextPage;
     }
+    this->numPages--;
     return curPage;
 }
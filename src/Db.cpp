@@ -9,23 +9,74 @@
 namespace fs = std::filesystem;
 
 /* Public definitions */
-Db::Db(int memtableSize, SearchType searchType, BufferPool *bufferPool, LSMTree *lsmTree) {
-    this->memtable = new Memtable(memtableSize);
+Db::Db(int memtableSize, SearchType searchType, BufferPool *bufferPool, LSMTree *lsmTree, const DbOptions &options) {
+    this->options = options;
+    if (!SST::IsValidPageSize(options.pageSize)) {
+        std::cerr << "Invalid page size " << options.pageSize << ", using " << SST::PAGE_SIZE << " instead."
+                  << std::endl;
+        this->options.pageSize = SST::PAGE_SIZE;
+    }
+    this->memtableSize = memtableSize;
+    this->memtable = new Memtable(memtableSize, options.memtableType);
+    this->spareMemtable = nullptr;
+    this->releaseFlushedMemtables = false;
     this->allSSTs = {};
     this->bufferPool = bufferPool;
     this->searchType = searchType;
     this->isLSMTree = lsmTree != nullptr;
     this->lsmTree = lsmTree;
+    this->asyncReader = options.enableAsyncReads ? new AsyncReader(options.asyncReadQueueDepth) : nullptr;
+    this->tableCache = options.maxOpenFiles > 0 ? new TableCache(options.maxOpenFiles) : nullptr;
+    if (lsmTree != nullptr) {
+        lsmTree->SetLeafFormat(options.leafFormat);
+        lsmTree->SetReadMode(options.readMode);
+        lsmTree->SetAsyncReader(this->asyncReader);
+        lsmTree->SetTableCache(this->tableCache);
+        lsmTree->SetDirectWrites(options.useDirectWrites);
+        lsmTree->SetPageSize(this->options.pageSize);
+        lsmTree->SetPageChecksums(options.enablePageChecksums);
+    }
+    this->wal = nullptr;
+    this->logNumber = 0;
+    this->stopFlushThread = false;
+    this->reportedMemoryUsage = 0;
+    if (options.maxImmutableMemtables > 0) {
+        this->flushThread = std::thread(&Db::RunFlushThread, this);
+    }
+    if (options.writeBufferManager != nullptr) {
+        this->UpdateMemoryUsage();
+        options.writeBufferManager->RegisterDb(this);
+    }
 }
 
 Db::~Db() {
+    if (this->options.writeBufferManager != nullptr) {
+        this->options.writeBufferManager->UnregisterDb(this);
+    }
+    if (this->flushThread.joinable()) {
+        {
+            std::lock_guard<std::shared_mutex> memtableLock(this->memtableMutex);
+            this->stopFlushThread = true;
+        }
+        this->flushCondition.notify_one();
+        // The flush thread finishes flushing the queued memtables before it exits.
+        this->flushThread.join();
+    }
+    if (this->options.writeBufferManager != nullptr) {
+        this->options.writeBufferManager->FreeMemory(this->reportedMemoryUsage);
+    }
+    delete this->wal;
     delete this->memtable;
+    delete this->spareMemtable;
     delete this->bufferPool;
     delete this->lsmTree;
     for (auto sst: this->allSSTs) {
         delete sst;
     }
     this->allSSTs.clear();
+    // The SST files may still be reading ahead with it until they are deleted.
+    delete this->asyncReader;
+    delete this->tableCache;
 }
 
 bool Db::Open(const std::string &path) {
@@ -46,68 +97,485 @@ bool Db::Open(const std::string &path) {
             std::string filePath = Utils::EnsureDirSlash(this->dbPath) + Utils::GetFilenameWithExt(fileNameStem);
             if (!this->isLSMTree) {
                 SST *sstFile = new SST(filePath, fs::file_size(entry));
+                sstFile->SetReadMode(this->options.readMode);
+                sstFile->SetTableCache(this->tableCache);
+                if (this->searchType != SearchType::BINARY_SEARCH) {
+                    // Files of an older layout, such as the one with the metadata on the first page, are
+                    // not read, rather than searched as if they were empty.
+                    if (!sstFile->LoadBTreeIndex()) {
+                        std::cerr << "Could not open " << filePath << ": not a B-Tree SST file of format version "
+                                  << SST::FORMAT_VERSION << std::endl;
+                        delete sstFile;
+                        return false;
+                    }
+                } else if (!sstFile->LoadBinarySearchFooter()) {
+                    // The pages of files without a footer of this version may not start with a header,
+                    // so they would read as empty.
+                    std::cerr << "Could not open " << filePath << ": not a SST file of format version "
+                              << SST::FORMAT_VERSION << std::endl;
+                    delete sstFile;
+                    return false;
+                }
                 this->allSSTs.push_back(sstFile);
             }
         }
     }
+    if (this->options.enableWriteAheadLog) {
+        this->ReplayWriteAheadLogs();
+        this->LimitWriteBufferMemory();
+    }
     return true;
 }
 
 void Db::Close() {
-    auto data = this->memtable->GetAllData();
-    if (!data.empty()) {
-        if (this->isLSMTree) {
-            return this->lsmTree->WriteMemtableData(data, this->searchType, this->dbPath);
-        }
-        std::string fileName = Utils::GetFilenameWithExt(std::to_string(this->allSSTs.size()));
-        std::string filePath = Utils::EnsureDirSlash(this->dbPath) + fileName;
-        SST *sstFile = new SST(filePath, data.size() * SST::KV_PAIR_BYTE_SIZE);
-        if (this->searchType == SearchType::B_TREE_SEARCH) {
-            sstFile->SetupBTreeFile();
-        }
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
-        sstFile->WriteFile(file, data, this->searchType, true);
-        this->allSSTs.push_back(sstFile);
+    std::lock_guard<std::mutex> writeLock(this->writeMutex);
+    std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    // Wait for the older memtables to be flushed so that the SST files keep the order of the writes.
+    this->stallCondition.wait(memtableLock, [this] { return this->immutableMemtables.empty(); });
+    if (!this->memtable->IsEmpty()) {
+        this->FlushMemtable(this->memtable);
+        this->memtable->Reset();
+    }
+    if (this->wal != nullptr) {
+        // Everything is in storage now, so none of the logs are needed anymore.
+        delete this->wal;
+        this->wal = nullptr;
+        WriteAheadLog::RemoveLogFilesBefore(this->dbPath, this->logNumber + 1);
+    }
+    if (this->isLSMTree) {
+        return;
     }
 
     // Clear out all SST file objects
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
     for (auto sstFile: this->allSSTs) {
         delete sstFile;
     }
     this->allSSTs.clear();
 }
 
-void Db::Put(uint64_t key, uint64_t value) {
-    // Insert this new node into the binary search tree
-    if (this->memtable->Put(key, value)) {
+void Db::FlushMemtable(Memtable *memtableToFlush) {
+    if (memtableToFlush->IsEmpty()) {
         return;
     }
+    uint64_t numEntries = memtableToFlush->GetCurrentSize();
 
-    auto data = this->memtable->GetAllData();
+    // Stream the entries straight from the memtable into the file.
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
+    EntryIterator *iterator = memtableToFlush->NewIterator();
     if (this->isLSMTree) {
-        this->lsmTree->WriteMemtableData(data, this->searchType, this->dbPath);
+        // The range tombstones go into the file too, even if the memtable holds nothing else.
+        this->lsmTree->WriteMemtableData(iterator, numEntries, this->searchType, this->dbPath,
+                                         &memtableToFlush->GetRangeTombstones());
+        delete iterator;
+        memtableToFlush->SetFlushed();
+        return;
+    }
+    std::string fileName = Utils::GetFilenameWithExt(std::to_string(this->allSSTs.size()));
+    std::string filePath = Utils::EnsureDirSlash(this->dbPath) + fileName;
+    SST *sstFile = new SST(filePath, numEntries * SST::KV_PAIR_BYTE_SIZE, nullptr, this->options.pageSize);
+    sstFile->SetPageChecksums(this->options.enablePageChecksums);
+    sstFile->SetReadMode(this->options.readMode);
+    sstFile->SetTableCache(this->tableCache);
+    if (this->searchType != SearchType::BINARY_SEARCH) {
+        sstFile->SetupBTreeFile(this->options.leafFormat, this->searchType == SearchType::LEARNED_INDEX);
+    }
+    AlignedFileWriter file(sstFile->GetFileName(), this->options.useDirectWrites, sstFile->GetMaxFileByteSize());
+    sstFile->WriteFile(file, iterator, this->searchType);
+    delete iterator;
+    this->allSSTs.push_back(sstFile);
+    memtableToFlush->SetFlushed();
+}
+
+void Db::SwitchMemtable(bool startNewLog) {
+    this->immutableMemtables.push_back(this->memtable);
+    if (this->spareMemtable != nullptr) {
+        this->memtable = this->spareMemtable;
+        this->spareMemtable = nullptr;
+    } else {
+        this->memtable = new Memtable(this->memtableSize, this->options.memtableType);
+    }
+    if (startNewLog) {
+        this->StartNewLog();
+    } else {
+        this->memtable->SetLogNumber(this->logNumber);
+    }
+    this->flushCondition.notify_one();
+}
+
+void Db::StartNewLog() {
+    if (this->wal != nullptr) {
+        this->logNumber++;
+        this->wal->Roll(this->logNumber);
+    }
+    this->memtable->SetLogNumber(this->logNumber);
+}
+
+void Db::RemoveObsoleteLogs() {
+    if (!this->options.enableWriteAheadLog) {
+        return;
+    }
+    // The key-value pairs in logs older than the oldest memtable that is not flushed are all in storage.
+    Memtable *oldestMemtable = this->immutableMemtables.empty() ? this->memtable : this->immutableMemtables.front();
+    WriteAheadLog::RemoveLogFilesBefore(this->dbPath, oldestMemtable->GetLogNumber());
+}
+
+void Db::ApplyWrite(const Writer &writer, std::unique_lock<std::shared_mutex> &memtableLock, bool startNewLog) {
+    if (writer.type == WalRecordType::RANGE_DELETION_RECORD) {
+        // The tombstone takes no room in the memtable, so it always fits.
+        this->memtable->DeleteRange(writer.entry.first, writer.entry.second);
+    } else if (writer.batch != nullptr) {
+        size_t nextEntry = this->memtable->PutSorted(*writer.batch, 0);
+        while (nextEntry < writer.batch->size()) {
+            this->MakeRoomForWrite(memtableLock, startNewLog);
+            nextEntry = this->memtable->PutSorted(*writer.batch, nextEntry);
+        }
+    } else {
+        while (!this->memtable->Put(writer.entry.first, writer.entry.second)) {
+            this->MakeRoomForWrite(memtableLock, startNewLog);
+        }
+    }
+}
+
+bool Db::CommitWrite(Writer &writer) {
+    if (this->wal == nullptr) {
+        std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+        this->ApplyWrite(writer, memtableLock);
+        this->UpdateMemoryUsage();
+        return true;
+    }
+
+    std::unique_lock<std::mutex> writersLock(this->writersMutex);
+    this->writers.push_back(&writer);
+    this->writersCondition.wait(writersLock, [this, &writer] {
+        return writer.isDone || this->writers.front() == &writer;
+    });
+    if (writer.isDone) {
+        return writer.success;
+    }
+
+    // Lead the group of every writer queued so far. The writers queuing up meanwhile wait for the next group.
+    std::vector<Writer *> group(this->writers.begin(), this->writers.end());
+    writersLock.unlock();
+    bool success = this->WriteGroup(group);
+    writersLock.lock();
+    for (Writer *groupWriter: group) {
+        groupWriter->isDone = true;
+        groupWriter->success = success;
+        this->writers.pop_front();
+    }
+    this->writersCondition.notify_all();
+    return success;
+}
+
+bool Db::WriteGroup(const std::vector<Writer *> &group) {
+    std::lock_guard<std::mutex> writeLock(this->writeMutex);
+    {
+        // A full memtable is replaced, along with its log, before the group is logged.
+        std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+        while (this->memtable->GetCurrentSize() >= this->memtable->GetMaxSize()) {
+            this->MakeRoomForWrite(memtableLock);
+        }
+    }
+
+    // The readers are not held up while the group is logged, only while it is applied.
+    for (const Writer *writer: group) {
+        if (writer->batch != nullptr) {
+            this->wal->AddRecord(writer->batch->data(), writer->batch->size(), writer->type);
+        } else {
+            this->wal->AddRecord(&writer->entry, 1, writer->type);
+        }
+    }
+    if (!this->wal->WriteRecords()) {
+        std::cerr << "Could not append to write-ahead log " << this->logNumber << std::endl;
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    for (const Writer *writer: group) {
+        // The rest of the group is in the current log, so a memtable filling up in the middle of
+        // the group is replaced by one sharing the log rather than starting a new one.
+        this->ApplyWrite(*writer, memtableLock, false);
+    }
+    this->UpdateMemoryUsage();
+    return true;
+}
+
+size_t Db::ComputeMemtableMemoryUsage() {
+    size_t memoryUsage = this->memtable->GetMemoryUsage();
+    for (Memtable *immutableMemtable: this->immutableMemtables) {
+        memoryUsage += immutableMemtable->GetMemoryUsage();
+    }
+    if (this->spareMemtable != nullptr) {
+        memoryUsage += this->spareMemtable->GetMemoryUsage();
+    }
+    return memoryUsage;
+}
+
+void Db::UpdateMemoryUsage() {
+    WriteBufferManager *writeBufferManager = this->options.writeBufferManager;
+    // The memory only changes when an arena takes a new block, so most writes stop here.
+    if (writeBufferManager == nullptr || this->ComputeMemtableMemoryUsage() == this->reportedMemoryUsage) {
+        return;
+    }
+    std::lock_guard<std::mutex> memoryUsageLock(this->memoryUsageMutex);
+    size_t memoryUsage = this->ComputeMemtableMemoryUsage();
+    if (memoryUsage > this->reportedMemoryUsage) {
+        writeBufferManager->ReserveMemory(memoryUsage - this->reportedMemoryUsage);
+    } else {
+        writeBufferManager->FreeMemory(this->reportedMemoryUsage - memoryUsage);
+    }
+    this->reportedMemoryUsage = memoryUsage;
+}
+
+void Db::LimitWriteBufferMemory() {
+    WriteBufferManager *writeBufferManager = this->options.writeBufferManager;
+    if (writeBufferManager != nullptr && writeBufferManager->ShouldFlush()) {
+        writeBufferManager->FlushLargestMemtable();
+    }
+}
+
+void Db::ReplayWriteAheadLogs() {
+    std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    delete this->wal;
+    this->wal = nullptr;
+
+    std::vector<uint64_t> logNumbers = WriteAheadLog::GetLogNumbers(this->dbPath);
+    this->logNumber = logNumbers.empty() ? 0 : logNumbers.front();
+    this->memtable->SetLogNumber(this->logNumber);
+    for (uint64_t replayedLogNumber: logNumbers) {
+        // A memtable that fills up during the replay is flushed as usual, and the memtable
+        // replacing it needs the log being replayed and the ones after it.
+        this->logNumber = replayedLogNumber;
+        std::vector<WalRecord> records;
+        WriteAheadLog::ReadLogFile(WriteAheadLog::GetLogFilePath(this->dbPath, replayedLogNumber), records);
+        for (const WalRecord &record: records) {
+            for (const DataEntry_t &entry: record.entries) {
+                if (record.type == WalRecordType::RANGE_DELETION_RECORD) {
+                    this->memtable->DeleteRange(entry.first, entry.second);
+                    continue;
+                }
+                while (!this->memtable->Put(entry.first, entry.second)) {
+                    this->MakeRoomForWrite(memtableLock);
+                }
+            }
+        }
+    }
+
+    // New writes go to a new log, rather than after a record that may have been cut short by a crash.
+    if (!logNumbers.empty()) {
+        this->logNumber = logNumbers.back() + 1;
+    }
+    if (this->memtable->GetCurrentSize() == 0) {
+        this->memtable->SetLogNumber(this->logNumber);
+    }
+    this->wal = new WriteAheadLog(this->dbPath, this->logNumber, this->options.walSyncMode,
+                                  this->options.walSyncIntervalMs);
+    this->RemoveObsoleteLogs();
+    this->UpdateMemoryUsage();
+}
+
+void Db::RunFlushThread() {
+    std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    while (true) {
+        this->flushCondition.wait(memtableLock, [this] {
+            return this->stopFlushThread || !this->immutableMemtables.empty();
+        });
+        if (this->immutableMemtables.empty()) {
+            return;
+        }
+
+        // The oldest immutable memtable stays in the queue, and readable, until its data is in
+        // storage. Nobody writes to it anymore so it can be read without holding the lock.
+        Memtable *immutableMemtable = this->immutableMemtables.front();
+        std::function<void()> flushedMemtableCallback = this->flushedMemtableCallback;
+        memtableLock.unlock();
+        this->FlushMemtable(immutableMemtable);
+        if (flushedMemtableCallback) {
+            flushedMemtableCallback();
+        }
+        memtableLock.lock();
+
+        this->immutableMemtables.pop_front();
+        if (this->spareMemtable == nullptr && !this->releaseFlushedMemtables) {
+            immutableMemtable->Reset();
+            this->spareMemtable = immutableMemtable;
+        } else {
+            delete immutableMemtable;
+        }
+        if (this->immutableMemtables.empty()) {
+            this->releaseFlushedMemtables = false;
+        }
+        this->RemoveObsoleteLogs();
+        this->UpdateMemoryUsage();
+        this->stallCondition.notify_all();
+    }
+}
+
+bool Db::Put(uint64_t key, uint64_t value) {
+    Writer writer = {WalRecordType::KEY_VALUE_RECORD, std::make_pair(key, value), nullptr, false, false};
+    bool isInserted = false;
+    if (this->wal == nullptr) {
+        // Without a log to keep in the same order as the memtable, writers only need to exclude
+        // each other when the memtable can't be written concurrently.
+        std::shared_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+        if (this->memtable->SupportsConcurrentWrites()) {
+            isInserted = this->memtable->Put(key, value);
+            if (isInserted) {
+                this->UpdateMemoryUsage();
+            }
+        }
+    }
+
+    // Otherwise the pair is inserted while the other writers are excluded, and logged first.
+    if (!isInserted && !this->CommitWrite(writer)) {
+        return false;
+    }
+    this->LimitWriteBufferMemory();
+    return true;
+}
+
+bool Db::Write(const WriteBatch &batch) {
+    if (!this->isLSMTree) {
+        for (const WriteBatch::Write &write: batch.GetWrites()) {
+            if (write.type == WriteBatch::UPDATE) {
+                std::cerr << "Update is not supported in a non-LSMTree db." << std::endl;
+            } else if (write.type == WriteBatch::DELETE) {
+                std::cerr << "Delete is not supported in a non-LSMTree db." << std::endl;
+            }
+        }
+    }
+    std::vector<DataEntry_t> entries = batch.GetSortedEntries(this->isLSMTree);
+    if (entries.empty()) {
+        return true;
+    }
+
+    // The batch is logged as one record, even if it is split between two memtables.
+    Writer writer = {WalRecordType::KEY_VALUE_RECORD, {}, &entries, false, false};
+    if (!this->CommitWrite(writer)) {
+        return false;
+    }
+    this->LimitWriteBufferMemory();
+    return true;
+}
+
+void Db::MakeRoomForWrite(std::unique_lock<std::shared_mutex> &memtableLock, bool startNewLog) {
+    if (this->options.maxImmutableMemtables <= 0) {
+        this->FlushMemtable(this->memtable);
+        // Reset and create a new memtable in the memory. Its log stays the same unless a new one is started.
+        this->memtable->Reset();
+        if (startNewLog) {
+            this->StartNewLog();
+            this->RemoveObsoleteLogs();
+        }
+    } else if ((int) this->immutableMemtables.size() < this->options.maxImmutableMemtables) {
+        this->SwitchMemtable(startNewLog);
+    } else {
+        // Too many memtables are waiting to be flushed, so wait for the flush thread to catch up.
+        this->stallCondition.wait(memtableLock);
+    }
+}
+
+bool Db::IngestFile(SST *sstFile) {
+    if (!this->isLSMTree) {
+        std::cerr << "IngestFile is not supported in a non-LSMTree db." << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> writeLock(this->writeMutex);
+    std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    // The pairs of the file are newer than the ones in the memtables, so any memtable holding
+    // keys or range tombstones within the range of the file has to be flushed first. Flush them
+    // all to keep the SST files in order.
+    uint64_t minKey = sstFile->GetMinKey();
+    uint64_t maxKey = sstFile->GetMaxKey();
+    bool memtablesOverlap = !this->memtable->Scan(minKey, maxKey).empty() ||
+                            this->memtable->GetRangeTombstones().OverlapsRange(minKey, maxKey);
+    for (Memtable *immutableMemtable: this->immutableMemtables) {
+        memtablesOverlap |= !immutableMemtable->Scan(minKey, maxKey).empty() ||
+                            immutableMemtable->GetRangeTombstones().OverlapsRange(minKey, maxKey);
+    }
+    if (memtablesOverlap) {
+        this->stallCondition.wait(memtableLock, [this] { return this->immutableMemtables.empty(); });
+        this->FlushMemtable(this->memtable);
+        this->memtable->Reset();
+        this->StartNewLog();
+        this->RemoveObsoleteLogs();
+    }
+
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
+    return this->lsmTree->IngestFile(sstFile, this->dbPath);
+}
+
+size_t Db::GetMemtableMemoryUsage() {
+    std::shared_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    return this->ComputeMemtableMemoryUsage();
+}
+
+size_t Db::GetActiveMemtableMemoryUsage() {
+    std::shared_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    return this->memtable->GetMemoryUsage();
+}
+
+void Db::ReleaseMemtable() {
+    // Switching to a new memtable starts a new log, which can't happen while a group is being written.
+    std::lock_guard<std::mutex> writeLock(this->writeMutex);
+    std::unique_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    // The spare memtable would keep the memory to give back, so a new memtable takes the writes instead.
+    delete this->spareMemtable;
+    this->spareMemtable = nullptr;
+    if (this->memtable->IsEmpty()) {
+        // Nothing to flush, but a memtable that was reset still holds the blocks of its arena.
+        uint64_t memtableLogNumber = this->memtable->GetLogNumber();
+        delete this->memtable;
+        this->memtable = new Memtable(this->memtableSize, this->options.memtableType);
+        this->memtable->SetLogNumber(memtableLogNumber);
+    } else if (this->options.maxImmutableMemtables <= 0) {
+        this->FlushMemtable(this->memtable);
+        delete this->memtable;
+        this->memtable = new Memtable(this->memtableSize, this->options.memtableType);
+        this->StartNewLog();
+        this->RemoveObsoleteLogs();
     } else {
-        auto fileName = this->dbPath + "/" + Utils::GetFilenameWithExt(std::to_string(this->allSSTs.size()));
-        int sstFileDataSize = data.size() * SST::KV_PAIR_BYTE_SIZE;
-        SST *sstFile = new SST(fileName, sstFileDataSize);
-        if (this->searchType == SearchType::B_TREE_SEARCH) {
-            sstFile->SetupBTreeFile();
+        // Once the queue is full, the flush thread already has the memtables to give back.
+        this->releaseFlushedMemtables = true;
+        if ((int) this->immutableMemtables.size() < this->options.maxImmutableMemtables) {
+            this->SwitchMemtable();
         }
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
-        sstFile->WriteFile(file, data, this->searchType, true);
-        this->allSSTs.push_back(sstFile);
     }
-    // Reset and create a new memtable in the memory
-    this->memtable->Reset();
-    this->memtable->Put(key, value);
+    this->UpdateMemoryUsage();
+}
+
+bool Db::GetFromMemtables(uint64_t key, uint64_t &value) {
+    value = this->memtable->Get(key);
+    bool isRangeDeleted = this->memtable->GetRangeTombstones().Covers(key);
+    // Then look in the immutable memtables from the newest one to the oldest one, unless
+    // a newer memtable has deleted the range of the key.
+    auto it = this->immutableMemtables.rbegin();
+    while (it != this->immutableMemtables.rend() && value == Utils::INVALID_VALUE && !isRangeDeleted) {
+        value = (*it)->Get(key);
+        isRangeDeleted = (*it)->GetRangeTombstones().Covers(key);
+        ++it;
+    }
+    if (value == Utils::INVALID_VALUE) {
+        return isRangeDeleted;
+    }
+    if (value == Utils::DELETED_KEY_VALUE) {
+        value = Utils::INVALID_VALUE; // Key does not exist since it has been deleted.
+    }
+    return true;
 }
 
 uint64_t Db::Get(uint64_t key) {
-    auto value = this->memtable->Get(key);
-    if (value != Utils::INVALID_VALUE) {
-        return value;
+    uint64_t value;
+    {
+        std::shared_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+        if (this->GetFromMemtables(key, value)) {
+            return value;
+        }
     }
 
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
     if (this->isLSMTree) {
         return this->lsmTree->Get(key, this->bufferPool);
     }
@@ -116,6 +584,11 @@ uint64_t Db::Get(uint64_t key) {
     auto it = this->allSSTs.rbegin();
     while (it != this->allSSTs.rend() && value == Utils::INVALID_VALUE) {
         SST *sstFile = *it;
+        // Skip the files whose key range does not hold the key without reading them.
+        if (!sstFile->OverlapsRange(key, key)) {
+            ++it;
+            continue;
+        }
         if (searchType == SearchType::BINARY_SEARCH) {
             value = sstFile->PerformBinarySearch(key, this->bufferPool);
         } else {
@@ -126,36 +599,139 @@ uint64_t Db::Get(uint64_t key) {
     return value;
 }
 
-void Db::Update(uint64_t key, uint64_t newValue) {
+void Db::MultiGet(const std::vector<uint64_t> &keys, std::vector<uint64_t> &values) {
+    values.assign(keys.size(), Utils::INVALID_VALUE);
+    std::vector<size_t> keyIndexesToFind;
+    {
+        std::shared_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (!this->GetFromMemtables(keys[i], values[i])) {
+                keyIndexesToFind.push_back(i);
+            }
+        }
+    }
+    if (keyIndexesToFind.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
     if (this->isLSMTree) {
-        Db::Put(key, newValue);
-    } else {
-        std::cerr << "Update is not supported in a non-LSMTree db." << std::endl;
+        this->lsmTree->MultiGet(keys, keyIndexesToFind, values, this->bufferPool);
+        return;
+    }
+
+    // Look for the keys in the sst files from the youngest one to the oldest one, all the keys
+    // still looked for in a file at once.
+    for (auto it = this->allSSTs.rbegin(); it != this->allSSTs.rend() && !keyIndexesToFind.empty(); ++it) {
+        SST *sstFile = *it;
+        std::vector<size_t> fileKeyIndexes;
+        std::vector<size_t> keyIndexesLeft;
+        for (size_t keyIndex: keyIndexesToFind) {
+            if (sstFile->OverlapsRange(keys[keyIndex], keys[keyIndex])) {
+                fileKeyIndexes.push_back(keyIndex);
+            } else {
+                keyIndexesLeft.push_back(keyIndex);
+            }
+        }
+
+        if (this->searchType == SearchType::BINARY_SEARCH) {
+            // The pages read by a binary search depend on the ones read before, so they are read one by one.
+            for (size_t keyIndex: fileKeyIndexes) {
+                values[keyIndex] = sstFile->PerformBinarySearch(keys[keyIndex], this->bufferPool);
+            }
+        } else if (!fileKeyIndexes.empty()) {
+            std::vector<uint64_t> fileKeys;
+            for (size_t keyIndex: fileKeyIndexes) {
+                fileKeys.push_back(keys[keyIndex]);
+            }
+            std::vector<uint64_t> fileValues;
+            sstFile->PerformBTreeMultiSearch(fileKeys, fileValues, this->bufferPool, this->isLSMTree,
+                                             this->asyncReader);
+            for (size_t i = 0; i < fileKeyIndexes.size(); i++) {
+                values[fileKeyIndexes[i]] = fileValues[i];
+            }
+        }
+        for (size_t keyIndex: fileKeyIndexes) {
+            if (values[keyIndex] == Utils::INVALID_VALUE) {
+                keyIndexesLeft.push_back(keyIndex);
+            }
+        }
+        keyIndexesToFind.swap(keyIndexesLeft);
     }
 }
 
-void Db::Delete(uint64_t key) {
+bool Db::Update(uint64_t key, uint64_t newValue) {
     if (this->isLSMTree) {
-        Db::Put(key, Utils::DELETED_KEY_VALUE);
-    } else {
-        std::cerr << "Delete is not supported in a non-LSMTree db." << std::endl;
+        return Db::Put(key, newValue);
     }
+    std::cerr << "Update is not supported in a non-LSMTree db." << std::endl;
+    return false;
+}
+
+bool Db::Delete(uint64_t key) {
+    if (this->isLSMTree) {
+        return Db::Put(key, Utils::DELETED_KEY_VALUE);
+    }
+    std::cerr << "Delete is not supported in a non-LSMTree db." << std::endl;
+    return false;
+}
+
+bool Db::DeleteRange(uint64_t key1, uint64_t key2) {
+    if (!this->isLSMTree) {
+        std::cerr << "DeleteRange is not supported in a non-LSMTree db." << std::endl;
+        return false;
+    }
+
+    // The bounds are logged as one pair, in a record of its own type so that it is not replayed as a put.
+    Writer writer = {WalRecordType::RANGE_DELETION_RECORD, std::make_pair(key1, key2), nullptr, false, false};
+    return this->CommitWrite(writer);
 }
 
 void Db::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult) {
+    // The range tombstones of the memtables scanned so far, which hide the keys of the older ones.
+    RangeTombstones newerRangeTombstones;
+    // Both locks are held while the memtables are scanned, otherwise a memtable could be flushed in
+    // between and its pairs found a second time in storage. The flushed memtables still queued are
+    // skipped for the same reason.
+    std::shared_lock<std::shared_mutex> memtableLock(this->memtableMutex);
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
     scanResult = this->memtable->Scan(key1, key2);
+    newerRangeTombstones = this->memtable->GetRangeTombstones();
+    for (auto it = this->immutableMemtables.rbegin(); it != this->immutableMemtables.rend(); ++it) {
+        if ((*it)->IsFlushed()) {
+            continue;
+        }
+        for (const DataEntry_t &entry: (*it)->Scan(key1, key2)) {
+            if (!newerRangeTombstones.Covers(entry.first)) {
+                scanResult.push_back(entry);
+            }
+        }
+        newerRangeTombstones.AddAll((*it)->GetRangeTombstones());
+    }
+    memtableLock.unlock();
     if (this->isLSMTree) {
-        return this->lsmTree->Scan(key1, key2, scanResult);
+        std::vector<DataEntry_t> storageResult;
+        this->lsmTree->Scan(key1, key2, storageResult);
+        for (const DataEntry_t &entry: storageResult) {
+            if (!newerRangeTombstones.Covers(entry.first)) {
+                scanResult.push_back(entry);
+            }
+        }
+        return;
     }
 
     // Look for the key in the sst files from the youngest one to the oldest one based on their creation time.
     auto it = this->allSSTs.rbegin();
     while (it != this->allSSTs.rend()) {
         SST *sstFile = *it;
+        if (!sstFile->OverlapsRange(key1, key2)) {
+            ++it;
+            continue;
+        }
         if (searchType == SearchType::BINARY_SEARCH) {
             sstFile->PerformBinaryScan(key1, key2, scanResult);
         } else {
-            sstFile->PerformBTreeScan(key1, key2, scanResult);
+            sstFile->PerformBTreeScan(key1, key2, scanResult, this->asyncReader);
         }
         ++it;
     }
@@ -163,6 +739,14 @@ void Db::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult
 
 // Used in experiments.
 void Db::ResetBufferPool(int bufferPoolMinSize, int bufferPoolMaxSize, EvictionPolicyType evictionPolicyType) {
+    std::lock_guard<std::mutex> storageLock(this->storageMutex);
     delete this->bufferPool;
-    this->bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicyType);
+    // The frames hold one page of the files this Db writes.
+    this->bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicyType, this->options.pageSize);
+}
+
+// Used in tests.
+void Db::SetFlushedMemtableCallback(std::function<void()> callback) {
+    std::lock_guard<std::shared_mutex> memtableLock(this->memtableMutex);
+    this->flushedMemtableCallback = std::move(callback);
 }
@@ -114,7 +114,7 @@ void ExtendibleHashtable::Split(const std::string &bucketId) {
     }
 
     // Re-hash all the pages in overflowing bucket
-    std::forward_list<Page *> pages = overflowBucket->GetPages();
+    std::vector<Page *> pages = overflowBucket->GetPages();
     this->size -= overflowBucket->GetSize();
     overflowBucket->Clear();
     for (Page *page : pages) {
@@ -134,7 +134,8 @@ void ExtendibleHashtable::Merge(const std::string &bucketId) {
 
     // Move all pages from currBucket to pairBucket, delete the currBucket object
     // and reassign current directory to pairBucket
-    std::forward_list<Page *>pages = currBucket->GetPages();
+    std::vector<Page *> pages = currBucket->GetPages();
+    currBucket->Clear();
     for (Page *page : pages) {
         pairBucket->Insert(page);
     }
@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <sys/mman.h>
+#include "FrameArena.h"
+#include "Page.h"
+
+FrameArena::FrameArena(size_t numFrames, size_t frameSize, bool useHugePages) {
+    this->frameSize = (frameSize + FrameArena::ALIGNMENT - 1) & ~(FrameArena::ALIGNMENT - 1);
+    this->useHugePages = useHugePages;
+    this->numFrames = 0;
+    this->Grow(numFrames);
+}
+
+FrameArena::~FrameArena() {
+    for (auto [region, numBytes]: this->regions) {
+        munmap(region, numBytes);
+    }
+    for (Page *pages: this->regionPages) {
+        delete[] pages;
+    }
+}
+
+void *FrameArena::MapRegion(size_t numBytes) const {
+    void *region = MAP_FAILED;
+    if (this->useHugePages) {
+        region = mmap(nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (region == MAP_FAILED) {
+        region = mmap(nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            perror("mmap");
+            return nullptr;
+        }
+        if (this->useHugePages) {
+            madvise(region, numBytes, MADV_HUGEPAGE);
+        }
+    }
+    return region;
+}
+
+void FrameArena::Grow(size_t numNewFrames) {
+    if (numNewFrames == 0) {
+        return;
+    }
+    size_t numBytes = numNewFrames * this->frameSize;
+    if (this->useHugePages) {
+        // Huge pages are mapped whole, so the frames take up the rest of the last one too.
+        numBytes = (numBytes + FrameArena::HUGE_PAGE_SIZE - 1) & ~(FrameArena::HUGE_PAGE_SIZE - 1);
+        numNewFrames = numBytes / this->frameSize;
+    }
+    void *region = this->MapRegion(numBytes);
+    if (region == nullptr) {
+        return;
+    }
+    this->regions.emplace_back(region, numBytes);
+    this->regionPages.push_back(new Page[numNewFrames]);
+    this->numFrames += numNewFrames;
+    this->freeFrames.reserve(this->numFrames);
+    // Hand out the frames in address order.
+    for (size_t i = numNewFrames; i > 0; i--) {
+        this->freeFrames.push_back((uint64_t *) ((char *) region + (i - 1) * this->frameSize));
+    }
+}
+
+Page *FrameArena::GetPage(const uint64_t *frame) const {
+    // There are only a few regions, one for the initial frames and one more each time the arena grows.
+    for (size_t i = 0; i < this->regions.size(); i++) {
+        auto [region, numBytes] = this->regions[i];
+        size_t byteOffset = (const char *) frame - (const char *) region;
+        if ((const char *) frame >= (const char *) region && byteOffset < numBytes) {
+            return &this->regionPages[i][byteOffset / this->frameSize];
+        }
+    }
+    return nullptr;
+}
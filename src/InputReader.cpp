@@ -1,11 +1,24 @@
 #include "InputReader.h"
 #include <iostream>
 
-InputReader::InputReader(uint64_t maxOffsetToRead, int capacity) {
+InputReader::InputReader(uint64_t maxOffsetToRead, int capacity, LeafFormat leafFormat, size_t pageSize) {
     this->inputBuffer = {};
+    this->numEntries = 0;
     this->offsetToRead = 0;
     this->bufferCapacity = capacity;
     this->maxOffsetToRead = maxOffsetToRead;
+    this->leafFormat = leafFormat;
+    this->pageSize = pageSize;
+    this->prefetcher = nullptr;
+}
+
+InputReader::~InputReader() {
+    delete this->prefetcher;
+}
+
+void InputReader::SetAsyncReader(AsyncReader *asyncReader) {
+    delete this->prefetcher;
+    this->prefetcher = asyncReader != nullptr ? new PagePrefetcher(asyncReader) : nullptr;
 }
 
 void InputReader::ObtainOffsetToRead(int fd) {
@@ -17,25 +30,35 @@ void InputReader::ObtainOffsetToRead(int fd) {
 
 void InputReader::ReadDataPagesInBuffer(int fd) {
     this->inputBuffer.clear();
+    this->numEntries = 0;
     if (this->offsetToRead > this->maxOffsetToRead) {
         return;
     }
 
     uint64_t numDataPagesToRead = std::min(this->bufferCapacity, this->maxOffsetToRead - this->offsetToRead + 1);
-    this->inputBuffer = SST::ReadPagesOfFile(fd, this->offsetToRead, numDataPagesToRead);
+    if (this->prefetcher != nullptr) {
+        uint64_t nextOffsetToRead = this->offsetToRead + numDataPagesToRead;
+        uint64_t numPagesToPrefetch = 0;
+        if (nextOffsetToRead <= this->maxOffsetToRead) {
+            numPagesToPrefetch = std::min(this->bufferCapacity, this->maxOffsetToRead - nextOffsetToRead + 1);
+        }
+        this->inputBuffer = SST::ReadLeafPagesOfFile(fd, this->offsetToRead, numDataPagesToRead, this->leafFormat,
+                                                     this->pageSize, this->prefetcher, numPagesToPrefetch);
+    } else {
+        this->inputBuffer = SST::ReadLeafPagesOfFile(fd, this->offsetToRead, numDataPagesToRead, this->leafFormat,
+                                                     this->pageSize);
+    }
+    this->numEntries = SST::GetLeafNumEntries(this->inputBuffer, this->leafFormat, this->pageSize);
     this->offsetToRead += numDataPagesToRead;
 }
 
 DataEntry_t InputReader::GetEntry(int index) {
-    DataEntry_t entry = std::make_pair(this->inputBuffer[index], this->inputBuffer[index + 1]);
-    if (this->inputBuffer[index] == Utils::INVALID_VALUE) {
-        // The number of entries in the file has not been page-aligned,
-        // and we have reached the end of the file, so we should stop reading.
-        this->inputBuffer.clear();
-    }
-    return entry;
+    // The buffer holds exactly the entries of the leaves read, as their headers tell, so there
+    // is no end of the data to look out for.
+    return std::make_pair(SST::GetLeafKey(this->inputBuffer, index / 2, this->leafFormat, this->pageSize),
+                          SST::GetLeafValue(this->inputBuffer, index / 2, this->leafFormat, this->pageSize));
 }
 
 uint64_t InputReader::GetInputBufferSize() {
-    return this->inputBuffer.size();
+    return this->numEntries * 2;
 }
\ No newline at end of file
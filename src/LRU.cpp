@@ -6,8 +6,7 @@ LRU::LRU() {
 }
 
 void LRU::Insert(Page *page) {
-    auto *newNode = new EvictionQueueNode(page, nullptr, nullptr);
-    page->SetEvictionQueueNode(newNode);
+    EvictionQueueNode *newNode = page->AddToEvictionQueue();
 
     if (this->evictionQueueHead == nullptr) {
         this->evictionQueueHead = newNode;
@@ -52,19 +51,34 @@ void LRU::UpdatePageAccessStatus(Page *accessedPage) {
     this->mostRecent = accessedNode;
 }
 
-// Evict the least recently used page
+// Evict the least recently used page that is not pinned
 Page *LRU::GetPageToEvict() {
     EvictionQueueNode *targetEvictionNode = this->evictionQueueHead;
+    while (targetEvictionNode != nullptr && targetEvictionNode->GetPage()->IsPinned()) {
+        targetEvictionNode = targetEvictionNode->GetNext();
+    }
+    if (targetEvictionNode == nullptr) {
+        return nullptr;
+    }
 
-    // Delete the EvictionQueueNode of this page, which is the first node of the queue.
+    // Delete the EvictionQueueNode of this page from the queue.
+    EvictionQueueNode *prev = targetEvictionNode->GetPrev();
     EvictionQueueNode *next = targetEvictionNode->GetNext();
+    if (prev != nullptr) {
+        prev->SetNext(next);
+    }
     if (next != nullptr) {
-        next->SetPrev(nullptr);
+        next->SetPrev(prev);
+    }
+    if (targetEvictionNode == this->evictionQueueHead) {
+        this->evictionQueueHead = next;
+    }
+    if (targetEvictionNode == this->mostRecent) {
+        this->mostRecent = prev;
     }
-    this->evictionQueueHead = next;
 
     Page *pageToEvict = targetEvictionNode->GetPage();
-    pageToEvict->SetEvictionQueueNode(nullptr);
+    pageToEvict->RemoveFromEvictionQueue();
     return pageToEvict;
 }
 
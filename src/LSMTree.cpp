@@ -9,6 +9,13 @@ LSMTree::LSMTree(int bloomFilterBitsPerEntry, int inputBufferCapacity, int outpu
     this->bitPerEntry = bloomFilterBitsPerEntry;
     this->inputBufferCapacity = inputBufferCapacity;
     this->outputBufferCapacity = outputBufferCapacity;
+    this->leafFormat = LeafFormat::RAW_LEAVES;
+    this->readMode = SSTReadMode::PREAD_READS;
+    this->asyncReader = nullptr;
+    this->tableCache = nullptr;
+    this->useDirectWrites = false;
+    this->pageSize = SST::PAGE_SIZE;
+    this->usePageChecksums = false;
 }
 
 LSMTree::~LSMTree() {
@@ -17,6 +24,34 @@ LSMTree::~LSMTree() {
     }
 }
 
+void LSMTree::SetLeafFormat(LeafFormat newLeafFormat) {
+    this->leafFormat = newLeafFormat;
+}
+
+void LSMTree::SetReadMode(SSTReadMode newReadMode) {
+    this->readMode = newReadMode;
+}
+
+void LSMTree::SetAsyncReader(AsyncReader *newAsyncReader) {
+    this->asyncReader = newAsyncReader;
+}
+
+void LSMTree::SetTableCache(TableCache *newTableCache) {
+    this->tableCache = newTableCache;
+}
+
+void LSMTree::SetDirectWrites(bool newUseDirectWrites) {
+    this->useDirectWrites = newUseDirectWrites;
+}
+
+void LSMTree::SetPageSize(size_t newPageSize) {
+    this->pageSize = newPageSize;
+}
+
+void LSMTree::SetPageChecksums(bool newUsePageChecksums) {
+    this->usePageChecksums = newUsePageChecksums;
+}
+
 void LSMTree::MaintainLevelCapacityAndCompact(Level *currLevel, std::string &dbPath) {
     int level = currLevel->GetLevelNumber();
     if (this->levels[level]->GetSSTFiles().size() <= 1) {
@@ -24,23 +59,80 @@ void LSMTree::MaintainLevelCapacityAndCompact(Level *currLevel, std::string &dbP
     }
 
     if (level + 1 >= this->levels.size()) {
-        auto *newLevel = new Level(level + 1, this->bitPerEntry, this->inputBufferCapacity, this->outputBufferCapacity);
+        auto *newLevel = new Level(level + 1, this->bitPerEntry, this->inputBufferCapacity, this->outputBufferCapacity,
+                                   this->leafFormat, this->readMode, this->asyncReader, this->tableCache,
+                                   this->useDirectWrites, this->pageSize, this->usePageChecksums);
         this->levels.push_back(newLevel);
     }
 
+    // The range tombstones are only needed as long as there are older keys below for them to hide.
+    bool isLastLevel = true;
+    for (int i = level + 1; i < this->levels.size(); i++) {
+        isLastLevel &= this->levels[i]->GetSSTFiles().empty();
+    }
+
     Level *nextLevel = this->levels[level + 1];
-    currLevel->SortMergeAndWriteToNextLevel(nextLevel, dbPath);
+    currLevel->SortMergeAndWriteToNextLevel(nextLevel, dbPath, isLastLevel);
     LSMTree::MaintainLevelCapacityAndCompact(nextLevel, dbPath);
 }
 
 void LSMTree::WriteMemtableData(std::vector<DataEntry_t> &data, SearchType searchType, std::string &dbPath) {
+    VectorEntryIterator iterator(data);
+    this->WriteMemtableData(&iterator, data.size(), searchType, dbPath);
+}
+
+void LSMTree::WriteMemtableData(EntryIterator *iterator, uint64_t numEntries, SearchType searchType,
+                                std::string &dbPath, const RangeTombstones *rangeTombstones) {
     // Always write the new sst files to the first level
     if (this->levels.empty()) {
-        auto *firstLevel = new Level(0, this->bitPerEntry, this->inputBufferCapacity, this->outputBufferCapacity);
+        auto *firstLevel = new Level(0, this->bitPerEntry, this->inputBufferCapacity, this->outputBufferCapacity,
+                                     this->leafFormat, this->readMode, this->asyncReader, this->tableCache,
+                                     this->useDirectWrites, this->pageSize, this->usePageChecksums);
         this->levels.push_back(firstLevel);
     }
-    this->levels[0]->WriteDataToLevel(data, searchType, dbPath);
+    this->levels[0]->WriteDataToLevel(iterator, numEntries, searchType, dbPath, rangeTombstones);
+    LSMTree::MaintainLevelCapacityAndCompact(this->levels[0], dbPath);
+}
+
+bool LSMTree::IngestFile(SST *sstFile, std::string &dbPath) {
+    uint64_t minKey = sstFile->GetMinKey();
+    uint64_t maxKey = sstFile->GetMaxKey();
+
+    // Go down the levels until one holds keys of the file, since the file has to stay above
+    // the older values of its keys. Levels hold at most one file, so only empty levels will do.
+    int targetLevel = -1;
+    int levelIndex = 0;
+    while (levelIndex < this->levels.size() && !this->levels[levelIndex]->OverlapsRange(minKey, maxKey)) {
+        if (this->levels[levelIndex]->GetSSTFiles().empty()) {
+            targetLevel = levelIndex;
+        }
+        levelIndex++;
+    }
+    if (levelIndex == this->levels.size() && (this->levels.empty() || targetLevel != levelIndex - 1)) {
+        // None of the levels hold keys of the file, so it can go below all of them.
+        targetLevel = (int) this->levels.size();
+        this->levels.push_back(new Level(targetLevel, this->bitPerEntry, this->inputBufferCapacity,
+                                         this->outputBufferCapacity, this->leafFormat, this->readMode,
+                                         this->asyncReader, this->tableCache, this->useDirectWrites,
+                                         this->pageSize, this->usePageChecksums));
+    }
+
+    if (targetLevel >= 0) {
+        return this->levels[targetLevel]->IngestSSTFile(sstFile, dbPath);
+    }
+    if (!this->levels[0]->IngestSSTFile(sstFile, dbPath)) {
+        return false;
+    }
     LSMTree::MaintainLevelCapacityAndCompact(this->levels[0], dbPath);
+    return true;
+}
+
+std::vector<size_t> LSMTree::GetIndexMemoryUsage() const {
+    std::vector<size_t> memoryUsage;
+    for (Level *level: this->levels) {
+        memoryUsage.push_back(level->GetIndexMemoryUsage());
+    }
+    return memoryUsage;
 }
 
 std::vector<Level *> LSMTree::GetLevels() {
@@ -62,21 +154,84 @@ uint64_t LSMTree::Get(uint64_t key, BufferPool *bufferPool) {
         // In an LSM tree with size ratio of greater than 2, we would need to make sure we traverse
         // from the most recent file of each level first, but we do not need to handle this in our case.
         for (SST *sstFile: level->GetSSTFiles()) {
-            uint64_t value = sstFile->PerformBTreeSearch(key, bufferPool, true);
+            // Skip the files whose key range does not hold the key without reading them, such
+            // as the ones written from a memtable holding only range tombstones.
+            uint64_t value = Utils::INVALID_VALUE;
+            if (sstFile->OverlapsRange(key, key)) {
+                value = sstFile->PerformBTreeSearch(key, bufferPool, true);
+            }
             if (value == Utils::DELETED_KEY_VALUE) {
                 return Utils::INVALID_VALUE; // Key does not exist since it has been deleted.
             } else if (value != Utils::INVALID_VALUE) {
                 return value; // Key exists.
+            } else if (sstFile->GetRangeTombstones().Covers(key)) {
+                return Utils::INVALID_VALUE; // Key does not exist since its range has been deleted.
             }
         }
     }
     return Utils::INVALID_VALUE; // Key does not exist.
 }
 
+void LSMTree::MultiGet(const std::vector<uint64_t> &keys, const std::vector<size_t> &keyIndexes,
+                       std::vector<uint64_t> &values, BufferPool *bufferPool) {
+    std::vector<size_t> keyIndexesToFind = keyIndexes;
+    for (Level *level: this->levels) {
+        for (SST *sstFile: level->GetSSTFiles()) {
+            if (keyIndexesToFind.empty()) {
+                return;
+            }
+
+            // Skip the keys whose range the file does not hold, as Get does.
+            std::vector<uint64_t> fileKeys;
+            for (size_t keyIndex: keyIndexesToFind) {
+                if (sstFile->OverlapsRange(keys[keyIndex], keys[keyIndex])) {
+                    fileKeys.push_back(keys[keyIndex]);
+                }
+            }
+            std::vector<uint64_t> fileValues;
+            if (!fileKeys.empty()) {
+                sstFile->PerformBTreeMultiSearch(fileKeys, fileValues, bufferPool, true, this->asyncReader);
+            }
+
+            // Keep looking for the keys that are neither in the file nor deleted by it.
+            std::vector<size_t> keyIndexesLeft;
+            size_t fileKeyIndex = 0;
+            for (size_t keyIndex: keyIndexesToFind) {
+                uint64_t value = Utils::INVALID_VALUE;
+                if (sstFile->OverlapsRange(keys[keyIndex], keys[keyIndex])) {
+                    value = fileValues[fileKeyIndex++];
+                }
+                if (value == Utils::DELETED_KEY_VALUE) {
+                    values[keyIndex] = Utils::INVALID_VALUE;
+                } else if (value != Utils::INVALID_VALUE) {
+                    values[keyIndex] = value;
+                } else if (sstFile->GetRangeTombstones().Covers(keys[keyIndex])) {
+                    values[keyIndex] = Utils::INVALID_VALUE;
+                } else {
+                    keyIndexesLeft.push_back(keyIndex);
+                }
+            }
+            keyIndexesToFind.swap(keyIndexesLeft);
+        }
+    }
+}
+
+bool LSMTree::OverlapsScanRange(SST *sstFile, uint64_t key1, uint64_t key2) {
+    return sstFile->OverlapsRange(key1, key2) || sstFile->GetRangeTombstones().OverlapsRange(key1, key2);
+}
+
 void LSMTree::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult) {
     uint64_t curKeyToLookFor = key1;
     uint64_t curKeyToLookForCounter = 0;
     std::vector<bool> allLevelsScanned(this->levels.size());
+    // The files holding neither keys nor range tombstones within the range are never read, and
+    // the levels with none of the other files are done already.
+    for (int levelIndex = 0; levelIndex < this->levels.size(); levelIndex++) {
+        std::vector<SST *> sstFiles = this->levels[levelIndex]->GetSSTFiles();
+        allLevelsScanned[levelIndex] = std::none_of(sstFiles.begin(), sstFiles.end(), [key1, key2](SST *sstFile) {
+            return LSMTree::OverlapsScanRange(sstFile, key1, key2);
+        });
+    }
     // The 2nd condition captures when are looking for key2 but even after the last level,
     // we could not find it. In this case the key2 does not exist and we stop.
     while (curKeyToLookFor <= key2 &&
@@ -85,29 +240,34 @@ void LSMTree::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanR
         while (levelIndex < this->levels.size()) {
             Level *level = this->levels[levelIndex];
             curKeyToLookForCounter++;
-            if (!level->GetSSTFiles().empty()) {
+            if (!allLevelsScanned[levelIndex]) {
                 // In case of size ratio of 2, there is at most one sst file in each level.
                 for (SST *sstFile: level->GetSSTFiles()) {
-                    int fd = Utils::OpenFile(sstFile->GetFileName());
+                    if (!LSMTree::OverlapsScanRange(sstFile, key1, key2)) {
+                        continue;
+                    }
+                    int fd = sstFile->AcquireFile();
                     if (fd == -1) {
                         return;
                     }
 
                     ScanInputReader *inputReader = sstFile->GetScanInputReader();
                     if (!inputReader->IsLeavesRangeToScanSet()) {
-                        uint64_t startOffsetToScan = SST::ReadBTreeScanLeavesRange(fd, curKeyToLookFor);
+                        uint64_t startOffsetToScan = sstFile->FindLeafOffset(curKeyToLookFor, fd);
                         inputReader->SetLeavesRangeToScan(startOffsetToScan, sstFile->GetMaxOffsetToReadLeaves(), fd);
                     }
 
                     if (inputReader->GetInputBufferSize()) {
                         DataEntry_t entry = inputReader->FindKey(curKeyToLookFor, fd);
-                        close(fd);
-                        if (entry.second != Utils::INVALID_VALUE) {
-                            if (entry.second != Utils::DELETED_KEY_VALUE) {
+                        sstFile->ReleaseFile(fd);
+                        if (entry.second != Utils::INVALID_VALUE ||
+                            sstFile->GetRangeTombstones().Covers(curKeyToLookFor)) {
+                            if (entry.second != Utils::INVALID_VALUE && entry.second != Utils::DELETED_KEY_VALUE) {
                                 scanResult.push_back(entry);
                             }
 
-                            // The curKeyToLookFor was found, so proceed to look for the next key.
+                            // The curKeyToLookFor was found, or its range was deleted, so proceed
+                            // to look for the next key.
                             curKeyToLookFor++;
                             curKeyToLookForCounter = 0;
                             levelIndex = this->levels.size();
@@ -119,14 +279,19 @@ void LSMTree::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanR
                             curKeyToLookForCounter = 0;
                         }
                     } else {
-                        close(fd);
+                        sstFile->ReleaseFile(fd);
+                        if (sstFile->GetRangeTombstones().Covers(curKeyToLookFor)) {
+                            // The range of curKeyToLookFor was deleted, so the older levels don't matter.
+                            curKeyToLookFor++;
+                            curKeyToLookForCounter = 0;
+                            levelIndex = this->levels.size();
+                            break;
+                        }
                     }
                     if (inputReader->IsScannedCompletely()) {
                         allLevelsScanned[levelIndex] = true;
                     }
                 }
-            } else {
-                allLevelsScanned[levelIndex] = true;
             }
             levelIndex++;
         }
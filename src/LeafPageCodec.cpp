@@ -0,0 +1,262 @@
+#include "LeafPageCodec.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LEAF_PAGE_CODEC_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    inline uint64_t UnpackValue(const uint64_t *words, uint64_t bit, uint64_t numBits, uint64_t mask) {
+        uint64_t word = bit / 64;
+        uint64_t shift = bit % 64;
+        uint64_t value = words[word] >> shift;
+        if (shift + numBits > 64) {
+            value |= words[word + 1] << (64 - shift);
+        }
+        return value & mask;
+    }
+
+    void UnpackBitsScalar(const uint64_t *words, uint64_t bitOffset, uint64_t numBits, uint64_t mask,
+                          uint64_t numValues, uint64_t base, uint64_t *output, uint64_t outputStride) {
+        for (uint64_t i = 0; i < numValues; i++) {
+            output[i * outputStride] = UnpackValue(words, bitOffset + i * numBits, numBits, mask) + base;
+        }
+    }
+
+#ifdef LEAF_PAGE_CODEC_X86
+    /**
+     * Unpack two values at once. There are no shifts by a different count per lane before AVX2,
+     * so each value is shifted out of the two words it may span in a general purpose register,
+     * and only masked, offset and stored in a vector.
+     */
+    __attribute__((target("sse4.2")))
+    void UnpackBitsSSE42(const uint64_t *words, uint64_t bitOffset, uint64_t numBits, uint64_t mask,
+                         uint64_t numValues, uint64_t base, uint64_t *output, uint64_t outputStride) {
+        // The word after the one a value starts in is read even if the value does not span it, as
+        // its bits are masked off then, but not past the last word holding a value.
+        uint64_t lastWord = (bitOffset + numValues * numBits - 1) / 64;
+        __m128i maskVector = _mm_set1_epi64x((long long) mask);
+        __m128i baseVector = _mm_set1_epi64x((long long) base);
+        uint64_t i = 0;
+        for (; i + 2 <= numValues; i += 2) {
+            uint64_t bit0 = bitOffset + i * numBits;
+            uint64_t bit1 = bit0 + numBits;
+            uint64_t word0 = bit0 / 64;
+            uint64_t word1 = bit1 / 64;
+            unsigned __int128 pair0 = (unsigned __int128) words[std::min(word0 + 1, lastWord)] << 64 | words[word0];
+            unsigned __int128 pair1 = (unsigned __int128) words[std::min(word1 + 1, lastWord)] << 64 | words[word1];
+            __m128i values = _mm_set_epi64x((long long) (uint64_t) (pair1 >> (bit1 % 64)),
+                                            (long long) (uint64_t) (pair0 >> (bit0 % 64)));
+            values = _mm_add_epi64(_mm_and_si128(values, maskVector), baseVector);
+            if (outputStride == 1) {
+                _mm_storeu_si128((__m128i *) (output + i), values);
+            } else {
+                output[i * outputStride] = _mm_cvtsi128_si64(values);
+                output[(i + 1) * outputStride] = _mm_extract_epi64(values, 1);
+            }
+        }
+        UnpackBitsScalar(words, bitOffset + i * numBits, numBits, mask, numValues - i, base,
+                         output + i * outputStride, outputStride);
+    }
+
+    /**
+     * Unpack four values at once, gathering the words each of them starts and ends in and
+     * shifting every lane by its own count.
+     */
+    __attribute__((target("avx2")))
+    void UnpackBitsAVX2(const uint64_t *words, uint64_t bitOffset, uint64_t numBits, uint64_t mask,
+                        uint64_t numValues, uint64_t base, uint64_t *output, uint64_t outputStride) {
+        const auto *wordsArray = (const long long *) words;
+        __m256i maskVector = _mm256_set1_epi64x((long long) mask);
+        __m256i baseVector = _mm256_set1_epi64x((long long) base);
+        __m256i lastShiftInWord = _mm256_set1_epi64x((long long) (64 - numBits));
+        __m256i bitStep = _mm256_set1_epi64x((long long) (4 * numBits));
+        __m256i bits = _mm256_add_epi64(_mm256_set1_epi64x((long long) bitOffset),
+                                        _mm256_set_epi64x((long long) (3 * numBits), (long long) (2 * numBits),
+                                                          (long long) numBits, 0));
+        __m256i one = _mm256_set1_epi64x(1);
+        __m256i sixtyFour = _mm256_set1_epi64x(64);
+        __m256i shiftMask = _mm256_set1_epi64x(63);
+        uint64_t i = 0;
+        for (; i + 4 <= numValues; i += 4) {
+            __m256i wordIndexes = _mm256_srli_epi64(bits, 6);
+            __m256i shifts = _mm256_and_si256(bits, shiftMask);
+            __m256i low = _mm256_i64gather_epi64(wordsArray, wordIndexes, 8);
+            // The word after is only read by the values spanning two words, as it may be past the payload.
+            __m256i spansTwoWords = _mm256_cmpgt_epi64(shifts, lastShiftInWord);
+            __m256i high = _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), wordsArray,
+                                                       _mm256_add_epi64(wordIndexes, one), spansTwoWords, 8);
+            // Shifting left by 64 gives 0, for the values that start a word.
+            __m256i values = _mm256_or_si256(_mm256_srlv_epi64(low, shifts),
+                                             _mm256_sllv_epi64(high, _mm256_sub_epi64(sixtyFour, shifts)));
+            values = _mm256_add_epi64(_mm256_and_si256(values, maskVector), baseVector);
+            if (outputStride == 1) {
+                _mm256_storeu_si256((__m256i *) (output + i), values);
+            } else {
+                alignas(32) uint64_t lanes[4];
+                _mm256_store_si256((__m256i *) lanes, values);
+                for (uint64_t lane = 0; lane < 4; lane++) {
+                    output[(i + lane) * outputStride] = lanes[lane];
+                }
+            }
+            bits = _mm256_add_epi64(bits, bitStep);
+        }
+        UnpackBitsScalar(words, bitOffset + i * numBits, numBits, mask, numValues - i, base,
+                         output + i * outputStride, outputStride);
+    }
+#endif
+}
+
+uint64_t LeafPageCodec::GetNumBits(uint64_t value) {
+    uint64_t numBits = 0;
+    while (numBits < 64 && (value >> numBits) != 0) {
+        numBits++;
+    }
+    return numBits;
+}
+
+uint64_t LeafPageCodec::GetPackedNumWords(uint64_t numEntries, uint64_t keyBits, uint64_t valueBits) {
+    // The first key is in the header, so there is one key delta less than there are values.
+    uint64_t numBits = (numEntries - 1) * keyBits + numEntries * valueBits;
+    return (numBits + 63) / 64;
+}
+
+void LeafPageCodec::PackBits(uint64_t *words, uint64_t bitOffset, uint64_t value, uint64_t numBits) {
+    if (numBits == 0) {
+        return;
+    }
+    uint64_t word = bitOffset / 64;
+    uint64_t shift = bitOffset % 64;
+    words[word] |= value << shift;
+    if (shift + numBits > 64) {
+        words[word + 1] |= value >> (64 - shift);
+    }
+}
+
+void LeafPageCodec::UnpackBits(const uint64_t *words, uint64_t bitOffset, uint64_t numBits, uint64_t numValues,
+                               uint64_t base, uint64_t *output, uint64_t outputStride, SearchKernel kernel) {
+    if (numBits == 0) {
+        for (uint64_t i = 0; i < numValues; i++) {
+            output[i * outputStride] = base;
+        }
+        return;
+    }
+
+    // Every value is unpacked the same way, without depending on the previous one, so that
+    // several of them are unpacked at once.
+    uint64_t mask = numBits == 64 ? ~0ULL : (1ULL << numBits) - 1;
+    switch (kernel) {
+#ifdef LEAF_PAGE_CODEC_X86
+        case AVX2_KERNEL:
+            return UnpackBitsAVX2(words, bitOffset, numBits, mask, numValues, base, output, outputStride);
+        case SSE42_KERNEL:
+            return UnpackBitsSSE42(words, bitOffset, numBits, mask, numValues, base, output, outputStride);
+#endif
+        default:
+            return UnpackBitsScalar(words, bitOffset, numBits, mask, numValues, base, output, outputStride);
+    }
+}
+
+size_t LeafPageCodec::GetMinEntriesPerPage(size_t pageNumWords) {
+    return ((pageNumWords - LeafPageCodec::HEADER_NUM_WORDS) * 64 + 64) / 128;
+}
+
+size_t LeafPageCodec::GetMaxEntriesPerPage(size_t pageNumWords) {
+    return LeafPageCodec::MAX_ENTRIES_PER_PAGE * pageNumWords / LeafPageCodec::PAGE_NUM_WORDS;
+}
+
+size_t LeafPageCodec::Encode(const DataEntry_t *entries, size_t numEntries, uint64_t *page, size_t pageNumWords) {
+    std::memset(page, 0, pageNumWords * sizeof(uint64_t));
+    if (numEntries == 0) {
+        return 0;
+    }
+
+    // Take entries as long as the page can hold them with the bits per delta and value they need.
+    uint64_t minDelta = Utils::INVALID_VALUE;
+    uint64_t maxDelta = 0;
+    uint64_t minValue = entries[0].second;
+    uint64_t maxValue = entries[0].second;
+    uint64_t keyBits = 0;
+    uint64_t valueBits = 0;
+    size_t numEncoded = 1;
+    size_t maxEntries = numEntries;
+    if (maxEntries > LeafPageCodec::GetMaxEntriesPerPage(pageNumWords)) {
+        maxEntries = LeafPageCodec::GetMaxEntriesPerPage(pageNumWords);
+    }
+    while (numEncoded < maxEntries) {
+        uint64_t delta = entries[numEncoded].first - entries[numEncoded - 1].first;
+        uint64_t newMinDelta = std::min(minDelta, delta);
+        uint64_t newMaxDelta = std::max(maxDelta, delta);
+        uint64_t newMinValue = std::min(minValue, entries[numEncoded].second);
+        uint64_t newMaxValue = std::max(maxValue, entries[numEncoded].second);
+        uint64_t newKeyBits = LeafPageCodec::GetNumBits(newMaxDelta - newMinDelta);
+        uint64_t newValueBits = LeafPageCodec::GetNumBits(newMaxValue - newMinValue);
+        uint64_t numWords = LeafPageCodec::GetPackedNumWords(numEncoded + 1, newKeyBits, newValueBits);
+        if (LeafPageCodec::HEADER_NUM_WORDS + numWords > pageNumWords) {
+            break;
+        }
+        minDelta = newMinDelta;
+        maxDelta = newMaxDelta;
+        minValue = newMinValue;
+        maxValue = newMaxValue;
+        keyBits = newKeyBits;
+        valueBits = newValueBits;
+        numEncoded++;
+    }
+    if (numEncoded == 1) {
+        minDelta = 0;
+    }
+
+    page[0] = numEncoded | (keyBits << 32) | (valueBits << 40);
+    page[1] = entries[0].first;
+    page[2] = minDelta;
+    page[3] = minValue;
+    uint64_t *payload = page + LeafPageCodec::HEADER_NUM_WORDS;
+    uint64_t bitOffset = 0;
+    for (size_t i = 1; i < numEncoded; i++) {
+        uint64_t delta = entries[i].first - entries[i - 1].first;
+        LeafPageCodec::PackBits(payload, bitOffset, delta - minDelta, keyBits);
+        bitOffset += keyBits;
+    }
+    for (size_t i = 0; i < numEncoded; i++) {
+        LeafPageCodec::PackBits(payload, bitOffset, entries[i].second - minValue, valueBits);
+        bitOffset += valueBits;
+    }
+    return numEncoded;
+}
+
+size_t LeafPageCodec::GetNumEntries(const uint64_t *page) {
+    return page[0] & 0xFFFFFFFF;
+}
+
+void LeafPageCodec::Decode(const uint64_t *page, std::vector<uint64_t> &data, size_t pageNumWords) {
+    LeafPageCodec::Decode(page, data, pageNumWords, SearchKernels::GetBestKernel());
+}
+
+void LeafPageCodec::Decode(const uint64_t *page, std::vector<uint64_t> &data, size_t pageNumWords,
+                           SearchKernel kernel) {
+    uint64_t numEntries = LeafPageCodec::GetNumEntries(page);
+    if (numEntries == 0 || numEntries > LeafPageCodec::GetMaxEntriesPerPage(pageNumWords)) {
+        return;
+    }
+    uint64_t keyBits = (page[0] >> 32) & 0xFF;
+    uint64_t valueBits = (page[0] >> 40) & 0xFF;
+    uint64_t minDelta = page[2];
+    uint64_t minValue = page[3];
+    const uint64_t *payload = page + LeafPageCodec::HEADER_NUM_WORDS;
+
+    // Unpack the deltas and values straight into their slots of the interleaved layout, each
+    // added to the smallest one. Only the keys are left to add up from the deltas.
+    size_t start = data.size();
+    data.resize(start + numEntries * 2);
+    uint64_t *entries = data.data() + start;
+    entries[0] = page[1];
+    LeafPageCodec::UnpackBits(payload, 0, keyBits, numEntries - 1, minDelta, entries + 2, 2, kernel);
+    LeafPageCodec::UnpackBits(payload, (numEntries - 1) * keyBits, valueBits, numEntries, minValue, entries + 1, 2,
+                              kernel);
+    for (uint64_t i = 1; i < numEntries; i++) {
+        entries[i * 2] += entries[(i - 1) * 2];
+    }
+}
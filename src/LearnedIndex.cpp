@@ -0,0 +1,134 @@
+#include "LearnedIndex.h"
+#include "SearchKernels.h"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+LearnedIndex::LearnedIndex() {
+    this->numKeys = 0;
+    this->minSlope = 0;
+    this->maxSlope = std::numeric_limits<double>::infinity();
+}
+
+void LearnedIndex::SetLastSegmentSlope() {
+    // Any line within the cone fits all the keys of the segment. The one in the middle is the
+    // furthest from both edges, which leaves room for rounding errors.
+    if (this->maxSlope == std::numeric_limits<double>::infinity()) {
+        this->segmentSlopes.back() = this->minSlope;
+    } else {
+        this->segmentSlopes.back() = (this->minSlope + this->maxSlope) / 2;
+    }
+}
+
+void LearnedIndex::AddKey(uint64_t key) {
+    uint64_t position = this->numKeys++;
+    if (!this->segmentFirstKeys.empty()) {
+        // Narrow the cone of the lines through the first key of the segment to the ones that
+        // predict the position of this key within MAX_ERROR.
+        auto keyDistance = (double) (key - this->segmentFirstKeys.back());
+        auto positionDistance = (double) (position - this->segmentFirstPositions.back());
+        double newMinSlope = std::max(this->minSlope, (positionDistance - MAX_ERROR) / keyDistance);
+        double newMaxSlope = std::min(this->maxSlope, (positionDistance + MAX_ERROR) / keyDistance);
+        if (newMinSlope <= newMaxSlope) {
+            this->minSlope = newMinSlope;
+            this->maxSlope = newMaxSlope;
+            this->SetLastSegmentSlope();
+            return;
+        }
+    }
+
+    // No line fits the key together with the keys before it, so start a new segment from it.
+    this->segmentFirstKeys.push_back(key);
+    this->segmentFirstPositions.push_back(position);
+    this->segmentSlopes.push_back(0);
+    this->minSlope = 0;
+    this->maxSlope = std::numeric_limits<double>::infinity();
+}
+
+uint64_t LearnedIndex::GetNumKeys() const {
+    return this->numKeys;
+}
+
+size_t LearnedIndex::GetNumSegments() const {
+    return this->segmentFirstKeys.size();
+}
+
+std::pair<uint64_t, uint64_t> LearnedIndex::GetSearchRange(uint64_t key) const {
+    size_t numSegments = this->segmentFirstKeys.size();
+    size_t segment = SearchKernels::LowerBound(this->segmentFirstKeys.data(), numSegments, key);
+    if (segment == numSegments || this->segmentFirstKeys[segment] != key) {
+        // The key is smaller than all the keys, so they are all not smaller than it.
+        if (segment == 0) {
+            return std::make_pair(0, 0);
+        }
+        segment--;
+    }
+
+    // The key is after the first key of its segment, and not after the first key of the next one.
+    uint64_t minPosition = this->segmentFirstPositions[segment];
+    uint64_t maxPosition = segment + 1 < numSegments ? this->segmentFirstPositions[segment + 1] : this->numKeys;
+    double predictedPosition = (double) minPosition +
+                               this->segmentSlopes[segment] * (double) (key - this->segmentFirstKeys[segment]);
+
+    // A key in between two keys is predicted in between their positions, so the range is one
+    // position wider than the error. Another one makes up for the rounding of the predictions.
+    double first = predictedPosition - (double) MAX_ERROR - 2;
+    double last = std::ceil(predictedPosition + (double) MAX_ERROR + 2);
+    uint64_t firstPosition = first <= (double) minPosition ? minPosition : (uint64_t) first;
+    uint64_t lastPosition = last >= (double) maxPosition ? maxPosition : (uint64_t) last;
+    if (firstPosition > lastPosition) {
+        firstPosition = lastPosition;
+    }
+    return std::make_pair(firstPosition, lastPosition);
+}
+
+void LearnedIndex::Serialize(std::vector<uint64_t> &words) const {
+    words.push_back(this->numKeys);
+    words.push_back(this->segmentFirstKeys.size());
+    for (size_t i = 0; i < this->segmentFirstKeys.size(); i++) {
+        uint64_t slopeBits;
+        std::memcpy(&slopeBits, &this->segmentSlopes[i], sizeof(uint64_t));
+        words.push_back(this->segmentFirstKeys[i]);
+        words.push_back(this->segmentFirstPositions[i]);
+        words.push_back(slopeBits);
+    }
+}
+
+bool LearnedIndex::Deserialize(const std::vector<uint64_t> &words) {
+    this->Clear();
+    if (words.size() < LearnedIndex::HEADER_NUM_WORDS) {
+        return false;
+    }
+    uint64_t numSegments = words[1];
+    if (words.size() < LearnedIndex::HEADER_NUM_WORDS + numSegments * LearnedIndex::SEGMENT_NUM_WORDS) {
+        return false;
+    }
+    this->numKeys = words[0];
+    this->segmentFirstKeys.reserve(numSegments);
+    this->segmentFirstPositions.reserve(numSegments);
+    this->segmentSlopes.reserve(numSegments);
+    for (uint64_t i = 0; i < numSegments; i++) {
+        const uint64_t *segment = &words[LearnedIndex::HEADER_NUM_WORDS + i * LearnedIndex::SEGMENT_NUM_WORDS];
+        double slope;
+        std::memcpy(&slope, &segment[2], sizeof(double));
+        this->segmentFirstKeys.push_back(segment[0]);
+        this->segmentFirstPositions.push_back(segment[1]);
+        this->segmentSlopes.push_back(slope);
+    }
+    return true;
+}
+
+size_t LearnedIndex::GetMemoryUsage() const {
+    return (this->segmentFirstKeys.capacity() + this->segmentFirstPositions.capacity()) * sizeof(uint64_t) +
+           this->segmentSlopes.capacity() * sizeof(double);
+}
+
+void LearnedIndex::Clear() {
+    this->segmentFirstKeys.clear();
+    this->segmentFirstPositions.clear();
+    this->segmentSlopes.clear();
+    this->numKeys = 0;
+    this->minSlope = 0;
+    this->maxSlope = std::numeric_limits<double>::infinity();
+}
@@ -5,12 +5,21 @@
 #include "Level.h"
 
 
-Level::Level(int level, int bloomFilterBitsPerEntry, int inputBufferCapacity, int outputBufferCapacity) {
+Level::Level(int level, int bloomFilterBitsPerEntry, int inputBufferCapacity, int outputBufferCapacity,
+             LeafFormat leafFormat, SSTReadMode readMode, AsyncReader *asyncReader, TableCache *tableCache,
+             bool useDirectWrites, size_t pageSize, bool usePageChecksums) {
     this->level = level;
     this->bloomFilterBitsPerEntry = bloomFilterBitsPerEntry;
     this->sstFiles = {};
     this->inputBufferCapacity = inputBufferCapacity;
     this->outputBufferCapacity = outputBufferCapacity;
+    this->leafFormat = leafFormat;
+    this->readMode = readMode;
+    this->asyncReader = asyncReader;
+    this->tableCache = tableCache;
+    this->useDirectWrites = useDirectWrites;
+    this->pageSize = pageSize;
+    this->usePageChecksums = usePageChecksums;
 }
 
 Level::~Level() {
@@ -23,26 +32,74 @@ int Level::GetLevelNumber() const {
     return this->level;
 }
 
-void Level::WriteDataToLevel(std::vector<DataEntry_t> data, SearchType searchType, std::string &dbPath) {
+void Level::WriteDataToLevel(std::vector<DataEntry_t> &data, SearchType searchType, std::string &dbPath) {
+    VectorEntryIterator iterator(data);
+    this->WriteDataToLevel(&iterator, data.size(), searchType, dbPath);
+}
+
+void Level::WriteDataToLevel(EntryIterator *iterator, uint64_t numEntries, SearchType searchType,
+                             std::string &dbPath, const RangeTombstones *rangeTombstones) {
     std::string fileName = Utils::GetFilenameWithExt(std::to_string(this->sstFiles.size()));
     std::string filePath = dbPath + "/" + Utils::LEVEL + std::to_string(this->level) + "-" + fileName;
-    uint64_t dataByteSize = data.size() * SST::KV_PAIR_BYTE_SIZE;
-    auto *bloomFilter = new BloomFilter(this->bloomFilterBitsPerEntry, data.size());
-    bloomFilter->InsertKeys(data);
-    SST *sstFile = new SST(filePath, dataByteSize, bloomFilter);
-    sstFile->SetupBTreeFile();
-    sstFile->SetInputReader(new InputReader(sstFile->GetMaxOffsetToReadLeaves(), this->inputBufferCapacity));
-    sstFile->SetScanInputReader(new ScanInputReader(this->inputBufferCapacity));
-    std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
-    sstFile->WriteFile(file, data, searchType, true);
+    uint64_t dataByteSize = numEntries * SST::KV_PAIR_BYTE_SIZE;
+    // The keys are added to the bloom filter as they are written.
+    auto *bloomFilter = new BloomFilter(this->bloomFilterBitsPerEntry, numEntries);
+    SST *sstFile = new SST(filePath, dataByteSize, bloomFilter, this->pageSize);
+    sstFile->SetPageChecksums(this->usePageChecksums);
+    sstFile->SetReadMode(this->readMode);
+    sstFile->SetTableCache(this->tableCache);
+    sstFile->SetupBTreeFile(this->leafFormat, searchType == SearchType::LEARNED_INDEX);
+    sstFile->SetScanInputReader(new ScanInputReader(this->inputBufferCapacity, this->leafFormat, this->pageSize));
+    sstFile->GetScanInputReader()->SetAsyncReader(this->asyncReader);
+    if (rangeTombstones != nullptr) {
+        sstFile->SetRangeTombstones(*rangeTombstones);
+    }
+    AlignedFileWriter file(sstFile->GetFileName(), this->useDirectWrites, sstFile->GetMaxFileByteSize());
+    sstFile->WriteFile(file, iterator, searchType, this->outputBufferCapacity);
+    // The internal levels follow the leaves, so only read the leaves up to where they end.
+    sstFile->SetInputReader(
+            new InputReader(sstFile->GetMaxOffsetToReadLeaves(), this->inputBufferCapacity, this->leafFormat,
+                            this->pageSize));
+    sstFile->GetInputReader()->SetAsyncReader(this->asyncReader);
     this->sstFiles.push_back(sstFile);
 }
 
-void WriteRemainingData(int fd, int index, BloomFilter *bloomFilter, InputReader *reader, OutputWriter *outputWriter) {
+bool Level::IngestSSTFile(SST *sstFile, std::string &dbPath) {
+    std::string fileName = Utils::GetFilenameWithExt(std::to_string(this->sstFiles.size()));
+    std::string filePath = dbPath + "/" + Utils::LEVEL + std::to_string(this->level) + "-" + fileName;
+    if (!sstFile->MoveFile(filePath)) {
+        return false;
+    }
+    sstFile->SetReadMode(this->readMode);
+    sstFile->SetTableCache(this->tableCache);
+    // The file keeps the page size it was written with, whatever the page size of the level.
+    sstFile->SetInputReader(new InputReader(sstFile->GetMaxOffsetToReadLeaves(), this->inputBufferCapacity,
+                                            sstFile->GetLeafFormat(), sstFile->GetPageSize()));
+    sstFile->SetScanInputReader(new ScanInputReader(this->inputBufferCapacity, sstFile->GetLeafFormat(),
+                                                    sstFile->GetPageSize()));
+    sstFile->GetInputReader()->SetAsyncReader(this->asyncReader);
+    sstFile->GetScanInputReader()->SetAsyncReader(this->asyncReader);
+    this->sstFiles.push_back(sstFile);
+    return true;
+}
+
+bool Level::OverlapsRange(uint64_t key1, uint64_t key2) const {
+    for (SST *sstFile: this->sstFiles) {
+        if (sstFile->OverlapsRange(key1, key2) || sstFile->GetRangeTombstones().OverlapsRange(key1, key2)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WriteRemainingData(int fd, int index, BloomFilter *bloomFilter, InputReader *reader, OutputWriter *outputWriter,
+                        const RangeTombstones &newerRangeTombstones) {
     while (index < reader->GetInputBufferSize()) {
         DataEntry_t entry = reader->GetEntry(index);
-        outputWriter->AddToOutputBuffer(entry);
-        bloomFilter->InsertKey(entry.first);
+        if (!newerRangeTombstones.Covers(entry.first)) {
+            outputWriter->AddToOutputBuffer(entry);
+            bloomFilter->InsertKey(entry.first);
+        }
         index += 2;
         // In the edge case when sst1Reader has greater keys than the sst2Reader,
         // make sure you read all the contents of sst1Reader.
@@ -53,7 +110,7 @@ void WriteRemainingData(int fd, int index, BloomFilter *bloomFilter, InputReader
     }
 }
 
-void Level::SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath) {
+void Level::SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath, bool isLastLevel) {
     uint64_t sstDataSize = 0;
     for (auto sstFile: this->sstFiles) {
         sstDataSize += sstFile->GetFileDataSize();
@@ -64,22 +121,36 @@ void Level::SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath)
     std::string filePath = dbPath + "/" + Utils::LEVEL + std::to_string(nextLevel->level) + "-" + fileName;
     int maxNumKeys = std::ceil(sstDataSize / SST::KV_PAIR_BYTE_SIZE);
     auto *bloomFilter = new BloomFilter(this->bloomFilterBitsPerEntry, maxNumKeys);
-    SST *sortMergedFile = new SST(filePath, sstDataSize, bloomFilter);
-
-    sortMergedFile->SetupBTreeFile();
-    sortMergedFile->SetInputReader(
-            new InputReader(sortMergedFile->GetMaxOffsetToReadLeaves(), this->inputBufferCapacity));
-    sortMergedFile->SetScanInputReader(new ScanInputReader(this->inputBufferCapacity));
+    SST *sortMergedFile = new SST(filePath, sstDataSize, bloomFilter, nextLevel->pageSize);
+    sortMergedFile->SetPageChecksums(nextLevel->usePageChecksums);
+    sortMergedFile->SetReadMode(nextLevel->readMode);
+    sortMergedFile->SetTableCache(nextLevel->tableCache);
+
+    // The merged file is searched the same way as the files it is merged from.
+    sortMergedFile->SetupBTreeFile(nextLevel->leafFormat, this->sstFiles[1]->HasLearnedIndex());
+    sortMergedFile->SetScanInputReader(new ScanInputReader(this->inputBufferCapacity, nextLevel->leafFormat,
+                                                           nextLevel->pageSize));
+    sortMergedFile->GetScanInputReader()->SetAsyncReader(nextLevel->asyncReader);
     nextLevel->AddSSTFile(sortMergedFile);
 
+    // The range tombstones of the newer file are applied to the older file here. They, and the ones
+    // of the older file, still have to hide the keys of the levels below, if there are any.
+    const RangeTombstones &newerRangeTombstones = this->sstFiles[1]->GetRangeTombstones();
+    if (!isLastLevel) {
+        RangeTombstones mergedRangeTombstones = this->sstFiles[0]->GetRangeTombstones();
+        mergedRangeTombstones.AddAll(newerRangeTombstones);
+        sortMergedFile->SetRangeTombstones(mergedRangeTombstones);
+    }
+
     // Sort-merge data
-    int fd1 = Utils::OpenFile(this->sstFiles[0]->GetFileName());
+    int fd1 = this->sstFiles[0]->AcquireFile();
     if (fd1 == -1) {
         return;
     }
 
-    int fd2 = Utils::OpenFile(this->sstFiles[1]->GetFileName());
+    int fd2 = this->sstFiles[1]->AcquireFile();
     if (fd2 == -1) {
+        this->sstFiles[0]->ReleaseFile(fd1);
         return;
     }
 
@@ -90,7 +161,7 @@ void Level::SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath)
     sst2Reader->ObtainOffsetToRead(fd2);
 
     // Consider the output buffer size to be this->bufferCapacity page
-    auto *outputWriter = new OutputWriter(sortMergedFile, this->outputBufferCapacity);
+    auto *outputWriter = new OutputWriter(sortMergedFile, this->outputBufferCapacity, nextLevel->useDirectWrites);
 
     sst1Reader->ReadDataPagesInBuffer(fd1);
     sst2Reader->ReadDataPagesInBuffer(fd2);
@@ -100,8 +171,10 @@ void Level::SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath)
         DataEntry_t entry1 = sst1Reader->GetEntry(index1);
         DataEntry_t entry2 = sst2Reader->GetEntry(index2);
         if (entry1.first < entry2.first) {
-            outputWriter->AddToOutputBuffer(entry1);
-            bloomFilter->InsertKey(entry1.first);
+            if (!newerRangeTombstones.Covers(entry1.first)) {
+                outputWriter->AddToOutputBuffer(entry1);
+                bloomFilter->InsertKey(entry1.first);
+            }
             index1 += 2;
         } else if (entry2.first < entry1.first) {
             outputWriter->AddToOutputBuffer(entry2);
@@ -127,19 +200,25 @@ void Level::SortMergeAndWriteToNextLevel(Level *nextLevel, std::string &dbPath)
 
     // Write all the elements of the dataBuffer that still has remaining data to the output buffer
     if (sst1Reader->GetInputBufferSize()) {
-        WriteRemainingData(fd1, index1, bloomFilter, sst1Reader, outputWriter);
+        WriteRemainingData(fd1, index1, bloomFilter, sst1Reader, outputWriter, newerRangeTombstones);
     } else if (sst2Reader->GetInputBufferSize()) {
-        WriteRemainingData(fd2, index2, bloomFilter, sst2Reader, outputWriter);
+        WriteRemainingData(fd2, index2, bloomFilter, sst2Reader, outputWriter, RangeTombstones());
     }
 
-    int numPagesWrittenToFile = outputWriter->WriteEndOfFile();
-    // We now have the exact number of pages of data that we wrote
-    // to the B-tree's leaf level, so update the file's data size.
-    sortMergedFile->SetFileDataSize(numPagesWrittenToFile * SST::KV_PAIRS_PER_PAGE * SST::KV_PAIR_BYTE_SIZE);
+    uint64_t numEntriesWrittenToFile = outputWriter->WriteEndOfFile();
+    delete outputWriter;
+    // We now have the exact number of entries that we wrote to the B-tree's leaf level, since
+    // updated or deleted keys are only written once, so update the file's data size. The internal
+    // levels follow the leaves, so only read the leaves up to where they end.
+    sortMergedFile->SetFileDataSize(numEntriesWrittenToFile * SST::KV_PAIR_BYTE_SIZE);
+    sortMergedFile->SetInputReader(new InputReader(sortMergedFile->GetMaxOffsetToReadLeaves(),
+                                                   this->inputBufferCapacity, nextLevel->leafFormat,
+                                                   nextLevel->pageSize));
+    sortMergedFile->GetInputReader()->SetAsyncReader(nextLevel->asyncReader);
 
     // Close files
-    close(fd1);
-    close(fd2);
+    this->sstFiles[0]->ReleaseFile(fd1);
+    this->sstFiles[1]->ReleaseFile(fd2);
 
     // Empty this level.
     Level::DeleteSSTFiles();
@@ -153,9 +232,20 @@ std::vector<SST *> Level::GetSSTFiles() {
     return this->sstFiles;
 }
 
+size_t Level::GetIndexMemoryUsage() const {
+    size_t memoryUsage = 0;
+    for (SST *sstFile: this->sstFiles) {
+        memoryUsage += sstFile->GetIndexMemoryUsage();
+    }
+    return memoryUsage;
+}
+
 void Level::DeleteSSTFiles() {
+    // The files are deleted with their SST objects, which unmap them if they are mapped, as a
+    // deleted file keeps taking disk space as long as it is mapped.
     for (auto sstFile: this->sstFiles) {
         std::filesystem::remove(sstFile->GetFileName());
+        delete sstFile;
     }
     this->sstFiles = {};
 }
\ No newline at end of file
@@ -1,30 +1,68 @@
 #include "Memtable.h"
+#include <algorithm>
 
 // Memtable constructor
-Memtable::Memtable(int maxSize) {
+Memtable::Memtable(int maxSize, MemtableType memtableType) {
     this->maxSize = maxSize;
-    this->redBlackTree = new RedBlackTree();
+    this->logNumber = 0;
+    this->isFlushed = false;
+    this->arena = new Arena();
+    if (memtableType == MemtableType::SKIP_LIST) {
+        this->index = new SkipList(this->arena);
+    } else if (memtableType == MemtableType::B_PLUS_TREE) {
+        this->index = new BPlusTree(this->arena);
+    } else {
+        this->index = new RedBlackTree(this->arena);
+    }
 }
 
 Memtable::~Memtable() {
-    delete this->redBlackTree;
+    delete this->index;
+    delete this->arena;
 }
 
 bool Memtable::Put(uint64_t key, uint64_t value) {
     if (this->GetCurrentSize() + 1 > this->maxSize) {
         return false;
     }
-    this->redBlackTree->Insert(key, value);
+    this->index->Insert(key, value);
     return true;
 }
 
+size_t Memtable::PutSorted(const std::vector<DataEntry_t> &entries, size_t start) {
+    while (start < entries.size()) {
+        // Insert as many pairs as there is room for at once. Pairs that overwrite an existing
+        // key take no room, so check again for room for the rest afterwards.
+        int room = this->maxSize - this->GetCurrentSize();
+        if (room <= 0) {
+            break;
+        }
+        size_t end = std::min(entries.size(), start + room);
+        this->index->InsertSorted(entries, start, end);
+        start = end;
+    }
+    return start;
+}
+
+void Memtable::DeleteRange(uint64_t key1, uint64_t key2) {
+    // Overwriting the keys that are already here takes no room, so it works on a full memtable too.
+    for (const DataEntry_t &entry: this->Scan(key1, key2)) {
+        this->index->Insert(entry.first, Utils::DELETED_KEY_VALUE);
+    }
+    this->rangeTombstones.Add(key1, key2);
+}
+
+const RangeTombstones &Memtable::GetRangeTombstones() const {
+    return this->rangeTombstones;
+}
+
 uint64_t Memtable::Get(uint64_t key) {
-    return this->redBlackTree->Search(key);
+    return this->index->Search(key);
 }
 
 std::vector<DataEntry_t> Memtable::Scan(uint64_t key1, uint64_t key2) {
     std::vector<DataEntry_t> nodesList;
-    RedBlackTree::InorderTraversal(this->redBlackTree->GetRoot(), key1, key2, nodesList);
+    this->index->Scan(key1, key2, nodesList);
     return nodesList;
 }
 
@@ -33,14 +71,49 @@ int Memtable::GetMaxSize() const {
 }
 
 int Memtable::GetCurrentSize() {
-    return this->redBlackTree->GetCurrentSize();
+    return this->index->GetCurrentSize();
+}
+
+bool Memtable::IsEmpty() {
+    return this->GetCurrentSize() == 0 && this->rangeTombstones.IsEmpty();
+}
+
+bool Memtable::SupportsConcurrentWrites() const {
+    return this->index->SupportsConcurrentWrites();
+}
+
+size_t Memtable::GetMemoryUsage() const {
+    return this->arena->GetMemoryUsage();
+}
+
+uint64_t Memtable::GetLogNumber() const {
+    return this->logNumber;
+}
+
+void Memtable::SetLogNumber(uint64_t logNumber) {
+    this->logNumber = logNumber;
+}
+
+bool Memtable::IsFlushed() const {
+    return this->isFlushed;
+}
+
+void Memtable::SetFlushed() {
+    this->isFlushed = true;
+}
+
+EntryIterator *Memtable::NewIterator() {
+    return this->index->NewIterator();
 }
 
 std::vector<DataEntry_t> Memtable::GetAllData() {
-    return this->Scan(this->redBlackTree->GetMinKey(), this->redBlackTree->GetMaxKey());
+    return this->Scan(0, std::numeric_limits<uint64_t>::max());
 }
 
 void Memtable::Reset() {
-    delete this->redBlackTree;
-    this->redBlackTree = new RedBlackTree();
+    // All the nodes live in the arena, so dropping them is just a matter of rewinding it.
+    this->index->Clear();
+    this->arena->Reset();
+    this->rangeTombstones.Clear();
+    this->isFlushed = false;
 }
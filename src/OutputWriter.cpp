@@ -1,29 +1,33 @@
 #include "OutputWriter.h"
 #include <iostream>
 
-OutputWriter::OutputWriter(SST *sstFile, int capacity) {
+OutputWriter::OutputWriter(SST *sstFile, int capacity, bool useDirectWrites) {
     this->sstFile = sstFile;
-    this->file.open(sstFile->GetFileName(), std::ios::out | std::ios::binary);
-    this->bufferCapacity = capacity * SST::KV_PAIRS_PER_PAGE;
+    this->file = new AlignedFileWriter(sstFile->GetFileName(), useDirectWrites, sstFile->GetMaxFileByteSize());
+    this->bufferCapacity = capacity * sstFile->GetKVPairsPerPage();
     this->outputBuffer = {};
-    this->numPagesWrittenToFile = 0;
+    this->numEntriesWrittenToFile = 0;
+}
+
+OutputWriter::~OutputWriter() {
+    delete this->file;
 }
 
 void OutputWriter::AddToOutputBuffer(DataEntry_t entry) {
     this->outputBuffer.push_back(entry);
     if (this->outputBuffer.size() >= this->bufferCapacity) {
-        this->sstFile->WriteBTreeLevels(this->file, this->outputBuffer, false);
-        this->numPagesWrittenToFile += this->outputBuffer.size() / SST::KV_PAIRS_PER_PAGE;
+        this->sstFile->WriteBTreeLevels(*this->file, this->outputBuffer, false);
+        this->numEntriesWrittenToFile += this->outputBuffer.size();
         this->outputBuffer.clear();
     }
 }
 
-int OutputWriter::WriteEndOfFile() {
-    if (!this->outputBuffer.empty()) {
-        this->sstFile->WriteBTreeLevels(this->file, this->outputBuffer, false);
-        this->numPagesWrittenToFile += this->outputBuffer.size() / SST::KV_PAIRS_PER_PAGE;
-        this->outputBuffer.clear();
-    }
-    this->sstFile->WriteEndOfBTreeFile(this->file);
-    return this->numPagesWrittenToFile;
+uint64_t OutputWriter::WriteEndOfFile() {
+    // Write the last entries as the end of the leaves, even if there are none left, so that
+    // the last leaf is marked if it is not full and the end of the leaves is known.
+    this->sstFile->WriteBTreeLevels(*this->file, this->outputBuffer, true);
+    this->numEntriesWrittenToFile += this->outputBuffer.size();
+    this->outputBuffer.clear();
+    this->sstFile->WriteEndOfBTreeFile(*this->file);
+    return this->numEntriesWrittenToFile;
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "PageHeader.h"
+#include "xxhash.h"
+
+uint64_t PageHeader::ComputeChecksum(const uint64_t *page, size_t pageNumWords) {
+    const uint64_t *payload = page + PageHeader::NUM_WORDS;
+    return XXH64(payload, PageHeader::GetPayloadNumWords(pageNumWords) * sizeof(uint64_t), page[0]);
+}
+
+void PageHeader::Write(uint64_t *page, size_t pageNumWords, PageType type, size_t numEntries, bool hasChecksum) {
+    uint64_t flags = hasChecksum ? PageHeader::HAS_CHECKSUM_FLAG : 0;
+    page[0] = (PageHeader::PAGE_MAGIC << PageHeader::MAGIC_SHIFT) | (flags << PageHeader::FLAGS_SHIFT) |
+              ((uint64_t) type << PageHeader::TYPE_SHIFT) | (numEntries & PageHeader::NUM_ENTRIES_MASK);
+    page[1] = hasChecksum ? PageHeader::ComputeChecksum(page, pageNumWords) : 0;
+}
+
+bool PageHeader::IsValid(const uint64_t *page) {
+    return page[0] >> PageHeader::MAGIC_SHIFT == PageHeader::PAGE_MAGIC;
+}
+
+PageType PageHeader::GetType(const uint64_t *page) {
+    return (PageType) ((page[0] >> PageHeader::TYPE_SHIFT) & 0xFF);
+}
+
+size_t PageHeader::GetNumEntries(const uint64_t *page) {
+    return PageHeader::IsValid(page) ? page[0] & PageHeader::NUM_ENTRIES_MASK : 0;
+}
+
+size_t PageHeader::GetNumEntryWords(const uint64_t *page) {
+    size_t numEntries = PageHeader::GetNumEntries(page);
+    PageType type = PageHeader::GetType(page);
+    // The leaves count their key-value pairs, the other pages their words.
+    if (type == PageType::ENTRIES_PAGE || type == PageType::COLUMNAR_LEAF_PAGE) {
+        return numEntries * 2;
+    }
+    return numEntries;
+}
+
+bool PageHeader::IsIntact(const uint64_t *page, size_t pageNumWords) {
+    if (!PageHeader::IsValid(page)) {
+        return false;
+    }
+    bool hasChecksum = (page[0] >> PageHeader::FLAGS_SHIFT) & PageHeader::HAS_CHECKSUM_FLAG;
+    return !hasChecksum || page[1] == PageHeader::ComputeChecksum(page, pageNumWords);
+}
@@ -0,0 +1,52 @@
+#include "RangeTombstones.h"
+#include <algorithm>
+
+void RangeTombstones::Add(uint64_t key1, uint64_t key2) {
+    if (key1 > key2) {
+        return;
+    }
+
+    // Find the first range that ends right before key1 or after it, then swallow every
+    // range that starts within [key1, key2 + 1].
+    auto it = std::lower_bound(this->ranges.begin(), this->ranges.end(), key1,
+                               [](const DataEntry_t &range, uint64_t key) {
+                                   return range.second < key && range.second + 1 < key;
+                               });
+    auto last = it;
+    while (last != this->ranges.end() && (last->first <= key2 || last->first - 1 <= key2)) {
+        key1 = std::min(key1, last->first);
+        key2 = std::max(key2, last->second);
+        ++last;
+    }
+    it = this->ranges.erase(it, last);
+    this->ranges.insert(it, std::make_pair(key1, key2));
+}
+
+void RangeTombstones::AddAll(const RangeTombstones &other) {
+    for (const DataEntry_t &range: other.ranges) {
+        this->Add(range.first, range.second);
+    }
+}
+
+bool RangeTombstones::Covers(uint64_t key) const {
+    return this->OverlapsRange(key, key);
+}
+
+bool RangeTombstones::OverlapsRange(uint64_t key1, uint64_t key2) const {
+    // The first range that does not end before key1 is the only one that can overlap.
+    auto it = std::lower_bound(this->ranges.begin(), this->ranges.end(), key1,
+                               [](const DataEntry_t &range, uint64_t key) { return range.second < key; });
+    return it != this->ranges.end() && it->first <= key2;
+}
+
+bool RangeTombstones::IsEmpty() const {
+    return this->ranges.empty();
+}
+
+const std::vector<DataEntry_t> &RangeTombstones::GetRanges() const {
+    return this->ranges;
+}
+
+void RangeTombstones::Clear() {
+    this->ranges.clear();
+}
@@ -1,16 +1,63 @@
 #include "RedBlackTree.h"
 #include <iostream>
 #include <queue>
+#include <new>
 
-RedBlackTree::RedBlackTree(Node *root) {
-    this->root = root;
+RedBlackTree::RedBlackTree(Arena *arena) {
+    this->root = nullptr;
+    this->arena = arena;
     this->currentSize = 0;
     this->maxKey = 0;
     this->minKey = std::numeric_limits<uint64_t>::max();
 }
 
 RedBlackTree::~RedBlackTree() {
-    delete this->root;
+    this->DeleteNodes();
+}
+
+Node *RedBlackTree::NewNode(uint64_t key, uint64_t value, Node *parent) {
+    // Color of a new node is always red.
+    if (this->arena == nullptr) {
+        return new Node(key, value, nullptr, nullptr, parent, RED);
+    }
+    return new(this->arena->Allocate(sizeof(Node))) Node(key, value, nullptr, nullptr, parent, RED);
+}
+
+void RedBlackTree::DeleteNodes() {
+    // Nodes allocated from an arena are released all at once with the arena.
+    if (this->arena != nullptr) {
+        return;
+    }
+
+    // Delete the nodes in post-order by following the parent pointers, so that
+    // we do not need a recursion as deep as the tree.
+    Node *node = this->root;
+    while (node != nullptr) {
+        if (node->GetLeftChild() != nullptr) {
+            node = node->GetLeftChild();
+        } else if (node->GetRightChild() != nullptr) {
+            node = node->GetRightChild();
+        } else {
+            Node *parent = node->GetParent();
+            if (parent != nullptr) {
+                if (parent->GetLeftChild() == node) {
+                    parent->SetLeftChild(nullptr);
+                } else {
+                    parent->SetRightChild(nullptr);
+                }
+            }
+            delete node;
+            node = parent;
+        }
+    }
+}
+
+void RedBlackTree::Clear() {
+    this->DeleteNodes();
+    this->root = nullptr;
+    this->currentSize = 0;
+    this->maxKey = 0;
+    this->minKey = std::numeric_limits<uint64_t>::max();
 }
 
 Node *RedBlackTree::GetRoot() {
@@ -100,9 +147,35 @@ void RedBlackTree::RotateLeft(Node *node) {
     ConnectParentWithNewChild(parent, node, rightChild);
 }
 
-void RedBlackTree::Insert(uint64_t key, uint64_t value) {
+bool RedBlackTree::Insert(uint64_t key, uint64_t value) {
+    int previousSize = this->currentSize;
+    this->InsertFrom(this->root, key, value);
+    return this->currentSize > previousSize;
+}
 
-    Node *node = this->root;
+void RedBlackTree::InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) {
+    Node *finger = nullptr;
+    for (size_t i = start; i < end; i++) {
+        uint64_t key = entries[i].first;
+        Node *node = this->root;
+        if (finger != nullptr && finger->GetKey() == this->maxKey) {
+            // The previous key is the largest one in the tree, so the key goes right below it.
+            node = finger;
+        } else if (finger != nullptr && finger->GetKey() < key) {
+            // Climb from the previous key until reaching a node that is the left child of a
+            // parent with a greater key, since the subtree of that node covers the key.
+            node = finger;
+            while (node->GetParent() != nullptr && node->GetParent()->GetKey() <= key) {
+                node = node->GetParent();
+            }
+        }
+        finger = this->InsertFrom(node, key, entries[i].second);
+    }
+}
+
+Node *RedBlackTree::InsertFrom(Node *start, uint64_t key, uint64_t value) {
+
+    Node *node = start;
     Node *parent = nullptr;
 
     // Find the new position for this new node
@@ -110,14 +183,18 @@ void RedBlackTree::Insert(uint64_t key, uint64_t value) {
         parent = node;
         if (key > node->GetKey()) {
             node = node->GetRightChild();
-        } else if (key <= node->GetKey()) {
+        } else if (key < node->GetKey()) {
             node = node->GetLeftChild();
+        } else {
+            // The key already exists, so the newer value replaces the older one.
+            node->SetValue(value);
+            return node;
         }
     }
 
     // At this point the variable parent refers to parent of this new node
     // Color of the new node is red.
-    Node *newNode = new Node(key, value, nullptr, nullptr, parent, RED);
+    Node *newNode = this->NewNode(key, value, parent);
 
     if (parent == nullptr) {
         this->root = newNode;
@@ -136,6 +213,7 @@ void RedBlackTree::Insert(uint64_t key, uint64_t value) {
     if (key < this->minKey) {
         this->minKey = key;
     }
+    return newNode;
 }
 
 void RedBlackTree::MaintainRedBlackTreePropertiesAfterInsert(Node *node) {
@@ -239,6 +317,14 @@ void RedBlackTree::MaintainRedBlackTreePropertiesAfterInsert(Node *node) {
     }
 }
 
+void RedBlackTree::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) {
+    RedBlackTree::InorderTraversal(this->root, key1, key2, nodesList);
+}
+
+EntryIterator *RedBlackTree::NewIterator() {
+    return new Iterator(this);
+}
+
 void RedBlackTree::InorderTraversal(Node *node, uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) {
     // Since the red-black tree is a balanced binary search tree, an inorder
     // traversal of that give us its elements in an ascending sorted order.
@@ -269,6 +355,41 @@ void RedBlackTree::InorderTraversal(Node *node, uint64_t key1, uint64_t key2, st
     }
 }
 
+RedBlackTree::Iterator::Iterator(RedBlackTree *tree) {
+    // Start at the leftmost node, i.e. the smallest key.
+    this->node = tree->GetRoot();
+    while (this->node != nullptr && this->node->GetLeftChild() != nullptr) {
+        this->node = this->node->GetLeftChild();
+    }
+}
+
+bool RedBlackTree::Iterator::Valid() const {
+    return this->node != nullptr;
+}
+
+DataEntry_t RedBlackTree::Iterator::GetEntry() const {
+    return std::make_pair(this->node->GetKey(), this->node->GetValue());
+}
+
+void RedBlackTree::Iterator::Next() {
+    // The successor is the leftmost node of the right subtree if there is one.
+    if (this->node->GetRightChild() != nullptr) {
+        this->node = this->node->GetRightChild();
+        while (this->node->GetLeftChild() != nullptr) {
+            this->node = this->node->GetLeftChild();
+        }
+        return;
+    }
+
+    // Otherwise, it is the first ancestor whose left subtree contains the current node.
+    Node *parent = this->node->GetParent();
+    while (parent != nullptr && this->node == parent->GetRightChild()) {
+        this->node = parent;
+        parent = parent->GetParent();
+    }
+    this->node = parent;
+}
+
 void RedBlackTree::Visit(Node *node, std::vector<DataEntry_t> &nodesList) {
     DataEntry_t data = std::make_pair(node->GetKey(), node->GetValue());
     nodesList.push_back(data);
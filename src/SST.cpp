@@ -1,20 +1,190 @@
 #include "SST.h"
+#include "LeafPageCodec.h"
+#include "SearchKernels.h"
+#include "AsyncReader.h"
+#include "AlignedBuffer.h"
+#include "TableCache.h"
+#include "InputReader.h"
+#include "ScanInputReader.h"
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <iostream>
 #include <limits>
 #include <queue>
 #include <list>
 #include <cmath>
 #include <set>
+#include <algorithm>
+#include <filesystem>
 
-SST::SST(std::string &fileName, uint64_t fileDataByteSize, BloomFilter *bloomFilter) {
+SST::SST(std::string &fileName, uint64_t fileDataByteSize, BloomFilter *bloomFilter, size_t pageSize) {
     this->fileName = fileName;
+    this->fileNumber = SST::nextFileNumber++;
     this->fileDataByteSize = fileDataByteSize;
+    this->pageSize = pageSize;
+    this->pageNumWords = pageSize / SST::KEY_BYTE_SIZE;
+    this->keysPerPage = PageHeader::GetPayloadNumWords(this->pageNumWords);
+    this->kvPairsPerPage = this->keysPerPage / 2;
+    this->usePageChecksums = false;
     this->bloomFilter = bloomFilter;
-    this->bTreeLevels = {};
+    this->isBTreeFile = false;
     this->maxOffsetToReadLeaves = 0;
     this->inputReader = nullptr;
     this->scanInputReader = nullptr;
+    this->minKey = Utils::INVALID_VALUE;
+    this->maxKey = 0;
+    this->numEntries = 0;
+    this->isBTreeIndexLoaded = false;
+    this->bloomFilterNumPages = 0;
+    this->bloomFilterStartPage = 0;
+    this->leafFormat = LeafFormat::RAW_LEAVES;
+    this->hasLearnedIndex = false;
+    this->learnedIndexNumPages = 0;
+    this->learnedIndexStartPage = 0;
+    this->readMode = SSTReadMode::PREAD_READS;
+    this->mappedWords = nullptr;
+    this->mappedNumPages = 0;
+    this->tableCache = nullptr;
+}
+
+SST::~SST() {
+    delete this->bloomFilter;
+    delete this->inputReader;
+    delete this->scanInputReader;
+    if (this->mappedWords != nullptr) {
+        munmap((void *) this->mappedWords, this->mappedNumPages * this->pageSize);
+    }
+    // The file may be deleted along with the object, which it keeps taking disk space for while it is open.
+    if (this->tableCache != nullptr) {
+        this->tableCache->Erase(this->fileNumber);
+    }
+}
+
+bool SST::IsValidPageSize(size_t pageSize) {
+    return pageSize >= SST::MIN_PAGE_SIZE && pageSize <= SST::MAX_PAGE_SIZE && (pageSize & (pageSize - 1)) == 0;
+}
+
+size_t SST::GetPageSize() const {
+    return this->pageSize;
+}
+
+size_t SST::GetKVPairsPerPage() const {
+    return this->kvPairsPerPage;
+}
+
+void SST::SetPageChecksums(bool newUsePageChecksums) {
+    this->usePageChecksums = newUsePageChecksums;
+}
+
+void SST::SetReadMode(SSTReadMode newReadMode) {
+    this->readMode = newReadMode;
+}
+
+SSTReadMode SST::GetReadMode() const {
+    return this->readMode;
+}
+
+void SST::SetTableCache(TableCache *newTableCache) {
+    this->tableCache = newTableCache;
+}
+
+int SST::AcquireFile() {
+    if (this->tableCache != nullptr) {
+        return this->tableCache->Acquire(this->fileNumber, this->fileName);
+    }
+    return Utils::OpenFile(this->fileName);
+}
+
+void SST::ReleaseFile(int fd) {
+    if (this->tableCache != nullptr) {
+        this->tableCache->Release(this->fileNumber, fd);
+        return;
+    }
+    close(fd);
+}
+
+void SST::MapFile() {
+    int fd = this->AcquireFile();
+    if (fd == -1) {
+        return;
+    }
+    // The last page may be cut short, such as by the end of the bloom filter. Its missing end
+    // is mapped as zeros, the same as it is read with pread.
+    struct stat fileStat{};
+    uint64_t numPages = fstat(fd, &fileStat) == 0 ? std::ceil(fileStat.st_size / (double) this->pageSize) : 0;
+    if (numPages == 0) {
+        this->ReleaseFile(fd);
+        return;
+    }
+
+    // The mapping stays valid once the file is closed, and even once it is moved or deleted.
+    void *mapping = mmap(nullptr, numPages * this->pageSize, PROT_READ, MAP_SHARED, fd, 0);
+    this->ReleaseFile(fd);
+    if (mapping == MAP_FAILED) {
+        perror("mmap");
+        return;
+    }
+    // Point lookups touch one page here and there, so don't read ahead of them.
+    madvise(mapping, numPages * this->pageSize, MADV_RANDOM);
+    this->mappedWords = static_cast<const uint64_t *>(mapping);
+    this->mappedNumPages = numPages;
+}
+
+const uint64_t *SST::GetMappedPage(uint64_t offset) {
+    if (this->readMode != SSTReadMode::MMAP_READS) {
+        return nullptr;
+    }
+    // The file is complete by the time it is first read, so it is mapped once and for all.
+    std::call_once(this->mapFileFlag, &SST::MapFile, this);
+    if (offset >= this->mappedNumPages) {
+        return nullptr;
+    }
+    return this->mappedWords + offset * this->pageNumWords;
+}
+
+void SST::AdviseMappedPages(uint64_t offset, uint64_t numPages, int advice) {
+    if (this->mappedWords == nullptr || offset >= this->mappedNumPages) {
+        return;
+    }
+    if (offset + numPages > this->mappedNumPages) {
+        numPages = this->mappedNumPages - offset;
+    }
+    madvise((void *) (this->mappedWords + offset * this->pageNumWords), numPages * this->pageSize, advice);
+}
+
+size_t SST::GetMappedPageNumEntries(const uint64_t *page) const {
+    return std::min(PageHeader::GetNumEntries(page), this->kvPairsPerPage);
+}
+
+uint64_t SST::GetNumBinarySearchPages() const {
+    if (this->numEntries > 0) {
+        return std::ceil(this->numEntries / (double) this->kvPairsPerPage);
+    }
+    return std::ceil(this->fileDataByteSize / (double) this->pageSize);
+}
+
+uint64_t SST::FindMappedBinarySearchPage(uint64_t key, uint64_t numPages) {
+    // The pages are searched by their first key, right after their header.
+    uint64_t firstPage = 0;
+    uint64_t lastPage = numPages - 1;
+    while (firstPage < lastPage) {
+        uint64_t midPage = firstPage + (lastPage - firstPage + 1) / 2;
+        if (this->GetMappedPage(midPage)[PageHeader::NUM_WORDS] <= key) {
+            firstPage = midPage;
+        } else {
+            lastPage = midPage - 1;
+        }
+    }
+    return firstPage;
+}
+
+LeafFormat SST::GetLeafFormat() const {
+    return this->leafFormat;
+}
+
+bool SST::HasLearnedIndex() const {
+    return this->hasLearnedIndex;
 }
 
 std::string SST::GetFileName() {
@@ -29,6 +199,121 @@ void SST::SetFileDataSize(uint64_t newFileDataByteSize) {
     this->fileDataByteSize = newFileDataByteSize;
 }
 
+uint64_t SST::GetMinKey() const {
+    return this->minKey;
+}
+
+uint64_t SST::GetMaxKey() const {
+    return this->maxKey;
+}
+
+uint64_t SST::GetNumEntries() const {
+    return this->numEntries;
+}
+
+bool SST::OverlapsRange(uint64_t key1, uint64_t key2) const {
+    return this->minKey <= this->maxKey && this->minKey <= key2 && key1 <= this->maxKey;
+}
+
+const RangeTombstones &SST::GetRangeTombstones() const {
+    return this->rangeTombstones;
+}
+
+void SST::SetRangeTombstones(const RangeTombstones &newRangeTombstones) {
+    this->rangeTombstones = newRangeTombstones;
+}
+
+bool SST::MoveFile(const std::string &newFileName) {
+    std::error_code error;
+    std::filesystem::rename(this->fileName, newFileName, error);
+    if (error) {
+        std::cerr << "Could not move " << this->fileName << " to " << newFileName << ": " << error.message()
+                  << std::endl;
+        return false;
+    }
+    this->fileName = newFileName;
+    return true;
+}
+
+void SST::UpdateKeyRange(std::vector<DataEntry_t> &data) {
+    if (data.empty()) {
+        return;
+    }
+    this->minKey = std::min(this->minKey, data.front().first);
+    this->maxKey = std::max(this->maxKey, data.back().first);
+    this->numEntries += data.size();
+}
+
+void SST::WriteMetaDataPage(AlignedFileWriter &file, const std::vector<uint64_t> &metaData) {
+    // The page is put together in memory, so that its checksum covers the footer too.
+    std::vector<uint64_t> page(this->pageNumWords, 0);
+    std::copy(metaData.begin(), metaData.end(), page.begin() + PageHeader::NUM_WORDS);
+    uint64_t footer[SST::FOOTER_NUM_WORDS] = {this->minKey, this->maxKey, this->numEntries, this->pageSize,
+                                              SST::FORMAT_VERSION, SST::FOOTER_MAGIC};
+    std::copy(footer, footer + SST::FOOTER_NUM_WORDS, page.end() - SST::FOOTER_NUM_WORDS);
+    PageHeader::Write(page.data(), this->pageNumWords, PageType::METADATA_PAGE, metaData.size(),
+                      this->usePageChecksums);
+    file.Write(page.data(), this->pageSize);
+}
+
+void SST::WriteBinarySearchFooter(AlignedFileWriter &file) {
+    // The pages of entries all end where the next one starts, so the footer page follows them.
+    this->WriteMetaDataPage(file, {});
+}
+
+bool SST::ReadFooterOfFile(int fd, uint64_t *footer, uint64_t &fileByteSize) {
+    // The footer ends the last page of the file, whatever its page size.
+    struct stat fileStat{};
+    uint64_t footerByteSize = SST::FOOTER_NUM_WORDS * sizeof(uint64_t);
+    if (fstat(fd, &fileStat) == -1 || fileStat.st_size < (off_t) footerByteSize) {
+        return false;
+    }
+    fileByteSize = fileStat.st_size;
+    // The file is opened with O_DIRECT, so the whole aligned block ending the file is read. It is part of
+    // the last page, which is at least as large.
+    uint64_t blockByteOffset = (fileByteSize - footerByteSize) & ~(AlignedBuffer::ALIGNMENT - 1);
+    AlignedBuffer block(AlignedBuffer::ALIGNMENT);
+    ssize_t bytesRead = pread(fd, block.Data(), block.GetByteSize(), (off_t) blockByteOffset);
+    if (bytesRead != (ssize_t) (fileByteSize - blockByteOffset)) {
+        return false;
+    }
+    const uint64_t *blockFooter = block.Data() + (fileByteSize - footerByteSize - blockByteOffset) / sizeof(uint64_t);
+    std::copy(blockFooter, blockFooter + SST::FOOTER_NUM_WORDS, footer);
+    return footer[SST::FOOTER_NUM_WORDS - 1] == SST::FOOTER_MAGIC && footer[4] == SST::FORMAT_VERSION &&
+           SST::IsValidPageSize(footer[3]) && fileByteSize % footer[3] == 0;
+}
+
+bool SST::ReadFooter(int fd) {
+    uint64_t footer[SST::FOOTER_NUM_WORDS];
+    uint64_t fileByteSize;
+    if (!SST::ReadFooterOfFile(fd, footer, fileByteSize)) {
+        this->minKey = 0;
+        this->maxKey = Utils::INVALID_VALUE;
+        return false;
+    }
+    this->minKey = footer[0];
+    this->maxKey = footer[1];
+    this->numEntries = footer[2];
+    this->pageSize = footer[3];
+    this->pageNumWords = this->pageSize / SST::KEY_BYTE_SIZE;
+    this->keysPerPage = PageHeader::GetPayloadNumWords(this->pageNumWords);
+    this->kvPairsPerPage = this->keysPerPage / 2;
+    return true;
+}
+
+bool SST::LoadBinarySearchFooter() {
+    int fd = this->AcquireFile();
+    if (fd == -1) {
+        return false;
+    }
+    bool isFooterRead = this->ReadFooter(fd);
+    if (isFooterRead) {
+        this->fileDataByteSize -= this->pageSize;
+    }
+    this->ReleaseFile(fd);
+    return isFooterRead;
+}
+
 InputReader *SST::GetInputReader() {
     return this->inputReader;
 }
@@ -41,6 +326,29 @@ uint64_t SST::GetMaxOffsetToReadLeaves() const {
     return this->maxOffsetToReadLeaves;
 }
 
+uint64_t SST::GetMaxFileByteSize() const {
+    uint64_t numLeaves = std::ceil(this->fileDataByteSize / SST::KV_PAIR_BYTE_SIZE / (double) this->kvPairsPerPage);
+    if (!this->isBTreeFile) {
+        // The entries of a binary search file are followed by the footer page.
+        return (numLeaves + 1) * this->pageSize;
+    }
+    if (this->leafFormat == LeafFormat::COMPRESSED_LEAVES) {
+        // As if none of the leaves could be compressed.
+        uint64_t numEntries = this->fileDataByteSize / SST::KV_PAIR_BYTE_SIZE;
+        numLeaves = std::ceil(numEntries / (double) LeafPageCodec::GetMinEntriesPerPage(this->keysPerPage));
+    }
+    // The leaves are followed by the internal levels, the bloom filter and the metadata page.
+    uint64_t numPages = std::max<uint64_t>(numLeaves, 1) + 1;
+    for (uint64_t numPagesInLevel = numLeaves; numPagesInLevel > 1;) {
+        numPagesInLevel = std::ceil(numPagesInLevel / (double) this->keysPerPage);
+        numPages += numPagesInLevel;
+    }
+    if (this->bloomFilter != nullptr) {
+        numPages += std::ceil(this->bloomFilter->GetFilterArraySize() / (double) this->pageNumWords);
+    }
+    return numPages * this->pageSize;
+}
+
 ScanInputReader *SST::GetScanInputReader() {
     return this->scanInputReader;
 }
@@ -49,45 +357,22 @@ void SST::SetScanInputReader(ScanInputReader *newScanInputReader) {
     this->scanInputReader = newScanInputReader;
 }
 
-std::vector<uint64_t> SST::GetBTreeLevelOffsets(int leavesNumPages) {
-    // B = SST::KEYS_PER_PAGE
-    std::vector<uint64_t> levelsSizes;
-    uint64_t numPagesInLevel = leavesNumPages;
-    levelsSizes.push_back(numPagesInLevel);
-    while (numPagesInLevel > 1) {
-        numPagesInLevel = std::ceil(numPagesInLevel / (double) SST::KEYS_PER_PAGE);
-        levelsSizes.push_back(numPagesInLevel);
-    }
-
-    std::vector<uint64_t> levelOffsets;
-    uint64_t numOfNodesSoFar = 1;
-    levelOffsets.push_back(numOfNodesSoFar);
-    for (int i = levelsSizes.size() - 1; i > 0; i--) {
-        numOfNodesSoFar += levelsSizes[i];
-        levelOffsets.push_back(numOfNodesSoFar);
-    }
-    this->maxOffsetToReadLeaves = numOfNodesSoFar + levelsSizes[0] - 1;
-    return levelOffsets;
-}
-
-void SST::SetupBTreeFile() {
-    int leavesNumPages = std::ceil(this->GetFileDataSize() / (double) SST::PAGE_SIZE);
-    std::vector<uint64_t> levelOffsets = this->GetBTreeLevelOffsets(leavesNumPages);
-
-    // Make B-tree levels
-    for (uint64_t levelOffset: levelOffsets) {
-        auto *level = new BTreeLevel(levelOffset * SST::PAGE_SIZE);
-        this->bTreeLevels.push_back(level);
-    }
+void SST::SetupBTreeFile(LeafFormat newLeafFormat, bool newHasLearnedIndex) {
+    this->isBTreeFile = true;
+    this->leafFormat = newLeafFormat;
+    this->hasLearnedIndex = newHasLearnedIndex;
+    this->learnedIndex.Clear();
+    this->leafFenceKeys.clear();
 }
 
-void SST::WriteEndOfBTreeFile(std::ofstream &file) {
-    // Write any non-complete internal nodes to the file
-    this->WriteBTreeInternalLevels(file, true);
-
-    // Write the bloom filter.
+void SST::WriteEndOfBTreeFile(AlignedFileWriter &file) {
+    // Everything after the leaves is written in one go, one section after another.
+    this->WriteBTreeInternalLevels(file);
     if (this->bloomFilter != nullptr) {
-        SST::WriteBloomFilter(file);
+        this->WriteBloomFilter(file);
+    }
+    if (this->hasLearnedIndex) {
+        this->WriteLearnedIndex(file);
     }
     this->WriteBTreeMetaData(file);
 
@@ -96,186 +381,356 @@ void SST::WriteEndOfBTreeFile(std::ofstream &file) {
     if (this->bloomFilter != nullptr) {
         this->bloomFilter->ClearFilterArray();
     }
-    file.close();
+    file.Close();
+    this->LoadBTreeIndex();
 }
 
-void SST::WriteFile(std::ofstream &file, std::vector<DataEntry_t> &data, SearchType searchType, bool endOfFile) {
+void SST::WriteFile(AlignedFileWriter &file, std::vector<DataEntry_t> &data, SearchType searchType, bool endOfFile) {
 
     if (searchType == SearchType::BINARY_SEARCH) {
-        for (DataEntry_t &i: data) {
-            file.write(reinterpret_cast<const char *>(&i.first), sizeof(uint64_t));
-            file.write(reinterpret_cast<const char *>(&i.second), sizeof(uint64_t));
-        }
-        // Mark the last valid value of a page by an invalidValue, if the data is not aligned.
-        if (data.size() % SST::KV_PAIRS_PER_PAGE != 0) {
-            SST::WriteExtraToAlign(file, 1);
-        }
-        file.close();
+        this->WriteEntries(file, data);
+        this->UpdateKeyRange(data);
+        this->WriteBinarySearchFooter(file);
+        file.Close();
         return;
     }
 
-    if (searchType == SearchType::B_TREE_SEARCH && !data.empty()) {
+    if (searchType != SearchType::BINARY_SEARCH && (!data.empty() || endOfFile)) {
         // B_TREE_SEARCH
-        // The output file will be:
-        /* Page 1 of the file: */
-        /* Number of B-tree levels | page index where level 1 starts | page index where level 2 starts | ...    | */
-        /* Next pages of the file: */
-        /* | level 0 (i.e. root node) | level 1 | ... | level 2 | ... | 
-        Number of pages of the bloomFilter | Page where the bloomFilter starts| */
+        // The output file is written from start to end, without seeking back:
+        /* | leaves | level right above the leaves | ... | level 0 (i.e. root node) | bloom filter | learned index |
+         * Last page of the file: */
+        /* | Number of B-tree levels | page index where level 0 starts | ... | page index where the leaves start |
+        Number of pages of the bloomFilter | Page where the bloomFilter starts | ... | footer | */
         this->WriteBTreeLevels(file, data, endOfFile);
     }
 
-    // Write 1 page of metadata
+    // Write the end of the file, ending with 1 page of metadata
     if (endOfFile) {
         this->WriteEndOfBTreeFile(file);
     }
 }
 
-void SST::WriteExtraToAlign(std::ofstream &file, uint64_t extraSpace) {
-    uint64_t invalidValue = Utils::INVALID_VALUE;
-    for (int i = 0; i < extraSpace; i++) {
-        file.write(reinterpret_cast<const char *>(&invalidValue), sizeof(uint64_t));
+void SST::WriteFile(AlignedFileWriter &file, EntryIterator *iterator, SearchType searchType, int bufferNumPages) {
+    // The buffer holds whole pages, so that the fence keys of the leaves written so far
+    // are known each time it is written out.
+    size_t bufferCapacity = bufferNumPages * this->kvPairsPerPage;
+    std::vector<DataEntry_t> buffer;
+    buffer.reserve(bufferCapacity);
+    while (iterator->Valid()) {
+        DataEntry_t entry = iterator->GetEntry();
+        buffer.push_back(entry);
+        if (this->bloomFilter != nullptr) {
+            this->bloomFilter->InsertKey(entry.first);
+        }
+        iterator->Next();
+
+        bool endOfData = !iterator->Valid();
+        if (buffer.size() < bufferCapacity && !endOfData) {
+            continue;
+        }
+        if (searchType == SearchType::BINARY_SEARCH) {
+            this->WriteEntries(file, buffer);
+            this->UpdateKeyRange(buffer);
+        } else {
+            this->WriteBTreeLevels(file, buffer, endOfData);
+        }
+        buffer.clear();
+    }
+
+    if (searchType == SearchType::BINARY_SEARCH) {
+        this->WriteBinarySearchFooter(file);
+        file.Close();
+        return;
     }
+    this->WriteEndOfBTreeFile(file);
 }
 
-void SST::WriteBTreeMetaData(std::ofstream &file) {
+void SST::WritePages(AlignedFileWriter &file, PageType type, const uint64_t *words, size_t numWords,
+                     size_t entryNumWords) {
+    std::vector<uint64_t> page(this->pageNumWords);
+    for (size_t pageStart = 0; pageStart < numWords; pageStart += this->keysPerPage) {
+        size_t numPageWords = std::min(numWords - pageStart, this->keysPerPage);
+        std::copy(words + pageStart, words + pageStart + numPageWords, page.begin() + PageHeader::NUM_WORDS);
+        std::fill(page.begin() + (long) (PageHeader::NUM_WORDS + numPageWords), page.end(), 0);
+        PageHeader::Write(page.data(), this->pageNumWords, type, numPageWords / entryNumWords, this->usePageChecksums);
+        file.Write(page.data(), this->pageSize);
+    }
+}
 
-    uint64_t numLevels = this->bTreeLevels.size();
+void SST::WriteEntries(AlignedFileWriter &file, std::vector<DataEntry_t> &data) {
+    static_assert(sizeof(DataEntry_t) == SST::KV_PAIR_BYTE_SIZE, "Entries must be laid out as they are on disk");
+    // The pages hold whole entries, as a page holds an even number of words after its header.
+    this->WritePages(file, PageType::ENTRIES_PAGE, (const uint64_t *) data.data(), data.size() * 2, 2);
+}
 
-    // MetaData will be the first page
-    file.seekp(0, std::ios_base::beg);
-    file.write(reinterpret_cast<const char *>(&numLevels), sizeof(uint64_t));
+bool SST::IsPageIntact(const uint64_t *page, size_t pageNumWords) {
+    if (PageHeader::IsIntact(page, pageNumWords)) {
+        return true;
+    }
+    if (PageHeader::IsValid(page)) {
+        std::cerr << "Corrupt SST page: its checksum does not match its content." << std::endl;
+    }
+    return false;
+}
 
-    // Write the BTree's metadata.
-    for (uint64_t i = 0; i < numLevels; i++) {
-        uint64_t levelStartOffset = std::ceil(this->bTreeLevels[i]->GetStartingByteOffset() / (double) SST::PAGE_SIZE);
-        file.write(reinterpret_cast<const char *>(&levelStartOffset), sizeof(uint64_t));
+PageType SST::GetLeafPageType(LeafFormat leafFormat) {
+    if (leafFormat == LeafFormat::COMPRESSED_LEAVES) {
+        return PageType::COMPRESSED_LEAF_PAGE;
     }
+    if (leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+        return PageType::COLUMNAR_LEAF_PAGE;
+    }
+    return PageType::ENTRIES_PAGE;
+}
 
-    // Write the bloom filter's metadata.
-    if (this->bloomFilter != nullptr) {
-        uint64_t bloomfilterNumPages = std::ceil(this->bloomFilter->GetFilterArraySize() / (double) SST::KEYS_PER_PAGE);
-        file.write(reinterpret_cast<const char *>(&bloomfilterNumPages), sizeof(uint64_t));
+bool SST::IsLeafPageIntact(const uint64_t *page, size_t pageNumWords, LeafFormat leafFormat) {
+    return SST::IsPageIntact(page, pageNumWords) && PageHeader::GetType(page) == SST::GetLeafPageType(leafFormat);
+}
 
-        // Write where the bloom filter starts.
-        uint64_t nextByteOffsetToWrite = this->bTreeLevels[numLevels - 1]->GetNextByteOffsetToWrite();
-        uint64_t bloomFilterStartPage = std::ceil(nextByteOffsetToWrite / (double) SST::PAGE_SIZE);
-        file.write(reinterpret_cast<const char *>(&bloomFilterStartPage), sizeof(uint64_t));
+uint64_t SST::WriteColumnarLeaves(AlignedFileWriter &file, std::vector<DataEntry_t> &data) {
+    std::vector<uint64_t> page(this->pageNumWords);
+    uint64_t *keys = page.data() + PageHeader::NUM_WORDS;
+    uint64_t *values = keys + this->kvPairsPerPage;
+    uint64_t numBytesWritten = 0;
+    for (size_t pageStart = 0; pageStart < data.size(); pageStart += this->kvPairsPerPage) {
+        size_t numEntries = data.size() - pageStart;
+        if (numEntries > this->kvPairsPerPage) {
+            numEntries = this->kvPairsPerPage;
+        }
+        std::fill(page.begin(), page.end(), 0);
+        for (size_t i = 0; i < numEntries; i++) {
+            keys[i] = data[pageStart + i].first;
+            values[i] = data[pageStart + i].second;
+        }
+        PageHeader::Write(page.data(), this->pageNumWords, PageType::COLUMNAR_LEAF_PAGE, numEntries,
+                          this->usePageChecksums);
+        file.Write(page.data(), this->pageSize);
+        numBytesWritten += this->pageSize;
     }
-    SST::WriteExtraToAlign(file, 1);
+    return numBytesWritten;
+}
+
+void SST::WriteExtraToAlign(AlignedFileWriter &file, uint64_t extraSpace) {
+    std::vector<uint64_t> invalidValues(extraSpace, Utils::INVALID_VALUE);
+    file.Write(invalidValues.data(), extraSpace * sizeof(uint64_t));
 }
 
-void SST::AddNextInternalLevelFenceKeys(std::vector<uint64_t> &data, int nextLevel) {
-    int numInternalNodes = std::ceil(data.size() / (double) SST::KEYS_PER_PAGE);
-    for (int i = 1; i <= numInternalNodes; i++) {
-        size_t lastIndex = (i * SST::KEYS_PER_PAGE) - 1;
-        if (lastIndex >= data.size()) {
-            lastIndex = data.size() - 1;
+void SST::WriteExtraToAlignPage(AlignedFileWriter &file) const {
+    uint64_t pagePosition = file.GetPosition() % this->pageSize;
+    if (pagePosition > 0) {
+        SST::WriteExtraToAlign(file, (this->pageSize - pagePosition) / sizeof(uint64_t));
+    }
+}
+
+void SST::WriteBTreeMetaData(AlignedFileWriter &file) {
+    uint64_t numLevels = this->levelsPageOffsets.size();
+    std::vector<uint64_t> metaData;
+    metaData.push_back(numLevels | ((uint64_t) this->leafFormat << SST::LEAF_FORMAT_SHIFT));
+
+    // Write the BTree's metadata.
+    metaData.insert(metaData.end(), this->levelsPageOffsets.begin(), this->levelsPageOffsets.end());
+
+    // Write the bloom filter's metadata.
+    if (this->bloomFilter != nullptr) {
+        metaData.push_back(this->bloomFilterNumPages);
+        metaData.push_back(this->bloomFilterStartPage);
+    }
+
+    // Write the learned index's metadata, after an empty bloom filter's metadata if there is no bloom filter.
+    if (this->learnedIndexNumPages > 0) {
+        if (this->bloomFilter == nullptr) {
+            metaData.push_back(0);
+            metaData.push_back(0);
         }
+        metaData.push_back(this->learnedIndexNumPages);
+        metaData.push_back(this->learnedIndexStartPage);
+    }
+    this->WriteMetaDataPage(file, metaData);
+}
 
-        // Put the fence keys in the next level
-        this->bTreeLevels[nextLevel]->AddDataToLevel(data[lastIndex]);
+void SST::AddLeafFenceKey(uint64_t key) {
+    this->leafFenceKeys.push_back(key);
+    if (this->hasLearnedIndex) {
+        this->learnedIndex.AddKey(key);
     }
 }
 
-void SST::WriteBTreeInternalLevels(std::ofstream &file, bool endOfFile) {
-    // Write internal levels
-    for (int i = this->bTreeLevels.size() - 2; i >= 0; i--) {
-        std::vector<uint64_t> levelData = this->bTreeLevels[i]->GetLevelData();
-        bool levelIsAtLeastOneFullPage = (levelData.size() / SST::KEYS_PER_PAGE) >= 1;
-        if (i > 0 && (levelIsAtLeastOneFullPage || endOfFile)) {
-            this->AddNextInternalLevelFenceKeys(levelData, i - 1);
+void SST::WriteEndOfLeaves(AlignedFileWriter &file) {
+    if (file.GetPosition() == 0) {
+        // A file without entries still has a leaf, an empty one.
+        std::vector<uint64_t> page(this->pageNumWords, 0);
+        if (this->leafFormat == LeafFormat::COMPRESSED_LEAVES) {
+            LeafPageCodec::Encode(nullptr, 0, page.data() + PageHeader::NUM_WORDS, this->keysPerPage);
         }
+        PageHeader::Write(page.data(), this->pageNumWords, SST::GetLeafPageType(this->leafFormat), 0,
+                          this->usePageChecksums);
+        file.Write(page.data(), this->pageSize);
+    }
 
-        if (levelIsAtLeastOneFullPage || endOfFile) {
-            file.seekp(this->bTreeLevels[i]->GetNextByteOffsetToWrite(), std::ios_base::beg);
-            uint64_t *dataArray = levelData.data();
-            file.write(reinterpret_cast<const char *>(&dataArray[0]), sizeof(uint64_t) * levelData.size());
-            this->bTreeLevels[i]->IncrementNextByteOffsetToWrite(levelData.size() * SST::KEY_BYTE_SIZE);
-            if (levelData.size() % SST::KEYS_PER_PAGE) {
-                SST::WriteExtraToAlign(file, 1);
+    // Every leaf takes a whole page, so the leaves end where the last one does.
+    this->maxOffsetToReadLeaves = file.GetPosition() / this->pageSize - 1;
+    this->pendingLeafEntries.shrink_to_fit();
+}
+
+void SST::WriteBTreeInternalLevels(AlignedFileWriter &file) {
+    // The levels are written from the bottom up, but listed from the root down like they are searched.
+    std::vector<uint64_t> levelsStartPages = {0};
+    if (this->leafFenceKeys.size() > 1) {
+        std::vector<uint64_t> levelData = this->leafFenceKeys;
+        while (true) {
+            levelsStartPages.push_back(file.GetPosition() / this->pageSize);
+            this->WritePages(file, PageType::FENCE_KEYS_PAGE, levelData.data(), levelData.size(), 1);
+            // The root is the level that fits in one page.
+            if (levelData.size() <= this->keysPerPage) {
+                break;
+            }
+
+            // Put the fence keys of each page in the next level
+            std::vector<uint64_t> nextLevelData;
+            for (size_t i = this->keysPerPage; i < levelData.size() + this->keysPerPage; i += this->keysPerPage) {
+                nextLevelData.push_back(levelData[std::min(i, levelData.size()) - 1]);
             }
-            this->bTreeLevels[i]->ClearLevel();
+            levelData.swap(nextLevelData);
         }
     }
+    this->levelsPageOffsets.assign(levelsStartPages.rbegin(), levelsStartPages.rend());
 }
 
-void SST::WriteBTreeLevels(std::ofstream &file, std::vector<DataEntry_t> &data, bool endOfFile) {
-
-    uint64_t numLevels = this->bTreeLevels.size();
-    int numLeaves = std::ceil(data.size() / (double) SST::KV_PAIRS_PER_PAGE);
-    if (numLevels > 1) {
+void SST::WriteBTreeLevels(AlignedFileWriter &file, std::vector<DataEntry_t> &data, bool endOfFile) {
+    if (this->leafFormat == LeafFormat::COMPRESSED_LEAVES) {
+        this->WriteCompressedLeaves(file, data, endOfFile);
+    } else {
+        int numLeaves = std::ceil(data.size() / (double) this->kvPairsPerPage);
         for (int i = 1; i <= numLeaves; i++) {
-            size_t lastPairIndex = (i * SST::KV_PAIRS_PER_PAGE) - 1;
+            size_t lastPairIndex = (i * this->kvPairsPerPage) - 1;
             if (lastPairIndex >= data.size()) {
                 lastPairIndex = data.size() - 1;
             }
-            // Put the fence keys of the leaves in the next internal level
-            this->bTreeLevels[numLevels - 2]->AddDataToLevel(data[lastPairIndex].first);
+            // Keep the fence keys of the leaves for the internal levels
+            this->AddLeafFenceKey(data[lastPairIndex].first);
         }
-    }
 
-    // Write the leaves by seeking to the beginning of where the leaves level starts
-    uint64_t leavesOffsetToWrite = this->bTreeLevels[numLevels - 1]->GetNextByteOffsetToWrite();
-    file.seekp(leavesOffsetToWrite, std::ios_base::beg);
-    for (DataEntry_t &i: data) {
-        file.write(reinterpret_cast<const char *>(&i.first), sizeof(uint64_t));
-        file.write(reinterpret_cast<const char *>(&i.second), sizeof(uint64_t));
+        // The leaves are written one after another from the start of the file
+        if (this->leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+            this->WriteColumnarLeaves(file, data);
+        } else {
+            this->WriteEntries(file, data);
+        }
+        this->UpdateKeyRange(data);
     }
-    this->bTreeLevels[numLevels - 1]->IncrementNextByteOffsetToWrite(data.size() * SST::KV_PAIR_BYTE_SIZE);
-
     if (endOfFile) {
-        uint64_t nextByteOffsetToWrite = this->bTreeLevels[numLevels - 1]->GetNextByteOffsetToWrite();
-        this->maxOffsetToReadLeaves = std::ceil(nextByteOffsetToWrite / (double) SST::PAGE_SIZE) - 1;
+        this->WriteEndOfLeaves(file);
+    }
+}
 
-        // Mark the last valid value of a page by an invalidValue, if the data is not page-aligned.
-        if (data.size() % KV_PAIRS_PER_PAGE) {
-            SST::WriteExtraToAlign(file, 1);
+void SST::WriteCompressedLeaves(AlignedFileWriter &file, std::vector<DataEntry_t> &data, bool endOfFile) {
+    this->UpdateKeyRange(data);
+    this->pendingLeafEntries.insert(this->pendingLeafEntries.end(), data.begin(), data.end());
+
+    std::vector<uint64_t> page(this->pageNumWords);
+    size_t numWritten = 0;
+    while (numWritten < this->pendingLeafEntries.size()) {
+        size_t numLeft = this->pendingLeafEntries.size() - numWritten;
+        size_t numEncoded = LeafPageCodec::Encode(&this->pendingLeafEntries[numWritten], numLeft,
+                                                  page.data() + PageHeader::NUM_WORDS, this->keysPerPage);
+        // The page may still have room for the entries written next.
+        if (numEncoded == numLeft && !endOfFile) {
+            break;
         }
+        numWritten += numEncoded;
+
+        // Keep the fence key of the leaf for the internal levels
+        this->AddLeafFenceKey(this->pendingLeafEntries[numWritten - 1].first);
+        PageHeader::Write(page.data(), this->pageNumWords, PageType::COMPRESSED_LEAF_PAGE, numEncoded,
+                          this->usePageChecksums);
+        file.Write(page.data(), this->pageSize);
     }
-    this->bTreeLevels[numLevels - 1]->ClearLevel();
-    this->WriteBTreeInternalLevels(file, false);
+    this->pendingLeafEntries.erase(this->pendingLeafEntries.begin(),
+                                   this->pendingLeafEntries.begin() + (long) numWritten);
 }
 
-void SST::WriteBloomFilter(std::ofstream &file) {
-    uint64_t offsetToWrite = (this->GetMaxOffsetToReadLeaves() + 1) * SST::PAGE_SIZE;
-    file.seekp(offsetToWrite, std::ios_base::beg);
+void SST::WriteBloomFilter(AlignedFileWriter &file) {
+    // The bloom filter is only ever read as a whole, so its pages have no header.
+    this->bloomFilterStartPage = file.GetPosition() / this->pageSize;
+    this->bloomFilterNumPages = std::ceil(this->bloomFilter->GetFilterArraySize() / (double) this->pageNumWords);
 
     std::vector<uint64_t> bloomFilterArray = this->bloomFilter->GetFilterArray();
     uint64_t size = sizeof(uint64_t) * this->bloomFilter->GetFilterArraySize();
-    file.write(reinterpret_cast<const char *>(&bloomFilterArray[0]), size);
+    file.Write(bloomFilterArray.data(), size);
+    this->WriteExtraToAlignPage(file);
+}
+
+void SST::WriteLearnedIndex(AlignedFileWriter &file) {
+    // A file with a single leaf has no fence keys to model.
+    this->learnedIndexNumPages = 0;
+    if (this->leafFenceKeys.size() <= 1) {
+        this->learnedIndex.Clear();
+        return;
+    }
+    std::vector<uint64_t> words;
+    this->learnedIndex.Serialize(words);
+    this->learnedIndexNumPages = std::ceil(words.size() / (double) this->pageNumWords);
+    words.resize(this->learnedIndexNumPages * this->pageNumWords, 0);
+
+    this->learnedIndexStartPage = file.GetPosition() / this->pageSize;
+    file.Write(words.data(), words.size() * sizeof(uint64_t));
 }
 
-std::vector<uint64_t> SST::ReadPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead) {
-    uint64_t buffer[numPagesToRead * SST::KEYS_PER_PAGE];
-    ssize_t bytesRead = pread(fd, buffer, numPagesToRead * SST::PAGE_SIZE, offset * SST::PAGE_SIZE);
+std::vector<uint64_t> SST::ReadPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead, size_t pageSize) {
+    // Read into an aligned buffer, as the file is opened with O_DIRECT, and copy the payloads of the
+    // pages into the returned vector.
+    size_t pageNumWords = pageSize / sizeof(uint64_t);
+    AlignedBuffer buffer(numPagesToRead * pageSize);
+    ssize_t bytesRead = pread(fd, buffer.Data(), numPagesToRead * pageSize, (off_t) (offset * pageSize));
     if (bytesRead == -1) {
         perror("pread");
     }
-
-    std::vector<uint64_t> keys;
-    if (bytesRead == 0) {
-        return keys;
+    if (bytesRead <= 0) {
+        return {};
     }
 
-    for (int i = 0; i < numPagesToRead * KEYS_PER_PAGE; i++) {
-        // Reached the end of the data
-        if (buffer[i] == Utils::INVALID_VALUE) {
+    // The pages of a section of the file are all of the same type.
+    PageType type = PageHeader::GetType(buffer.Data());
+    uint64_t numPagesRead = std::ceil(bytesRead / (double) pageSize);
+    std::vector<uint64_t> keys(numPagesRead * PageHeader::GetPayloadNumWords(pageNumWords));
+    size_t numWords = 0;
+    for (uint64_t i = 0; i < numPagesRead; i++) {
+        const uint64_t *page = buffer.Data() + i * pageNumWords;
+        if (!SST::IsPageIntact(page, pageNumWords) || PageHeader::GetType(page) != type) {
             break;
         }
-        keys.push_back(buffer[i]);
+        size_t numPageWords = std::min(PageHeader::GetNumEntryWords(page),
+                                       PageHeader::GetPayloadNumWords(pageNumWords));
+        const uint64_t *payload = page + PageHeader::NUM_WORDS;
+        std::copy(payload, payload + numPageWords, keys.begin() + (long) numWords);
+        numWords += numPageWords;
     }
+    keys.resize(numWords);
     return keys;
 }
 
+std::vector<uint64_t> SST::ReadBTreeMetaData(int fd, uint64_t &metaDataPage, size_t &pageSize) {
+    // BTree's metadata is on the last page of the file, which is written last and ends with the footer.
+    uint64_t footer[SST::FOOTER_NUM_WORDS];
+    uint64_t fileByteSize;
+    if (!SST::ReadFooterOfFile(fd, footer, fileByteSize)) {
+        return {};
+    }
+    pageSize = footer[3];
+    metaDataPage = fileByteSize / pageSize - 1;
+    return SST::ReadPagesOfFile(fd, metaDataPage, 1, pageSize);
+}
+
 std::vector<uint64_t> SST::ReadBTreeLevelOffsets(int fd) {
-    std::vector<uint64_t> metadata = SST::ReadPagesOfFile(fd, 0);
+    uint64_t metaDataPage;
+    size_t pageSize;
+    std::vector<uint64_t> metadata = SST::ReadBTreeMetaData(fd, metaDataPage, pageSize);
     if (metadata.empty()) {
         return metadata;
     }
 
-    // BTree's metadata starts at page index 0
-    uint64_t numOfLevels = metadata[0];
+    uint64_t numOfLevels = metadata[0] & SST::NUM_LEVELS_MASK;
     std::vector<uint64_t> levelsPageOffsets;
     for (int i = 1; i <= numOfLevels; i++) {
         levelsPageOffsets.push_back(metadata[i]);
@@ -283,62 +738,248 @@ std::vector<uint64_t> SST::ReadBTreeLevelOffsets(int fd) {
     return levelsPageOffsets;
 }
 
-std::vector<uint64_t> SST::ReadBloomFilter(int fd, uint64_t offset, uint64_t numPagesToRead) {
-    auto *buffer = new uint64_t[numPagesToRead * SST::KEYS_PER_PAGE];
-    ssize_t bytesRead = pread(fd, buffer, numPagesToRead * SST::PAGE_SIZE, offset * SST::PAGE_SIZE);
+std::vector<uint64_t> SST::ReadLeafPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead,
+                                               LeafFormat leafFormat, size_t pageSize) {
+    if (leafFormat == LeafFormat::RAW_LEAVES) {
+        return SST::ReadPagesOfFile(fd, offset, numPagesToRead, pageSize);
+    }
+
+    AlignedBuffer buffer(numPagesToRead * pageSize);
+    ssize_t bytesRead = pread(fd, buffer.Data(), numPagesToRead * pageSize, (off_t) (offset * pageSize));
     if (bytesRead == -1) {
         perror("pread");
     }
+    if (leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+        // The pages are kept as they are, since they are searched in place.
+        size_t pageNumWords = pageSize / sizeof(uint64_t);
+        uint64_t numPagesRead = bytesRead > 0 ? bytesRead / pageSize : 0;
+        uint64_t numLeavesRead = 0;
+        while (numLeavesRead < numPagesRead &&
+               SST::IsLeafPageIntact(buffer.Data() + numLeavesRead * pageNumWords, pageNumWords, leafFormat)) {
+            numLeavesRead++;
+        }
+        return {buffer.Data(), buffer.Data() + numLeavesRead * pageNumWords};
+    }
+    return SST::DecodeLeafPages(buffer.Data(), bytesRead, leafFormat, pageSize);
+}
 
-    uint64_t numElements = numPagesToRead * SST::KEYS_PER_PAGE;
-    std::vector<uint64_t> data((uint64_t *) buffer, (uint64_t *) buffer + numElements);
-    delete[] buffer;
+std::vector<uint64_t> SST::ReadLeafPagesOfFile(int fd, uint64_t offset, uint64_t numPagesToRead, LeafFormat leafFormat,
+                                               size_t pageSize, PagePrefetcher *prefetcher,
+                                               uint64_t numPagesToPrefetch) {
+    std::vector<uint64_t> data;
+    const uint64_t *pages;
+    ssize_t bytesRead = prefetcher->Take(offset * pageSize, numPagesToRead * pageSize, pages);
+    if (bytesRead >= 0) {
+        data = SST::DecodeLeafPages(pages, bytesRead, leafFormat, pageSize);
+    } else {
+        data = SST::ReadLeafPagesOfFile(fd, offset, numPagesToRead, leafFormat, pageSize);
+    }
+
+    // Read the next pages while these ones are processed.
+    if (numPagesToPrefetch > 0) {
+        prefetcher->Prefetch(fd, (offset + numPagesToRead) * pageSize, numPagesToPrefetch * pageSize);
+    }
     return data;
 }
 
-std::vector<uint64_t> SST::GetPage(const std::string &pageId, int fd, uint64_t offset, BufferPool *bufferPool) {
+std::vector<uint64_t> SST::DecodeLeafPages(const uint64_t *pages, ssize_t bytesRead, LeafFormat leafFormat,
+                                           size_t pageSize) {
     std::vector<uint64_t> data;
+    if (bytesRead <= 0) {
+        return data;
+    }
+    uint64_t numPagesRead = bytesRead / pageSize;
+    size_t pageNumWords = pageSize / SST::KEY_BYTE_SIZE;
+    size_t payloadNumWords = PageHeader::GetPayloadNumWords(pageNumWords);
+    uint64_t numLeavesRead = 0;
+    while (numLeavesRead < numPagesRead &&
+           SST::IsLeafPageIntact(pages + numLeavesRead * pageNumWords, pageNumWords, leafFormat)) {
+        numLeavesRead++;
+    }
+    if (leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+        // The pages are kept as they are, since they are searched in place.
+        data.assign(pages, pages + numLeavesRead * pageNumWords);
+        return data;
+    }
+    for (uint64_t i = 0; i < numLeavesRead; i++) {
+        const uint64_t *page = pages + i * pageNumWords;
+        if (leafFormat == LeafFormat::RAW_LEAVES) {
+            size_t numPageWords = std::min(PageHeader::GetNumEntryWords(page), payloadNumWords);
+            data.insert(data.end(), page + PageHeader::NUM_WORDS, page + PageHeader::NUM_WORDS + numPageWords);
+        } else {
+            LeafPageCodec::Decode(page + PageHeader::NUM_WORDS, data, payloadNumWords);
+        }
+    }
+    return data;
+}
+
+size_t SST::GetLeafNumEntries(const std::vector<uint64_t> &leaves, LeafFormat leafFormat, size_t pageSize) {
+    return SST::GetLeafNumEntries(leaves.data(), leaves.size(), leafFormat, pageSize);
+}
+
+size_t SST::GetLeafNumEntries(const uint64_t *leaves, size_t numWords, LeafFormat leafFormat, size_t pageSize) {
+    if (leafFormat != LeafFormat::COLUMNAR_LEAVES) {
+        return numWords / 2;
+    }
+    size_t pageNumWords = pageSize / SST::KEY_BYTE_SIZE;
+    size_t kvPairsPerPage = PageHeader::GetPayloadNumWords(pageNumWords) / 2;
+    size_t numPages = numWords / pageNumWords;
+    if (numPages == 0) {
+        return 0;
+    }
+
+    // Only the last leaf may not be full, and its header tells how many entries it holds.
+    const uint64_t *lastPage = leaves + (numPages - 1) * pageNumWords;
+    return (numPages - 1) * kvPairsPerPage + std::min(PageHeader::GetNumEntries(lastPage), kvPairsPerPage);
+}
+
+size_t SST::FindKeyInLeaves(const std::vector<uint64_t> &leaves, size_t numEntries, uint64_t key,
+                            LeafFormat leafFormat, size_t startIndex, size_t pageSize) {
+    return SST::FindKeyInLeaves(leaves.data(), numEntries, key, leafFormat, startIndex, pageSize);
+}
+
+size_t SST::FindKeyInLeaves(const uint64_t *leaves, size_t numEntries, uint64_t key, LeafFormat leafFormat,
+                            size_t startIndex, size_t pageSize) {
+    if (startIndex >= numEntries) {
+        return startIndex;
+    }
+    if (leafFormat != LeafFormat::COLUMNAR_LEAVES) {
+        const uint64_t *entries = leaves + startIndex * 2;
+        return startIndex + SearchKernels::LowerBoundInPairs(entries, numEntries - startIndex, key);
+    }
+
+    // Find the page holding the lower bound by the first key of each page, then search its keys.
+    size_t pageNumWords = pageSize / SST::KEY_BYTE_SIZE;
+    size_t kvPairsPerPage = PageHeader::GetPayloadNumWords(pageNumWords) / 2;
+    size_t firstPage = startIndex / kvPairsPerPage;
+    size_t lastPage = (numEntries - 1) / kvPairsPerPage;
+    while (firstPage < lastPage) {
+        size_t midPage = firstPage + (lastPage - firstPage + 1) / 2;
+        if (leaves[midPage * pageNumWords + PageHeader::NUM_WORDS] < key) {
+            firstPage = midPage;
+        } else {
+            lastPage = midPage - 1;
+        }
+    }
+    size_t start = firstPage * kvPairsPerPage;
+    if (start < startIndex) {
+        start = startIndex;
+    }
+    size_t end = (firstPage + 1) * kvPairsPerPage;
+    if (end > numEntries) {
+        end = numEntries;
+    }
+    const uint64_t *keys = leaves + firstPage * pageNumWords + PageHeader::NUM_WORDS + start % kvPairsPerPage;
+    return start + SearchKernels::LowerBound(keys, end - start, key);
+}
+
+std::vector<uint64_t> SST::ReadBloomFilter(int fd, uint64_t offset, uint64_t numPagesToRead) {
+    AlignedBuffer buffer(numPagesToRead * this->pageSize);
+    ssize_t bytesRead = pread(fd, buffer.Data(), numPagesToRead * this->pageSize, offset * this->pageSize);
+    if (bytesRead == -1) {
+        perror("pread");
+    }
+
+    uint64_t numElements = numPagesToRead * this->pageNumWords;
+    return {buffer.Data(), buffer.Data() + numElements};
+}
+
+PageHandle SST::InsertPageReadIntoFrame(const std::string &pageId, uint64_t *frame, ssize_t bytesRead,
+                                        BufferPool *bufferPool, LeafFormat leafFormat) {
+    const uint64_t *words = frame;
+    size_t numWords = 0;
+    if (bytesRead == (ssize_t) this->pageSize) {
+        if (leafFormat == LeafFormat::COLUMNAR_LEAVES) {
+            // The page is kept as it is, since it is searched in place.
+            numWords = SST::IsLeafPageIntact(frame, this->pageNumWords, leafFormat) ? this->pageNumWords : 0;
+        } else if (SST::IsPageIntact(frame, this->pageNumWords)) {
+            words = frame + PageHeader::NUM_WORDS;
+            numWords = std::min(PageHeader::GetNumEntryWords(frame), this->keysPerPage);
+        }
+    }
+    if (numWords == 0) {
+        bufferPool->ReleaseFrame(frame);
+        return {};
+    }
+    return bufferPool->Insert(pageId, frame, words, numWords);
+}
+
+PageHandle SST::GetPage(const std::string &pageId, int fd, uint64_t offset, BufferPool *bufferPool,
+                        LeafFormat leafFormat) {
+    // The page is read where it is in the buffer pool, without copying it.
     if (bufferPool != nullptr) {
-        data = bufferPool->Get(pageId);
+        PageHandle page = bufferPool->Pin(pageId);
+        if (!page.Empty()) {
+            return page;
+        }
     }
 
-    // Read one page of the file if page not in buffer pool
-    if (data.empty()) {
-        data = SST::ReadPagesOfFile(fd, offset);
-        // Save this page into the buffer pool
-        if (bufferPool != nullptr) {
-            bufferPool->Insert(pageId, data);
+    // Read one page of the file if page not in buffer pool, straight into a frame of the buffer pool.
+    uint64_t *frame = this->CanReadIntoFrame(bufferPool, leafFormat) ? bufferPool->AcquireFrame() : nullptr;
+    if (frame != nullptr) {
+        ssize_t bytesRead = pread(fd, frame, this->pageSize, (off_t) (offset * this->pageSize));
+        if (bytesRead == -1) {
+            perror("pread");
         }
+        return this->InsertPageReadIntoFrame(pageId, frame, bytesRead, bufferPool, leafFormat);
     }
-    return data;
+
+    // Pages that don't fit in a frame are saved into the buffer pool as they are decoded.
+    std::vector<uint64_t> data = SST::ReadLeafPagesOfFile(fd, offset, 1, leafFormat, this->pageSize);
+    if (bufferPool != nullptr && !data.empty()) {
+        return bufferPool->Insert(pageId, std::move(data));
+    }
+    return PageHandle(std::move(data));
 }
 
-std::vector<uint64_t> SST::GetBloomFilterPages(const std::string &pageId, int fd, uint64_t offset, uint64_t numPages,
-                                               BufferPool *bufferPool) {
+PageHandle SST::GetBloomFilterPages(const std::string &pageId, int fd, uint64_t offset, uint64_t numPages,
+                                    BufferPool *bufferPool) {
     if (bufferPool != nullptr) {
-        std::vector<uint64_t> data = bufferPool->Get(pageId);
-        if (!data.empty()) {
-            return data;
+        PageHandle pages = bufferPool->Pin(pageId);
+        if (!pages.Empty()) {
+            return pages;
         }
     }
 
-    // Read the bloom filter array if it was not in buffer pool.
-    std::vector<uint64_t> data = SST::ReadBloomFilter(fd, offset, numPages);
+    // Read the bloom filter array if it was not in buffer pool, straight into a frame of the
+    // buffer pool if it fits in one.
+    uint64_t numBytes = numPages * this->pageSize;
+    uint64_t *frame = bufferPool != nullptr && numBytes <= bufferPool->GetFrameSize() ? bufferPool->AcquireFrame()
+                                                                                     : nullptr;
+    if (frame != nullptr) {
+        ssize_t bytesRead = pread(fd, frame, numBytes, (off_t) (offset * this->pageSize));
+        if (bytesRead == (ssize_t) numBytes) {
+            return bufferPool->Insert(pageId, frame, frame, numPages * this->pageNumWords);
+        }
+        bufferPool->ReleaseFrame(frame);
+    }
 
-    // Save the bloom filter in the buffer pool
+    // Save the bloom filter in the buffer pool otherwise.
+    std::vector<uint64_t> data = this->ReadBloomFilter(fd, offset, numPages);
     if (bufferPool != nullptr) {
-        bufferPool->Insert(pageId, data);
+        return bufferPool->Insert(pageId, std::move(data));
     }
-    return data;
+    return PageHandle(std::move(data));
 }
 
 uint64_t SST::PerformBinarySearch(uint64_t key, BufferPool *bufferPool) {
-    int fd = Utils::OpenFile(this->fileName);
-    if (fd == -1) {
+    int numPages = (int) this->GetNumBinarySearchPages();
+    if (numPages > 0 && this->GetMappedPage(numPages - 1) != nullptr) {
+        // Search the page that may hold the key where it is mapped.
+        const uint64_t *page = this->GetMappedPage(this->FindMappedBinarySearchPage(key, numPages));
+        size_t numEntries = this->GetMappedPageNumEntries(page);
+        const uint64_t *entries = page + PageHeader::NUM_WORDS;
+        size_t index = SST::FindKeyInLeaves(entries, numEntries, key, LeafFormat::RAW_LEAVES);
+        if (index < numEntries && entries[index * 2] == key) {
+            return entries[index * 2 + 1];
+        }
         return Utils::INVALID_VALUE;
     }
 
-    int numPages = ceil(this->fileDataByteSize / SST::PAGE_SIZE);
+    int fd = this->AcquireFile();
+    if (fd == -1) {
+        return Utils::INVALID_VALUE;
+    }
 
     // Read the file and do a binary search on that to look for the key
     uint64_t value = Utils::INVALID_VALUE;
@@ -357,126 +998,382 @@ uint64_t SST::PerformBinarySearch(uint64_t key, BufferPool *bufferPool) {
         // See if the buffer pool has this page, else
         // read this page and insert it into the buffer pool.
         std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
-        std::vector<uint64_t> data = SST::GetPage(pageId, fd, offsetToRead, bufferPool);
-        if (data.empty()) { // No more data in SST, break out of the loop
+        PageHandle page = this->GetPage(pageId, fd, offsetToRead, bufferPool);
+        if (page.Empty()) { // No more data in SST, break out of the loop
             break;
         }
 
-        // Get the keys from the data.
-        std::vector<uint64_t> keys = Utils::GetKeys(data);
-        if (key < keys[0]) {
+        // The pages are laid out as raw leaves, so search the keys where they are.
+        const uint64_t *data = page.Data();
+        size_t numEntries = SST::GetLeafNumEntries(data, page.Size(), LeafFormat::RAW_LEAVES);
+        if (key < data[0]) {
             end = offsetToRead - 1;
-        } else if (key > keys[keys.size() - 1]) {
+        } else if (key > SST::GetLeafKey(data, numEntries - 1, LeafFormat::RAW_LEAVES)) {
             start = offsetToRead + 1;
         } else {
-            int index = Utils::BinarySearch(keys, key);
+            size_t index = SST::FindKeyInLeaves(data, numEntries, key, LeafFormat::RAW_LEAVES);
             // Found the data, break out of the loop
-            if (index < keys.size() && keys[index] == key) {
+            if (index < numEntries && data[index * 2] == key) {
                 value = data[index * 2 + 1]; // values are in odd indexes
             }
             break;
         }
     }
-    close(fd);
+    this->ReleaseFile(fd);
     return value;
 }
 
-uint64_t SST::FindKeyInBTree(int fd, uint64_t key, BufferPool *bufferPool, std::vector<uint64_t> &levelsPageOffsets) {
-    uint64_t value = Utils::INVALID_VALUE;
-    uint64_t numOfLevels = levelsPageOffsets.size();
-    uint64_t currLevel = 0;
-    uint64_t offsetToRead = levelsPageOffsets[0]; // Should be 1 always
-    uint64_t prevLevelChildIndex = 0;
-    int index;
-    while (currLevel < numOfLevels) {
-        // See if the buffer pool has this page, else
-        // read this page and insert it into the buffer pool.
-        std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
-        std::vector<uint64_t> data = SST::GetPage(pageId, fd, offsetToRead, bufferPool);
-        if (data.empty()) {
-            return value;
+bool SST::LoadBTreeIndex() {
+    int fd = this->AcquireFile();
+    if (fd == -1) {
+        return false;
+    }
+
+    uint64_t metaDataPage = 0;
+    size_t filePageSize = SST::PAGE_SIZE;
+    std::vector<uint64_t> metadata = SST::ReadBTreeMetaData(fd, metaDataPage, filePageSize);
+    uint64_t numOfLevels = metadata.empty() ? 0 : metadata[0] & SST::NUM_LEVELS_MASK;
+    if (numOfLevels == 0 || metadata.size() < numOfLevels + 1) {
+        this->ReleaseFile(fd);
+        return false;
+    }
+    this->leafFormat = (LeafFormat) (metadata[0] >> SST::LEAF_FORMAT_SHIFT);
+    this->ReadFooter(fd);
+    this->levelsPageOffsets.assign(metadata.begin() + 1, metadata.begin() + 1 + numOfLevels);
+    // The leaves are from the start of the file up to the level right above them.
+    uint64_t numLeaves = numOfLevels > 1 ? this->levelsPageOffsets[numOfLevels - 2] : 1;
+    this->maxOffsetToReadLeaves = numLeaves - 1;
+    if (metadata.size() >= numOfLevels + 3) {
+        this->bloomFilterNumPages = metadata[numOfLevels + 1];
+        this->bloomFilterStartPage = metadata[numOfLevels + 2];
+    }
+
+    // A learned index, if any, replaces the fence keys of the leaves in memory.
+    this->learnedIndex.Clear();
+    if (metadata.size() >= numOfLevels + 5) {
+        this->learnedIndexNumPages = metadata[numOfLevels + 3];
+        this->learnedIndexStartPage = metadata[numOfLevels + 4];
+        uint64_t numBytes = this->learnedIndexNumPages * this->pageSize;
+        AlignedBuffer buffer(numBytes);
+        ssize_t bytesRead = pread(fd, buffer.Data(), numBytes, (off_t) (this->learnedIndexStartPage * this->pageSize));
+        if (bytesRead == -1) {
+            perror("pread");
+        }
+        std::vector<uint64_t> words(buffer.Data(), buffer.Data() + this->learnedIndexNumPages * this->pageNumWords);
+        if (bytesRead != (ssize_t) numBytes || !this->learnedIndex.Deserialize(words)) {
+            this->ReleaseFile(fd);
+            return false;
+        }
+        this->hasLearnedIndex = true;
+    }
+
+    // The level right above the leaves holds one fence key per leaf, which is the largest key of the leaf.
+    this->leafFenceKeys.clear();
+    if (numOfLevels > 1 && this->learnedIndex.GetNumKeys() == 0) {
+        uint64_t numPages = std::ceil(numLeaves / (double) this->keysPerPage);
+        this->leafFenceKeys = SST::ReadPagesOfFile(fd, this->levelsPageOffsets[numOfLevels - 2], numPages,
+                                                    this->pageSize);
+        if (this->leafFenceKeys.size() != numLeaves) {
+            this->leafFenceKeys.clear();
+            this->ReleaseFile(fd);
+            return false;
         }
+    }
+    this->leafFenceKeys.shrink_to_fit();
+    this->isBTreeIndexLoaded = true;
+    this->ReleaseFile(fd);
+    return true;
+}
 
-        if (currLevel == numOfLevels - 1) {
-            // This is the leaves level. Get the keys from the data.
-            std::vector<uint64_t> keys = Utils::GetKeys(data);
+size_t SST::GetIndexMemoryUsage() const {
+    return (this->levelsPageOffsets.capacity() + this->leafFenceKeys.capacity()) * sizeof(uint64_t) +
+           this->learnedIndex.GetMemoryUsage();
+}
 
-            index = Utils::BinarySearch(keys, key);
-            if (index < keys.size() && keys[index] == key) {
-                value = data[index * 2 + 1]; // values are in odd indexes
+uint64_t SST::FindLeafOffset(uint64_t key, int fd, BufferPool *bufferPool) {
+    if (!this->isBTreeIndexLoaded && !this->LoadBTreeIndex()) {
+        return Utils::INVALID_VALUE;
+    }
+    if (this->learnedIndex.GetNumKeys() > 0) {
+        return this->FindLeafOffsetWithLearnedIndex(key, fd, bufferPool);
+    }
+
+    uint64_t leavesStartPage = this->levelsPageOffsets.back();
+    // A B-Tree with a single level is just one leaf.
+    if (this->leafFenceKeys.empty()) {
+        return leavesStartPage;
+    }
+    return leavesStartPage + SearchKernels::LowerBound(this->leafFenceKeys.data(), this->leafFenceKeys.size(), key);
+}
+
+uint64_t SST::FindLeafOffsetWithLearnedIndex(uint64_t key, int fd, BufferPool *bufferPool) {
+    uint64_t leavesStartPage = this->levelsPageOffsets.back();
+    auto [first, last] = this->learnedIndex.GetSearchRange(key);
+    if (first == last) {
+        return leavesStartPage + first;
+    }
+
+    // The fence keys within the predicted range may be over a few pages of their level, so search
+    // them page by page where they are mapped.
+    uint64_t fenceKeysStartPage = this->levelsPageOffsets[this->levelsPageOffsets.size() - 2];
+    if (this->GetMappedPage(fenceKeysStartPage + (last - 1) / this->keysPerPage) != nullptr) {
+        for (uint64_t index = first; index < last;) {
+            uint64_t page = index / this->keysPerPage;
+            uint64_t pageEnd = std::min<uint64_t>(last, (page + 1) * this->keysPerPage);
+            const uint64_t *fenceKeys = this->GetMappedPage(fenceKeysStartPage + page) + PageHeader::NUM_WORDS;
+            size_t numKeys = pageEnd - index;
+            size_t position = SearchKernels::LowerBound(fenceKeys + index % this->keysPerPage, numKeys, key);
+            if (position < numKeys) {
+                return leavesStartPage + index + position;
             }
-            return value;
-        } else {
-            index = Utils::BinarySearch(data, key);
+            index = pageEnd;
         }
+        return leavesStartPage + last;
+    }
 
-        // Key not found
-        if (index >= data.size()) {
+    bool isFileOpened = false;
+    if (fd == -1) {
+        fd = this->AcquireFile();
+        if (fd == -1) {
             return Utils::INVALID_VALUE;
         }
-        offsetToRead = levelsPageOffsets[currLevel + 1];
-        offsetToRead += prevLevelChildIndex * SST::KEYS_PER_PAGE + index;
-        prevLevelChildIndex = index;
-        currLevel++;
+        isFileOpened = true;
+    }
+
+    // Read the fence keys within the predicted range from the level right above the leaves.
+    std::vector<uint64_t> fenceKeys;
+    for (uint64_t page = first / this->keysPerPage; page <= (last - 1) / this->keysPerPage; page++) {
+        uint64_t offsetToRead = fenceKeysStartPage + page;
+        std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
+        PageHandle keys = this->GetPage(pageId, fd, offsetToRead, bufferPool);
+        uint64_t pageFirst = page * this->keysPerPage;
+        uint64_t from = first > pageFirst ? first - pageFirst : 0;
+        uint64_t to = last - pageFirst < keys.Size() ? last - pageFirst : keys.Size();
+        if (from < to) {
+            fenceKeys.insert(fenceKeys.end(), keys.begin() + (long) from, keys.begin() + (long) to);
+        }
+    }
+    if (isFileOpened) {
+        this->ReleaseFile(fd);
+    }
+    return leavesStartPage + first + SearchKernels::LowerBound(fenceKeys.data(), fenceKeys.size(), key);
+}
+
+uint64_t SST::FindKeyInBTree(int fd, uint64_t key, BufferPool *bufferPool) {
+    uint64_t value = Utils::INVALID_VALUE;
+    uint64_t offsetToRead = this->FindLeafOffset(key, fd, bufferPool);
+    // Key is greater than every key of the file
+    if (offsetToRead == Utils::INVALID_VALUE || offsetToRead > this->maxOffsetToReadLeaves) {
+        return value;
     }
 
-    // Key not found
+    std::vector<uint64_t> data;
+    PageHandle page;
+    size_t numEntries;
+    const uint64_t *leaf = this->GetMappedPage(offsetToRead);
+    if (leaf != nullptr && this->leafFormat != LeafFormat::COMPRESSED_LEAVES) {
+        // Search the leaf where it is mapped.
+        numEntries = this->GetMappedPageNumEntries(leaf);
+        if (this->leafFormat == LeafFormat::RAW_LEAVES) {
+            leaf += PageHeader::NUM_WORDS;
+        }
+    } else {
+        if (leaf != nullptr) {
+            LeafPageCodec::Decode(leaf + PageHeader::NUM_WORDS, data, this->keysPerPage);
+            numEntries = SST::GetLeafNumEntries(data, this->leafFormat, this->pageSize);
+            leaf = data.data();
+        } else {
+            // See if the buffer pool has this page, else
+            // read this page and insert it into the buffer pool.
+            std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
+            page = this->GetPage(pageId, fd, offsetToRead, bufferPool, this->leafFormat);
+            numEntries = SST::GetLeafNumEntries(page.Data(), page.Size(), this->leafFormat, this->pageSize);
+            leaf = page.Data();
+        }
+    }
+    size_t index = SST::FindKeyInLeaves(leaf, numEntries, key, this->leafFormat, 0, this->pageSize);
+    if (index < numEntries && SST::GetLeafKey(leaf, index, this->leafFormat, this->pageSize) == key) {
+        value = SST::GetLeafValue(leaf, index, this->leafFormat, this->pageSize);
+    }
     return value;
 }
 
 uint64_t SST::PerformBTreeSearch(uint64_t key, BufferPool *bufferPool, bool isLSMTree) {
     uint64_t value = Utils::INVALID_VALUE;
-    int fd = Utils::OpenFile(this->fileName);
-    if (fd == -1) {
+    if (!this->isBTreeIndexLoaded && !this->LoadBTreeIndex()) {
         return value;
     }
 
-    uint64_t offsetToRead = 0;
-    // See if the buffer pool has this page, else
-    // read this page and insert it into the buffer pool.
-    std::string metadataPageId = this->GetPageIdInBufferPool(offsetToRead);
-    std::vector<uint64_t> metadata = SST::GetPage(metadataPageId, fd, offsetToRead, bufferPool);
-    if (metadata.empty()) {
-        close(fd);
+    // A mapped file is searched without opening it, the bloom filter included.
+    if (this->GetMappedPage(this->maxOffsetToReadLeaves) != nullptr) {
+        const uint64_t *bloomFilterArray = nullptr;
+        if (this->GetMappedPage(this->bloomFilterStartPage + this->bloomFilterNumPages - 1) != nullptr) {
+            bloomFilterArray = this->GetMappedPage(this->bloomFilterStartPage);
+        }
+        if (isLSMTree && this->bloomFilter && this->bloomFilterNumPages > 0 && bloomFilterArray != nullptr &&
+            !this->bloomFilter->KeyProbablyExists(key, bloomFilterArray)) {
+            return value;
+        }
+        return this->FindKeyInBTree(-1, key, bufferPool);
+    }
+
+    int fd = this->AcquireFile();
+    if (fd == -1) {
         return value;
     }
 
-    uint64_t numOfLevels = metadata[0];
     // Check the bloom filter if one is defined for this sst file.
-    if (isLSMTree) {
-        uint64_t numPagesToRead = metadata[numOfLevels + 1];
-        offsetToRead = metadata[numOfLevels + 2]; // offset where the bloom filter starts
+    if (isLSMTree && this->bloomFilter && this->bloomFilterNumPages > 0) {
+        uint64_t offsetToRead = this->bloomFilterStartPage;
         std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
-        auto bloomFilterArray = SST::GetBloomFilterPages(pageId, fd, offsetToRead, numPagesToRead, bufferPool);
-        if (this->bloomFilter && !this->bloomFilter->KeyProbablyExists(key, bloomFilterArray)) {
-            close(fd);
+        PageHandle bloomFilterArray = this->GetBloomFilterPages(pageId, fd, offsetToRead,
+                                                               this->bloomFilterNumPages, bufferPool);
+        if (!this->bloomFilter->KeyProbablyExists(key, bloomFilterArray.Data())) {
+            this->ReleaseFile(fd);
             return value;
         }
     }
 
-    std::vector<uint64_t> levelsPageOffsets;
-    for (int i = 1; i <= numOfLevels; i++) {
-        // When computing the index of the starting page of each level,
-        // count for this page by adding a one.
-        levelsPageOffsets.push_back(metadata[i]);
+    uint64_t result = SST::FindKeyInBTree(fd, key, bufferPool);
+    this->ReleaseFile(fd);
+    return result;
+}
+
+void SST::PerformBTreeMultiSearch(const std::vector<uint64_t> &keys, std::vector<uint64_t> &values,
+                                  BufferPool *bufferPool, bool isLSMTree, AsyncReader *asyncReader) {
+    values.assign(keys.size(), Utils::INVALID_VALUE);
+    if (!this->isBTreeIndexLoaded && !this->LoadBTreeIndex()) {
+        return;
+    }
+    // There is nothing to read ahead of the searches of a mapped file.
+    if (asyncReader == nullptr || this->GetMappedPage(this->maxOffsetToReadLeaves) != nullptr) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            values[i] = this->PerformBTreeSearch(keys[i], bufferPool, isLSMTree);
+        }
+        return;
     }
 
-    uint64_t result = SST::FindKeyInBTree(fd, key, bufferPool, levelsPageOffsets);
-    close(fd);
-    return result;
+    int fd = this->AcquireFile();
+    if (fd == -1) {
+        return;
+    }
+    PageHandle bloomFilterArray;
+    if (isLSMTree && this->bloomFilter && this->bloomFilterNumPages > 0) {
+        uint64_t offsetToRead = this->bloomFilterStartPage;
+        std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
+        bloomFilterArray = this->GetBloomFilterPages(pageId, fd, offsetToRead, this->bloomFilterNumPages, bufferPool);
+    }
+
+    // Find the leaf of each key first, so that the keys of a leaf share one read of it.
+    std::map<uint64_t, std::vector<size_t>> keysOfLeaves;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (!bloomFilterArray.Empty() && !this->bloomFilter->KeyProbablyExists(keys[i], bloomFilterArray.Data())) {
+            continue;
+        }
+        uint64_t offsetToRead = this->FindLeafOffset(keys[i], fd, bufferPool);
+        if (offsetToRead != Utils::INVALID_VALUE && offsetToRead <= this->maxOffsetToReadLeaves) {
+            keysOfLeaves[offsetToRead].push_back(i);
+        }
+    }
+
+    // Submit the reads of all the leaves that are not in the buffer pool at once, then search
+    // each leaf as its read is done. The leaves are read straight into frames of the buffer pool,
+    // or into a buffer of their own if they don't fit in one.
+    std::vector<PageHandle> leaves(keysOfLeaves.size());
+    std::vector<AsyncReadRequest> requests(keysOfLeaves.size());
+    std::vector<uint64_t *> frames(keysOfLeaves.size(), nullptr);
+    AlignedBuffer buffer;
+    bool canReadIntoFrame = this->CanReadIntoFrame(bufferPool, this->leafFormat);
+    size_t leafIndex = 0;
+    for (auto &[offsetToRead, keyIndexes]: keysOfLeaves) {
+        if (bufferPool != nullptr) {
+            leaves[leafIndex] = bufferPool->Pin(this->GetPageIdInBufferPool(offsetToRead));
+        }
+        if (leaves[leafIndex].Empty()) {
+            AsyncReadRequest &request = requests[leafIndex];
+            request.fd = fd;
+            request.byteOffset = offsetToRead * this->pageSize;
+            request.numBytes = this->pageSize;
+            frames[leafIndex] = canReadIntoFrame ? bufferPool->AcquireFrame() : nullptr;
+            if (frames[leafIndex] != nullptr) {
+                request.buffer = frames[leafIndex];
+            } else {
+                // Sized once for all the leaves, so that the reads already submitted keep their buffer.
+                buffer.Reserve(keysOfLeaves.size() * this->pageSize);
+                request.buffer = buffer.Data() + leafIndex * this->pageNumWords;
+            }
+            asyncReader->Submit(&request);
+        }
+        leafIndex++;
+    }
+
+    leafIndex = 0;
+    for (auto &[offsetToRead, keyIndexes]: keysOfLeaves) {
+        PageHandle &leaf = leaves[leafIndex];
+        if (requests[leafIndex].fd != -1) {
+            ssize_t bytesRead = asyncReader->Wait(&requests[leafIndex]);
+            std::string pageId = this->GetPageIdInBufferPool(offsetToRead);
+            if (frames[leafIndex] != nullptr) {
+                leaf = this->InsertPageReadIntoFrame(pageId, frames[leafIndex], bytesRead, bufferPool,
+                                                     this->leafFormat);
+            } else {
+                std::vector<uint64_t> decoded = SST::DecodeLeafPages(buffer.Data() + leafIndex * this->pageNumWords,
+                                                                     bytesRead, this->leafFormat, this->pageSize);
+                if (bufferPool != nullptr && !decoded.empty()) {
+                    leaf = bufferPool->Insert(pageId, std::move(decoded));
+                } else {
+                    leaf = PageHandle(std::move(decoded));
+                }
+            }
+        }
+        const uint64_t *data = leaf.Data();
+        size_t numEntries = SST::GetLeafNumEntries(data, leaf.Size(), this->leafFormat, this->pageSize);
+        for (size_t keyIndex: keyIndexes) {
+            size_t index = SST::FindKeyInLeaves(data, numEntries, keys[keyIndex], this->leafFormat, 0,
+                                                this->pageSize);
+            if (index < numEntries && SST::GetLeafKey(data, index, this->leafFormat, this->pageSize) == keys[keyIndex]) {
+                values[keyIndex] = SST::GetLeafValue(data, index, this->leafFormat, this->pageSize);
+            }
+        }
+        leafIndex++;
+    }
+    this->ReleaseFile(fd);
 }
 
 void SST::PerformBinaryScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult) {
-    int fd = Utils::OpenFile(this->fileName);
+    uint64_t numOfPagesOfFile = this->GetNumBinarySearchPages();
+    if (numOfPagesOfFile > 0 && this->GetMappedPage(numOfPagesOfFile - 1) != nullptr) {
+        // Read the pages from the one holding key1 on where they are mapped, and read ahead of them while at it.
+        uint64_t firstPage = this->FindMappedBinarySearchPage(key1, numOfPagesOfFile);
+        uint64_t numPages = this->FindMappedBinarySearchPage(key2, numOfPagesOfFile) - firstPage + 1;
+        this->AdviseMappedPages(firstPage, numPages, MADV_SEQUENTIAL);
+        bool foundKey2 = false;
+        for (uint64_t offset = firstPage; offset < numOfPagesOfFile && !foundKey2; offset++) {
+            const uint64_t *page = this->GetMappedPage(offset);
+            size_t numEntries = this->GetMappedPageNumEntries(page);
+            const uint64_t *entries = page + PageHeader::NUM_WORDS;
+            size_t index = SST::FindKeyInLeaves(entries, numEntries, key1, LeafFormat::RAW_LEAVES);
+            for (; index < numEntries; index++) {
+                if (entries[index * 2] > key2) {
+                    foundKey2 = true;
+                    break;
+                }
+                scanResult.emplace_back(entries[index * 2], entries[index * 2 + 1]);
+            }
+        }
+        this->AdviseMappedPages(firstPage, numPages, MADV_RANDOM);
+        return;
+    }
+
+    int fd = this->AcquireFile();
     if (fd == -1) {
         return;
     }
 
     // Read the file and do a binary search on that to look for the key1
     bool foundKey1 = false;
-    int numOfPagesOfFile = ceil((double) this->fileDataByteSize / SST::PAGE_SIZE);
     int start = 0;
-    int end = numOfPagesOfFile - 1;
+    int end = (int) numOfPagesOfFile - 1;
     int offsetToRead;
     std::set<uint64_t> pagesReadSoFar;
     uint64_t key1Page = 0;
@@ -484,8 +1381,11 @@ void SST::PerformBinaryScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_
         // Perform a binary search for key1
         offsetToRead = start + (end - start) / 2;
         std::vector<uint64_t> data;
-        data = SST::ReadPagesOfFile(fd, offsetToRead);
+        data = SST::ReadPagesOfFile(fd, offsetToRead, 1, this->pageSize);
         pagesReadSoFar.insert(offsetToRead);
+        if (data.empty()) {
+            break;
+        }
 
         // Get the keys from the data.
         std::vector<uint64_t> keys = Utils::GetKeys(data);
@@ -499,8 +1399,8 @@ void SST::PerformBinaryScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_
             start = offsetToRead + 1;
             // Skip this page
             startIndex = std::numeric_limits<int>::max(); // max value
-            if (offsetToRead == numOfPagesOfFile - 1) {
-                close(fd);
+            if (offsetToRead == (int) numOfPagesOfFile - 1) {
+                this->ReleaseFile(fd);
                 return;
             }
         } else {
@@ -533,7 +1433,7 @@ void SST::PerformBinaryScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_
     uint64_t nextPageToRead = key1Page + 1;
     while (!foundKey2 && nextPageToRead < numOfPagesOfFile) {
         if (!pagesReadSoFar.count(nextPageToRead)) {
-            std::vector<uint64_t> data = SST::ReadPagesOfFile(fd, nextPageToRead);
+            std::vector<uint64_t> data = SST::ReadPagesOfFile(fd, nextPageToRead, 1, this->pageSize);
             for (int i = 0; i < data.size(); i += 2) {
                 // Read until we find a key greater than key2.
                 if (data[i] > key2) {
@@ -546,60 +1446,93 @@ void SST::PerformBinaryScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_
         }
         nextPageToRead++;
     }
-    close(fd);
+    this->ReleaseFile(fd);
 }
 
-uint64_t SST::ReadBTreeScanLeavesRange(int fd, uint64_t key1) {
-    // Read one page of the file containing the metadata of the tree.
-    std::vector<uint64_t> levelsPageOffsets = SST::ReadBTreeLevelOffsets(fd);
-    int currLevel = 0;
-    uint64_t offsetToRead = levelsPageOffsets[0];
-    uint64_t numOfLevels = levelsPageOffsets.size();
-
-    // A queue of pairs of page offset to read and its index at its parent node.
-    std::queue<DataEntry_t> queue;
-    queue.emplace(offsetToRead, 0);
-    while (currLevel != numOfLevels - 1) {
-        std::vector<DataEntry_t> keysIndexesLimits;
-        std::vector<DataEntry_t> keysIndexes;
-        DataEntry_t curPageToRead = queue.front();
-        queue.pop();
-        std::vector<uint64_t> data = SST::ReadPagesOfFile(fd, curPageToRead.first);
-        if (data.empty()) {
-            break;
-        }
-
-        uint64_t keyCeilIndex = Utils::BinarySearch(data, key1);
-        offsetToRead = levelsPageOffsets[currLevel + 1];
-        offsetToRead += curPageToRead.second * SST::KEYS_PER_PAGE + keyCeilIndex;
-        if (keyCeilIndex >= data.size()) {
-            keyCeilIndex = data.size() - 1;
-        }
-        queue.emplace(offsetToRead, keyCeilIndex);
-        currLevel++;
+void SST::PerformBTreeScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult,
+                           AsyncReader *asyncReader) {
+    // A mapped file is scanned without opening it.
+    if ((this->isBTreeIndexLoaded || this->LoadBTreeIndex()) &&
+        this->GetMappedPage(this->maxOffsetToReadLeaves) != nullptr) {
+        this->ScanMappedLeaves(key1, key2, scanResult);
+        return;
     }
-    return queue.front().first;
-}
 
-void SST::PerformBTreeScan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult) {
-    int fd = Utils::OpenFile(this->fileName);
+    int fd = this->AcquireFile();
     if (fd == -1) {
         return;
     }
 
-    uint64_t offsetToRead = SST::ReadBTreeScanLeavesRange(fd, key1);
+    uint64_t offsetToRead = this->FindLeafOffset(key1, fd);
     // Read all the pages between offsetToRead (where the key1 is) and
     // this->maxOffsetToReadLeaves, until you either find key2 or reach end of the leaves.
-    while (offsetToRead <= this->maxOffsetToReadLeaves) {
-        std::vector<uint64_t> data = SST::ReadPagesOfFile(fd, offsetToRead);
-        for (int i = 0; i < SST::KEYS_PER_PAGE - 1; i += 2) {
-            if (data[i] > key2 || data[i] == Utils::INVALID_VALUE) {
+    // With an async reader, each leaf is read while the one before it is scanned.
+    PagePrefetcher prefetcher(asyncReader);
+    bool foundKey2 = false;
+    while (offsetToRead <= this->maxOffsetToReadLeaves && !foundKey2) {
+        std::vector<uint64_t> data;
+        if (asyncReader != nullptr) {
+            uint64_t numPagesToPrefetch = offsetToRead < this->maxOffsetToReadLeaves ? 1 : 0;
+            data = SST::ReadLeafPagesOfFile(fd, offsetToRead, 1, this->leafFormat, this->pageSize, &prefetcher,
+                                            numPagesToPrefetch);
+        } else {
+            data = SST::ReadLeafPagesOfFile(fd, offsetToRead, 1, this->leafFormat, this->pageSize);
+        }
+        // The last leaf ends before the end of its page if it is not full.
+        size_t numEntries = SST::GetLeafNumEntries(data, this->leafFormat, this->pageSize);
+        size_t start = SST::FindKeyInLeaves(data, numEntries, key1, this->leafFormat, 0, this->pageSize);
+        for (size_t i = start; i < numEntries; i++) {
+            uint64_t key = SST::GetLeafKey(data, i, this->leafFormat, this->pageSize);
+            if (key > key2) {
+                foundKey2 = true;
                 break;
-            } else if (data[i] >= key1) {
-                scanResult.emplace_back(data[i], data[i + 1]);
             }
+            scanResult.emplace_back(key, SST::GetLeafValue(data, i, this->leafFormat, this->pageSize));
         }
         offsetToRead++;
     }
-    close(fd);
+    prefetcher.Cancel();
+    this->ReleaseFile(fd);
+}
+
+void SST::ScanMappedLeaves(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &scanResult) {
+    uint64_t offsetToRead = this->FindLeafOffset(key1);
+    if (offsetToRead > this->maxOffsetToReadLeaves) {
+        return;
+    }
+    // The leaves up to the one holding key2 are read in a row, so have them read ahead.
+    uint64_t lastOffsetToRead = this->FindLeafOffset(key2);
+    if (lastOffsetToRead > this->maxOffsetToReadLeaves) {
+        lastOffsetToRead = this->maxOffsetToReadLeaves;
+    }
+    uint64_t numPages = lastOffsetToRead >= offsetToRead ? lastOffsetToRead - offsetToRead + 1 : 1;
+    this->AdviseMappedPages(offsetToRead, numPages, MADV_SEQUENTIAL);
+
+    std::vector<uint64_t> data;
+    bool foundKey2 = false;
+    for (uint64_t offset = offsetToRead; offset <= this->maxOffsetToReadLeaves && !foundKey2; offset++) {
+        const uint64_t *leaf = this->GetMappedPage(offset);
+        size_t numEntries;
+        if (this->leafFormat == LeafFormat::COMPRESSED_LEAVES) {
+            data.clear();
+            LeafPageCodec::Decode(leaf + PageHeader::NUM_WORDS, data, this->keysPerPage);
+            numEntries = SST::GetLeafNumEntries(data, this->leafFormat, this->pageSize);
+            leaf = data.data();
+        } else {
+            numEntries = this->GetMappedPageNumEntries(leaf);
+            if (this->leafFormat == LeafFormat::RAW_LEAVES) {
+                leaf += PageHeader::NUM_WORDS;
+            }
+        }
+        size_t start = SST::FindKeyInLeaves(leaf, numEntries, key1, this->leafFormat, 0, this->pageSize);
+        for (size_t i = start; i < numEntries; i++) {
+            uint64_t key = SST::GetLeafKey(leaf, i, this->leafFormat, this->pageSize);
+            if (key > key2) {
+                foundKey2 = true;
+                break;
+            }
+            scanResult.emplace_back(key, SST::GetLeafValue(leaf, i, this->leafFormat, this->pageSize));
+        }
+    }
+    this->AdviseMappedPages(offsetToRead, numPages, MADV_RANDOM);
 }
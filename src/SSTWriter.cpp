@@ -0,0 +1,86 @@
+#include "SSTWriter.h"
+#include <filesystem>
+#include <iostream>
+
+SSTWriter::SSTWriter(const std::string &filePath, uint64_t numEntries, int bloomFilterBitsPerEntry,
+                     int bufferNumPages, LeafFormat leafFormat, bool useDirectWrites, size_t pageSize) {
+    std::string fileName = filePath;
+    this->numEntries = numEntries;
+    this->numEntriesAdded = 0;
+    this->lastKey = 0;
+    this->hasError = false;
+    if (!SST::IsValidPageSize(pageSize)) {
+        std::cerr << "Invalid page size " << pageSize << " for SST file " << fileName << std::endl;
+        pageSize = SST::PAGE_SIZE;
+        this->hasError = true;
+    }
+    this->bloomFilter = new BloomFilter(bloomFilterBitsPerEntry, numEntries);
+    this->sstFile = new SST(fileName, numEntries * SST::KV_PAIR_BYTE_SIZE, this->bloomFilter, pageSize);
+    this->sstFile->SetupBTreeFile(leafFormat);
+    // The buffer holds whole pages, so that the fence keys of the leaves written so far
+    // are known each time it is written out.
+    this->bufferCapacity = bufferNumPages * this->sstFile->GetKVPairsPerPage();
+    this->buffer.reserve(this->bufferCapacity);
+    this->file = new AlignedFileWriter(fileName, useDirectWrites, this->sstFile->GetMaxFileByteSize());
+    if (!this->file->IsGood()) {
+        std::cerr << "Could not create SST file " << fileName << std::endl;
+        this->hasError = true;
+    }
+}
+
+SSTWriter::~SSTWriter() {
+    delete this->file;
+    if (this->sstFile != nullptr) {
+        std::filesystem::remove(this->sstFile->GetFileName());
+        delete this->sstFile;
+    }
+}
+
+bool SSTWriter::Add(uint64_t key, uint64_t value) {
+    if (this->numEntriesAdded >= this->numEntries) {
+        std::cerr << "More key-value pairs added than the " << this->numEntries << " announced." << std::endl;
+        return false;
+    }
+    if (this->numEntriesAdded > 0 && key <= this->lastKey) {
+        std::cerr << "Keys must be added in strictly ascending order." << std::endl;
+        return false;
+    }
+    // The invalid value is what lookups return for the keys that are not found.
+    if (value == Utils::INVALID_VALUE) {
+        std::cerr << "Invalid key-value pair." << std::endl;
+        return false;
+    }
+
+    this->buffer.emplace_back(key, value);
+    this->lastKey = key;
+    this->bloomFilter->InsertKey(key);
+    this->numEntriesAdded++;
+    if (this->buffer.size() >= this->bufferCapacity || this->numEntriesAdded == this->numEntries) {
+        this->WriteBuffer();
+    }
+    return true;
+}
+
+void SSTWriter::WriteBuffer() {
+    if (!this->hasError) {
+        bool endOfData = this->numEntriesAdded == this->numEntries;
+        this->sstFile->WriteBTreeLevels(*this->file, this->buffer, endOfData);
+    }
+    this->buffer.clear();
+}
+
+SST *SSTWriter::Finish() {
+    if (this->numEntriesAdded != this->numEntries || this->numEntries == 0) {
+        std::cerr << "Added " << this->numEntriesAdded << " key-value pairs instead of the " << this->numEntries
+                  << " announced." << std::endl;
+        return nullptr;
+    }
+    if (this->hasError) {
+        return nullptr;
+    }
+
+    this->sstFile->WriteEndOfBTreeFile(*this->file);
+    SST *finishedFile = this->sstFile;
+    this->sstFile = nullptr;
+    return finishedFile;
+}
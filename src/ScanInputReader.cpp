@@ -1,28 +1,51 @@
 #include "ScanInputReader.h"
 #include <iostream>
 
-ScanInputReader::ScanInputReader(uint64_t capacity) {
+ScanInputReader::ScanInputReader(uint64_t capacity, LeafFormat leafFormat, size_t pageSize) {
     this->bufferCapacity = capacity;
     this->inputBuffer = {};
     this->offsetToRead = 0;
     this->endOffsetToScan = Utils::INVALID_VALUE;
-    this->keys = {};
+    this->numEntries = 0;
     this->startIndex = 0;
     this->isScannedCompletely = false;
+    this->leafFormat = leafFormat;
+    this->pageSize = pageSize;
+    this->prefetcher = nullptr;
+}
+
+ScanInputReader::~ScanInputReader() {
+    delete this->prefetcher;
+}
+
+void ScanInputReader::SetAsyncReader(AsyncReader *asyncReader) {
+    delete this->prefetcher;
+    this->prefetcher = asyncReader != nullptr ? new PagePrefetcher(asyncReader) : nullptr;
 }
 
 void ScanInputReader::ReadDataPagesIntoBuffer(int fd) {
     this->inputBuffer.clear();
-    this->keys.clear();
+    this->numEntries = 0;
     if (this->offsetToRead > this->endOffsetToScan) {
         this->isScannedCompletely = true;
         return;
     }
 
     uint64_t numDataPagesToRead = std::min(this->bufferCapacity, this->endOffsetToScan - this->offsetToRead + 1);
-    this->inputBuffer = SST::ReadPagesOfFile(fd, this->offsetToRead, numDataPagesToRead);
+    if (this->prefetcher != nullptr) {
+        uint64_t nextOffsetToRead = this->offsetToRead + numDataPagesToRead;
+        uint64_t numPagesToPrefetch = 0;
+        if (nextOffsetToRead <= this->endOffsetToScan) {
+            numPagesToPrefetch = std::min(this->bufferCapacity, this->endOffsetToScan - nextOffsetToRead + 1);
+        }
+        this->inputBuffer = SST::ReadLeafPagesOfFile(fd, this->offsetToRead, numDataPagesToRead, this->leafFormat,
+                                                     this->pageSize, this->prefetcher, numPagesToPrefetch);
+    } else {
+        this->inputBuffer = SST::ReadLeafPagesOfFile(fd, this->offsetToRead, numDataPagesToRead, this->leafFormat,
+                                                     this->pageSize);
+    }
+    this->numEntries = SST::GetLeafNumEntries(this->inputBuffer, this->leafFormat, this->pageSize);
     this->offsetToRead += numDataPagesToRead;
-    this->SetKeys();
     this->startIndex = 0;
 }
 
@@ -36,32 +59,28 @@ void ScanInputReader::SetLeavesRangeToScan(uint64_t newStartOffsetToScan, uint64
     ScanInputReader::ReadDataPagesIntoBuffer(fd);
 }
 
-void ScanInputReader::SetKeys() {
-    this->keys.clear();
-    for (int i = 0; i < this->inputBuffer.size(); i += 2) {
-        this->keys.push_back(this->inputBuffer[i]);
-    }
-}
-
 int ScanInputReader::GetInputBufferSize() {
-    return this->inputBuffer.size();
+    return this->numEntries * 2;
 }
 
 DataEntry_t ScanInputReader::FindKey(uint64_t key, int fd) {
     // Set the default entry to INVALID_VALUE
     DataEntry_t entry = std::make_pair(key, Utils::INVALID_VALUE);
-    int index = Utils::BinarySearch(this->keys, key, this->startIndex);
-    while (index >= this->keys.size()) {
+    // The keys are searched in the buffer as they are laid out in the leaves.
+    size_t index = SST::FindKeyInLeaves(this->inputBuffer, this->numEntries, key, this->leafFormat, this->startIndex,
+                                        this->pageSize);
+    while (index >= this->numEntries) {
         ScanInputReader::ReadDataPagesIntoBuffer(fd);
-        if (this->keys.empty()) {
+        if (this->numEntries == 0) {
             return entry;
         }
-        index = Utils::BinarySearch(this->keys, key, this->startIndex);
+        index = SST::FindKeyInLeaves(this->inputBuffer, this->numEntries, key, this->leafFormat, this->startIndex,
+                                     this->pageSize);
     }
 
     this->startIndex = index;
-    if (this->keys[index] == key) {
-        entry.second = this->inputBuffer[2 * index + 1];
+    if (SST::GetLeafKey(this->inputBuffer, index, this->leafFormat, this->pageSize) == key) {
+        entry.second = SST::GetLeafValue(this->inputBuffer, index, this->leafFormat, this->pageSize);
     }
     return entry;
 }
@@ -0,0 +1,124 @@
+#include "SearchKernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SEARCH_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    /**
+     * Narrow down the range of [start, start + numKeys] holding the lower bound of key until it
+     * is no longer than LINEAR_SEARCH_NUM_KEYS keys. The keys are stride words apart.
+     */
+    inline void NarrowRange(const uint64_t *keys, size_t stride, uint64_t key, size_t &start, size_t &numKeys) {
+        while (numKeys > SearchKernels::LINEAR_SEARCH_NUM_KEYS) {
+            size_t half = numKeys / 2;
+            // A conditional move rather than a branch the CPU would mispredict half of the time.
+            start = keys[(start + half - 1) * stride] < key ? start + half : start;
+            numKeys -= half;
+        }
+    }
+
+    size_t CountSmallerKeysScalar(const uint64_t *keys, size_t numKeys, size_t stride, uint64_t key) {
+        size_t count = 0;
+        for (size_t i = 0; i < numKeys; i++) {
+            count += keys[i * stride] < key;
+        }
+        return count;
+    }
+
+#ifdef SEARCH_KERNELS_X86
+    // There are only signed 64-bit comparisons, so the keys are compared with their top bit flipped.
+    const long long SIGN_BIT = (long long) (1ULL << 63);
+
+    __attribute__((target("sse4.2,popcnt")))
+    size_t CountSmallerKeysSSE42(const uint64_t *keys, size_t numKeys, size_t stride, uint64_t key) {
+        __m128i sign = _mm_set1_epi64x(SIGN_BIT);
+        __m128i target = _mm_xor_si128(_mm_set1_epi64x((long long) key), sign);
+        // With keys and values one after another, a vector holds a single key.
+        int keyMask = stride == 1 ? 0x3 : 0x1;
+        size_t keysPerVector = stride == 1 ? 2 : 1;
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + keysPerVector <= numKeys; i += keysPerVector) {
+            __m128i words = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (keys + i * stride)), sign);
+            __m128i isSmaller = _mm_cmpgt_epi64(target, words);
+            count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(isSmaller)) & keyMask);
+        }
+        return count + CountSmallerKeysScalar(keys + i * stride, numKeys - i, stride, key);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    size_t CountSmallerKeysAVX2(const uint64_t *keys, size_t numKeys, size_t stride, uint64_t key) {
+        __m256i sign = _mm256_set1_epi64x(SIGN_BIT);
+        __m256i target = _mm256_xor_si256(_mm256_set1_epi64x((long long) key), sign);
+        // With keys and values one after another, only every other word of a vector is a key.
+        int keyMask = stride == 1 ? 0xF : 0x5;
+        size_t keysPerVector = stride == 1 ? 4 : 2;
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + keysPerVector <= numKeys; i += keysPerVector) {
+            __m256i words = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (keys + i * stride)), sign);
+            __m256i isSmaller = _mm256_cmpgt_epi64(target, words);
+            count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(isSmaller)) & keyMask);
+        }
+        return count + CountSmallerKeysScalar(keys + i * stride, numKeys - i, stride, key);
+    }
+#endif
+
+    size_t LowerBoundStrided(const uint64_t *keys, size_t numKeys, size_t stride, uint64_t key,
+                             SearchKernel kernel) {
+        size_t start = 0;
+        NarrowRange(keys, stride, key, start, numKeys);
+        const uint64_t *range = keys + start * stride;
+        switch (kernel) {
+#ifdef SEARCH_KERNELS_X86
+            case AVX2_KERNEL:
+                return start + CountSmallerKeysAVX2(range, numKeys, stride, key);
+            case SSE42_KERNEL:
+                return start + CountSmallerKeysSSE42(range, numKeys, stride, key);
+#endif
+            default:
+                return start + CountSmallerKeysScalar(range, numKeys, stride, key);
+        }
+    }
+}
+
+SearchKernel SearchKernels::DetectBestKernel() {
+#ifdef SEARCH_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return AVX2_KERNEL;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        return SSE42_KERNEL;
+    }
+#endif
+    return SCALAR_KERNEL;
+}
+
+SearchKernel SearchKernels::GetBestKernel() {
+    static const SearchKernel bestKernel = SearchKernels::DetectBestKernel();
+    return bestKernel;
+}
+
+bool SearchKernels::IsKernelSupported(SearchKernel kernel) {
+    return kernel <= SearchKernels::GetBestKernel();
+}
+
+size_t SearchKernels::LowerBound(const uint64_t *keys, size_t numKeys, uint64_t key) {
+    return LowerBoundStrided(keys, numKeys, 1, key, SearchKernels::GetBestKernel());
+}
+
+size_t SearchKernels::LowerBound(const uint64_t *keys, size_t numKeys, uint64_t key, SearchKernel kernel) {
+    return LowerBoundStrided(keys, numKeys, 1, key, kernel);
+}
+
+size_t SearchKernels::LowerBoundInPairs(const uint64_t *entries, size_t numEntries, uint64_t key) {
+    return LowerBoundStrided(entries, numEntries, 2, key, SearchKernels::GetBestKernel());
+}
+
+size_t SearchKernels::LowerBoundInPairs(const uint64_t *entries, size_t numEntries, uint64_t key,
+                                        SearchKernel kernel) {
+    return LowerBoundStrided(entries, numEntries, 2, key, kernel);
+}
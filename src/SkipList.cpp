@@ -0,0 +1,199 @@
+#include "SkipList.h"
+#include <new>
+#include <random>
+
+SkipList::SkipList(Arena *arena) {
+    this->arena = arena;
+    // The head lives outside the arena so that it survives the arena being reset.
+    this->headMemory = new char[SkipList::GetNodeSize(SkipList::MAX_HEIGHT)];
+    this->head = SkipList::InitNode(this->headMemory, 0, Utils::INVALID_VALUE, SkipList::MAX_HEIGHT);
+    this->maxHeight = 1;
+    this->currentSize = 0;
+}
+
+SkipList::~SkipList() {
+    delete[] this->headMemory;
+}
+
+size_t SkipList::GetNodeSize(int height) {
+    return sizeof(SkipListNode) + sizeof(std::atomic<SkipListNode *>) * (height - 1);
+}
+
+SkipList::SkipListNode *SkipList::NewNode(uint64_t key, uint64_t value, int height) {
+    return SkipList::InitNode(this->arena->AllocateConcurrently(GetNodeSize(height)), key, value, height);
+}
+
+SkipList::SkipListNode *SkipList::InitNode(char *memory, uint64_t key, uint64_t value, int height) {
+    auto *node = new(memory) SkipListNode;
+    node->key = key;
+    node->value.store(value, std::memory_order_relaxed);
+    for (int i = 0; i < height; i++) {
+        new(&node->next[i]) std::atomic<SkipListNode *>(nullptr);
+    }
+    return node;
+}
+
+int SkipList::RandomHeight() {
+    // Each thread draws from its own generator so that writers do not contend on it.
+    thread_local std::minstd_rand generator(std::random_device{}());
+    int height = 1;
+    while (height < SkipList::MAX_HEIGHT && generator() % SkipList::BRANCHING == 0) {
+        height++;
+    }
+    return height;
+}
+
+void SkipList::FindSpliceForLevel(uint64_t key, SkipListNode *before, int level, SkipListNode **prev,
+                                  SkipListNode **next) {
+    while (true) {
+        SkipListNode *after = before->GetNext(level);
+        if (after == nullptr || after->key >= key) {
+            *prev = before;
+            *next = after;
+            return;
+        }
+        before = after;
+    }
+}
+
+SkipList::SkipListNode *SkipList::FindGreaterOrEqual(uint64_t key) {
+    SkipListNode *node = this->head;
+    int level = this->maxHeight.load(std::memory_order_relaxed) - 1;
+    while (true) {
+        SkipListNode *next = node->GetNext(level);
+        if (next != nullptr && next->key < key) {
+            // Keep searching in this level
+            node = next;
+        } else if (level == 0) {
+            return next;
+        } else {
+            // Switch to the next level down
+            level--;
+        }
+    }
+}
+
+bool SkipList::Insert(uint64_t key, uint64_t value) {
+    SkipListNode *prev[SkipList::MAX_HEIGHT];
+    for (auto &node: prev) {
+        node = this->head;
+    }
+    return this->InsertWithHint(key, value, prev);
+}
+
+void SkipList::InsertSorted(const std::vector<DataEntry_t> &entries, size_t start, size_t end) {
+    SkipListNode *prev[SkipList::MAX_HEIGHT];
+    for (auto &node: prev) {
+        node = this->head;
+    }
+    for (size_t i = start; i < end; i++) {
+        this->InsertWithHint(entries[i].first, entries[i].second, prev);
+    }
+}
+
+bool SkipList::InsertWithHint(uint64_t key, uint64_t value, SkipListNode **prev) {
+    SkipListNode *next[SkipList::MAX_HEIGHT];
+
+    // Find where the key goes in every level, from the top down. Levels higher than the
+    // height loaded here are searched too, since other writers may be linking nodes into them.
+    int height = this->maxHeight.load(std::memory_order_relaxed);
+    SkipListNode *before = this->head;
+    for (int level = SkipList::MAX_HEIGHT - 1; level >= 0; level--) {
+        // Both the hint and the node found in the level above come before the key in
+        // this level, so start from whichever of them is further along.
+        if (before == this->head || (prev[level] != this->head && prev[level]->key > before->key)) {
+            before = prev[level];
+        }
+        FindSpliceForLevel(key, before, level, &prev[level], &next[level]);
+        before = prev[level];
+    }
+
+    if (next[0] != nullptr && next[0]->key == key) {
+        next[0]->value.store(value, std::memory_order_release);
+        return false;
+    }
+
+    int nodeHeight = SkipList::RandomHeight();
+    while (nodeHeight > height) {
+        if (this->maxHeight.compare_exchange_weak(height, nodeHeight, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    SkipListNode *node = this->NewNode(key, value, nodeHeight);
+    for (int level = 0; level < nodeHeight; level++) {
+        while (true) {
+            node->next[level].store(next[level], std::memory_order_relaxed);
+            if (prev[level]->next[level].compare_exchange_strong(next[level], node, std::memory_order_release)) {
+                break;
+            }
+
+            // Another writer linked a node in between, so find the new place of the key
+            // in this level, starting from the node we were about to link after.
+            FindSpliceForLevel(key, prev[level], level, &prev[level], &next[level]);
+            if (level == 0 && next[0] != nullptr && next[0]->key == key) {
+                // Another writer inserted the same key first. The node we allocated is never
+                // linked in and is released with the arena.
+                next[0]->value.store(value, std::memory_order_release);
+                return false;
+            }
+        }
+        // The next greater key comes after this node.
+        prev[level] = node;
+    }
+    this->currentSize.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+uint64_t SkipList::Search(uint64_t key) {
+    SkipListNode *node = this->FindGreaterOrEqual(key);
+    if (node != nullptr && node->key == key) {
+        return node->value.load(std::memory_order_acquire);
+    }
+    // key not found.
+    return Utils::INVALID_VALUE;
+}
+
+void SkipList::Scan(uint64_t key1, uint64_t key2, std::vector<DataEntry_t> &nodesList) {
+    SkipListNode *node = this->FindGreaterOrEqual(key1);
+    while (node != nullptr && node->key <= key2) {
+        nodesList.emplace_back(node->key, node->value.load(std::memory_order_acquire));
+        node = node->GetNext(0);
+    }
+}
+
+SkipList::Iterator::Iterator(SkipList *skipList) {
+    this->node = skipList->head->GetNext(0);
+}
+
+bool SkipList::Iterator::Valid() const {
+    return this->node != nullptr;
+}
+
+DataEntry_t SkipList::Iterator::GetEntry() const {
+    return std::make_pair(this->node->key, this->node->value.load(std::memory_order_acquire));
+}
+
+void SkipList::Iterator::Next() {
+    this->node = this->node->GetNext(0);
+}
+
+EntryIterator *SkipList::NewIterator() {
+    return new Iterator(this);
+}
+
+bool SkipList::SupportsConcurrentWrites() const {
+    return true;
+}
+
+int SkipList::GetCurrentSize() const {
+    return this->currentSize.load(std::memory_order_relaxed);
+}
+
+void SkipList::Clear() {
+    for (int level = 0; level < SkipList::MAX_HEIGHT; level++) {
+        this->head->next[level].store(nullptr, std::memory_order_relaxed);
+    }
+    this->maxHeight = 1;
+    this->currentSize = 0;
+}
@@ -0,0 +1,90 @@
+#include "TableCache.h"
+#include "Utils.h"
+#include <unistd.h>
+
+TableCache::TableCache(size_t capacity) {
+    this->capacity = capacity;
+    this->numHits = 0;
+    this->numMisses = 0;
+}
+
+TableCache::~TableCache() {
+    for (Entry &entry: this->entries) {
+        close(entry.fd);
+    }
+}
+
+void TableCache::EvictFiles() {
+    auto it = this->entries.end();
+    while (this->entries.size() > this->capacity && it != this->entries.begin()) {
+        it--;
+        if (it->numPins > 0) {
+            continue;
+        }
+        close(it->fd);
+        this->entryOfFile.erase(it->fileNumber);
+        it = this->entries.erase(it);
+    }
+}
+
+int TableCache::Acquire(uint64_t fileNumber, const std::string &fileName) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entryOfFile.find(fileNumber);
+    if (found != this->entryOfFile.end()) {
+        this->numHits++;
+        // Move the file to the front of the list, as the most recently used one.
+        this->entries.splice(this->entries.begin(), this->entries, found->second);
+        found->second->numPins++;
+        return found->second->fd;
+    }
+
+    this->numMisses++;
+    int fd = Utils::OpenFile(fileName);
+    if (fd == -1) {
+        return -1;
+    }
+    this->entries.push_front({fileNumber, fd, 1});
+    this->entryOfFile[fileNumber] = this->entries.begin();
+    this->EvictFiles();
+    return fd;
+}
+
+void TableCache::Release(uint64_t fileNumber, int fd) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entryOfFile.find(fileNumber);
+    if (found == this->entryOfFile.end() || found->second->fd != fd) {
+        // The file was erased while it was pinned.
+        close(fd);
+        return;
+    }
+    found->second->numPins--;
+    this->EvictFiles();
+}
+
+void TableCache::Erase(uint64_t fileNumber) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entryOfFile.find(fileNumber);
+    if (found == this->entryOfFile.end()) {
+        return;
+    }
+    if (found->second->numPins == 0) {
+        close(found->second->fd);
+    }
+    this->entries.erase(found->second);
+    this->entryOfFile.erase(found);
+}
+
+size_t TableCache::GetNumOpenFiles() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.size();
+}
+
+uint64_t TableCache::GetNumHits() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->numHits;
+}
+
+uint64_t TableCache::GetNumMisses() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->numMisses;
+}
@@ -4,7 +4,7 @@
 
 namespace Utils {
 
-    int BinarySearch(std::vector<uint64_t> keys, uint64_t key, int startIndex) {
+    int BinarySearch(const std::vector<uint64_t> &keys, uint64_t key, int startIndex) {
         if (key == keys[startIndex]) {
             return startIndex;
         } else if (key == keys[keys.size() - 1]) {
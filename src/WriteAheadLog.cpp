@@ -0,0 +1,190 @@
+#include "WriteAheadLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include "xxhash.h"
+
+namespace fs = std::filesystem;
+
+const std::string WriteAheadLog::LOG_FILE_PREFIX = "wal-";
+const std::string WriteAheadLog::LOG_FILE_EXTENSION = ".log";
+
+WriteAheadLog::WriteAheadLog(const std::string &dirPath, uint64_t logNumber, WalSyncMode syncMode,
+                             int syncIntervalMs) {
+    this->dirPath = dirPath;
+    this->logNumber = logNumber;
+    this->syncMode = syncMode;
+    this->syncIntervalMs = syncIntervalMs;
+    this->hasUnsyncedWrites = false;
+    this->stopSyncThread = false;
+    this->OpenLogFile();
+    if (syncMode == WalSyncMode::SYNC_INTERVAL) {
+        this->syncThread = std::thread(&WriteAheadLog::RunSyncThread, this);
+    }
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    if (this->syncThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopSyncThread = true;
+        }
+        this->syncCondition.notify_one();
+        this->syncThread.join();
+    }
+    if (this->fd != -1) {
+        fdatasync(this->fd);
+        close(this->fd);
+    }
+}
+
+void WriteAheadLog::OpenLogFile() {
+    std::string filePath = GetLogFilePath(this->dirPath, this->logNumber);
+    this->fd = open(filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (this->fd == -1) {
+        perror("fd");
+    }
+}
+
+void WriteAheadLog::RunSyncThread() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (!this->stopSyncThread) {
+        this->syncCondition.wait_for(lock, std::chrono::milliseconds(this->syncIntervalMs));
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> fileLock(this->fileMutex);
+            if (this->hasUnsyncedWrites.exchange(false) && this->fd != -1) {
+                fdatasync(this->fd);
+            }
+        }
+        lock.lock();
+    }
+}
+
+void WriteAheadLog::EncodeRecord(const DataEntry_t *entries, size_t numEntries, WalRecordType type,
+                                 std::string &record) {
+    static_assert(sizeof(DataEntry_t) == 16, "A key-value pair should be written as two 8-byte integers");
+    size_t offset = record.size();
+    record.resize(offset + RECORD_HEADER_BYTE_SIZE + numEntries * sizeof(DataEntry_t));
+    char *header = &record[offset];
+    uint64_t recordType = type;
+    uint64_t count = numEntries;
+    memcpy(header + sizeof(uint64_t), &recordType, sizeof(uint64_t));
+    memcpy(header + 2 * sizeof(uint64_t), &count, sizeof(uint64_t));
+    memcpy(header + RECORD_HEADER_BYTE_SIZE, entries, numEntries * sizeof(DataEntry_t));
+    // The checksum covers the rest of the header and the key-value pairs.
+    uint64_t checksum = XXH64(header + sizeof(uint64_t),
+                              RECORD_HEADER_BYTE_SIZE - sizeof(uint64_t) + numEntries * sizeof(DataEntry_t), 0);
+    memcpy(header, &checksum, sizeof(uint64_t));
+}
+
+void WriteAheadLog::AddRecord(const DataEntry_t *entries, size_t numEntries, WalRecordType type) {
+    EncodeRecord(entries, numEntries, type, this->pendingRecords);
+}
+
+bool WriteAheadLog::WriteRecords() {
+    bool success = this->fd != -1;
+    size_t bytesWritten = 0;
+    while (success && bytesWritten < this->pendingRecords.size()) {
+        ssize_t result = write(this->fd, this->pendingRecords.data() + bytesWritten,
+                               this->pendingRecords.size() - bytesWritten);
+        if (result == -1) {
+            perror("write");
+            success = false;
+        } else {
+            bytesWritten += result;
+        }
+    }
+    if (success && this->syncMode == WalSyncMode::SYNC_PER_WRITE && fdatasync(this->fd) == -1) {
+        perror("fdatasync");
+        success = false;
+    }
+    if (this->syncMode == WalSyncMode::SYNC_INTERVAL) {
+        this->hasUnsyncedWrites = true;
+    }
+    // The memory of the records is kept for the next ones.
+    this->pendingRecords.clear();
+    return success;
+}
+
+void WriteAheadLog::Roll(uint64_t newLogNumber) {
+    std::lock_guard<std::mutex> fileLock(this->fileMutex);
+    if (this->fd != -1) {
+        fdatasync(this->fd);
+        close(this->fd);
+    }
+    this->hasUnsyncedWrites = false;
+    this->logNumber = newLogNumber;
+    this->OpenLogFile();
+}
+
+uint64_t WriteAheadLog::GetLogNumber() const {
+    return this->logNumber;
+}
+
+std::string WriteAheadLog::GetLogFilePath(const std::string &dirPath, uint64_t logNumber) {
+    return Utils::EnsureDirSlash(dirPath) + LOG_FILE_PREFIX + std::to_string(logNumber) + LOG_FILE_EXTENSION;
+}
+
+std::vector<uint64_t> WriteAheadLog::GetLogNumbers(const std::string &dirPath) {
+    std::vector<uint64_t> logNumbers;
+    for (const auto &entry: fs::directory_iterator(dirPath)) {
+        std::string fileNameStem = entry.path().stem().string();
+        if (fs::is_regular_file(entry) && entry.path().extension() == LOG_FILE_EXTENSION &&
+            fileNameStem.rfind(LOG_FILE_PREFIX, 0) == 0) {
+            logNumbers.push_back(std::stoull(fileNameStem.substr(LOG_FILE_PREFIX.size())));
+        }
+    }
+    std::sort(logNumbers.begin(), logNumbers.end());
+    return logNumbers;
+}
+
+bool WriteAheadLog::ReadLogFile(const std::string &filePath, std::vector<WalRecord> &records) {
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if (!file) {
+        std::cerr << "Could not open write-ahead log " << filePath << std::endl;
+        return false;
+    }
+
+    uint64_t fileSize = fs::file_size(filePath);
+    uint64_t header[3];
+    std::vector<DataEntry_t> recordEntries;
+    while (file.read(reinterpret_cast<char *>(header), RECORD_HEADER_BYTE_SIZE)) {
+        uint64_t checksum = header[0];
+        uint64_t recordType = header[1];
+        uint64_t numEntries = header[2];
+        // A huge count can only come from a corrupted header, don't try to allocate for it.
+        if (numEntries > fileSize / sizeof(DataEntry_t)) {
+            break;
+        }
+        recordEntries.resize(numEntries);
+        if (!file.read(reinterpret_cast<char *>(recordEntries.data()), numEntries * sizeof(DataEntry_t))) {
+            break;
+        }
+
+        XXH64_state_t *state = XXH64_createState();
+        XXH64_reset(state, 0);
+        XXH64_update(state, &header[1], RECORD_HEADER_BYTE_SIZE - sizeof(uint64_t));
+        XXH64_update(state, recordEntries.data(), numEntries * sizeof(DataEntry_t));
+        bool isValid = XXH64_digest(state) == checksum && recordType <= WalRecordType::RANGE_DELETION_RECORD;
+        XXH64_freeState(state);
+        if (!isValid) {
+            break;
+        }
+        records.push_back({(WalRecordType) recordType, recordEntries});
+    }
+    return true;
+}
+
+void WriteAheadLog::RemoveLogFilesBefore(const std::string &dirPath, uint64_t minLogNumber) {
+    for (uint64_t logNumber: GetLogNumbers(dirPath)) {
+        if (logNumber < minLogNumber) {
+            fs::remove(GetLogFilePath(dirPath, logNumber));
+        }
+    }
+}
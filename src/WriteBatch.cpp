@@ -0,0 +1,52 @@
+#include "WriteBatch.h"
+#include <algorithm>
+
+void WriteBatch::Put(uint64_t key, uint64_t value) {
+    this->writes.push_back({WriteType::PUT, key, value});
+}
+
+void WriteBatch::Update(uint64_t key, uint64_t newValue) {
+    this->writes.push_back({WriteType::UPDATE, key, newValue});
+}
+
+void WriteBatch::Delete(uint64_t key) {
+    this->writes.push_back({WriteType::DELETE, key, Utils::DELETED_KEY_VALUE});
+}
+
+void WriteBatch::Clear() {
+    this->writes.clear();
+}
+
+size_t WriteBatch::GetSize() const {
+    return this->writes.size();
+}
+
+const std::vector<WriteBatch::Write> &WriteBatch::GetWrites() const {
+    return this->writes;
+}
+
+std::vector<DataEntry_t> WriteBatch::GetSortedEntries(bool includeUpdatesAndDeletes) const {
+    std::vector<DataEntry_t> entries;
+    entries.reserve(this->writes.size());
+    for (const Write &write: this->writes) {
+        if (write.type == WriteType::PUT || includeUpdatesAndDeletes) {
+            entries.emplace_back(write.key, write.value);
+        }
+    }
+
+    // A stable sort keeps the writes of the same key in the order they were added,
+    // so the last one of them is the one that should win.
+    std::stable_sort(entries.begin(), entries.end(), [](const DataEntry_t &a, const DataEntry_t &b) {
+        return a.first < b.first;
+    });
+    size_t numUniqueKeys = 0;
+    for (const DataEntry_t &entry: entries) {
+        if (numUniqueKeys > 0 && entries[numUniqueKeys - 1].first == entry.first) {
+            entries[numUniqueKeys - 1] = entry;
+        } else {
+            entries[numUniqueKeys++] = entry;
+        }
+    }
+    entries.resize(numUniqueKeys);
+    return entries;
+}
@@ -0,0 +1,76 @@
+#include "WriteBufferManager.h"
+#include "Db.h"
+#include <algorithm>
+
+WriteBufferManager::WriteBufferManager(size_t bufferSize) {
+    this->bufferSize = bufferSize;
+    this->memoryUsage = 0;
+    this->dbs = {};
+}
+
+void WriteBufferManager::RegisterDb(Db *db) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->dbs.push_back(db);
+}
+
+void WriteBufferManager::UnregisterDb(Db *db) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->dbs.erase(std::remove(this->dbs.begin(), this->dbs.end(), db), this->dbs.end());
+    // The writers that picked the Db before it was removed still use it.
+    this->flushCondition.wait(lock, [this, db] {
+        return std::find(this->flushingDbs.begin(), this->flushingDbs.end(), db) == this->flushingDbs.end();
+    });
+}
+
+void WriteBufferManager::ReserveMemory(size_t bytes) {
+    this->memoryUsage.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void WriteBufferManager::FreeMemory(size_t bytes) {
+    this->memoryUsage.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool WriteBufferManager::ShouldFlush() const {
+    return this->GetMemoryUsage() > this->bufferSize;
+}
+
+void WriteBufferManager::FlushLargestMemtable() {
+    Db *largestDb = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // The writers that went over the budget at the same time each pick a different Db, and the
+        // ones coming after the memory is back within the budget stop here.
+        if (!this->ShouldFlush()) {
+            return;
+        }
+        size_t largestMemoryUsage = 0;
+        for (Db *db: this->dbs) {
+            size_t dbMemoryUsage = db->GetActiveMemtableMemoryUsage();
+            if (dbMemoryUsage > largestMemoryUsage &&
+                std::find(this->flushingDbs.begin(), this->flushingDbs.end(), db) == this->flushingDbs.end()) {
+                largestDb = db;
+                largestMemoryUsage = dbMemoryUsage;
+            }
+        }
+        if (largestDb == nullptr) {
+            return;
+        }
+        this->flushingDbs.push_back(largestDb);
+    }
+
+    largestDb->ReleaseMemtable();
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->flushingDbs.erase(std::find(this->flushingDbs.begin(), this->flushingDbs.end(), largestDb));
+    }
+    this->flushCondition.notify_all();
+}
+
+size_t WriteBufferManager::GetMemoryUsage() const {
+    return this->memoryUsage.load(std::memory_order_relaxed);
+}
+
+size_t WriteBufferManager::GetBufferSize() const {
+    return this->bufferSize;
+}
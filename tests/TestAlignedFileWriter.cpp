@@ -0,0 +1,84 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "TestBase.h"
+#include "AlignedFileWriter.h"
+
+class TestAlignedFileWriter : public TestBase {
+    /**
+     * Whether the file holds exactly the given bytes.
+     */
+    static bool FileEquals(const std::string &fileName, const std::vector<uint8_t> &expected) {
+        std::ifstream file(fileName, std::ios::in | std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return bytes == expected;
+    }
+
+    /**
+     * Write given bytes at given offset of both the file and the expected bytes.
+     */
+    static void Write(AlignedFileWriter &writer, std::vector<uint8_t> &expected, uint64_t offset,
+                      uint64_t numBytes, uint8_t seed) {
+        std::vector<uint8_t> bytes(numBytes);
+        for (uint64_t i = 0; i < numBytes; i++) {
+            bytes[i] = (uint8_t) (seed + i * 7);
+        }
+        if (expected.size() < offset + numBytes) {
+            expected.resize(offset + numBytes, 0);
+        }
+        std::copy(bytes.begin(), bytes.end(), expected.begin() + (long) offset);
+        writer.Seek(offset);
+        writer.Write(bytes.data(), numBytes);
+    }
+
+    /**
+     * Expect the writes to end up in the file as they were made, whether they are whole pages or
+     * not, go back to pages written out already, or span more than the buffer, with and without O_DIRECT.
+     */
+    static bool TestWrites() {
+        bool result = true;
+        const std::string fileName = "aligned_file_writer_test.bin";
+        const uint64_t pageSize = AlignedFileWriter::ALIGNMENT;
+        for (bool useDirectIO: {false, true}) {
+            std::vector<uint8_t> expected;
+            AlignedFileWriter writer(fileName, useDirectIO, 64 * pageSize, 4);
+            result &= writer.IsGood();
+
+            // Contiguous writes, of whole and partial pages, filling the buffer more than once
+            Write(writer, expected, pageSize, 3 * pageSize, 1);
+            Write(writer, expected, 4 * pageSize, 100, 2);
+            Write(writer, expected, 4 * pageSize + 100, 9 * pageSize, 3);
+            result &= writer.GetPosition() == 13 * pageSize + 100;
+
+            // Back to pages written out already, partly, then past the end with a gap
+            Write(writer, expected, 2 * pageSize + 10, 20, 4);
+            Write(writer, expected, 20 * pageSize + 5, 3, 5);
+            Write(writer, expected, 8, 16, 6);
+            Write(writer, expected, 13 * pageSize + 50, 2 * pageSize, 7);
+
+            result &= writer.Close();
+            result &= writer.GetNumWriteCalls() > 0 && writer.GetNumBytesWritten() % pageSize == 0;
+            // The file ends at the last byte written, even though it was allocated further up front.
+            result &= std::filesystem::file_size(fileName) == expected.size();
+            result &= FileEquals(fileName, expected);
+        }
+
+        // Creating a file empties it
+        {
+            AlignedFileWriter writer(fileName);
+            result &= writer.Close();
+        }
+        result &= std::filesystem::file_size(fileName) == 0;
+        std::filesystem::remove(fileName);
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestWrites, "TestAlignedFileWriter::TestWrites");
+        return allTestPassed;
+    }
+};
@@ -0,0 +1,148 @@
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "TestBase.h"
+#include "AsyncReader.h"
+
+class TestAsyncReader : public TestBase {
+    static const uint64_t NUM_WORDS = 64 * 512;
+
+    /**
+     * Write a file holding its word indexes, and open it.
+     */
+    static int CreateFile(const std::string &fileName) {
+        std::vector<uint64_t> words;
+        for (uint64_t i = 0; i < NUM_WORDS; i++) {
+            words.push_back(i);
+        }
+        std::ofstream file(fileName, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char *>(words.data()), (long) (words.size() * sizeof(uint64_t)));
+        file.close();
+        return open(fileName.c_str(), O_RDONLY);
+    }
+
+    /**
+     * Expect both backends to read the parts of a file submitted together, with more of them
+     * than the queue depth, and to read short at the end of the file.
+     */
+    static bool TestReads() {
+        int fd = CreateFile("async_reader_test.bin");
+        bool result = fd != -1;
+        for (AsyncReadBackend backend: {AsyncReadBackend::IO_URING_BACKEND, AsyncReadBackend::THREAD_POOL_BACKEND}) {
+            AsyncReader asyncReader(4, backend);
+            if (backend == AsyncReadBackend::THREAD_POOL_BACKEND) {
+                result &= asyncReader.GetBackend() == AsyncReadBackend::THREAD_POOL_BACKEND;
+            }
+
+            // Read every other page, backwards.
+            uint64_t numRequests = 20;
+            std::vector<AsyncReadRequest> requests(numRequests);
+            std::vector<uint64_t> buffer(numRequests * 512);
+            for (uint64_t i = 0; i < numRequests; i++) {
+                requests[i].fd = fd;
+                requests[i].byteOffset = (NUM_WORDS - (i * 2 + 1) * 512) * sizeof(uint64_t);
+                requests[i].numBytes = 512 * sizeof(uint64_t);
+                requests[i].buffer = &buffer[i * 512];
+                asyncReader.Submit(&requests[i]);
+            }
+            for (uint64_t i = 0; i < numRequests; i++) {
+                result &= asyncReader.Wait(&requests[i]) == 512 * sizeof(uint64_t);
+                result &= buffer[i * 512] == NUM_WORDS - (i * 2 + 1) * 512 && buffer[i * 512 + 511] == buffer[i * 512] + 511;
+            }
+
+            // A read past the end of the file is cut short.
+            AsyncReadRequest request;
+            std::vector<uint64_t> words(512);
+            request.fd = fd;
+            request.byteOffset = (NUM_WORDS - 10) * sizeof(uint64_t);
+            request.numBytes = 512 * sizeof(uint64_t);
+            request.buffer = words.data();
+            asyncReader.Submit(&request);
+            asyncReader.WaitAll();
+            result &= request.isDone && request.bytesRead == 10 * sizeof(uint64_t) && words[9] == NUM_WORDS - 1;
+        }
+        close(fd);
+        std::filesystem::remove("async_reader_test.bin");
+        return result;
+    }
+
+    /**
+     * Expect the prefetcher to hand out the part of the file it read ahead only if it is the one
+     * asked for, even once the file descriptor it was read with is closed.
+     */
+    static bool TestPagePrefetcher() {
+        int fd = CreateFile("async_reader_test.bin");
+        bool result = fd != -1;
+        AsyncReader asyncReader;
+        PagePrefetcher prefetcher(&asyncReader);
+        const uint64_t *words = nullptr;
+        prefetcher.Prefetch(fd, 4096, 8192);
+        close(fd);
+        result &= prefetcher.Take(4096, 8192, words) == 8192;
+        result &= words != nullptr && words[0] == 512 && words[1023] == 1535;
+
+        // Nothing is read ahead anymore, and another part is not handed out.
+        result &= prefetcher.Take(4096, 8192, words) == -1;
+        fd = open("async_reader_test.bin", O_RDONLY);
+        prefetcher.Prefetch(fd, 0, 4096);
+        result &= prefetcher.Take(4096, 4096, words) == -1;
+        close(fd);
+        std::filesystem::remove("async_reader_test.bin");
+        return result;
+    }
+
+    /**
+     * Expect the reader to fall back to the thread pool once io_uring fails, making the reads the
+     * kernel did not take yet instead of waiting for them forever.
+     */
+    static bool TestIoUringFailure() {
+        int fd = CreateFile("async_reader_test.bin");
+        bool result = fd != -1;
+        AsyncReader asyncReader(4);
+        if (asyncReader.GetBackend() == AsyncReadBackend::IO_URING_BACKEND) {
+            // Replace the io_uring instance with a file io_uring_enter does not take.
+            int nullFd = open("/dev/null", O_RDONLY);
+            for (const auto &entry: std::filesystem::directory_iterator("/proc/self/fd")) {
+                std::error_code error;
+                std::string target = std::filesystem::read_symlink(entry.path(), error).string();
+                if (target.find("io_uring") != std::string::npos) {
+                    dup2(nullFd, std::stoi(entry.path().filename().string()));
+                }
+            }
+            close(nullFd);
+        }
+
+        // The reads are queued, but not sent to the kernel until they are waited for.
+        uint64_t numRequests = 3;
+        std::vector<AsyncReadRequest> requests(numRequests);
+        std::vector<uint64_t> buffer(numRequests * 512);
+        for (uint64_t i = 0; i < numRequests; i++) {
+            requests[i].fd = fd;
+            requests[i].byteOffset = i * 512 * sizeof(uint64_t);
+            requests[i].numBytes = 512 * sizeof(uint64_t);
+            requests[i].buffer = &buffer[i * 512];
+            asyncReader.Submit(&requests[i]);
+        }
+        result &= asyncReader.Wait(&requests[0]) == 512 * sizeof(uint64_t);
+        asyncReader.WaitAll();
+        result &= asyncReader.GetBackend() == AsyncReadBackend::THREAD_POOL_BACKEND;
+        for (uint64_t i = 0; i < numRequests; i++) {
+            result &= requests[i].isDone && requests[i].bytesRead == 512 * sizeof(uint64_t);
+            result &= buffer[i * 512] == i * 512 && buffer[i * 512 + 511] == i * 512 + 511;
+        }
+        close(fd);
+        std::filesystem::remove("async_reader_test.bin");
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestReads, "TestAsyncReader::TestReads");
+        allTestPassed &= assertTrue(TestPagePrefetcher, "TestAsyncReader::TestPagePrefetcher");
+        allTestPassed &= assertTrue(TestIoUringFailure, "TestAsyncReader::TestIoUringFailure");
+        return allTestPassed;
+    }
+};
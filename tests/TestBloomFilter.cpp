@@ -81,12 +81,26 @@ class TestBloomFilter : public TestBase {
         return result;
     }
 
+    /**
+     * Expect the bit array to round up to whole elements, so that it holds every bit the keys take.
+     */
+    static bool TestFilterArraySize() {
+        bool result = true;
+        for (int keys: {1, 64, 300, 6401}) {
+            auto *bloomFilter = new BloomFilter(bitsPerEntry, keys);
+            result &= bloomFilter->GetFilterArraySize() == (uint64_t) (bitsPerEntry * keys + 63) / 64;
+            delete bloomFilter;
+        }
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool allTestPassed = true;
         allTestPassed &= assertTrue(TestGetIndexInBitArray, "TestBloomFilter::TestGetIndexInBitArray");
         allTestPassed &= assertTrue(TestInsertKey, "TestBloomFilter::TestInsertKey");
         allTestPassed &= assertTrue(TestKeyProbablyExists, "TestBloomFilter::TestKeyProbablyExists");
+        allTestPassed &= assertTrue(TestFilterArraySize, "TestBloomFilter::TestFilterArraySize");
         return allTestPassed;
     }
 };
@@ -0,0 +1,186 @@
+
+#include <set>
+#include "TestBase.h"
+#include "BufferPool.h"
+
+class TestBufferPool : public TestBase {
+
+    static bool TestPinWithoutCopy() {
+        bool result = true;
+        for (EvictionPolicyType evictionPolicy: {EvictionPolicyType::LRU_t, EvictionPolicyType::CLOCK_t}) {
+            // Set up
+            auto bufferPool = new BufferPool(2, 4, evictionPolicy);
+
+            // Test
+            result &= !bufferPool->Pin("test1").IsValid();
+            const uint64_t *insertedData = bufferPool->Insert("test1", {1, 2, 3}).Data();
+            PageHandle page1 = bufferPool->Pin("test1");
+            PageHandle page2 = bufferPool->Pin("test1");
+            result &= page1.IsValid() && page1.Size() == 3 && page1[0] == 1 && page1[2] == 3;
+            // Both handles read the page where it is in the buffer pool.
+            result &= page1.Data() == insertedData && page2.Data() == insertedData;
+            result &= bufferPool->Get("test1") == std::vector<uint64_t>({1, 2, 3});
+
+            // A moved handle keeps the page pinned.
+            PageHandle page3 = std::move(page2);
+            result &= !page2.IsValid() && page3.Data() == insertedData;
+
+            // A page read outside of the buffer pool is owned by its handle.
+            PageHandle ownedPage(std::vector<uint64_t>{4, 5});
+            result &= ownedPage.Size() == 2 && ownedPage[1] == 5;
+
+            // Clean up
+            page1 = PageHandle();
+            page3 = PageHandle();
+            delete bufferPool;
+        }
+        return result;
+    }
+
+    static bool TestPinnedPagesAreNotEvicted() {
+        bool result = true;
+        for (EvictionPolicyType evictionPolicy: {EvictionPolicyType::LRU_t, EvictionPolicyType::CLOCK_t}) {
+            // Set up
+            auto bufferPool = new BufferPool(2, 4, evictionPolicy);
+            PageHandle pinnedPage = bufferPool->Insert("test0", {0});
+            bufferPool->Insert("test1", {1});
+
+            // Test
+            // Fill the buffer pool way over its size, which evicts pages other than the pinned one.
+            // Pin a page as it is inserted as well, since the policies evict either the oldest or the newest pages.
+            PageHandle pinnedNewPage;
+            int numPagesInBufferPool = 0;
+            for (uint64_t i = 2; i < 32; i++) {
+                PageHandle newPage = bufferPool->Insert("test" + std::to_string(i), {i});
+                if (i == 16) {
+                    pinnedNewPage = std::move(newPage);
+                }
+            }
+            for (uint64_t i = 1; i < 32; i++) {
+                numPagesInBufferPool += !bufferPool->Get("test" + std::to_string(i)).empty();
+            }
+            result &= numPagesInBufferPool < 31;
+            PageHandle page = bufferPool->Pin("test0");
+            result &= page.Data() == pinnedPage.Data() && page[0] == 0;
+            result &= bufferPool->Pin("test16").Data() == pinnedNewPage.Data() && pinnedNewPage[0] == 16;
+
+            // Clean up
+            page = PageHandle();
+            pinnedPage = PageHandle();
+            pinnedNewPage = PageHandle();
+            delete bufferPool;
+        }
+        return result;
+    }
+
+    static bool TestInsertIntoFrame() {
+        // Set up
+        auto bufferPool = new BufferPool(2, 4, EvictionPolicyType::LRU_t);
+
+        // Test
+        bool result = true;
+        uint64_t *frame = bufferPool->AcquireFrame();
+        result &= frame != nullptr && (uintptr_t) frame % FrameArena::ALIGNMENT == 0;
+        for (uint64_t i = 0; i < 5; i++) {
+            frame[i] = i;
+        }
+        // The page is read where it is in the frame, past what comes before its data.
+        PageHandle page = bufferPool->Insert("test1", frame, frame + 2, 3);
+        result &= page.Data() == frame + 2 && page.Size() == 3;
+        result &= bufferPool->Get("test1") == std::vector<uint64_t>({2, 3, 4});
+
+        // Clean up
+        page = PageHandle();
+        delete bufferPool;
+        return result;
+    }
+
+    static bool TestFramesAreReused() {
+        bool result = true;
+        for (EvictionPolicyType evictionPolicy: {EvictionPolicyType::LRU_t, EvictionPolicyType::CLOCK_t}) {
+            // Set up
+            auto bufferPool = new BufferPool(2, 4, evictionPolicy);
+
+            // Test
+            // The pages evicted give their frames, and the Page objects of the frames, back to the new ones.
+            std::set<uint64_t *> frames;
+            for (uint64_t i = 0; i < 64; i++) {
+                uint64_t *frame = bufferPool->AcquireFrame();
+                result &= frame != nullptr;
+                if (frame == nullptr) {
+                    break;
+                }
+                frames.insert(frame);
+                frame[0] = i;
+                bufferPool->Insert("test" + std::to_string(i), frame, frame, 1);
+            }
+            result &= frames.size() <= 4;
+            result &= bufferPool->Get("test63") == std::vector<uint64_t>({63});
+            for (uint64_t i = 0; i < 64; i++) {
+                PageHandle page = bufferPool->Pin("test" + std::to_string(i));
+                result &= !page.IsValid() || (page.Size() == 1 && page[0] == i);
+            }
+
+            // Clean up
+            delete bufferPool;
+        }
+        return result;
+    }
+
+    static bool TestAcquireFrameWithEveryPagePinned() {
+        // Set up
+        auto bufferPool = new BufferPool(2, 4, EvictionPolicyType::LRU_t);
+        std::vector<PageHandle> pages;
+        uint64_t *frame = bufferPool->AcquireFrame();
+        while (frame != nullptr && pages.size() < 4) {
+            pages.push_back(bufferPool->Insert("test" + std::to_string(pages.size()), frame, frame, 0));
+            frame = bufferPool->AcquireFrame();
+        }
+
+        // Test
+        bool result = true;
+        // The frames are all held by pinned pages, which are not evicted to free one.
+        result &= pages.size() == 4 && frame == nullptr;
+        pages.pop_back();
+        frame = bufferPool->AcquireFrame();
+        result &= frame != nullptr;
+
+        // Clean up
+        bufferPool->ReleaseFrame(frame);
+        pages.clear();
+        delete bufferPool;
+        return result;
+    }
+
+    static bool TestHugePageFrames() {
+        // Set up
+        // Huge pages are used if some are reserved, and transparent huge pages otherwise.
+        auto bufferPool = new BufferPool(2, 4, EvictionPolicyType::LRU_t, BufferPool::DEFAULT_FRAME_SIZE, true);
+
+        // Test
+        bool result = true;
+        uint64_t *frame = bufferPool->AcquireFrame();
+        result &= frame != nullptr && (uintptr_t) frame % FrameArena::ALIGNMENT == 0;
+        frame[BufferPool::DEFAULT_FRAME_SIZE / sizeof(uint64_t) - 1] = 1;
+        PageHandle page = bufferPool->Insert("test1", frame, frame, BufferPool::DEFAULT_FRAME_SIZE / sizeof(uint64_t));
+        result &= page[page.Size() - 1] == 1;
+
+        // Clean up
+        page = PageHandle();
+        delete bufferPool;
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestPinWithoutCopy, "TestBufferPool::TestPinWithoutCopy");
+        allTestPassed &= assertTrue(TestPinnedPagesAreNotEvicted, "TestBufferPool::TestPinnedPagesAreNotEvicted");
+        allTestPassed &= assertTrue(TestInsertIntoFrame, "TestBufferPool::TestInsertIntoFrame");
+        allTestPassed &= assertTrue(TestFramesAreReused, "TestBufferPool::TestFramesAreReused");
+        allTestPassed &= assertTrue(TestAcquireFrameWithEveryPagePinned,
+                                    "TestBufferPool::TestAcquireFrameWithEveryPagePinned");
+        allTestPassed &= assertTrue(TestHugePageFrames, "TestBufferPool::TestHugePageFrames");
+        return allTestPassed;
+    }
+};
@@ -53,12 +53,34 @@ class TestClock : public TestBase {
         return result;
     }
 
+    static bool TestGetPageToEvictSkipsPinnedPages() {
+        // Set up
+        auto page1 = new Page("test1", {1});
+        auto page2 = new Page("test2", {1});
+        auto evictPolicy = new Clock();
+        evictPolicy->Insert(page1);
+        evictPolicy->Insert(page2);
+        page1->Pin();
+        page2->Pin();
+
+        // Test
+        bool result = true;
+        // Nothing is evicted when every page is pinned.
+        result &= evictPolicy->GetPageToEvict() == nullptr;
+        page2->Unpin();
+        result &= page2 == evictPolicy->GetPageToEvict();
+        page1->Unpin();
+        result &= page1 == evictPolicy->GetPageToEvict();
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool allTestPassed = true;
         allTestPassed &= assertTrue(TestInsert, "TestClock::TestInsert");
         allTestPassed &= assertTrue(TestUpdatePageAccessStatus, "TestClock::TestUpdatePageAccessStatus");
         allTestPassed &= assertTrue(TestGetPageToEvict, "TestClock::TestGetPageToEvict");
+        allTestPassed &= assertTrue(TestGetPageToEvictSkipsPinnedPages, "TestClock::TestGetPageToEvictSkipsPinnedPages");
         return allTestPassed;
     }
 };
@@ -1,6 +1,11 @@
 #include <filesystem>
+#include <atomic>
 #include <algorithm>
 #include <cmath>
+#include <thread>
+#include <future>
+#include <tuple>
+#include <fstream>
 #include "Db.h"
 #include "TestBase.h"
 
@@ -23,6 +28,52 @@ class TestDb : public TestBase {
         return result;
     }
 
+    static bool TestOpenLegacyBTreeFile() {
+        // A B-Tree file of the layout with the metadata on the first page, and no footer
+        std::filesystem::create_directories("test_dir");
+        std::vector<uint64_t> pages(2 * SST::PAGE_SIZE / sizeof(uint64_t), 0);
+        pages[0] = 1;
+        pages[1] = 1;
+        uint64_t *leaf = pages.data() + SST::PAGE_SIZE / sizeof(uint64_t);
+        leaf[0] = 1;
+        leaf[1] = 10;
+        std::ofstream file("test_dir/0.sst", std::ios::binary);
+        file.write((const char *) pages.data(), (std::streamsize) (pages.size() * sizeof(uint64_t)));
+        file.close();
+
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        auto db = new Db(10, SearchType::B_TREE_SEARCH, bufferPool);
+        bool result = !db->Open("test_dir");
+
+        // Clean up
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
+    static bool TestOpenHeaderlessFile() {
+        // A binary search file whose pages have no header, ending with a footer without a format version
+        std::filesystem::create_directories("test_dir");
+        size_t pageNumWords = SST::PAGE_SIZE / sizeof(uint64_t);
+        std::vector<uint64_t> pages(2 * pageNumWords, Utils::INVALID_VALUE);
+        pages[0] = 1;
+        pages[1] = 10;
+        uint64_t footer[] = {1, 1, 1, SST::PAGE_SIZE, 0x535354464F4F5452};
+        std::copy(footer, footer + 5, pages.end() - 5);
+        std::ofstream file("test_dir/0.sst", std::ios::binary);
+        file.write((const char *) pages.data(), (std::streamsize) (pages.size() * sizeof(uint64_t)));
+        file.close();
+
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        auto db = new Db(10, SearchType::BINARY_SEARCH, bufferPool);
+        bool result = !db->Open("test_dir");
+
+        // Clean up
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
     static bool TestPut() {
         int memtableSize = 2;
         auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
@@ -141,15 +192,846 @@ class TestDb : public TestBase {
         return result;
     }
 
+    static bool TestConcurrentPutWithSkipList() {
+        // Small memtable so that writers flush it many times while others are writing
+        int memtableSize = 1000;
+        int numThreads = 4;
+        uint64_t numKeysPerThread = 5000;
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        DbOptions options;
+        options.memtableType = MemtableType::SKIP_LIST;
+        auto db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, nullptr, options);
+        db->Open("test_dir");
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([=]() {
+                for (uint64_t i = 0; i < numKeysPerThread; i++) {
+                    uint64_t key = i * numThreads + t;
+                    db->Put(key, key * 10);
+                    // Readers run alongside the writers
+                    db->Get(key);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        bool result = true;
+        for (uint64_t key = 0; key < numThreads * numKeysPerThread; key++) {
+            result &= db->Get(key) == key * 10;
+        }
+
+        // Clean up
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
+    static bool TestBackgroundFlush() {
+        int memtableSize = 100;
+        uint64_t numKeys = 2000;
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        DbOptions options;
+        options.maxImmutableMemtables = 2;
+        auto db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, nullptr, options);
+        db->Open("test_dir");
+
+        bool result = true;
+        for (uint64_t key = 1; key <= numKeys; key++) {
+            db->Put(key, key * 10);
+            // Keys in a memtable that is being flushed should still be found
+            result &= db->Get(key) == key * 10;
+        }
+        std::vector<DataEntry_t> scanResult;
+        db->Scan(1, numKeys, scanResult);
+        result &= scanResult.size() == numKeys;
+
+        // Close waits for the queued memtables to be flushed
+        db->Close();
+        db->Open("test_dir");
+        for (uint64_t key = 1; key <= numKeys; key++) {
+            result &= db->Get(key) == key * 10;
+        }
+
+        // Clean up
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
+    static bool TestScanDuringBackgroundFlush() {
+        int memtableSize = 100;
+        uint64_t numKeys = 150;
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        DbOptions options;
+        options.maxImmutableMemtables = 2;
+        auto db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, nullptr, options);
+        db->Open("test_dir");
+
+        // Hold the flush thread once the first memtable is in storage, while it is still queued.
+        std::promise<void> flushed;
+        std::promise<void> scanned;
+        std::shared_future<void> scannedFuture = scanned.get_future().share();
+        bool isFirstFlush = true;
+        db->SetFlushedMemtableCallback([&] {
+            if (isFirstFlush) {
+                isFirstFlush = false;
+                flushed.set_value();
+                scannedFuture.wait();
+            }
+        });
+
+        bool result = true;
+        for (uint64_t key = 1; key <= numKeys; key++) {
+            db->Put(key, key * 10);
+        }
+        flushed.get_future().wait();
+        // The pairs of the flushed memtable are only found once, in storage.
+        std::vector<DataEntry_t> scanResult;
+        db->Scan(1, numKeys, scanResult);
+        result &= scanResult.size() == numKeys;
+        scanned.set_value();
+
+        // Clean up
+        db->Close();
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
+    static bool TestWriteBatch() {
+        // The batch should leave the db in the same state as applying its writes one by one
+        uint64_t numKeys = 1000;
+        bool result = true;
+        for (bool useLSMTree: {false, true}) {
+            // Without the LSM-Tree the memtable is flushed a few times during the batch
+            int memtableSize = useLSMTree ? (int) numKeys * 2 : 300;
+            Db *dbs[2];
+            std::string dirs[2] = {"test_dir", "test_dir_batch"};
+            for (int i = 0; i < 2; i++) {
+                auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+                auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+                dbs[i] = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, lsmTree);
+                dbs[i]->Open(dirs[i]);
+            }
+
+            WriteBatch batch;
+            for (uint64_t i = 1; i <= numKeys; i++) {
+                // Write the keys out of order, and some of them more than once
+                uint64_t key = (i * 7919) % numKeys + 1;
+                dbs[0]->Put(key, i);
+                batch.Put(key, i);
+                if (i % 3 == 0) {
+                    dbs[0]->Put(key / 2 + 1, i * 10);
+                    batch.Put(key / 2 + 1, i * 10);
+                }
+                if (useLSMTree && i % 7 == 0) {
+                    dbs[0]->Delete(key);
+                    batch.Delete(key);
+                }
+            }
+            dbs[1]->Write(batch);
+
+            for (uint64_t key = 1; key <= numKeys; key++) {
+                result &= dbs[0]->Get(key) == dbs[1]->Get(key);
+            }
+            result &= dbs[1]->Get(1) != Utils::INVALID_VALUE;
+
+            // Clean up
+            for (int i = 0; i < 2; i++) {
+                delete dbs[i];
+                std::filesystem::remove_all(dirs[i]);
+            }
+        }
+        return result;
+    }
+
+    static bool TestLeafFormats() {
+        // The files hold several pages of leaves, and are compacted with the LSM-Tree
+        int memtableSize = 5000;
+        uint64_t numKeys = 20000;
+        bool result = true;
+        for (auto [leafFormat, useLSMTree]: {std::make_pair(LeafFormat::COMPRESSED_LEAVES, false),
+                                             std::make_pair(LeafFormat::COMPRESSED_LEAVES, true),
+                                             std::make_pair(LeafFormat::COLUMNAR_LEAVES, false),
+                                             std::make_pair(LeafFormat::COLUMNAR_LEAVES, true)}) {
+            DbOptions options;
+            options.leafFormat = leafFormat;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+            auto db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, lsmTree, options);
+            db->Open("test_dir");
+            for (uint64_t key = 1; key <= numKeys; key++) {
+                db->Put(key * 3, key % 100);
+                if (useLSMTree && key % 10 == 0) {
+                    db->Delete((key - 5) * 3);
+                }
+            }
+            db->Close();
+            if (!useLSMTree) {
+                // Consecutive keys and small values fit in several times fewer compressed pages
+                uint64_t filesSize = 0;
+                for (const auto &entry: std::filesystem::directory_iterator("test_dir")) {
+                    filesSize += std::filesystem::file_size(entry);
+                }
+                result &= leafFormat != LeafFormat::COMPRESSED_LEAVES ||
+                          filesSize < numKeys * SST::KV_PAIR_BYTE_SIZE / 2;
+
+                // The leaf format is read from the files when they are opened again
+                db->Open("test_dir");
+            }
+
+            bool hasDeletes = useLSMTree;
+            auto isDeleted = [hasDeletes](uint64_t key) { return hasDeletes && key % 10 == 5; };
+            for (uint64_t key = 1; key <= numKeys; key++) {
+                uint64_t expectedValue = isDeleted(key) ? Utils::INVALID_VALUE : key % 100;
+                result &= db->Get(key * 3) == expectedValue;
+                result &= db->Get(key * 3 + 1) == Utils::INVALID_VALUE;
+            }
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(3, numKeys * 3, scanResult);
+            result &= scanResult.size() == (useLSMTree ? numKeys - numKeys / 10 : numKeys);
+
+            // Clean up
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static bool TestLearnedIndex() {
+        // The files hold hundreds of leaves, with keys far less dense in some ranges than in others
+        int memtableSize = 50000;
+        uint64_t numKeys = 100000;
+        auto getKey = [](uint64_t i) { return i < 60000 ? i * 2 : 120000 + (i - 60000) * 1000 + i % 7; };
+        bool result = true;
+        for (auto [leafFormat, useLSMTree]: {std::make_pair(LeafFormat::RAW_LEAVES, false),
+                                             std::make_pair(LeafFormat::RAW_LEAVES, true),
+                                             std::make_pair(LeafFormat::COMPRESSED_LEAVES, false)}) {
+            DbOptions options;
+            options.leafFormat = leafFormat;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+            auto db = new Db(memtableSize, SearchType::LEARNED_INDEX, bufferPool, lsmTree, options);
+            db->Open("test_dir");
+            for (uint64_t i = 0; i < numKeys; i++) {
+                db->Put(getKey(i), i);
+            }
+            db->Close();
+            if (!useLSMTree) {
+                // The learned index is read from the files when they are opened again
+                db->Open("test_dir");
+            }
+
+            for (uint64_t i = 0; i < numKeys; i++) {
+                result &= db->Get(getKey(i)) == i;
+                result &= db->Get(getKey(i) + 1) == Utils::INVALID_VALUE;
+            }
+            result &= db->Get(getKey(numKeys - 1) + 1000) == Utils::INVALID_VALUE;
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(getKey(59000), getKey(61000) - 1, scanResult);
+            result &= scanResult.size() == 2000;
+
+            // Clean up
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static bool TestMmapReads() {
+        int memtableSize = 5000;
+        uint64_t numKeys = 12000;
+        bool result = true;
+        std::tuple<SearchType, LeafFormat, bool> configs[] = {
+                {SearchType::BINARY_SEARCH, LeafFormat::RAW_LEAVES,        false},
+                {SearchType::B_TREE_SEARCH, LeafFormat::RAW_LEAVES,        false},
+                {SearchType::B_TREE_SEARCH, LeafFormat::RAW_LEAVES,        true},
+                {SearchType::B_TREE_SEARCH, LeafFormat::COLUMNAR_LEAVES,   true},
+                {SearchType::B_TREE_SEARCH, LeafFormat::COMPRESSED_LEAVES, false},
+                {SearchType::LEARNED_INDEX, LeafFormat::RAW_LEAVES,        false}
+        };
+        for (auto [searchType, leafFormat, useLSMTree]: configs) {
+            DbOptions options;
+            options.leafFormat = leafFormat;
+            options.readMode = SSTReadMode::MMAP_READS;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+            auto db = new Db(memtableSize, searchType, bufferPool, lsmTree, options);
+            db->Open("test_dir");
+            for (uint64_t i = 0; i < numKeys; i++) {
+                db->Put(i * 3 + 1, i);
+            }
+            db->Close();
+            if (!useLSMTree) {
+                // The files are mapped again once they are opened again
+                db->Open("test_dir");
+            }
+
+            for (uint64_t i = 0; i < numKeys; i++) {
+                result &= db->Get(i * 3 + 1) == i;
+                result &= db->Get(i * 3 + 2) == Utils::INVALID_VALUE;
+            }
+            result &= db->Get(0) == Utils::INVALID_VALUE;
+            result &= db->Get(numKeys * 3 + 1) == Utils::INVALID_VALUE;
+
+            // Scans across the leaves and the files
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(2, 3 * 7000 + 1, scanResult);
+            result &= scanResult.size() == 7000;
+            result &= !scanResult.empty() && scanResult.front() == DataEntry_t(4, 1) &&
+                      scanResult.back() == DataEntry_t(3 * 7000 + 1, 7000);
+            scanResult.clear();
+            db->Scan(numKeys * 3 - 5, Utils::INVALID_VALUE - 3, scanResult);
+            result &= scanResult.size() == 2;
+
+            // Clean up
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static bool TestMultiGet() {
+        int memtableSize = 5000;
+        uint64_t numKeys = 12000;
+        bool result = true;
+        std::tuple<SearchType, bool, bool> configs[] = {
+                {SearchType::BINARY_SEARCH, false, true},
+                {SearchType::B_TREE_SEARCH, false, false},
+                {SearchType::B_TREE_SEARCH, false, true},
+                {SearchType::B_TREE_SEARCH, true,  true},
+                {SearchType::LEARNED_INDEX, false, true}
+        };
+        for (auto [searchType, useLSMTree, enableAsyncReads]: configs) {
+            DbOptions options;
+            options.enableAsyncReads = enableAsyncReads;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+            auto db = new Db(memtableSize, searchType, bufferPool, lsmTree, options);
+            db->Open("test_dir");
+            for (uint64_t i = 0; i < numKeys; i++) {
+                db->Put(i * 3 + 1, i);
+            }
+            if (useLSMTree) {
+                // Deleted in a newer file than the one holding them, and in the memtable
+                db->Delete(7);
+                db->DeleteRange(100, 200);
+                for (uint64_t i = 0; i < (uint64_t) memtableSize; i++) {
+                    db->Put(numKeys * 3 + i, i);
+                }
+                db->Delete(10);
+            }
+
+            // Keys out of order and repeated, in and out of the files
+            std::vector<uint64_t> keys;
+            for (uint64_t i = 0; i < numKeys; i += 7) {
+                keys.push_back((numKeys - i) * 3 + 1);
+                keys.push_back(i * 3 + 2);
+                keys.push_back(i * 3 + 1);
+            }
+            keys.push_back(1);
+            keys.push_back(7);
+            keys.push_back(10);
+            keys.push_back(103);
+            std::vector<uint64_t> values;
+            db->MultiGet(keys, values);
+            result &= values.size() == keys.size();
+            for (size_t i = 0; i < keys.size() && i < values.size(); i++) {
+                result &= values[i] == db->Get(keys[i]);
+            }
+            result &= values[2] == 0 && values[1] == Utils::INVALID_VALUE;
+            if (useLSMTree) {
+                result &= values[keys.size() - 3] == Utils::INVALID_VALUE;
+                result &= values[keys.size() - 2] == Utils::INVALID_VALUE;
+                result &= values[keys.size() - 1] == Utils::INVALID_VALUE;
+            }
+
+            // Scans read the leaves ahead
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(3 * 5000, 3 * 9000 + 1, scanResult);
+            result &= scanResult.size() == 4001;
+
+            // Clean up
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static size_t GetNumOpenFileDescriptors() {
+        auto entries = std::filesystem::directory_iterator("/proc/self/fd");
+        return std::distance(std::filesystem::begin(entries), std::filesystem::end(entries));
+    }
+
+    static bool TestTableCache() {
+        int memtableSize = 1000;
+        uint64_t numKeys = 12000;
+        bool result = true;
+        std::tuple<SearchType, bool, size_t> configs[] = {
+                {SearchType::BINARY_SEARCH, false, 2},
+                {SearchType::B_TREE_SEARCH, false, 2},
+                {SearchType::B_TREE_SEARCH, true,  1},
+                {SearchType::B_TREE_SEARCH, true,  TableCache::DEFAULT_CAPACITY},
+                {SearchType::B_TREE_SEARCH, true,  0}
+        };
+        for (auto [searchType, useLSMTree, maxOpenFiles]: configs) {
+            size_t numOpenFileDescriptors = GetNumOpenFileDescriptors();
+            DbOptions options;
+            options.maxOpenFiles = maxOpenFiles;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+            auto db = new Db(memtableSize, searchType, bufferPool, lsmTree, options);
+            db->Open("test_dir");
+            // Read in between the flushes and compactions, which replace the files read before
+            for (uint64_t i = 0; i < numKeys; i++) {
+                db->Put(i * 3 + 1, i);
+                if (i % 500 == 0) {
+                    result &= db->Get(i / 2 * 3 + 1) == i / 2;
+                }
+            }
+            for (uint64_t i = 0; i < numKeys; i++) {
+                result &= db->Get(i * 3 + 1) == i;
+                result &= db->Get(i * 3 + 2) == Utils::INVALID_VALUE;
+            }
+            // The files of a Db without an LSM-Tree are scanned one after another
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(2, 3 * 7000 + 1, scanResult);
+            std::sort(scanResult.begin(), scanResult.end());
+            auto scanEnd = std::upper_bound(scanResult.begin(), scanResult.end(), DataEntry_t(3 * 7000 + 1, 7000));
+            result &= scanEnd - scanResult.begin() == 7000;
+            result &= !scanResult.empty() && scanResult.front() == DataEntry_t(4, 1);
+
+            // All the files are closed along with the Db
+            delete db;
+            result &= GetNumOpenFileDescriptors() == numOpenFileDescriptors;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static bool TestWriteAheadLog() {
+        int memtableSize = 100;
+        uint64_t numThreads = 4;
+        uint64_t numKeysPerThread = 60;
+        uint64_t numKeys = numThreads * numKeysPerThread;
+        bool result = true;
+        // Writers log outside of the exclusive lock of the red-black tree memtable, so they are
+        // committed in groups with either memtable.
+        std::vector<std::pair<MemtableType, WalSyncMode>> configurations = {
+                {MemtableType::SKIP_LIST, WalSyncMode::SYNC_PER_WRITE},
+                {MemtableType::SKIP_LIST, WalSyncMode::SYNC_INTERVAL},
+                {MemtableType::SKIP_LIST, WalSyncMode::SYNC_NONE},
+                {MemtableType::RED_BLACK_TREE, WalSyncMode::SYNC_PER_WRITE}};
+        for (auto [memtableType, syncMode]: configurations) {
+            DbOptions options;
+            options.memtableType = memtableType;
+            options.maxImmutableMemtables = 1;
+            options.enableWriteAheadLog = true;
+            options.walSyncMode = syncMode;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto db = new Db(memtableSize, SearchType::BINARY_SEARCH, bufferPool, nullptr, options);
+            db->Open("test_dir");
+
+            // Concurrent writers are committed to the log in groups
+            std::vector<std::thread> threads;
+            std::atomic<bool> isEveryPutLogged = true;
+            for (uint64_t t = 0; t < numThreads; t++) {
+                threads.emplace_back([db, t, numThreads, numKeysPerThread, &isEveryPutLogged] {
+                    for (uint64_t i = 0; i < numKeysPerThread; i++) {
+                        uint64_t key = i * numThreads + t + 1;
+                        if (!db->Put(key, key * 10)) {
+                            isEveryPutLogged = false;
+                        }
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            result &= isEveryPutLogged;
+            WriteBatch batch;
+            for (uint64_t key = numKeys + 1; key <= numKeys + 50; key++) {
+                batch.Put(key, key * 10);
+            }
+            result &= db->Write(batch);
+
+            // Destroy the db without closing it, as if the process had crashed, and leave
+            // half of a record at the end of the log.
+            delete db;
+            std::vector<uint64_t> logNumbers = WriteAheadLog::GetLogNumbers("test_dir");
+            result &= !logNumbers.empty();
+            std::ofstream logFile(WriteAheadLog::GetLogFilePath("test_dir", logNumbers.back()),
+                                  std::ios::app | std::ios::binary);
+            logFile.write("torn", 4);
+            logFile.close();
+
+            bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            db = new Db(memtableSize, SearchType::BINARY_SEARCH, bufferPool, nullptr, options);
+            db->Open("test_dir");
+            for (uint64_t key = 1; key <= numKeys + 50; key++) {
+                result &= db->Get(key) == key * 10;
+            }
+
+            // Once everything is flushed, the logs are removed
+            db->Close();
+            result &= WriteAheadLog::GetLogNumbers("test_dir").empty();
+
+            // Clean up
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    /**
+     * Expect a replay to restore the values the readers saw when concurrent writers overwrite
+     * the same keys, as the writes are applied in the order they are logged.
+     */
+    static bool TestWriteAheadLogOrder() {
+        uint64_t numThreads = 4;
+        uint64_t numWritesPerThread = 2000;
+        uint64_t numKeys = 16;
+        bool result = true;
+        for (MemtableType memtableType: {MemtableType::RED_BLACK_TREE, MemtableType::SKIP_LIST}) {
+            DbOptions options;
+            options.memtableType = memtableType;
+            options.enableWriteAheadLog = true;
+            options.walSyncMode = WalSyncMode::SYNC_NONE;
+            // Everything stays in the memtable, so that only the log holds the writes.
+            int memtableSize = 1000;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto db = new Db(memtableSize, SearchType::BINARY_SEARCH, bufferPool, nullptr, options);
+            db->Open("test_dir");
+
+            std::vector<std::thread> threads;
+            for (uint64_t t = 0; t < numThreads; t++) {
+                threads.emplace_back([db, t, numWritesPerThread, numKeys] {
+                    for (uint64_t i = 0; i < numWritesPerThread; i++) {
+                        uint64_t key = i % numKeys + 1;
+                        if (i % 100 == 99) {
+                            WriteBatch batch;
+                            batch.Put(key, t * numWritesPerThread + i);
+                            batch.Put(key + numKeys, t * numWritesPerThread + i);
+                            db->Write(batch);
+                        } else {
+                            db->Put(key, t * numWritesPerThread + i);
+                        }
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            std::vector<uint64_t> values;
+            for (uint64_t key = 1; key <= numKeys * 2; key++) {
+                values.push_back(db->Get(key));
+            }
+
+            // Destroy the db without closing it, as if the process had crashed
+            delete db;
+            bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            db = new Db(memtableSize, SearchType::BINARY_SEARCH, bufferPool, nullptr, options);
+            db->Open("test_dir");
+            for (uint64_t key = 1; key <= numKeys * 2; key++) {
+                result &= db->Get(key) == values[key - 1];
+            }
+
+            // Clean up
+            db->Close();
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static bool TestIngestFile() {
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        auto db = new Db(1000, SearchType::B_TREE_SEARCH, bufferPool, new LSMTree(10, 4, 4));
+        db->Open("test_dir");
+        for (uint64_t key = 1; key <= 100; key++) {
+            db->Put(key, key);
+        }
+
+        SSTWriter writer("test_dir/ingest.sst", 100, 10);
+        for (uint64_t key = 50; key < 150; key++) {
+            writer.Add(key, key * 2);
+        }
+        // The memtable holds older values of some of the keys, so it is flushed first
+        bool result = db->IngestFile(writer.Finish());
+        for (uint64_t key = 1; key < 150; key++) {
+            result &= db->Get(key) == (key < 50 ? key : key * 2);
+        }
+        db->Put(60, 7);
+        result &= db->Get(60) == 7;
+
+        // Clean up
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
+    static bool TestPageSize() {
+        int memtableSize = 5000;
+        uint64_t numKeys = 20000;
+        bool result = true;
+        for (bool useLSMTree: {false, true}) {
+            DbOptions options;
+            options.pageSize = 16384;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            auto lsmTree = useLSMTree ? new LSMTree(10, 4, 4) : nullptr;
+            auto db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, lsmTree, options);
+            db->Open("test_dir");
+            for (uint64_t key = 1; key <= numKeys; key++) {
+                db->Put(key * 3, key % 100);
+            }
+            if (useLSMTree) {
+                // A file of the default page size is compacted with the files of larger pages
+                SSTWriter writer("test_dir/ingest.sst", 100, 10);
+                for (uint64_t key = 1; key <= 100; key++) {
+                    writer.Add(key * 3 + 1, key);
+                }
+                result &= db->IngestFile(writer.Finish());
+                for (uint64_t key = numKeys + 1; key <= numKeys + 2 * memtableSize; key++) {
+                    db->Put(key * 3, key % 100);
+                }
+                numKeys += 2 * memtableSize;
+            }
+            db->Close();
+            for (const auto &entry: std::filesystem::directory_iterator("test_dir")) {
+                result &= std::filesystem::file_size(entry) % options.pageSize == 0;
+            }
+            if (!useLSMTree) {
+                // The page size is read from the files when they are opened again
+                db->Open("test_dir");
+            }
+
+            for (uint64_t key = 1; key <= numKeys; key++) {
+                result &= db->Get(key * 3) == key % 100;
+            }
+            uint64_t numIngestedKeys = useLSMTree ? 100 : 0;
+            for (uint64_t key = 1; key <= numIngestedKeys; key++) {
+                result &= db->Get(key * 3 + 1) == key;
+            }
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(1, numKeys * 3, scanResult);
+            result &= scanResult.size() == numKeys + numIngestedKeys;
+
+            // Clean up
+            delete db;
+            std::filesystem::remove_all("./test_dir");
+        }
+        return result;
+    }
+
+    static bool TestWriteBufferManager() {
+        // Both memtables could hold all the keys, so only the manager flushes them
+        int memtableSize = 1 << 20;
+        size_t bufferSize = 4 * Arena::BLOCK_SIZE;
+        auto *writeBufferManager = new WriteBufferManager(bufferSize);
+        DbOptions options;
+        options.writeBufferManager = writeBufferManager;
+        Db *dbs[2];
+        std::string dirs[2] = {"test_dir", "test_dir_wbm"};
+        for (int i = 0; i < 2; i++) {
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            dbs[i] = new Db(memtableSize, SearchType::BINARY_SEARCH, bufferPool, nullptr, options);
+            dbs[i]->Open(dirs[i]);
+        }
+
+        // The first db goes idle holding most of the budget
+        bool result = true;
+        uint64_t numKeys[2] = {0, 0};
+        while (dbs[0]->GetMemtableMemoryUsage() < 3 * Arena::BLOCK_SIZE) {
+            numKeys[0]++;
+            dbs[0]->Put(numKeys[0], numKeys[0] * 10);
+        }
+        result &= std::filesystem::is_empty(dirs[0]);
+
+        // Then the second db goes over the budget, and the largest memtable is flushed
+        size_t peakMemoryUsage = 0;
+        while (numKeys[1] < 100000 && std::filesystem::is_empty(dirs[0])) {
+            numKeys[1]++;
+            dbs[1]->Put(numKeys[1], numKeys[1] * 20);
+            peakMemoryUsage = std::max(peakMemoryUsage, writeBufferManager->GetMemoryUsage());
+            result &= writeBufferManager->GetMemoryUsage() ==
+                      dbs[0]->GetMemtableMemoryUsage() + dbs[1]->GetMemtableMemoryUsage();
+        }
+        result &= !std::filesystem::is_empty(dirs[0]) && std::filesystem::is_empty(dirs[1]);
+        result &= peakMemoryUsage <= bufferSize;
+        result &= dbs[0]->GetMemtableMemoryUsage() < Arena::BLOCK_SIZE * 2;
+
+        for (int i = 0; i < 2; i++) {
+            for (uint64_t key = 1; key <= numKeys[i]; key++) {
+                result &= dbs[i]->Get(key) == key * 10 * (i + 1);
+            }
+        }
+
+        // The memory of a destroyed db is not accounted anymore
+        delete dbs[0];
+        result &= writeBufferManager->GetMemoryUsage() == dbs[1]->GetMemtableMemoryUsage();
+        delete dbs[1];
+        result &= writeBufferManager->GetMemoryUsage() == 0;
+
+        // Clean up
+        delete writeBufferManager;
+        for (const std::string &dir: dirs) {
+            std::filesystem::remove_all(dir);
+        }
+        return result;
+    }
+
+    static bool TestWriteBufferManagerBackgroundFlush() {
+        int memtableSize = 1 << 20;
+        size_t bufferSize = 4 * Arena::BLOCK_SIZE;
+        auto *writeBufferManager = new WriteBufferManager(bufferSize);
+        DbOptions options;
+        options.writeBufferManager = writeBufferManager;
+        Db *dbs[2];
+        std::string dirs[2] = {"test_dir", "test_dir_wbm"};
+        for (int i = 0; i < 2; i++) {
+            // The first db flushes its memtables in the background
+            options.maxImmutableMemtables = 1 - i;
+            auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+            dbs[i] = new Db(memtableSize, SearchType::BINARY_SEARCH, bufferPool, nullptr, options);
+            dbs[i]->Open(dirs[i]);
+        }
+        std::promise<std::thread::id> flushed;
+        dbs[0]->SetFlushedMemtableCallback([&] { flushed.set_value(std::this_thread::get_id()); });
+
+        bool result = true;
+        uint64_t numKeys[2] = {0, 0};
+        while (dbs[0]->GetMemtableMemoryUsage() < 3 * Arena::BLOCK_SIZE) {
+            numKeys[0]++;
+            dbs[0]->Put(numKeys[0], numKeys[0] * 10);
+        }
+
+        // The writer of the second db only switches the memtable of the first one
+        while (numKeys[1] < 100000 && dbs[0]->GetActiveMemtableMemoryUsage() >= 3 * Arena::BLOCK_SIZE) {
+            numKeys[1]++;
+            dbs[1]->Put(numKeys[1], numKeys[1] * 20);
+        }
+        result &= flushed.get_future().get() != std::this_thread::get_id();
+
+        // The flushed memtable is freed rather than kept for the next writes
+        dbs[0]->Close();
+        result &= !std::filesystem::is_empty(dirs[0]) && std::filesystem::is_empty(dirs[1]);
+        result &= dbs[0]->GetMemtableMemoryUsage() < Arena::BLOCK_SIZE * 2;
+        result &= writeBufferManager->GetMemoryUsage() ==
+                  dbs[0]->GetMemtableMemoryUsage() + dbs[1]->GetMemtableMemoryUsage();
+        dbs[0]->Open(dirs[0]);
+        for (int i = 0; i < 2; i++) {
+            for (uint64_t key = 1; key <= numKeys[i]; key++) {
+                result &= dbs[i]->Get(key) == key * 10 * (i + 1);
+            }
+        }
+
+        // Clean up
+        for (int i = 0; i < 2; i++) {
+            delete dbs[i];
+        }
+        delete writeBufferManager;
+        for (const std::string &dir: dirs) {
+            std::filesystem::remove_all(dir);
+        }
+        return result;
+    }
+
+    static bool TestDeleteRange() {
+        int memtableSize = 100;
+        uint64_t numKeys = 500;
+        DbOptions options;
+        options.enableWriteAheadLog = true;
+        auto bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        auto db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, new LSMTree(10, 4, 4), options);
+        db->Open("test_dir");
+        for (uint64_t key = 1; key <= numKeys; key++) {
+            db->Put(key, key * 10);
+        }
+
+        // The range hides the keys in the SST files and the memtable, but not the ones put afterwards
+        db->DeleteRange(100, 299);
+        db->Put(150, 7);
+        auto isExpected = [db, numKeys]() {
+            bool result = true;
+            for (uint64_t key = 1; key <= numKeys; key++) {
+                uint64_t expectedValue = key * 10;
+                if (key == 150) {
+                    expectedValue = 7;
+                } else if (key >= 100 && key <= 299) {
+                    expectedValue = Utils::INVALID_VALUE;
+                }
+                result &= db->Get(key) == expectedValue;
+            }
+            std::vector<DataEntry_t> scanResult;
+            db->Scan(1, numKeys, scanResult);
+            result &= scanResult.size() == numKeys - 199;
+            return result;
+        };
+        bool result = isExpected();
+
+        // The tombstone is flushed and compacted with the keys it hides
+        for (uint64_t key = numKeys + 1; key <= numKeys + 1000; key++) {
+            db->Put(key, key * 10);
+        }
+        result &= isExpected();
+
+        // A range deletion in the write-ahead log is replayed too
+        db->Put(numKeys + 2000, 1);
+        db->DeleteRange(numKeys + 1500, numKeys + 2500);
+        // and puts are replayed as puts, whatever their value
+        db->Put(numKeys + 3000, Utils::DELETED_KEY_VALUE - 1);
+        db->Put(numKeys + 3001, 1);
+        delete db;
+        bufferPool = new BufferPool(bufferPoolMinSize, bufferPoolMaxSize, evictionPolicy);
+        db = new Db(memtableSize, SearchType::B_TREE_SEARCH, bufferPool, new LSMTree(10, 4, 4), options);
+        db->Open("test_dir");
+        result &= db->Get(numKeys + 2000) == Utils::INVALID_VALUE;
+        result &= db->Get(numKeys + 3000) == Utils::DELETED_KEY_VALUE - 1 && db->Get(numKeys + 3001) == 1;
+
+        // A memtable holding only a range tombstone is flushed as a file without keys
+        db->Put(1, 10);
+        db->Put(51, 510);
+        db->Close();
+        db->DeleteRange(1, 50);
+        db->Close();
+        result &= db->Get(1) == Utils::INVALID_VALUE && db->Get(51) == 510;
+
+        // Clean up
+        delete db;
+        std::filesystem::remove_all("./test_dir");
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool result = true;
         result &= assertTrue(TestOpen, "TestDb::TestOpen");
+        result &= assertTrue(TestOpenLegacyBTreeFile, "TestDb::TestOpenLegacyBTreeFile");
+        result &= assertTrue(TestOpenHeaderlessFile, "TestDb::TestOpenHeaderlessFile");
         result &= assertTrue(TestPut, "TestDb::TestPut");
         result &= assertTrue(TestClose, "TestDb::TestClose");
         result &= assertTrue(TestGetBinarySearch, "TestDb::TestGetBinarySearch");
         result &= assertTrue(TestScanBinarySearch, "TestDb::TestScanBinarySearch");
         result &= assertTrue(TestDBWithBTreeSearch, "TestDb::TestDBWithBTreeSearch");
+        result &= assertTrue(TestConcurrentPutWithSkipList, "TestDb::TestConcurrentPutWithSkipList");
+        result &= assertTrue(TestBackgroundFlush, "TestDb::TestBackgroundFlush");
+        result &= assertTrue(TestScanDuringBackgroundFlush, "TestDb::TestScanDuringBackgroundFlush");
+        result &= assertTrue(TestWriteBatch, "TestDb::TestWriteBatch");
+        result &= assertTrue(TestLeafFormats, "TestDb::TestLeafFormats");
+        result &= assertTrue(TestLearnedIndex, "TestDb::TestLearnedIndex");
+        result &= assertTrue(TestMmapReads, "TestDb::TestMmapReads");
+        result &= assertTrue(TestMultiGet, "TestDb::TestMultiGet");
+        result &= assertTrue(TestTableCache, "TestDb::TestTableCache");
+        result &= assertTrue(TestWriteAheadLog, "TestDb::TestWriteAheadLog");
+        result &= assertTrue(TestWriteAheadLogOrder, "TestDb::TestWriteAheadLogOrder");
+        result &= assertTrue(TestIngestFile, "TestDb::TestIngestFile");
+        result &= assertTrue(TestPageSize, "TestDb::TestPageSize");
+        result &= assertTrue(TestWriteBufferManager, "TestDb::TestWriteBufferManager");
+        result &= assertTrue(TestWriteBufferManagerBackgroundFlush, "TestDb::TestWriteBufferManagerBackgroundFlush");
+        result &= assertTrue(TestDeleteRange, "TestDb::TestDeleteRange");
         return result;
     }
 };
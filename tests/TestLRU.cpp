@@ -69,12 +69,35 @@ class TestLRU : public TestBase {
         return result;
     }
 
+    static bool TestGetPageToEvictSkipsPinnedPages() {
+        // Set up
+        auto page1 = new Page("test1", {1});
+        auto page2 = new Page("test2", {1});
+        auto evictPolicy = new LRU();
+        evictPolicy->Insert(page1);
+        evictPolicy->Insert(page2);
+        page1->Pin();
+
+        // Test
+        bool result = true;
+        result &= page2 == evictPolicy->GetPageToEvict();
+        result &= evictPolicy->GetQueueHead() == page1->GetEvictionQueueNode();
+        result &= evictPolicy->GetQueueHead()->GetNext() == nullptr;
+        // Nothing is evicted when every page is pinned.
+        result &= evictPolicy->GetPageToEvict() == nullptr;
+        page1->Unpin();
+        result &= page1 == evictPolicy->GetPageToEvict();
+        result &= evictPolicy->GetQueueHead() == nullptr;
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool allTestPassed = true;
         allTestPassed &= assertTrue(TestInsert, "TestLRU::TestInsert");
         allTestPassed &= assertTrue(TestUpdatePageAccessStatus, "TestLRU::TestUpdatePageAccessStatus");
         allTestPassed &= assertTrue(TestGetPageToEvict, "TestLRU::TestGetPageToEvict");
+        allTestPassed &= assertTrue(TestGetPageToEvictSkipsPinnedPages, "TestLRU::TestGetPageToEvictSkipsPinnedPages");
         return allTestPassed;
     }
 };
@@ -2,6 +2,7 @@
 #include <vector>
 #include <filesystem>
 #include "LSMTree.h"
+#include "SSTWriter.h"
 #include "TestBase.h"
 
 namespace fs = std::filesystem;
@@ -154,6 +155,49 @@ class TestLSMTree : public TestBase {
         return result;
     }
 
+    /**
+     * Expect the LSM tree to keep the fence keys of every leaf of its SST files in memory,
+     * and to find the keys at both ends of every leaf with them.
+     */
+    static bool TestGetWithPinnedBTreeIndex() {
+        LSMTree *lsmTree = Setup();
+        if (!lsmTree) {
+            return false;
+        }
+
+        // 1. Set up data by writing sst files to level 0 and 1
+        std::vector<DataEntry_t> data1;
+        GetData(0, 256, 10, data1, 1);
+        WriteDataToLSMTree(lsmTree, data1);
+
+        std::vector<DataEntry_t> data2;
+        GetData(256, 512, 10, data2, 1);
+        WriteDataToLSMTree(lsmTree, data2);
+        lsmTree->MaintainLevelCapacityAndCompact(lsmTree->GetLevels()[0], dbDirPath);
+
+        std::vector<DataEntry_t> data3;
+        GetData(512, 600, 10, data3, 1);
+        WriteDataToLSMTree(lsmTree, data3);
+
+        // 2. Run and check expected values
+        bool result = true;
+        std::vector<size_t> indexMemoryUsage = lsmTree->GetIndexMemoryUsage();
+        result &= indexMemoryUsage.size() == 2;
+        result &= indexMemoryUsage[0] >= 88 * sizeof(uint64_t);
+        result &= indexMemoryUsage[1] >= 512 * sizeof(uint64_t);
+        for (uint64_t leafIndex = 0; leafIndex < 600; leafIndex++) {
+            uint64_t firstKey = leafIndex * SST::KV_PAIRS_PER_PAGE;
+            uint64_t lastKey = firstKey + SST::KV_PAIRS_PER_PAGE - 1;
+            result &= lsmTree->Get(firstKey) == firstKey * 10;
+            result &= lsmTree->Get(lastKey) == lastKey * 10;
+        }
+        result &= lsmTree->Get(600 * 256) == Utils::INVALID_VALUE;
+
+        // 3. Clean up
+        fs::remove_all(dbDirPath);
+        return result;
+    }
+
     /**
      * Expect the LSM tree to scan and return the most updated range of keys requested.
      */
@@ -265,6 +309,110 @@ class TestLSMTree : public TestBase {
         return result;
     }
 
+    static SST *WriteFileToIngest(uint64_t startKey, uint64_t endKey, uint64_t value) {
+        SSTWriter writer(dbDirPath + "/ingest.sst", endKey - startKey, bloomFilterBitsPerEntry);
+        for (uint64_t key = startKey; key < endKey; key++) {
+            writer.Add(key, key * value);
+        }
+        return writer.Finish();
+    }
+
+    /**
+     * Expect merging files that are not page-aligned, with keys in common, to keep every key.
+     */
+    static bool TestCompactWithPartialPages() {
+        LSMTree *lsmTree = Setup();
+        if (!lsmTree) {
+            return false;
+        }
+
+        // 1. Write files whose sizes are not a multiple of a page, and whose merged size shrinks
+        // because of the keys they have in common.
+        std::vector<DataEntry_t> data1;
+        for (uint64_t key = 1; key <= 300; key++) {
+            data1.emplace_back(key, key * 10);
+        }
+        lsmTree->WriteMemtableData(data1, searchType, dbDirPath);
+        std::vector<DataEntry_t> data2;
+        for (uint64_t key = 200; key <= 450; key++) {
+            data2.emplace_back(key, key * 20);
+        }
+        lsmTree->WriteMemtableData(data2, searchType, dbDirPath);
+        std::vector<DataEntry_t> data3;
+        for (uint64_t key = 440; key <= 700; key++) {
+            data3.emplace_back(key, key * 30);
+        }
+        lsmTree->WriteMemtableData(data3, searchType, dbDirPath);
+        std::vector<DataEntry_t> data4 = {std::make_pair(1, 40), std::make_pair(2, 80)};
+        lsmTree->WriteMemtableData(data4, searchType, dbDirPath);
+
+        // 2. Run and check expected values
+        bool result = lsmTree->GetLevels().size() == 3;
+        result &= lsmTree->GetLevels()[2]->GetSSTFiles().size() == 1;
+        result &= lsmTree->GetLevels()[2]->GetSSTFiles()[0]->GetFileDataSize() == 700 * SST::KV_PAIR_BYTE_SIZE;
+        for (uint64_t key = 1; key <= 700; key++) {
+            uint64_t value = key <= 2 ? key * 40 : key < 200 ? key * 10 : key < 440 ? key * 20 : key * 30;
+            result &= lsmTree->Get(key) == value;
+        }
+        result &= lsmTree->Get(701) == Utils::INVALID_VALUE;
+
+        // 3. Clean up
+        delete lsmTree;
+        fs::remove_all(dbDirPath);
+        return result;
+    }
+
+    /**
+     * Expect an ingested file to go in the deepest level that keeps it above older values of its keys.
+     */
+    static bool TestIngestFile() {
+        LSMTree *lsmTree = Setup();
+        if (!lsmTree) {
+            return false;
+        }
+
+        // 1. Set up data by writing keys 0 to 511 to level 1
+        std::vector<DataEntry_t> data1;
+        GetData(0, 1, 10, data1, 1);
+        lsmTree->WriteMemtableData(data1, searchType, dbDirPath);
+        std::vector<DataEntry_t> data2;
+        GetData(1, 2, 10, data2, 1);
+        lsmTree->WriteMemtableData(data2, searchType, dbDirPath);
+
+        // 2. Run and check expected values
+        bool result = true;
+
+        // No level holds any of its keys, so it goes in a new level at the bottom.
+        result &= lsmTree->IngestFile(WriteFileToIngest(1000, 2000, 20), dbDirPath);
+        result &= lsmTree->GetLevels().size() == 3;
+        result &= lsmTree->GetLevels()[2]->GetSSTFiles().size() == 1;
+        result &= lsmTree->GetLevels()[2]->GetSSTFiles()[0]->GetFileName() == dbDirPath + "/level2-0.sst";
+
+        // Level 1 holds some of its keys, so it goes in the empty level above it.
+        result &= lsmTree->IngestFile(WriteFileToIngest(400, 451, 30), dbDirPath);
+        result &= lsmTree->GetLevels().size() == 3;
+        result &= lsmTree->GetLevels()[0]->GetSSTFiles().size() == 1;
+        result &= lsmTree->GetLevels()[0]->GetSSTFiles()[0]->GetFileName() == dbDirPath + "/level0-0.sst";
+
+        // The first level holds some of its keys, so it is merged in.
+        result &= lsmTree->IngestFile(WriteFileToIngest(445, 461, 40), dbDirPath);
+        result &= lsmTree->GetLevels()[0]->GetSSTFiles().empty();
+        result &= !fs::exists(dbDirPath + "/ingest.sst");
+
+        for (uint64_t key = 0; key < 512; key++) {
+            uint64_t value = key < 400 ? key * 10 : key < 445 ? key * 30 : key < 461 ? key * 40 : key * 10;
+            result &= lsmTree->Get(key) == value;
+        }
+        for (uint64_t key = 1000; key < 2000; key++) {
+            result &= lsmTree->Get(key) == key * 20;
+        }
+
+        // 3. Clean up
+        delete lsmTree;
+        fs::remove_all(dbDirPath);
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool allTestPassed = true;
@@ -272,9 +420,12 @@ public:
         allTestPassed &= assertTrue(TestMaintainLevelsCapacityAndCompact,
                                     "TestLSMTree::TestMaintainLevelsCapacityAndCompact");
         allTestPassed &= assertTrue(TestGetWithAllUniqueKeys, "TestLSMTree::TestGetWithAllUniqueKeys");
+        allTestPassed &= assertTrue(TestGetWithPinnedBTreeIndex, "TestLSMTree::TestGetWithPinnedBTreeIndex");
         allTestPassed &= assertTrue(TestScanWithAllUniqueKeys, "TestLSMTree::TestScanWithAllUniqueKeys");
         allTestPassed &= assertTrue(TestScanAndGetWithUpdatedAndDeletedKeys,
                                     "TestLSMTree::TestScanAndGetWithUpdatedAndDeletedKeys");
+        allTestPassed &= assertTrue(TestCompactWithPartialPages, "TestLSMTree::TestCompactWithPartialPages");
+        allTestPassed &= assertTrue(TestIngestFile, "TestLSMTree::TestIngestFile");
         return allTestPassed;
     }
 };
\ No newline at end of file
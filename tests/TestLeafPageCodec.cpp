@@ -0,0 +1,105 @@
+#include <vector>
+#include "TestBase.h"
+#include "LeafPageCodec.h"
+
+class TestLeafPageCodec : public TestBase {
+    static std::vector<SearchKernel> GetSupportedKernels() {
+        std::vector<SearchKernel> kernels;
+        for (SearchKernel kernel: {SCALAR_KERNEL, SSE42_KERNEL, AVX2_KERNEL}) {
+            if (SearchKernels::IsKernelSupported(kernel)) {
+                kernels.push_back(kernel);
+            }
+        }
+        return kernels;
+    }
+
+    static bool EncodeAndDecode(std::vector<DataEntry_t> &entries, size_t expectedNumEncoded) {
+        uint64_t page[LeafPageCodec::PAGE_NUM_WORDS];
+        size_t numEncoded = LeafPageCodec::Encode(entries.data(), entries.size(), page);
+        std::vector<uint64_t> data;
+        LeafPageCodec::Decode(page, data);
+
+        bool result = numEncoded == expectedNumEncoded;
+        result &= LeafPageCodec::GetNumEntries(page) == numEncoded;
+        result &= data.size() == numEncoded * 2;
+        for (size_t i = 0; result && i < numEncoded; i++) {
+            result &= data[i * 2] == entries[i].first && data[i * 2 + 1] == entries[i].second;
+        }
+        return result;
+    }
+
+    /**
+     * Expect dense keys with small values to fit several times more entries than a raw page.
+     */
+    static bool TestEncodeDenseKeys() {
+        std::vector<DataEntry_t> entries;
+        for (uint64_t key = 1000; key < 1000 + 4096; key++) {
+            entries.emplace_back(key * 2, key % 100);
+        }
+        // Deltas of 2 take no bits and values take 7, so the payload could hold 4644 entries.
+        return EncodeAndDecode(entries, LeafPageCodec::MAX_ENTRIES_PER_PAGE);
+    }
+
+    /**
+     * Expect the entries to be decoded as they were when they take up to 64 bits, as the
+     * values of deleted keys do.
+     */
+    static bool TestEncodeWideEntries() {
+        bool result = true;
+        std::vector<DataEntry_t> entries;
+        uint64_t key = 0;
+        for (uint64_t i = 0; i < 1000; i++) {
+            key += (i % 2) ? 1 : (1ULL << 52);
+            entries.emplace_back(key, (i % 3) ? i : Utils::DELETED_KEY_VALUE);
+        }
+        // Deltas take 52 bits and values take 64, so the payload holds (508 * 64 + 52) / 116 entries.
+        result &= EncodeAndDecode(entries, 280);
+
+        // A page with a single entry
+        std::vector<DataEntry_t> singleEntry = {std::make_pair(Utils::DELETED_KEY_VALUE, 0)};
+        result &= EncodeAndDecode(singleEntry, 1);
+        return result;
+    }
+
+    /**
+     * Expect every kernel to decode the same entries, for values of every width from 0 to 64 bits
+     * and key deltas of up to 50 bits, with numbers of entries that leave a tail after each batch.
+     */
+    static bool TestDecodeKernels() {
+        bool result = true;
+        uint64_t page[LeafPageCodec::PAGE_NUM_WORDS];
+        for (uint64_t numBits = 0; numBits <= 64; numBits++) {
+            uint64_t mask = numBits == 64 ? ~0ULL : (1ULL << numBits) - 1;
+            uint64_t deltaMask = numBits >= 50 ? (1ULL << 50) - 1 : mask;
+            for (size_t numEntries: {1, 2, 5, 63}) {
+                std::vector<DataEntry_t> entries;
+                uint64_t key = 12345;
+                for (uint64_t i = 0; i < numEntries; i++) {
+                    uint64_t random = (i + 1) * 0x9E3779B97F4A7C15ULL;
+                    key += 1 + ((random >> 7) & deltaMask);
+                    entries.emplace_back(key, i == 0 ? mask : random & mask);
+                }
+                size_t numEncoded = LeafPageCodec::Encode(entries.data(), entries.size(), page);
+                result &= numEncoded == numEntries;
+                for (SearchKernel kernel: GetSupportedKernels()) {
+                    std::vector<uint64_t> data;
+                    LeafPageCodec::Decode(page, data, LeafPageCodec::PAGE_NUM_WORDS, kernel);
+                    result &= data.size() == numEntries * 2;
+                    for (size_t i = 0; result && i < numEntries; i++) {
+                        result &= data[i * 2] == entries[i].first && data[i * 2 + 1] == entries[i].second;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestEncodeDenseKeys, "TestLeafPageCodec::TestEncodeDenseKeys");
+        allTestPassed &= assertTrue(TestEncodeWideEntries, "TestLeafPageCodec::TestEncodeWideEntries");
+        allTestPassed &= assertTrue(TestDecodeKernels, "TestLeafPageCodec::TestDecodeKernels");
+        return allTestPassed;
+    }
+};
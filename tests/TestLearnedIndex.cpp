@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <vector>
+#include "TestBase.h"
+#include "LearnedIndex.h"
+
+class TestLearnedIndex : public TestBase {
+    /**
+     * Whether the lower bound of every key, and of the keys right before and after them, is
+     * within the range predicted by the learned index.
+     */
+    static bool IsLowerBoundInSearchRange(const LearnedIndex &learnedIndex, const std::vector<uint64_t> &keys) {
+        bool result = learnedIndex.GetNumKeys() == keys.size();
+        for (uint64_t key: keys) {
+            for (uint64_t keyToSearch: {key - 1, key, key + 1}) {
+                uint64_t lowerBound = std::lower_bound(keys.begin(), keys.end(), keyToSearch) - keys.begin();
+                auto [first, last] = learnedIndex.GetSearchRange(keyToSearch);
+                result &= first <= lowerBound && lowerBound <= last;
+                result &= last - first <= 2 * LearnedIndex::MAX_ERROR + 5;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Expect evenly spread keys to be modeled by a single segment.
+     */
+    static bool TestUniformKeys() {
+        LearnedIndex learnedIndex;
+        std::vector<uint64_t> keys;
+        for (uint64_t i = 1; i <= 10000; i++) {
+            keys.push_back(i * 1000 + (i * 7919) % 500);
+            learnedIndex.AddKey(keys.back());
+        }
+        bool result = IsLowerBoundInSearchRange(learnedIndex, keys);
+        result &= learnedIndex.GetNumSegments() == 1;
+        result &= learnedIndex.GetSearchRange(0) == std::make_pair<uint64_t, uint64_t>(0, 0);
+        return result;
+    }
+
+    /**
+     * Expect keys that grow further apart to be modeled by more segments, and the model to be
+     * the same once serialized and deserialized.
+     */
+    static bool TestSkewedKeys() {
+        LearnedIndex learnedIndex;
+        std::vector<uint64_t> keys;
+        uint64_t key = 1;
+        for (uint64_t i = 0; i < 10000; i++) {
+            key += 1 + i * i / 100;
+            keys.push_back(key);
+            learnedIndex.AddKey(key);
+        }
+        bool result = IsLowerBoundInSearchRange(learnedIndex, keys);
+        result &= learnedIndex.GetNumSegments() > 1 && learnedIndex.GetNumSegments() < keys.size() / 100;
+
+        std::vector<uint64_t> words;
+        learnedIndex.Serialize(words);
+        LearnedIndex deserializedIndex;
+        result &= deserializedIndex.Deserialize(words);
+        result &= deserializedIndex.GetNumSegments() == learnedIndex.GetNumSegments();
+        result &= IsLowerBoundInSearchRange(deserializedIndex, keys);
+
+        // A model cut short is not deserialized
+        words.pop_back();
+        result &= !deserializedIndex.Deserialize(words);
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestUniformKeys, "TestLearnedIndex::TestUniformKeys");
+        allTestPassed &= assertTrue(TestSkewedKeys, "TestLearnedIndex::TestSkewedKeys");
+        return allTestPassed;
+    }
+};
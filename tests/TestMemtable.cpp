@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <thread>
+#include <map>
 #include "Memtable.h"
 #include "TestBase.h"
 
@@ -87,6 +89,279 @@ class TestMemtable : public TestBase {
         return memtable->GetCurrentSize() == 0;
     }
 
+    static bool TestPutAfterReset() {
+        // Set up, fill the memtable with enough entries to span multiple arena blocks
+        int numEntries = 10000;
+        auto memtable = new Memtable(numEntries);
+        for (int i = 0; i < numEntries; i++) {
+            memtable->Put(i, i + 1);
+        }
+        memtable->Reset();
+
+        // Tests, the reused memory should only hold the new entries
+        bool result = true;
+        for (int i = numEntries; i > 0; i--) {
+            result &= memtable->Put(i, i * 2);
+        }
+        result &= memtable->Get(0) == Utils::INVALID_VALUE;
+        auto data = memtable->GetAllData();
+        result &= data.size() == (size_t) numEntries;
+        for (uint64_t i = 0; i < data.size(); i++) {
+            result &= data[i].first == i + 1 && data[i].second == (i + 1) * 2;
+        }
+        return result;
+    }
+
+    static bool TestPutExistingKey() {
+        bool result = true;
+        for (auto memtableType: {MemtableType::RED_BLACK_TREE, MemtableType::SKIP_LIST}) {
+            auto memtable = new Memtable(10, memtableType);
+            memtable->Put(1, 2);
+            memtable->Put(2, 3);
+            memtable->Put(1, 4);
+
+            // The newer value replaces the older one
+            result &= memtable->GetCurrentSize() == 2;
+            result &= memtable->Get(1) == 4;
+            auto data = memtable->GetAllData();
+            result &= data.size() == 2 && data[0] == std::make_pair<uint64_t, uint64_t>(1, 4);
+        }
+        return result;
+    }
+
+    static bool TestSkipList() {
+        // Set up, insert keys out of order
+        auto memtable = new Memtable(1000, MemtableType::SKIP_LIST);
+        for (int i = 999; i >= 0; i--) {
+            memtable->Put((i * 7) % 1000, i);
+        }
+
+        // Tests
+        bool result = true;
+        result &= memtable->GetCurrentSize() == 1000;
+        result &= !memtable->Put(1000, 1);
+        result &= memtable->Get(1000) == Utils::INVALID_VALUE;
+        for (uint64_t i = 0; i < 1000; i++) {
+            result &= memtable->Get((i * 7) % 1000) == i;
+        }
+        auto data = memtable->Scan(100, 199);
+        result &= data.size() == 100;
+        result &= std::is_sorted(data.begin(), data.end());
+        data = memtable->GetAllData();
+        result &= data.size() == 1000 && std::is_sorted(data.begin(), data.end());
+
+        memtable->Reset();
+        result &= memtable->GetCurrentSize() == 0 && memtable->GetAllData().empty();
+        return result;
+    }
+
+    static bool TestSkipListConcurrentPut() {
+        // Set up, every thread writes its own keys and all threads also write a shared set of keys
+        int numThreads = 8;
+        int numKeysPerThread = 10000;
+        int numSharedKeys = 100;
+        auto memtable = new Memtable(numThreads * numKeysPerThread + numSharedKeys, MemtableType::SKIP_LIST);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([=]() {
+                for (int i = 0; i < numKeysPerThread; i++) {
+                    memtable->Put(numSharedKeys + i * numThreads + t, t);
+                    if (i < numSharedKeys) {
+                        memtable->Put(i, t);
+                    }
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        // Tests
+        bool result = true;
+        auto data = memtable->GetAllData();
+        result &= memtable->GetCurrentSize() == numThreads * numKeysPerThread + numSharedKeys;
+        result &= data.size() == (size_t) (numThreads * numKeysPerThread + numSharedKeys);
+        for (uint64_t i = 0; i < data.size(); i++) {
+            result &= data[i].first == i;
+        }
+        for (uint64_t i = numSharedKeys; i < data.size(); i++) {
+            result &= data[i].second == (i - numSharedKeys) % numThreads;
+        }
+        return result;
+    }
+
+    static bool TestSkipListConcurrentPutSorted() {
+        // Set up, the threads interleave their sorted keys, half of them through Put
+        int numThreads = 8;
+        int numKeysPerThread = 10000;
+        auto memtable = new Memtable(numThreads * numKeysPerThread, MemtableType::SKIP_LIST);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([=]() {
+                std::vector<DataEntry_t> entries;
+                for (int i = 0; i < numKeysPerThread; i++) {
+                    entries.emplace_back(i * numThreads + t, t);
+                }
+                if (t % 2 == 0) {
+                    memtable->PutSorted(entries, 0);
+                } else {
+                    for (auto &entry: entries) {
+                        memtable->Put(entry.first, entry.second);
+                    }
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        // Tests
+        bool result = true;
+        auto data = memtable->GetAllData();
+        result &= data.size() == (size_t) (numThreads * numKeysPerThread);
+        for (uint64_t i = 0; i < data.size(); i++) {
+            result &= data[i].first == i && data[i].second == i % numThreads;
+        }
+        delete memtable;
+        return result;
+    }
+
+    static bool TestIterator() {
+        bool result = true;
+        for (MemtableType memtableType: {MemtableType::RED_BLACK_TREE, MemtableType::SKIP_LIST,
+                                          MemtableType::B_PLUS_TREE}) {
+            auto memtable = new Memtable(1000, memtableType);
+            for (uint64_t i = 0; i < 1000; i++) {
+                // Insert the keys out of order
+                uint64_t key = (i * 7919) % 1000;
+                memtable->Put(key, key + 1);
+            }
+
+            // The iterator should return the same entries as GetAllData
+            auto expectedData = memtable->GetAllData();
+            EntryIterator *iterator = memtable->NewIterator();
+            size_t numEntries = 0;
+            while (iterator->Valid() && numEntries < expectedData.size()) {
+                result &= iterator->GetEntry() == expectedData[numEntries];
+                iterator->Next();
+                numEntries++;
+            }
+            result &= !iterator->Valid() && numEntries == expectedData.size() && numEntries == 1000;
+
+            delete iterator;
+            delete memtable;
+        }
+        return result;
+    }
+
+    static bool TestPutSorted() {
+        bool result = true;
+        for (MemtableType memtableType: {MemtableType::RED_BLACK_TREE, MemtableType::SKIP_LIST,
+                                          MemtableType::B_PLUS_TREE}) {
+            auto memtable = new Memtable(100, memtableType);
+            for (uint64_t key = 0; key < 100; key += 2) {
+                memtable->Put(key, 0);
+            }
+
+            // The even keys overwrite existing keys, so only the odd keys take room
+            std::vector<DataEntry_t> entries;
+            for (uint64_t key = 0; key < 120; key++) {
+                entries.emplace_back(key, key + 1);
+            }
+            size_t nextEntry = memtable->PutSorted(entries, 0);
+            result &= nextEntry == 100 && memtable->GetCurrentSize() == 100;
+            result &= memtable->PutSorted(entries, nextEntry) == nextEntry;
+
+            auto data = memtable->GetAllData();
+            for (size_t i = 0; i < data.size(); i++) {
+                result &= data[i] == entries[i];
+            }
+            delete memtable;
+        }
+        return result;
+    }
+
+    static bool TestDeleteRange() {
+        bool result = true;
+        for (MemtableType memtableType: {MemtableType::RED_BLACK_TREE, MemtableType::SKIP_LIST,
+                                          MemtableType::B_PLUS_TREE}) {
+            auto memtable = new Memtable(100, memtableType);
+            for (uint64_t key = 0; key < 100; key++) {
+                memtable->Put(key, key + 1);
+            }
+
+            // The keys already in the full memtable are marked as deleted without taking room
+            memtable->DeleteRange(10, 19);
+            memtable->DeleteRange(20, 29);
+            memtable->DeleteRange(200, 300);
+            result &= memtable->GetCurrentSize() == 100;
+            for (uint64_t key = 0; key < 100; key++) {
+                result &= memtable->Get(key) == (key >= 10 && key < 30 ? Utils::DELETED_KEY_VALUE : key + 1);
+            }
+
+            // Adjacent ranges are merged into one tombstone
+            const RangeTombstones &rangeTombstones = memtable->GetRangeTombstones();
+            result &= rangeTombstones.GetRanges().size() == 2;
+            result &= rangeTombstones.Covers(10) && rangeTombstones.Covers(29) && rangeTombstones.Covers(250);
+            result &= !rangeTombstones.Covers(9) && !rangeTombstones.Covers(30) && !rangeTombstones.Covers(301);
+            result &= rangeTombstones.OverlapsRange(100, 200) && !rangeTombstones.OverlapsRange(30, 199);
+
+            // A memtable holding only range tombstones still has something to flush
+            memtable->Reset();
+            result &= memtable->IsEmpty();
+            memtable->DeleteRange(0, 5);
+            result &= !memtable->IsEmpty() && memtable->GetCurrentSize() == 0;
+            delete memtable;
+        }
+        return result;
+    }
+
+    static bool TestBPlusTree() {
+        // Enough keys for the tree to be a few levels deep
+        uint64_t numKeys = 20000;
+        auto memtable = new Memtable((int) numKeys, MemtableType::B_PLUS_TREE);
+        std::map<uint64_t, uint64_t> expected;
+        bool result = true;
+        for (uint64_t i = 0; i < numKeys; i++) {
+            uint64_t key = (i * 7919) % numKeys;
+            result &= memtable->Put(key, i);
+            expected[key] = i;
+            if (i % 5 == 0) {
+                // Overwrite a key inserted before
+                uint64_t existingKey = ((i / 2) * 7919) % numKeys;
+                memtable->Put(existingKey, i + 1);
+                expected[existingKey] = i + 1;
+            }
+        }
+        result &= memtable->GetCurrentSize() == (int) expected.size();
+        for (auto &[key, value]: expected) {
+            result &= memtable->Get(key) == value;
+        }
+        result &= memtable->Get(numKeys) == Utils::INVALID_VALUE;
+
+        auto data = memtable->Scan(100, 5000);
+        result &= data.size() == 4901 && data.front().first == 100 && data.back().first == 5000;
+        for (auto &[key, value]: data) {
+            result &= expected[key] == value;
+        }
+
+        // Sorted insertion into a tree that already has keys on both sides
+        memtable->Reset();
+        std::vector<DataEntry_t> entries;
+        for (uint64_t key = 0; key < numKeys / 2; key += 2) {
+            memtable->Put(key, 0);
+            entries.emplace_back(key + 1, key + 1);
+        }
+        memtable->PutSorted(entries, 0);
+        data = memtable->GetAllData();
+        result &= data.size() == numKeys / 2;
+        for (uint64_t key = 0; key < data.size(); key++) {
+            result &= data[key].first == key && memtable->Get(key) == (key % 2 ? key : 0);
+        }
+        delete memtable;
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool allTestPassed = true;
@@ -96,6 +371,15 @@ public:
         allTestPassed &= assertTrue(TestScan, "TestMemtable::TestScan");
         allTestPassed &= assertTrue(TestGetAllData, "TestMemtable::TestGetAllData");
         allTestPassed &= assertTrue(TestReset, "TestMemtable::TestReset");
+        allTestPassed &= assertTrue(TestPutAfterReset, "TestMemtable::TestPutAfterReset");
+        allTestPassed &= assertTrue(TestPutExistingKey, "TestMemtable::TestPutExistingKey");
+        allTestPassed &= assertTrue(TestSkipList, "TestMemtable::TestSkipList");
+        allTestPassed &= assertTrue(TestSkipListConcurrentPut, "TestMemtable::TestSkipListConcurrentPut");
+        allTestPassed &= assertTrue(TestSkipListConcurrentPutSorted, "TestMemtable::TestSkipListConcurrentPutSorted");
+        allTestPassed &= assertTrue(TestIterator, "TestMemtable::TestIterator");
+        allTestPassed &= assertTrue(TestPutSorted, "TestMemtable::TestPutSorted");
+        allTestPassed &= assertTrue(TestDeleteRange, "TestMemtable::TestDeleteRange");
+        allTestPassed &= assertTrue(TestBPlusTree, "TestMemtable::TestBPlusTree");
         return allTestPassed;
     }
 };
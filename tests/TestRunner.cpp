@@ -8,6 +8,14 @@
 #include "TestClock.cpp"
 #include "TestLSMTree.cpp"
 #include "TestBloomFilter.cpp"
+#include "TestSSTWriter.cpp"
+#include "TestLeafPageCodec.cpp"
+#include "TestSearchKernels.cpp"
+#include "TestLearnedIndex.cpp"
+#include "TestAsyncReader.cpp"
+#include "TestTableCache.cpp"
+#include "TestAlignedFileWriter.cpp"
+#include "TestBufferPool.cpp"
 
 
 int main() {
@@ -21,7 +29,15 @@ int main() {
             std::make_pair(new TestLRU(), "TestLRU"),  // LRU Tests
             std::make_pair(new TestClock(), "TestClock"),  // Clock Tests
             std::make_pair(new TestLSMTree(), "TestLSMTree"),  // LSMTree Tests
-            std::make_pair(new TestBloomFilter(), "TestBloomFilter")  // BloomFilter Tests
+            std::make_pair(new TestBloomFilter(), "TestBloomFilter"),  // BloomFilter Tests
+            std::make_pair(new TestSSTWriter(), "TestSSTWriter"),  // SSTWriter Tests
+            std::make_pair(new TestLeafPageCodec(), "TestLeafPageCodec"),  // LeafPageCodec Tests
+            std::make_pair(new TestSearchKernels(), "TestSearchKernels"),  // SearchKernels Tests
+            std::make_pair(new TestLearnedIndex(), "TestLearnedIndex"),  // LearnedIndex Tests
+            std::make_pair(new TestAsyncReader(), "TestAsyncReader"),  // AsyncReader Tests
+            std::make_pair(new TestTableCache(), "TestTableCache"),  // TableCache Tests
+            std::make_pair(new TestAlignedFileWriter(), "TestAlignedFileWriter"),  // AlignedFileWriter Tests
+            std::make_pair(new TestBufferPool(), "TestBufferPool")  // BufferPool Tests
     };
 
     for (auto [testClass, name]: testClasses) {
@@ -1,6 +1,11 @@
 #include <string>
 #include <iostream>
+#include <unistd.h>
+#include <filesystem>
+#include <algorithm>
+#include <fcntl.h>
 #include "SST.h"
+#include "AlignedBuffer.h"
 #include "TestBase.h"
 
 
@@ -10,7 +15,7 @@ class TestSST : public TestBase {
         std::string filename = Utils::GetFilenameWithExt("test");
         std::vector<DataEntry_t> dataToWrite = {std::make_pair(1, 2), std::make_pair(2, 3)};
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         std::ifstream inputFile(filename);
@@ -33,7 +38,7 @@ class TestSST : public TestBase {
                 std::make_pair(5, 3),
         };
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         // Perform action
@@ -65,7 +70,7 @@ class TestSST : public TestBase {
             dataToWrite.emplace_back(i, i + 10);
         }
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         // Tests
@@ -93,7 +98,7 @@ class TestSST : public TestBase {
             dataToWrite.emplace_back(i, i + 10);
         }
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         // Tests
@@ -125,7 +130,7 @@ class TestSST : public TestBase {
             dataToWrite.emplace_back(i, i + 10);
         }
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         // Tests
@@ -152,7 +157,7 @@ class TestSST : public TestBase {
             dataToWrite.emplace_back(i, i + 10);
         }
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         // Tests
@@ -203,7 +208,7 @@ class TestSST : public TestBase {
             dataToWrite.emplace_back(i, i + 10);
         }
         SST *sstFile = new SST(filename, dataToWrite.size() * SST::KV_PAIR_BYTE_SIZE);
-        std::ofstream file(sstFile->GetFileName(), std::ios::out | std::ios::binary);
+        AlignedFileWriter file(sstFile->GetFileName());
         sstFile->WriteFile(file, dataToWrite, SearchType::BINARY_SEARCH, true);
 
         // Tests
@@ -231,6 +236,345 @@ class TestSST : public TestBase {
         return result;
     }
 
+    static bool TestWriteFileFromIterator() {
+        // More than one buffer of entries and a partial last page
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 1; i <= 5 * SST::KV_PAIRS_PER_PAGE + 3; i++) {
+            data.emplace_back(i, i * 10);
+        }
+
+        bool result = true;
+        for (SearchType searchType: {SearchType::BINARY_SEARCH, SearchType::B_TREE_SEARCH}) {
+            // Streaming the entries should produce the same file as writing the whole vector
+            std::string filenames[2] = {Utils::GetFilenameWithExt("test_vector"),
+                                        Utils::GetFilenameWithExt("test_iterator")};
+            for (int i = 0; i < 2; i++) {
+                SST *sstFile = new SST(filenames[i], data.size() * SST::KV_PAIR_BYTE_SIZE);
+                if (searchType == SearchType::B_TREE_SEARCH) {
+                    sstFile->SetupBTreeFile();
+                }
+                AlignedFileWriter file(sstFile->GetFileName());
+                if (i == 0) {
+                    sstFile->WriteFile(file, data, searchType, true);
+                } else {
+                    VectorEntryIterator iterator(data);
+                    sstFile->WriteFile(file, &iterator, searchType, 2);
+                }
+                delete sstFile;
+            }
+
+            std::ifstream vectorFile(filenames[0], std::ios::binary);
+            std::ifstream iteratorFile(filenames[1], std::ios::binary);
+            std::string vectorContent((std::istreambuf_iterator<char>(vectorFile)), std::istreambuf_iterator<char>());
+            std::string iteratorContent((std::istreambuf_iterator<char>(iteratorFile)),
+                                        std::istreambuf_iterator<char>());
+            result &= !vectorContent.empty() && vectorContent == iteratorContent;
+
+            // Clean up
+            std::remove(filenames[0].c_str());
+            std::remove(filenames[1].c_str());
+        }
+        return result;
+    }
+
+    /**
+     * Expect the keys to be found in the leaves as they are laid out, including the partial last leaf.
+     */
+    static bool TestFindKeyInLeaves() {
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 1; i <= 2 * SST::KV_PAIRS_PER_PAGE + 3; i++) {
+            data.emplace_back(i * 2, i * 10);
+        }
+
+        bool result = true;
+        for (LeafFormat leafFormat: {LeafFormat::RAW_LEAVES, LeafFormat::COLUMNAR_LEAVES}) {
+            std::string fileName = Utils::GetFilenameWithExt("test_leaves");
+            SST *sstFile = new SST(fileName, data.size() * SST::KV_PAIR_BYTE_SIZE);
+            sstFile->SetupBTreeFile(leafFormat);
+            AlignedFileWriter file(sstFile->GetFileName());
+            sstFile->WriteFile(file, data, SearchType::B_TREE_SEARCH, true);
+
+            int fd = Utils::OpenFile(fileName);
+            uint64_t leavesStartPage = sstFile->FindLeafOffset(0);
+            std::vector<uint64_t> leaves = SST::ReadLeafPagesOfFile(fd, leavesStartPage, 3, leafFormat);
+            size_t numEntries = SST::GetLeafNumEntries(leaves, leafFormat);
+            result &= numEntries == data.size();
+            for (size_t i = 0; i < data.size(); i++) {
+                size_t index = SST::FindKeyInLeaves(leaves, numEntries, data[i].first, leafFormat);
+                result &= index == i && SST::GetLeafValue(leaves, index, leafFormat) == data[i].second;
+                // Keys in between are not found
+                index = SST::FindKeyInLeaves(leaves, numEntries, data[i].first - 1, leafFormat);
+                result &= index == i && SST::GetLeafKey(leaves, index, leafFormat) != data[i].first - 1;
+            }
+            result &= SST::FindKeyInLeaves(leaves, numEntries, data.back().first + 1, leafFormat) == numEntries;
+
+            // Clean up
+            close(fd);
+            delete sstFile;
+            std::remove(fileName.c_str());
+        }
+        return result;
+    }
+
+    /**
+     * Expect the key range and number of entries of a file to be read back from its footer
+     * once it is opened again, so that it can be skipped without reading it.
+     */
+    static bool TestFooter() {
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 1; i <= 2 * SST::KV_PAIRS_PER_PAGE + 3; i++) {
+            data.emplace_back(i * 2 + 100, i);
+        }
+
+        bool result = true;
+        std::string fileName = Utils::GetFilenameWithExt("test_footer");
+        for (SearchType searchType: {SearchType::BINARY_SEARCH, SearchType::B_TREE_SEARCH}) {
+            SST *sstFile = new SST(fileName, data.size() * SST::KV_PAIR_BYTE_SIZE);
+            if (searchType == SearchType::B_TREE_SEARCH) {
+                sstFile->SetupBTreeFile();
+            }
+            AlignedFileWriter file(sstFile->GetFileName());
+            sstFile->WriteFile(file, data, searchType, true);
+            delete sstFile;
+
+            // Open the file the way Db::Open does
+            sstFile = new SST(fileName, std::filesystem::file_size(fileName));
+            if (searchType == SearchType::B_TREE_SEARCH) {
+                result &= sstFile->LoadBTreeIndex();
+            } else {
+                result &= sstFile->LoadBinarySearchFooter();
+                result &= sstFile->GetFileDataSize() == 3 * SST::PAGE_SIZE;
+                result &= sstFile->PerformBinarySearch(data.back().first, nullptr) == data.back().second;
+            }
+            result &= sstFile->GetMinKey() == data.front().first && sstFile->GetMaxKey() == data.back().first;
+            result &= sstFile->GetNumEntries() == data.size();
+            result &= sstFile->OverlapsRange(0, data.front().first) && !sstFile->OverlapsRange(0, 100);
+            result &= !sstFile->OverlapsRange(data.back().first + 1, Utils::INVALID_VALUE);
+
+            // Clean up
+            delete sstFile;
+            std::remove(fileName.c_str());
+        }
+        return result;
+    }
+
+    /**
+     * Expect a B-Tree file to be written from start to end, with the leaves first and the metadata
+     * page last, even when its number of entries is not known up front, and to be searched once opened again.
+     */
+    static bool TestAppendOnlyBTreeFile() {
+        // More leaves than fit in a page of fence keys, so that the B-Tree has three levels
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 1; i <= (SST::KEYS_PER_PAGE + 2) * SST::KV_PAIRS_PER_PAGE + 3; i++) {
+            data.emplace_back(i * 2, i);
+        }
+
+        bool result = true;
+        std::string fileName = Utils::GetFilenameWithExt("test_append_only");
+        SST *sstFile = new SST(fileName, 0);
+        sstFile->SetupBTreeFile();
+        AlignedFileWriter file(sstFile->GetFileName());
+        VectorEntryIterator iterator(data);
+        sstFile->WriteFile(file, &iterator, SearchType::B_TREE_SEARCH, 4);
+        // Each page is written out once
+        uint64_t fileSize = std::filesystem::file_size(fileName);
+        result &= file.GetNumBytesWritten() == fileSize && fileSize % SST::PAGE_SIZE == 0;
+        delete sstFile;
+
+        int fd = Utils::OpenFile(fileName);
+        std::vector<uint64_t> firstLeaf = SST::ReadPagesOfFile(fd, 0);
+        result &= !firstLeaf.empty() && firstLeaf[0] == data.front().first;
+        AlignedBuffer lastPage(SST::PAGE_SIZE);
+        result &= pread(fd, lastPage.Data(), SST::PAGE_SIZE, (off_t) (fileSize - SST::PAGE_SIZE)) == SST::PAGE_SIZE;
+        result &= lastPage.Data()[SST::PAGE_SIZE / sizeof(uint64_t) - 1] == SST::FOOTER_MAGIC;
+        std::vector<uint64_t> levelsPageOffsets = SST::ReadBTreeLevelOffsets(fd);
+        result &= levelsPageOffsets.size() == 3 && levelsPageOffsets.back() == 0;
+        close(fd);
+
+        // Open the file the way Db::Open does
+        sstFile = new SST(fileName, fileSize);
+        result &= sstFile->LoadBTreeIndex();
+        result &= sstFile->GetMaxOffsetToReadLeaves() == SST::KEYS_PER_PAGE + 2;
+        result &= sstFile->GetNumEntries() == data.size();
+        for (size_t i = 0; i < data.size(); i += SST::KV_PAIRS_PER_PAGE / 2 + 1) {
+            result &= sstFile->PerformBTreeSearch(data[i].first, nullptr, false) == data[i].second;
+            result &= sstFile->PerformBTreeSearch(data[i].first + 1, nullptr, false) == Utils::INVALID_VALUE;
+        }
+        result &= sstFile->PerformBTreeSearch(data.back().first, nullptr, false) == data.back().second;
+
+        // Clean up
+        delete sstFile;
+        std::remove(fileName.c_str());
+        return result;
+    }
+
+    /**
+     * Expect files written with larger pages to record their page size, and to be searched and
+     * scanned once opened again with the default page size, whatever the layout of their leaves.
+     */
+    static bool TestPageSizes() {
+        bool result = true;
+        std::string fileName = Utils::GetFilenameWithExt("test_page_sizes");
+        for (size_t pageSize: {(size_t) 16384, SST::MAX_PAGE_SIZE}) {
+            std::vector<DataEntry_t> data;
+            for (uint64_t i = 1; i <= 3 * (pageSize / SST::KV_PAIR_BYTE_SIZE) + 5; i++) {
+                data.emplace_back(i * 3, i);
+            }
+            for (int format = -1; format <= LeafFormat::COLUMNAR_LEAVES; format++) {
+                // The binary search file first, then a B-Tree file of each leaf format
+                SearchType searchType = format == -1 ? SearchType::BINARY_SEARCH : SearchType::B_TREE_SEARCH;
+                SST *sstFile = new SST(fileName, data.size() * SST::KV_PAIR_BYTE_SIZE, nullptr, pageSize);
+                if (searchType == SearchType::B_TREE_SEARCH) {
+                    sstFile->SetupBTreeFile((LeafFormat) format);
+                }
+                AlignedFileWriter file(sstFile->GetFileName());
+                sstFile->WriteFile(file, data, searchType, true);
+                delete sstFile;
+                uint64_t fileSize = std::filesystem::file_size(fileName);
+                result &= fileSize % pageSize == 0;
+
+                // Open the file the way Db::Open does
+                sstFile = new SST(fileName, fileSize);
+                std::vector<DataEntry_t> scanResult;
+                if (searchType == SearchType::B_TREE_SEARCH) {
+                    result &= sstFile->LoadBTreeIndex();
+                    result &= sstFile->PerformBTreeSearch(data[1].first, nullptr, false) == data[1].second;
+                    result &= sstFile->PerformBTreeSearch(data.back().first, nullptr, false) == data.back().second;
+                    result &= sstFile->PerformBTreeSearch(data[1].first + 1, nullptr, false) == Utils::INVALID_VALUE;
+                    sstFile->PerformBTreeScan(data.front().first, data.back().first, scanResult);
+                } else {
+                    result &= sstFile->LoadBinarySearchFooter();
+                    result &= sstFile->PerformBinarySearch(data[1].first, nullptr) == data[1].second;
+                    result &= sstFile->PerformBinarySearch(data.back().first, nullptr) == data.back().second;
+                    sstFile->PerformBinaryScan(data.front().first, data.back().first, scanResult);
+                }
+                result &= sstFile->GetPageSize() == pageSize && sstFile->GetNumEntries() == data.size();
+                // The binary scan does not return the pairs in order
+                std::sort(scanResult.begin(), scanResult.end());
+                result &= scanResult == data;
+
+                // Clean up
+                delete sstFile;
+                std::remove(fileName.c_str());
+            }
+        }
+        result &= !SST::IsValidPageSize(2048) && !SST::IsValidPageSize(12288);
+        result &= !SST::IsValidPageSize(2 * SST::MAX_PAGE_SIZE) && SST::IsValidPageSize(SST::PAGE_SIZE);
+        return result;
+    }
+
+    /**
+     * Expect each page of entries to start with a header telling its type and number of entries,
+     * so that keys and values of UINT64_MAX are read back like any other, whatever the read mode.
+     */
+    static bool TestPageHeaders() {
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 1; i <= 2 * SST::KV_PAIRS_PER_PAGE + 3; i++) {
+            data.emplace_back(i * 2, i == SST::KV_PAIRS_PER_PAGE / 2 ? Utils::INVALID_VALUE : i);
+        }
+        data.back().first = Utils::INVALID_VALUE;
+
+        bool result = true;
+        std::string fileName = Utils::GetFilenameWithExt("test_page_headers");
+        for (int format = -1; format <= LeafFormat::COLUMNAR_LEAVES; format++) {
+            SearchType searchType = format == -1 ? SearchType::BINARY_SEARCH : SearchType::B_TREE_SEARCH;
+            SST *sstFile = new SST(fileName, data.size() * SST::KV_PAIR_BYTE_SIZE);
+            if (searchType == SearchType::B_TREE_SEARCH) {
+                sstFile->SetupBTreeFile((LeafFormat) format);
+            }
+            AlignedFileWriter file(sstFile->GetFileName());
+            sstFile->WriteFile(file, data, searchType, true);
+            delete sstFile;
+
+            int fd = Utils::OpenFile(fileName);
+            AlignedBuffer page(SST::PAGE_SIZE);
+            pread(fd, page.Data(), SST::PAGE_SIZE, 0);
+            result &= PageHeader::IsIntact(page.Data(), SST::PAGE_SIZE / sizeof(uint64_t));
+            if (format == -1 || format == LeafFormat::RAW_LEAVES) {
+                result &= PageHeader::GetType(page.Data()) == PageType::ENTRIES_PAGE;
+                result &= PageHeader::GetNumEntries(page.Data()) == SST::KV_PAIRS_PER_PAGE;
+                pread(fd, page.Data(), SST::PAGE_SIZE, 2 * SST::PAGE_SIZE);
+                result &= PageHeader::GetNumEntries(page.Data()) == 3;
+            }
+            if (format != -1) {
+                std::vector<uint64_t> leaves = SST::ReadLeafPagesOfFile(fd, 0, 3, (LeafFormat) format);
+                size_t numEntries = SST::GetLeafNumEntries(leaves, (LeafFormat) format);
+                result &= numEntries == data.size();
+                result &= SST::FindKeyInLeaves(leaves, numEntries, Utils::INVALID_VALUE, (LeafFormat) format) ==
+                          data.size() - 1;
+            }
+            close(fd);
+
+            for (SSTReadMode readMode: {SSTReadMode::PREAD_READS, SSTReadMode::MMAP_READS}) {
+                // Open the file the way Db::Open does
+                sstFile = new SST(fileName, std::filesystem::file_size(fileName));
+                sstFile->SetReadMode(readMode);
+                std::vector<DataEntry_t> scanResult;
+                if (searchType == SearchType::B_TREE_SEARCH) {
+                    result &= sstFile->LoadBTreeIndex();
+                    result &= sstFile->PerformBTreeSearch(data.back().first, nullptr, false) == data.back().second;
+                    sstFile->PerformBTreeScan(0, Utils::INVALID_VALUE, scanResult);
+                } else {
+                    result &= sstFile->LoadBinarySearchFooter();
+                    result &= sstFile->PerformBinarySearch(data.back().first, nullptr) == data.back().second;
+                    sstFile->PerformBinaryScan(0, Utils::INVALID_VALUE, scanResult);
+                }
+                std::sort(scanResult.begin(), scanResult.end());
+                result &= scanResult == data;
+                delete sstFile;
+            }
+
+            // Clean up
+            std::remove(fileName.c_str());
+        }
+        return result;
+    }
+
+    /**
+     * Expect the pages of a file written with checksums to be read up to the first corrupt one.
+     */
+    static bool TestPageChecksums() {
+        // Values spread over all 64 bits, so that compressed leaves take several pages too
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 1; i <= 2 * SST::KV_PAIRS_PER_PAGE + 3; i++) {
+            data.emplace_back(i * 2, i * 0x9E3779B97F4A7C15);
+        }
+
+        bool result = true;
+        std::string fileName = Utils::GetFilenameWithExt("test_page_checksums");
+        for (LeafFormat leafFormat: {LeafFormat::RAW_LEAVES, LeafFormat::COMPRESSED_LEAVES,
+                                     LeafFormat::COLUMNAR_LEAVES}) {
+            SST *sstFile = new SST(fileName, data.size() * SST::KV_PAIR_BYTE_SIZE);
+            sstFile->SetPageChecksums(true);
+            sstFile->SetupBTreeFile(leafFormat);
+            AlignedFileWriter file(sstFile->GetFileName());
+            sstFile->WriteFile(file, data, SearchType::B_TREE_SEARCH, true);
+            uint64_t numLeaves = sstFile->GetMaxOffsetToReadLeaves() + 1;
+            delete sstFile;
+
+            int fd = open(fileName.c_str(), O_RDWR);
+            std::vector<uint64_t> leaves = SST::ReadLeafPagesOfFile(fd, 0, numLeaves, leafFormat);
+            result &= SST::GetLeafNumEntries(leaves, leafFormat) == data.size();
+
+            // Flip a bit of the last word of the second leaf, past the header that tells its extent.
+            uint64_t word;
+            off_t byteOffset = 2 * SST::PAGE_SIZE - sizeof(uint64_t);
+            pread(fd, &word, sizeof(word), byteOffset);
+            word ^= 1;
+            pwrite(fd, &word, sizeof(word), byteOffset);
+            leaves = SST::ReadLeafPagesOfFile(fd, 0, numLeaves, leafFormat);
+            size_t numEntries = SST::GetLeafNumEntries(leaves, leafFormat);
+            result &= numEntries > 0 && numEntries < data.size();
+            result &= SST::GetLeafKey(leaves, numEntries - 1, leafFormat) == data[numEntries - 1].first;
+            result &= SST::ReadLeafPagesOfFile(fd, 1, 1, leafFormat).empty();
+
+            // Clean up
+            close(fd);
+            std::remove(fileName.c_str());
+        }
+        return result;
+    }
+
 public:
     bool RunTests() override {
         bool allTestPassed = true;
@@ -241,6 +585,13 @@ public:
         allTestPassed &= assertTrue(TestPerformBinarySearchKeyNotExist, "TestSST::TestPerformBinarySearchKeyNotExist");
         allTestPassed &= assertTrue(TestPerformBinaryScanFullSST, "TestSST::TestPerformBinaryScanFullSST");
         allTestPassed &= assertTrue(TestPerformBinaryScanPartialSST, "TestSST::TestPerformBinaryScanPartialSST");
+        allTestPassed &= assertTrue(TestWriteFileFromIterator, "TestSST::TestWriteFileFromIterator");
+        allTestPassed &= assertTrue(TestFindKeyInLeaves, "TestSST::TestFindKeyInLeaves");
+        allTestPassed &= assertTrue(TestFooter, "TestSST::TestFooter");
+        allTestPassed &= assertTrue(TestAppendOnlyBTreeFile, "TestSST::TestAppendOnlyBTreeFile");
+        allTestPassed &= assertTrue(TestPageSizes, "TestSST::TestPageSizes");
+        allTestPassed &= assertTrue(TestPageHeaders, "TestSST::TestPageHeaders");
+        allTestPassed &= assertTrue(TestPageChecksums, "TestSST::TestPageChecksums");
         return allTestPassed;
     }
 };
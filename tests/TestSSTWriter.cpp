@@ -0,0 +1,85 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include "SSTWriter.h"
+#include "TestBase.h"
+
+class TestSSTWriter : public TestBase {
+
+    static std::vector<char> ReadFileBytes(const std::string &fileName) {
+        std::ifstream file(fileName, std::ios::in | std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    static bool TestWriteFile() {
+        // More than one buffer of pairs, and not page-aligned
+        uint64_t numEntries = 1000;
+        std::string fileName = Utils::GetFilenameWithExt("test_writer");
+        auto *writer = new SSTWriter(fileName, numEntries, 10, 1);
+        bool result = true;
+        std::vector<DataEntry_t> data;
+        for (uint64_t i = 0; i < numEntries; i++) {
+            data.emplace_back(i * 2 + 1, i * 10);
+            result &= writer->Add(i * 2 + 1, i * 10);
+        }
+        SST *sstFile = writer->Finish();
+        delete writer;
+        if (sstFile == nullptr) {
+            return false;
+        }
+        result &= sstFile->GetMinKey() == 1 && sstFile->GetMaxKey() == numEntries * 2 - 1;
+
+        // Every key is found, and the keys in between are not
+        for (uint64_t i = 0; i < numEntries; i++) {
+            result &= sstFile->PerformBTreeSearch(i * 2 + 1, nullptr, true) == i * 10;
+            result &= sstFile->PerformBTreeSearch(i * 2, nullptr, true) == Utils::INVALID_VALUE;
+        }
+
+        // The file is the same as the one the LSM-Tree writes for the same data
+        std::string expectedFileName = Utils::GetFilenameWithExt("test_expected");
+        SST *expectedFile = new SST(expectedFileName, numEntries * SST::KV_PAIR_BYTE_SIZE,
+                                    new BloomFilter(10, numEntries));
+        expectedFile->SetupBTreeFile();
+        AlignedFileWriter file(expectedFile->GetFileName());
+        VectorEntryIterator iterator(data);
+        expectedFile->WriteFile(file, &iterator, SearchType::B_TREE_SEARCH);
+        result &= ReadFileBytes(fileName) == ReadFileBytes(expectedFileName);
+
+        // Clean up
+        delete sstFile;
+        delete expectedFile;
+        std::remove(fileName.c_str());
+        std::remove(expectedFileName.c_str());
+        return result;
+    }
+
+    static bool TestInvalidInput() {
+        std::string fileName = Utils::GetFilenameWithExt("test_writer");
+        bool result = true;
+        {
+            SSTWriter writer(fileName, 3, 10);
+            result &= writer.Add(5, 50);
+            result &= !writer.Add(5, 60);  // Keys must be strictly ascending
+            result &= !writer.Add(4, 40);
+            result &= !writer.Add(6, Utils::INVALID_VALUE);
+            result &= writer.Add(6, 60);
+            // Finishing before all the announced pairs are added fails
+            result &= writer.Finish() == nullptr;
+            result &= writer.Add(7, 70);
+            result &= !writer.Add(8, 80);
+        }
+        // An unfinished file is removed
+        result &= !std::filesystem::exists(fileName);
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool result = true;
+        result &= assertTrue(TestWriteFile, "TestSSTWriter::TestWriteFile");
+        result &= assertTrue(TestInvalidInput, "TestSSTWriter::TestInvalidInput");
+        return result;
+    }
+};
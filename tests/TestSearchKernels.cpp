@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <vector>
+#include "TestBase.h"
+#include "SearchKernels.h"
+#include "Utils.h"
+
+class TestSearchKernels : public TestBase {
+    static std::vector<SearchKernel> GetSupportedKernels() {
+        std::vector<SearchKernel> kernels;
+        for (SearchKernel kernel: {SCALAR_KERNEL, SSE42_KERNEL, AVX2_KERNEL}) {
+            if (SearchKernels::IsKernelSupported(kernel)) {
+                kernels.push_back(kernel);
+            }
+        }
+        return kernels;
+    }
+
+    /**
+     * Expect every kernel to find the same index as std::lower_bound for every key of arrays of
+     * all sizes up to past a few linear search ranges, and for the keys in between them.
+     */
+    static bool TestLowerBound() {
+        bool result = true;
+        for (size_t numKeys = 0; numKeys <= SearchKernels::LINEAR_SEARCH_NUM_KEYS * 5; numKeys++) {
+            std::vector<uint64_t> keys;
+            for (size_t i = 0; i < numKeys; i++) {
+                keys.push_back(i * 2 + 1);
+            }
+            for (SearchKernel kernel: GetSupportedKernels()) {
+                for (uint64_t key = 0; key <= numKeys * 2 + 1; key++) {
+                    size_t expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+                    result &= SearchKernels::LowerBound(keys.data(), numKeys, key, kernel) == expected;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Expect the keys to be compared as unsigned integers, as the vector instructions only
+     * compare signed ones.
+     */
+    static bool TestLowerBoundLargeKeys() {
+        bool result = true;
+        std::vector<uint64_t> keys = {0, 1, 1ULL << 62, (1ULL << 63) - 1, 1ULL << 63, (1ULL << 63) + 1,
+                                      Utils::DELETED_KEY_VALUE - 1, Utils::DELETED_KEY_VALUE};
+        std::vector<uint64_t> entries;
+        for (uint64_t key: keys) {
+            entries.push_back(key);
+            entries.push_back(Utils::INVALID_VALUE - key);
+        }
+        for (SearchKernel kernel: GetSupportedKernels()) {
+            for (size_t i = 0; i < keys.size(); i++) {
+                result &= SearchKernels::LowerBound(keys.data(), keys.size(), keys[i], kernel) == i;
+                result &= SearchKernels::LowerBoundInPairs(entries.data(), keys.size(), keys[i], kernel) == i;
+            }
+            result &= SearchKernels::LowerBound(keys.data(), keys.size(), Utils::INVALID_VALUE, kernel) ==
+                      keys.size();
+        }
+        return result;
+    }
+
+    /**
+     * Expect only the keys of entries laid out as keys and values one after another to be
+     * compared, with values that would be smaller than the keys.
+     */
+    static bool TestLowerBoundInPairs() {
+        bool result = true;
+        for (size_t numEntries = 0; numEntries <= SearchKernels::LINEAR_SEARCH_NUM_KEYS * 5; numEntries++) {
+            std::vector<uint64_t> keys;
+            std::vector<uint64_t> entries;
+            for (size_t i = 0; i < numEntries; i++) {
+                keys.push_back(i * 3 + 10);
+                entries.push_back(i * 3 + 10);
+                entries.push_back(i % 4);
+            }
+            for (SearchKernel kernel: GetSupportedKernels()) {
+                for (uint64_t key = 0; key <= numEntries * 3 + 11; key++) {
+                    size_t expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+                    result &= SearchKernels::LowerBoundInPairs(entries.data(), numEntries, key, kernel) == expected;
+                }
+            }
+        }
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestLowerBound, "TestSearchKernels::TestLowerBound");
+        allTestPassed &= assertTrue(TestLowerBoundLargeKeys, "TestSearchKernels::TestLowerBoundLargeKeys");
+        allTestPassed &= assertTrue(TestLowerBoundInPairs, "TestSearchKernels::TestLowerBoundInPairs");
+        return allTestPassed;
+    }
+};
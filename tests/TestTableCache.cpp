@@ -0,0 +1,108 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include "TestBase.h"
+#include "TableCache.h"
+
+class TestTableCache : public TestBase {
+    static const int NUM_FILES = 3;
+
+    static std::string GetFileName(int fileNumber) {
+        return "table_cache_test" + std::to_string(fileNumber) + ".bin";
+    }
+
+    static void CreateFiles() {
+        for (int i = 0; i < NUM_FILES; i++) {
+            std::ofstream file(GetFileName(i), std::ios::out | std::ios::binary);
+            file << "file " << i;
+        }
+    }
+
+    static void RemoveFiles() {
+        for (int i = 0; i < NUM_FILES; i++) {
+            std::filesystem::remove(GetFileName(i));
+        }
+    }
+
+    static bool IsOpen(int fd) {
+        return fcntl(fd, F_GETFD) != -1;
+    }
+
+    /**
+     * Expect the files to stay open between their reads, and the least recently used one to be
+     * closed first once there are more than the capacity.
+     */
+    static bool TestLeastRecentlyUsed() {
+        CreateFiles();
+        TableCache tableCache(2);
+        int fd0 = tableCache.Acquire(0, GetFileName(0));
+        tableCache.Release(0, fd0);
+        int fd1 = tableCache.Acquire(1, GetFileName(1));
+        tableCache.Release(1, fd1);
+        bool result = fd0 != -1 && fd1 != -1 && IsOpen(fd0) && IsOpen(fd1);
+
+        // The file is open already, and is now the most recently used one.
+        result &= tableCache.Acquire(0, GetFileName(0)) == fd0;
+        tableCache.Release(0, fd0);
+        result &= tableCache.GetNumHits() == 1 && tableCache.GetNumMisses() == 2;
+
+        int fd2 = tableCache.Acquire(2, GetFileName(2));
+        tableCache.Release(2, fd2);
+        result &= tableCache.GetNumOpenFiles() == 2;
+        result &= IsOpen(fd0) && IsOpen(fd2);
+
+        // The file closed is opened again.
+        fd1 = tableCache.Acquire(1, GetFileName(1));
+        tableCache.Release(1, fd1);
+        result &= fd1 != -1 && tableCache.GetNumMisses() == 4 && tableCache.GetNumOpenFiles() == 2;
+
+        // A missing file is not cached.
+        result &= tableCache.Acquire(NUM_FILES, GetFileName(NUM_FILES)) == -1;
+        result &= tableCache.GetNumOpenFiles() == 2;
+        RemoveFiles();
+        return result;
+    }
+
+    /**
+     * Expect the pinned files to stay open past the capacity until they are released, and the
+     * erased files to be closed once they are not pinned anymore.
+     */
+    static bool TestPinnedAndErasedFiles() {
+        CreateFiles();
+        TableCache tableCache(1);
+        std::vector<int> fds;
+        for (int i = 0; i < NUM_FILES; i++) {
+            fds.push_back(tableCache.Acquire(i, GetFileName(i)));
+        }
+        bool result = tableCache.GetNumOpenFiles() == NUM_FILES;
+        for (int i = 0; i < NUM_FILES; i++) {
+            result &= IsOpen(fds[i]);
+        }
+
+        // Erased while it is pinned, so closed once released.
+        tableCache.Erase(0);
+        result &= IsOpen(fds[0]) && tableCache.GetNumOpenFiles() == NUM_FILES - 1;
+        tableCache.Release(0, fds[0]);
+        result &= !IsOpen(fds[0]);
+
+        tableCache.Release(1, fds[1]);
+        tableCache.Release(2, fds[2]);
+        result &= tableCache.GetNumOpenFiles() == 1 && !IsOpen(fds[1]) && IsOpen(fds[2]);
+
+        // Erased while it is not pinned, so closed right away.
+        tableCache.Erase(2);
+        result &= tableCache.GetNumOpenFiles() == 0 && !IsOpen(fds[2]);
+        RemoveFiles();
+        return result;
+    }
+
+public:
+    bool RunTests() override {
+        bool allTestPassed = true;
+        allTestPassed &= assertTrue(TestLeastRecentlyUsed, "TestTableCache::TestLeastRecentlyUsed");
+        allTestPassed &= assertTrue(TestPinnedAndErasedFiles, "TestTableCache::TestPinnedAndErasedFiles");
+        return allTestPassed;
+    }
+};